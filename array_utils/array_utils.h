@@ -125,5 +125,21 @@
 // [`print.c`](print.html).
 void print(int number_of_items, int items[number_of_items]);
 
+/** \brief Print a given array's `double` items in `stdout`, one item per line.
+ *
+ * \param number_of_items The number of items of the array `items` to print.
+ * \param items The array (or rather, a pointer to its first item) whose
+ * items will be printed.
+ * \return Nothing (it is a procedure).
+ * \pre `number_of_items` ≥ 0
+ * \pre `items` ≠ null
+ * \pre `items` points to an array with at least `number_of_items` items
+ *
+ * This procedure prints `number_of_items` items from the array `items`. It
+ * prints each item of the array in a separate line, with the smallest number
+ * of significant digits that allows reading back exactly the same value.
+ */
+void print_doubles(int number_of_items, double items[number_of_items]);
+
 // Final da instrução condicional do pré-processador.
 #endif // ISLA_EDA_ARRAY_UTILS_H_INCLUDED
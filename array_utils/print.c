@@ -41,13 +41,20 @@
 // Estas inclusões ser feita apenas _após_ se incluir o ficheiro de cabeçalho
 // corresponde ao próprio ficheiro de implementação. Neste caso temos:
 //
-// - `stdio.h` &ndash; Necessário para poder usar o procedimento `printf`.
+// - `stdio.h` &ndash; Necessário para poder usar o canal `stdout`.
 //
 // - `assert.h` &ndash; Necessário para se poder usar a macro `assert()` para
 //   fazer asserções no código.
+//
+// - `buffered_output.h` &ndash; Necessário para se poder usar a biblioteca de
+//   escrita com _buffer_ (ver
+//   [`buffered_output.h`](../buffered_output/buffered_output.h.html)), que é
+//   muito mais rápida do que `printf()` quando se imprimem muitos itens.
 #include <stdio.h>
 #include <assert.h>
 
+#include "buffered_output.h"
+
 // ### Definição de rotinas
 //
 // Definição de todas as rotinas correspondentes a este ficheiro. Neste caso há
@@ -77,6 +84,14 @@ void print(int number_of_items, int items[number_of_items])
 	// terminaria e tudo _pareceria_ funcionar. No caso da guarda fraca, o
 	// ciclo tornar-se-ia muito longo (mas não infinito) o que levaria à
 	// mais rápida detecção do problema.
-	for (int i = 0; i != number_of_items; i++)
-		printf("%d\n", items[i]);
+	//
+	// Os itens são acumulados num _buffer_ colocado na pilha, que é escrito
+	// de uma só vez sempre que fica cheio, e no final.
+	struct buffered_output output;
+	buffered_output_start(&output, stdout);
+	for (int i = 0; i != number_of_items; i++) {
+		buffered_output_long(&output, items[i]);
+		buffered_output_char(&output, '\n');
+	}
+	buffered_output_finish(&output);
 }
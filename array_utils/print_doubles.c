@@ -0,0 +1,37 @@
+// `print_doubles.c` &ndash; Ficheiro de implementação (modularização física)
+// ==========================================================================
+//
+// Este é mais um dos ficheiros de implementação associados ao ficheiro de
+// cabeçalho [`array_utils.h`](array_utils.html). Ver a explicação no ficheiro
+// [`print.c`](print.html), cujo procedimento `print()` faz para os _arrays_ de
+// `int` o mesmo que o procedimento `print_doubles()` faz para os _arrays_ de
+// `double`.
+
+// ### Inclusão do cabeçalho correspondente a esta implementação
+#include "array_utils.h"
+
+// ### Inclusão de ficheiros de cabeçalho necessários no código de implementação
+#include <stdio.h>
+#include <assert.h>
+
+#include "buffered_output.h"
+
+// ### Definição de rotinas
+//
+// Cada item é escrito com 17 algarismos significativos, o que permite
+// recuperá-lo exactamente (ver `buffered_output_double()`). Assim, ao
+// contrário do que acontece com `printf("%g\n")`, que usa apenas 6 algarismos
+// significativos, os itens impressos podem ser lidos de volta sem perdas.
+void print_doubles(int number_of_items, double items[number_of_items])
+{
+	assert(number_of_items >= 0);
+	assert(items != NULL);
+
+	struct buffered_output output;
+	buffered_output_start(&output, stdout);
+	for (int i = 0; i != number_of_items; i++) {
+		buffered_output_double(&output, items[i]);
+		buffered_output_char(&output, '\n');
+	}
+	buffered_output_finish(&output);
+}
@@ -0,0 +1,354 @@
+// `benchmark.c` &ndash; Implementação da biblioteca de micro-avaliação de desempenho
+// ================================================================================
+
+// Implementação do módulo físico `benchmark`
+// ------------------------------------------
+//
+// Este ficheiro de implementação contém a implementação do módulo físico
+// `benchmark`. A interface deste módulo encontra-se no ficheiro de cabeçalho
+// ou de interface [`benchmark.h`](benchmark.h.html).
+//
+// Note-se que este ficheiro não possui comentários de documentação (começados
+// por `/**`). Tratando-se de um ficheiro de implementação, nada contém que seja
+// relevante na documentação do módulo físico, já que esta está relacionada
+// apenas com a sua interface.
+
+// ### Inclusão do cabeçalho correspondente a esta implementação
+#include "benchmark.h"
+
+// ### Inclusão de ficheiros de cabeçalho necessários no código de implementação
+//
+// - `stdlib.h` &ndash; Para podermos usar as rotinas `malloc()` e `free()` e o
+//   valor especial `NULL`.
+//
+// - `time.h` &ndash; Para podermos usar a rotina `clock_gettime()` e, na sua
+//   falta, a função `clock()` e a macro `CLOCKS_PER_SEC`.
+//
+// - `math.h` &ndash; Para podermos usar a função `sqrt()` e as macros `NAN` e
+//   `INFINITY`.
+//
+// - `assert.h` &ndash; Para podermos usar a macro `assert()`.
+//
+// - `unistd.h` &ndash; Apenas em sistemas Unix, para podermos usar a rotina
+//   `sysconf()` para obter a dimensão da _cache_ de último nível e a macro
+//   `_POSIX_MONOTONIC_CLOCK`, que indica se a rotina `clock_gettime()` suporta
+//   o relógio monótono `CLOCK_MONOTONIC`.
+//
+// - `array_of_doubles.h` &ndash; Para podermos usar a rotina
+//   `double_array_median_in_place()`, que calcula a mediana dos tempos por
+//   selecção rápida.
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include <assert.h>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+#include "array_of_doubles.h"
+
+// ### Definição de constantes
+
+const struct benchmark_settings default_benchmark_settings = {
+	.precision = 1.0,
+	.warm_up_runs = 1L,
+	.maximum_repetition_time = 300.0,
+	.maximum_repetitions = 1001L,
+	.flush_cache = false
+};
+
+// Dimensão, em _bytes_, da _cache_ de último nível a admitir quando não for
+// possível obtê-la do sistema operativo.
+static const long default_last_level_cache_size = 32L * 1024L * 1024L;
+
+// ### Rotinas auxiliares
+
+// Devolve o instante corrente, em segundos, medido por um relógio monótono de
+// alta resolução, quando disponível, ou pela função `clock()`, no caso
+// contrário. Todos os tempos são medidos através desta função, para que os
+// tempos das execuções acumuladas e os das execuções isoladas (com as _caches_
+// frias) meçam a mesma coisa, i.e., o tempo real decorrido, e possam ser
+// comparados entre si. Note que a função `clock()` mede o tempo de processador
+// consumido pelo processo, e não o tempo real.
+static double now(void)
+{
+#if defined(_POSIX_MONOTONIC_CLOCK) && _POSIX_MONOTONIC_CLOCK >= 0
+	struct timespec instant;
+	clock_gettime(CLOCK_MONOTONIC, &instant);
+	return instant.tv_sec + instant.tv_nsec * 1e-9;
+#else
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+// Realiza uma execução completa: esvazia as _caches_ (se `flush_cache` for
+// `true`), prepara a execução através de `setup`, executa `routine` e arruma a
+// casa através de `teardown`. Qualquer das rotinas pode ser `NULL`, sendo nesse
+// caso ignorada. Isso permite usar esta mesma rotina para estimar o custo de
+// tudo o que não é a rotina a avaliar, passando `NULL` como `routine`. Devolve
+// `true` em caso de erro.
+static bool run_once(benchmark_routine *const routine,
+		     benchmark_setup *const setup,
+		     benchmark_teardown *const teardown, void *const context,
+		     const bool flush_cache)
+{
+	if (flush_cache && benchmark_flush_cache())
+		return true;
+
+	if (setup != NULL && setup(context))
+		return true;
+
+	if (routine != NULL && routine(context))
+		return true;
+
+	if (teardown != NULL)
+		teardown(context);
+
+	return false;
+}
+
+// Realiza `runs` execuções completas, sem esvaziar as _caches_, devolvendo o
+// tempo médio de cada uma, em segundos. Em caso de erro, devolve um valor
+// negativo.
+static double time_per_run(const long runs, benchmark_routine *const routine,
+			   benchmark_setup *const setup,
+			   benchmark_teardown *const teardown,
+			   void *const context)
+{
+	const double start = now();
+
+	for (long i = 0L; i != runs; i++)
+		if (run_once(routine, setup, teardown, context, false))
+			return -1.0;
+
+	return (now() - start) / runs;
+}
+
+// Devolve uma estimativa do tempo, em segundos, de uma execução completa
+// excluindo a rotina a avaliar, ou seja, o custo de preparar a execução e de
+// arrumar a casa. A estimativa é obtida de forma
+// semelhante à usada para a rotina a avaliar: um primeiro ciclo determina o
+// número de execuções necessárias para se atingir a precisão pretendida e um
+// segundo ciclo repete esse número de execuções sem invocações intermédias da
+// função `now()`. Em caso de erro, devolve um valor negativo.
+static double overhead_time_estimate(benchmark_setup *const setup,
+				     benchmark_teardown *const teardown,
+				     void *const context,
+				     const struct benchmark_settings *const
+				     settings)
+{
+	if (setup == NULL && teardown == NULL)
+		return 0.0;
+
+	long runs = 0L;
+	const double start = now();
+
+	do {
+		if (run_once(NULL, setup, teardown, context, false))
+			return -1.0;
+		runs++;
+	} while (now() - start < settings->precision);
+
+	return time_per_run(runs, NULL, setup, teardown, context);
+}
+
+// Devolve o número de execuções completas necessárias para acumular
+// `settings->precision` segundos de execução da rotina a avaliar, descontando
+// o custo `overhead_time` do restante de cada execução. Para evitar ciclos
+// demasiado longos quando a estimativa desse custo for exagerada, o ciclo
+// termina também quando se exceder o tempo máximo das repetições. Em caso de
+// erro, devolve um valor negativo.
+static long number_of_runs(benchmark_routine *const routine,
+			   benchmark_setup *const setup,
+			   benchmark_teardown *const teardown,
+			   void *const context,
+			   const struct benchmark_settings *const settings,
+			   const double overhead_time)
+{
+	long runs = 0L;
+	const double start = now();
+	double elapsed;
+
+	do {
+		if (run_once(routine, setup, teardown, context, false))
+			return -1L;
+		runs++;
+		elapsed = now() - start;
+	} while (elapsed - runs * overhead_time < settings->precision &&
+		 elapsed < settings->maximum_repetition_time);
+
+	return runs;
+}
+
+// Realiza uma execução isolada: esvazia as _caches_, prepara a execução através
+// de `setup`, executa `routine` e arruma a casa através de `teardown`.
+// Devolve o tempo de execução de `routine`, e apenas de `routine`, em segundos.
+// Em caso de erro, devolve um valor negativo.
+static double isolated_run_time(benchmark_routine *const routine,
+				benchmark_setup *const setup,
+				benchmark_teardown *const teardown,
+				void *const context)
+{
+	if (benchmark_flush_cache())
+		return -1.0;
+
+	if (setup != NULL && setup(context))
+		return -1.0;
+
+	const double start = now();
+
+	if (routine(context))
+		return -1.0;
+
+	const double time = now() - start;
+
+	if (teardown != NULL)
+		teardown(context);
+
+	return time;
+}
+
+// Calcula as estatísticas dos `length` tempos em `times`, guardando-as em
+// `statistics`. O mínimo e o máximo são obtidos na mesma passagem que a soma e
+// a mediana é obtida por selecção (ver `double_array_median_in_place()`, do
+// módulo `array_of_doubles`), pelo que o _array_ `times` fica reordenado, mas
+// não ordenado.
+static void calculate_statistics(const long length, double times[length],
+				 struct benchmark_statistics *const statistics)
+{
+	double sum = 0.0;
+	statistics->minimum = INFINITY;
+	statistics->maximum = -INFINITY;
+	for (long i = 0L; i != length; i++) {
+		sum += times[i];
+		if (times[i] < statistics->minimum)
+			statistics->minimum = times[i];
+		if (times[i] > statistics->maximum)
+			statistics->maximum = times[i];
+	}
+	statistics->average = sum / length;
+
+	double sum_of_squares = 0.0;
+	for (long i = 0L; i != length; i++)
+		sum_of_squares += (times[i] - statistics->average) *
+			(times[i] - statistics->average);
+	statistics->stddev = sqrt(sum_of_squares / length);
+
+	statistics->median = double_array_median_in_place(length, times);
+}
+
+// ### Rotinas
+
+bool benchmark_flush_cache(void)
+{
+	// O _buffer_ usado para expulsar das _caches_ os dados aí existentes. É
+	// reservado na primeira invocação e nunca é libertado.
+	static volatile char *buffer = NULL;
+	static long buffer_size = 0L;
+
+	if (buffer == NULL) {
+		long last_level_cache_size = 0L;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+		last_level_cache_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+		if (last_level_cache_size <= 0L)
+			last_level_cache_size = default_last_level_cache_size;
+
+		// Usamos o dobro da dimensão da _cache_ para compensar a sua
+		// associatividade e as políticas de substituição que não são
+		// exactamente LRU.
+		buffer_size = 2L * last_level_cache_size;
+		buffer = malloc(buffer_size);
+		if (buffer == NULL)
+			return true;
+	}
+
+	// Lemos e escrevemos um _byte_ por cada 64 _bytes_, ou seja, por cada
+	// linha de _cache_. A escrita obriga a que as linhas passem a estar
+	// modificadas, expulsando as linhas que lá estavam.
+	for (long i = 0L; i < buffer_size; i += 64L)
+		buffer[i]++;
+
+	return false;
+}
+
+bool bench(benchmark_routine *const routine, benchmark_setup *const setup,
+	   benchmark_teardown *const teardown, void *const context,
+	   const struct benchmark_settings *const settings,
+	   struct benchmark_statistics *const statistics)
+{
+	assert(routine != NULL);
+	assert(settings != NULL);
+	assert(settings->precision > 0.0);
+	assert(settings->warm_up_runs >= 0L);
+	assert(settings->maximum_repetitions >= 1L);
+	assert(statistics != NULL);
+
+	// Realizamos as execuções de aquecimento, cujos tempos são ignorados.
+	const double warm_up_start = now();
+	for (long i = 0L; i != settings->warm_up_runs &&
+		     (!settings->flush_cache ||
+		      now() - warm_up_start < settings->precision); i++)
+		if (run_once(routine, setup, teardown, context,
+			     settings->flush_cache))
+			return true;
+
+	// Estimamos o custo de tudo o que não é a rotina a avaliar e
+	// determinamos o número de execuções usadas em cada estimativa. Com
+	// esvaziamento das _caches_, cada estimativa corresponde a uma única
+	// execução isolada, pelo que não há custos a descontar.
+	double overhead_time = 0.0;
+	long runs = 1L;
+
+	if (!settings->flush_cache) {
+		overhead_time = overhead_time_estimate(setup, teardown, context,
+						       settings);
+		if (overhead_time < 0.0)
+			return true;
+
+		runs = number_of_runs(routine, setup, teardown, context,
+				      settings, overhead_time);
+		if (runs < 0L)
+			return true;
+	}
+
+	// Os tempos obtidos em cada uma das repetições das estimativas são
+	// guardados neste _array_ dinâmico.
+	double *const times =
+		malloc(settings->maximum_repetitions * sizeof(double));
+	if (times == NULL)
+		return true;
+
+	// Repetimos a obtenção de estimativas do tempo de execução até se
+	// atingir o número máximo de repetições ou até se ultrapassar o limiar
+	// do tempo acumulado.
+	long repetitions = 0L;
+	const double start = now();
+	double repetition_time;
+
+	do {
+		const double time = settings->flush_cache ?
+			isolated_run_time(routine, setup, teardown, context) :
+			time_per_run(runs, routine, setup, teardown, context);
+		if (time < 0.0) {
+			free(times);
+			return true;
+		}
+
+		times[repetitions++] = time - overhead_time;
+
+		repetition_time = now() - start;
+	} while (repetitions != settings->maximum_repetitions &&
+		 repetition_time < settings->maximum_repetition_time);
+
+	statistics->accumulated_runs = runs;
+	statistics->repetitions = repetitions;
+	statistics->repetition_time = repetition_time;
+	statistics->overhead_time = overhead_time;
+	calculate_statistics(repetitions, times, statistics);
+
+	free(times);
+
+	return false;
+}
@@ -0,0 +1,170 @@
+// `benchmark.h` &ndash; Interface da biblioteca de micro-avaliação de desempenho
+// =============================================================================
+
+// Interface do módulo físico `benchmark`
+// --------------------------------------
+//
+// Este ficheiro de cabeçalho destina-se a ser utilizado pelo código cliente do
+// módulo físico `benchmark`, cuja implementação se encontra no ficheiro
+// [`benchmark.c`](benchmark.c.html). O módulo fornece as ferramentas para
+// estimar o tempo de execução de uma rotina qualquer, lidando com os problemas
+// habituais destas medições: a resolução limitada do relógio (executando a
+// rotina tantas vezes quantas necessárias para acumular um tempo mínimo), as
+// flutuações devidas à carga da máquina (repetindo as estimativas e calculando
+// estatísticas), o custo da preparação de cada execução (estimando-o e
+// subtraindo-o), o aquecimento inicial e o estado das _caches_.
+//
+// Estas ferramentas foram extraídas do programa de experiências com algoritmos
+// de ordenação (ver [`perform_experiments.c`](../sorting/perform_experiments.c.html)),
+// de modo a poderem ser usadas por todos os módulos.
+
+// ### Comentário de documentação do ficheiro de cabeçalho
+/**
+ * \file benchmark.h
+ * \brief Header file for the `benchmark` module, a small micro-benchmarking
+ * library.
+ *
+ * This header file declares the settings, the statistics and the routines
+ * used to estimate the execution time of arbitrary routines.
+ */
+
+// ### Protecção contra inclusões múltiplas
+#ifndef ISLA_EDA_BENCHMARK_H_INCLUDED
+#define ISLA_EDA_BENCHMARK_H_INCLUDED
+
+// Incluímos o ficheiro de interface `stdbool.h` para podermos usar o tipo
+// `bool` e os seus dois valores `true` e `false`.
+#include <stdbool.h>
+
+// ### Tipos das rotinas avaliadas
+//
+// Todas as rotinas recebem um ponteiro genérico, o _contexto_, que o código
+// cliente usa para lhes passar os dados de que necessitam (e.g., o _array_ a
+// ordenar). Seguindo a convenção usada neste projecto, as rotinas devolvem
+// `true` em caso de erro.
+
+/** \brief The type of the routines whose execution time is estimated.
+ *
+ * \param context The context passed to `bench()`.
+ * \return `true` if an error occurred, `false` otherwise.
+ */
+typedef bool benchmark_routine(void *context);
+
+/** \brief The type of the routines that prepare each execution of the routine
+ * being benchmarked.
+ *
+ * \param context The context passed to `bench()`.
+ * \return `true` if an error occurred, `false` otherwise.
+ */
+typedef bool benchmark_setup(void *context);
+
+/** \brief The type of the routines that clean up after each execution of the
+ * routine being benchmarked.
+ *
+ * \param context The context passed to `bench()`.
+ */
+typedef void benchmark_teardown(void *context);
+
+// ### Parâmetros das avaliações
+
+/** \struct benchmark_settings
+ * \brief The settings of a benchmark.
+ *
+ * All times are elapsed (wall-clock) times, measured with a monotonic high
+ * resolution clock when available, whether or not the caches are flushed.
+ */
+struct benchmark_settings {
+	/** \brief The minimum accumulated time, in seconds, of the runs used
+	 * for each time estimate. The routine is run as many times as needed
+	 * to accumulate this time, so as to overcome the clock resolution. */
+	double precision;
+	/** \brief The number of untimed runs performed before calibrating the
+	 * number of runs, so that caches, branch predictors and lazily
+	 * allocated memory are warmed up. */
+	long warm_up_runs;
+	/** \brief The repetitions of the time estimates stop when their
+	 * accumulated time, in seconds, exceeds this threshold... */
+	double maximum_repetition_time;
+	/** \brief ... or when their number reaches this maximum (≥ 1). */
+	long maximum_repetitions;
+	/** \brief If `true`, the caches are flushed (see
+	 * `benchmark_flush_cache()`) before each run, and each time estimate
+	 * is obtained from a single run of the routine, timed in isolation,
+	 * since accumulating several runs would mix the (much larger) flushing
+	 * time into the estimate. In this case `precision` is used only to
+	 * bound the warm-up. */
+	bool flush_cache;
+};
+
+/** \brief The default settings: 1 s precision, one warm-up run, up to 1001
+ * repetitions during at most 300 s and no cache flushing. */
+extern const struct benchmark_settings default_benchmark_settings;
+
+// ### Resultados das avaliações
+
+/** \struct benchmark_statistics
+ * \brief The results of a benchmark.
+ */
+struct benchmark_statistics {
+	/** \brief The number of runs used for each time estimate. */
+	long accumulated_runs;
+	/** \brief The number of time estimates obtained. */
+	long repetitions;
+	/** \brief The total time, in seconds, taken by the repetitions. */
+	double repetition_time;
+	/** \brief The estimated time, in seconds, of the setup and teardown
+	 * of a single run, which was subtracted from each time estimate (zero
+	 * when the caches are flushed, since runs are then timed in
+	 * isolation). */
+	double overhead_time;
+	/** \brief The average, standard deviation, median, minimum and
+	 * maximum of the time estimates, in seconds. */
+	double average;
+	double stddev;
+	double median;
+	double minimum;
+	double maximum;
+};
+
+// ### Rotinas
+
+/** \brief Estimates the execution time of a routine.
+ *
+ * \param routine The routine whose execution time will be estimated.
+ * \param setup The routine run before each run of `routine` (may be null).
+ * \param teardown The routine run after each run of `routine` (may be null).
+ * \param context The context passed to `routine`, `setup` and `teardown`.
+ * \param settings The benchmark settings.
+ * \param statistics Where to store the benchmark results.
+ * \return `true` if an error occurred (i.e., if any of the routines signalled
+ * an error or memory could not be allocated), `false` otherwise.
+ * \pre `routine` ≠ null
+ * \pre `settings` ≠ null
+ * \pre `statistics` ≠ null
+ *
+ * Each run consists of flushing the caches (if required by the settings),
+ * running `setup`, running `routine` and running `teardown`. After the warm-up
+ * runs, the time taken by everything but `routine` is estimated and the number
+ * of runs required to accumulate `settings->precision` seconds of `routine`
+ * execution is calibrated. The time of `routine` is then repeatedly estimated,
+ * by dividing the time taken by that number of runs by the number of runs and
+ * subtracting the overhead, and statistics of those estimates are calculated.
+ * When `settings->flush_cache` is `true`, each estimate is instead the time of
+ * a single isolated run of `routine` (see `struct benchmark_settings`).
+ */
+bool bench(benchmark_routine *routine, benchmark_setup *setup,
+	   benchmark_teardown *teardown, void *context,
+	   const struct benchmark_settings *settings,
+	   struct benchmark_statistics *statistics);
+
+/** \brief Flushes the data caches, by reading and writing a buffer larger than
+ * the last level cache.
+ *
+ * \return `true` if the buffer could not be allocated, `false` otherwise.
+ *
+ * The buffer is allocated on the first call and reused afterwards.
+ */
+bool benchmark_flush_cache(void);
+
+// ### Fim do ficheiro
+#endif // ISLA_EDA_BENCHMARK_H_INCLUDED
@@ -0,0 +1,209 @@
+// `buffered_output.c` &ndash; Implementação da biblioteca de escrita com _buffer_
+// ==============================================================================
+
+// Implementação do módulo físico `buffered_output`
+// ------------------------------------------------
+//
+// Este ficheiro de implementação contém a implementação do módulo físico
+// `buffered_output`. A interface deste módulo encontra-se no ficheiro de
+// cabeçalho ou de interface [`buffered_output.h`](buffered_output.h.html).
+
+// ### Definição de macros de selecção de funcionalidades
+//
+// A rotina `fileno()`, declarada em `stdio.h`, faz parte da norma POSIX, e não
+// da norma do C, pelo que é necessário pedir a sua declaração explicitamente,
+// definindo a macro `_POSIX_C_SOURCE` antes de qualquer inclusão.
+#define _POSIX_C_SOURCE 200809L
+
+// ### Inclusão do cabeçalho correspondente a esta implementação
+#include "buffered_output.h"
+
+// ### Inclusão de ficheiros de cabeçalho necessários no código de implementação
+//
+// - `string.h` &ndash; Para podermos usar as rotinas `memcpy()` e `strlen()`.
+//
+// - `errno.h` &ndash; Para podermos usar a variável `errno` e a macro `EINTR`.
+//
+// - `assert.h` &ndash; Para podermos usar a macro `assert()`.
+//
+// - `unistd.h` &ndash; Para podermos usar a rotina `write()`.
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <unistd.h>
+
+// ### Definição de constantes
+
+// A representação decimal de todos os pares de algarismos, de `00` a `99`. O
+// par correspondente a _n_ começa na posição 2_n_. Converter os números para
+// decimal de dois em dois algarismos reduz para metade o número de divisões,
+// que são as operações mais lentas da conversão.
+static const char digit_pairs[200] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+// O número máximo de caracteres da representação de um `long` (com 64 _bits_,
+// 19 algarismos e o sinal) e de um `double` (e.g.,
+// `-2.2250738585072014e-308`).
+#define maximum_long_length 20
+#define maximum_double_length 32
+
+// ### Rotinas auxiliares
+
+// Garante que cabem mais `length` caracteres no _buffer_, esvaziando-o se
+// necessário.
+static inline void make_room(struct buffered_output *const output,
+			     const size_t length)
+{
+	if (output->length + length > BUFFERED_OUTPUT_SIZE)
+		buffered_output_flush(output);
+}
+
+// ### Definição das rotinas
+
+void buffered_output_start(struct buffered_output *const output,
+			   FILE *const stream)
+{
+	assert(output != NULL);
+	assert(stream != NULL);
+
+	output->failed = fflush(stream) != 0;
+	output->file_descriptor = fileno(stream);
+	output->length = 0;
+}
+
+// A rotina `write()` pode escrever apenas parte dos _bytes_ pedidos, ou ser
+// interrompida por um sinal antes de escrever o que quer que seja, pelo que é
+// invocada repetidamente até escrever todo o conteúdo do _buffer_. Em caso de
+// erro, o conteúdo do _buffer_ perde-se, tal como aconteceria com o `FILE`.
+bool buffered_output_flush(struct buffered_output *const output)
+{
+	assert(output != NULL);
+
+	size_t written = 0;
+	while (!output->failed && written != output->length) {
+		const ssize_t result = write(output->file_descriptor,
+					     output->buffer + written,
+					     output->length - written);
+		if (result >= 0)
+			written += (size_t)result;
+		else if (errno != EINTR)
+			output->failed = true;
+	}
+
+	output->length = 0;
+
+	return output->failed;
+}
+
+bool buffered_output_finish(struct buffered_output *const output)
+{
+	return buffered_output_flush(output);
+}
+
+void buffered_output_char(struct buffered_output *const output,
+			  const char character)
+{
+	assert(output != NULL);
+
+	make_room(output, 1);
+	output->buffer[output->length++] = character;
+}
+
+// As cadeias maiores do que o _buffer_ são escritas por partes.
+void buffered_output_string(struct buffered_output *const output,
+			    const char *string)
+{
+	assert(output != NULL);
+	assert(string != NULL);
+
+	size_t length = strlen(string);
+	while (length != 0) {
+		make_room(output, length < BUFFERED_OUTPUT_SIZE ?
+			  length : BUFFERED_OUTPUT_SIZE);
+
+		size_t part = BUFFERED_OUTPUT_SIZE - output->length;
+		if (part > length)
+			part = length;
+
+		memcpy(output->buffer + output->length, string, part);
+		output->length += part;
+		string += part;
+		length -= part;
+	}
+}
+
+// Esta função devolve o número de algarismos decimais de `magnitude`.
+static inline int number_of_digits(const unsigned long magnitude)
+{
+	int digits = 1;
+	for (unsigned long power = 10UL; digits != maximum_long_length - 1 &&
+		     magnitude >= power; power *= 10UL)
+		digits++;
+	return digits;
+}
+
+// Os algarismos são obtidos do menos para o mais significativo, pelo que são
+// colocados da direita para a esquerda, directamente no _buffer_, depois de
+// se calcular quantos são. O módulo do valor é calculado sem sinal, pois o
+// simétrico de `LONG_MIN` não é representável num `long`.
+void buffered_output_long(struct buffered_output *const output,
+			  const long value)
+{
+	assert(output != NULL);
+
+	unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value :
+		(unsigned long)value;
+	const size_t length = (size_t)number_of_digits(magnitude) +
+		(value < 0 ? 1 : 0);
+
+	make_room(output, length);
+
+	char *const first = output->buffer + output->length;
+	char *last = first + length;
+
+	while (magnitude >= 100UL) {
+		const unsigned long pair = magnitude % 100UL;
+		magnitude /= 100UL;
+		last -= 2;
+		memcpy(last, digit_pairs + 2 * pair, 2);
+	}
+	if (magnitude >= 10UL) {
+		last -= 2;
+		memcpy(last, digit_pairs + 2 * magnitude, 2);
+	} else
+		*--last = (char)('0' + magnitude);
+
+	if (value < 0)
+		*first = '-';
+
+	output->length += length;
+}
+
+// Com 17 algarismos significativos, qualquer `double` é recuperado
+// exactamente. Muitos valores precisam de menos (e.g., 0,1), mas procurar a
+// representação mais curta experimentando 15, 16 e 17 algarismos exige até
+// três conversões e outras tantas leituras por valor, o que torna a escrita
+// até três vezes mais lenta do que com `printf("%.17g")`. Usamos, por isso,
+// sempre 17 algarismos. A representação é escrita directamente no _buffer_,
+// que tem sempre espaço para o terminador escrito pela `snprintf()`.
+void buffered_output_double(struct buffered_output *const output,
+			    const double value)
+{
+	assert(output != NULL);
+
+	make_room(output, maximum_double_length);
+
+	const int length = snprintf(output->buffer + output->length,
+				    maximum_double_length, "%.17g", value);
+
+	output->length += (size_t)length;
+}
@@ -0,0 +1,142 @@
+// `buffered_output.h` &ndash; Interface da biblioteca de escrita com _buffer_
+// ==========================================================================
+
+// Interface do módulo físico `buffered_output`
+// --------------------------------------------
+//
+// Este ficheiro de cabeçalho destina-se a ser utilizado pelo código cliente do
+// módulo físico `buffered_output`, cuja implementação se encontra no ficheiro
+// [`buffered_output.c`](buffered_output.c.html). O módulo fornece uma forma
+// rápida de escrever grandes quantidades de números, e.g., todos os termos de
+// uma sucessão ou todos os itens de um _array_.
+//
+// Escrever cada número através de `printf()` é lento: cada invocação tem de
+// interpretar a cadeia de formatação e de passar pelos trincos do `FILE`
+// correspondente. Este módulo converte os números directamente para um _buffer_
+// grande, sob controlo do código cliente, usando tabelas com a representação
+// decimal de todos os pares de algarismos, e esvazia-o através de uma única
+// invocação de `write()` sempre que este fica cheio. Os `double` são escritos
+// com 17 algarismos significativos, o que permite recuperar exactamente o valor
+// original.
+//
+// A escrita começa sempre por esvaziar o _buffer_ do `FILE` usado, pelo que
+// se pode misturar com as escritas feitas através de `printf()` e afins, desde
+// que estas não ocorram entre o início e o fim de uma escrita com _buffer_.
+
+// ### Comentário de documentação do ficheiro de cabeçalho
+/**
+ * \file buffered_output.h
+ * \brief Header file for the `buffered_output` module, a small library for
+ * fast output of large amounts of numbers.
+ *
+ * This header file declares the buffer structure and the routines used to
+ * write characters, strings, `long`s and `double`s into it.
+ */
+
+// ### Protecção contra inclusões múltiplas
+#ifndef ISLA_EDA_BUFFERED_OUTPUT_H_INCLUDED
+#define ISLA_EDA_BUFFERED_OUTPUT_H_INCLUDED
+
+// Incluímos os ficheiros de interface `stdbool.h`, para podermos usar o tipo
+// `bool`, `stddef.h`, para podermos usar o tipo `size_t`, e `stdio.h`, para
+// podermos usar o tipo `FILE`.
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// ### O _buffer_
+//
+// A estrutura é definida no ficheiro de cabeçalho, e não apenas declarada,
+// para que o código cliente a possa colocar na pilha, evitando reservas de
+// memória dinâmica. O código cliente não deve, no entanto, aceder aos seus
+// campos.
+
+/** \brief The size, in bytes, of the output buffers.
+ */
+#define BUFFERED_OUTPUT_SIZE (64 * 1024)
+
+/** \brief C structure used to accumulate the output before writing it.
+ *
+ * Its fields are private: they should be used only through the routines of
+ * this module.
+ */
+struct buffered_output {
+	int file_descriptor;
+	bool failed;
+	size_t length;
+	char buffer[BUFFERED_OUTPUT_SIZE];
+};
+
+// ### Rotinas
+
+/** \brief Starts buffered output to the given stream.
+ *
+ * \param output The buffer to use.
+ * \param stream The stream to write to, e.g., `stdout`.
+ * \pre `output` ≠ null
+ * \pre `stream` ≠ null
+ *
+ * The stream is flushed, so that everything previously written to it comes
+ * before the buffered output. The stream must not be used until
+ * `buffered_output_finish()` is called.
+ */
+void buffered_output_start(struct buffered_output *output, FILE *stream);
+
+/** \brief Writes the contents of the buffer, emptying it.
+ *
+ * \param output The buffer to flush.
+ * \return `true` if an error occurred, in this or in any previous flush,
+ * `false` otherwise.
+ * \pre `output` ≠ null
+ */
+bool buffered_output_flush(struct buffered_output *output);
+
+/** \brief Finishes buffered output, writing what remains in the buffer.
+ *
+ * \param output The buffer to finish.
+ * \return `true` if an error occurred while writing, `false` otherwise.
+ * \pre `output` ≠ null
+ */
+bool buffered_output_finish(struct buffered_output *output);
+
+/** \brief Appends a character to the buffer.
+ *
+ * \param output The buffer.
+ * \param character The character to append.
+ * \pre `output` ≠ null
+ */
+void buffered_output_char(struct buffered_output *output, char character);
+
+/** \brief Appends a null-terminated string to the buffer.
+ *
+ * \param output The buffer.
+ * \param string The string to append.
+ * \pre `output` ≠ null
+ * \pre `string` ≠ null
+ */
+void buffered_output_string(struct buffered_output *output,
+			    const char *string);
+
+/** \brief Appends the decimal representation of a `long` to the buffer.
+ *
+ * \param output The buffer.
+ * \param value The value to append, written as `printf("%ld")` would.
+ * \pre `output` ≠ null
+ */
+void buffered_output_long(struct buffered_output *output, long value);
+
+/** \brief Appends a representation of a `double` that converts back to the
+ * same value.
+ *
+ * \param output The buffer.
+ * \param value The value to append.
+ * \pre `output` ≠ null
+ *
+ * The value is written as `printf("%.17g")` would. With 17 significant digits,
+ * `strtod()` recovers exactly `value`. Infinities and NaNs are written as by
+ * `printf("%g")`.
+ */
+void buffered_output_double(struct buffered_output *output, double value);
+
+// ### Fim do ficheiro
+#endif // ISLA_EDA_BUFFERED_OUTPUT_H_INCLUDED
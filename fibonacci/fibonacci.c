@@ -139,23 +139,24 @@
 //
 // - `stdlib.h` &ndash; Para definição da _macro_ `EXIT_SUCCESS`.
 //
-// - `time.h` &ndash; Para definição da função `clock()` e da macro
-//   `CLOCKS_PER_SEC`.
-//
 // - `assert.h` &ndash; Para definição da macro `assert()`.
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 #include <assert.h>
 
 // ### Inclusão de ficheiros de cabeçalho próprios
 //
-// Incluímos apenas um ficheiro de cabeçalho «não oficial»:
+// Incluímos dois ficheiros de cabeçalho «não oficiais»:
 //
 // - `sequence_of_longs.h` &ndash; Para declaração do TAD (tipo abstracto de
 // dados) sucessão de `long` usada para guardar em memória dos termos da
 // sucessão já calculados.
+//
+// - `benchmark.h` &ndash; Para declaração da rotina `bench()`, da biblioteca
+// partilhada de micro-avaliação de desempenho, usada para estimar os tempos de
+// execução das várias implementações.
 #include "sequence_of_longs.h"
+#include "benchmark.h"
 
 // ### Implementação recursiva «estúpida»
 
@@ -906,8 +907,26 @@ long iterative_fibonacci(int n)
 //
 // Definimos agora um procedimento que realiza experiências para estimar o tempo
 // de execução de uma qualquer das várias funções de cálculo de termos da
-// sucessão de Fibonacci que desenvolvemos.
-  
+// sucessão de Fibonacci que desenvolvemos. As medições são feitas através da
+// biblioteca `benchmark`, que recebe a rotina a avaliar e um ponteiro genérico
+// para o seu _contexto_. Neste caso, o contexto contém a função de cálculo a
+// usar, o número do termo a calcular e o valor calculado.
+struct fibonacci_context {
+	long (*fibonacci)(int);
+	int n;
+	long f_n;
+};
+
+// Rotina avaliada pela biblioteca `benchmark`: calcula o termo do contexto.
+static bool calculate_term(void *generic_context)
+{
+	struct fibonacci_context *context = generic_context;
+
+	context->f_n = context->fibonacci(context->n);
+
+	return false;
+}
+
 // #### Documentação
 /** \brief Experiments a given Fibonacci sequence term calculation function for
  * a sequence of terms and reports the extimated execution times to `stdout`.
@@ -916,39 +935,44 @@ long iterative_fibonacci(int n)
  * \param fibonacci Pointer to the function to experiment with.
  * \param last_term_to_test The function will be experimented with terms from 0
  * up to this number.
+ * \param minimum_accumulated_time The minimum accumulated time, in seconds, of
+ * the repeated executions used to estimate each execution time.
  * \pre `title` ≠ null
  * \pre `fibonacci` ≠ null
  * \pre `last_term_to_test` ≥ 0
+ * \pre `minimum_accumulated_time` > 0
  * \post The results of the experiment are writen in `stdout`.
  *
  * This procedure performs experiments with the provided Fibonacci function
  * `fibonacci()`, reporting the estimated execution times for terms 0 up to
  * `last_term_to_test`. In order to overcome clock resolution issues, each
- * experiment is repeated until a total of at least 0.1 seconds is reached. For
- * all but the first term, the relative increases in execution time are also
- * reported.
- *
- * \bug The minimum accumulated time should not be hardcoded as 0.1 seconds. It
- * should be a parameter of the procedure instead.
+ * experiment is repeated until a total of at least `minimum_accumulated_time`
+ * seconds is reached. For all but the first term, the relative increases in
+ * execution time are also reported.
  */
 // #### Definição
 void experiment_efficiency_of(char title[], long fibonacci(int),
-			int last_term_to_test)
+			int last_term_to_test, double minimum_accumulated_time)
 {
 	assert(title != NULL);
 	assert(fibonacci != NULL);
 	assert(last_term_to_test >= 0);
+	assert(minimum_accumulated_time > 0.0);
 
-	// Calculamos o número mínimo de _clocks_ do relógio a passar durante as
-	// repetições das execuções da função em teste para perfazer um tempo
-	// mínimo de 0,1 segundos. Dessa forma garantimos um mínimo de precisão
-	// nas medidas sem, com isso, se realizar um número excessivo de
-	// repetições (não queremos esperar muito...). A macro `CLOCKS_PER_SEC`
-	// representa o número (inteiro) de _clocks_ ou tiques do relógio que
-	// ocorrem num segundo. O tipo `clock_t` é um sinónimo de um dos tipos
-	// inteiros sem sinal do C (o tipo exacto depende da implementação).
-	const clock_t minimum_accumulated_clocks =
-		(clock_t) (0.1 * CLOCKS_PER_SEC);
+	// Definimos os parâmetros das medições. As execuções da função em teste
+	// são repetidas até perfazer o tempo mínimo `minimum_accumulated_time`.
+	// Dessa forma garantimos um mínimo de precisão nas medidas sem, com
+	// isso, se realizar um número excessivo de repetições (não queremos
+	// esperar muito...). Não realizamos execuções de aquecimento, nem
+	// repetimos as estimativas para fins estatísticos: uma única
+	// estimativa por termo é suficiente para os nossos objectivos.
+	const struct benchmark_settings settings = {
+		.precision = minimum_accumulated_time,
+		.warm_up_runs = 0L,
+		.maximum_repetition_time = 10.0 * minimum_accumulated_time,
+		.maximum_repetitions = 1L,
+		.flush_cache = false
+	};
 
 	// Imprimimos o título da experiência em curso.
 	printf("%s\n", title);
@@ -967,40 +991,25 @@ void experiment_efficiency_of(char title[], long fibonacci(int),
 	// próprio termo em experiência fica memorizado... Analise os tempos
 	// obtidos tendo estes factos em conta.
 	for (int n = 0; n != last_term_to_test + 1; n++) {
-		long f_n;
-
-		// Este primeiro ciclo serve para calcular o número de
-		// repetições necessário para se acumular o tempo mínimo de 0.1
-		// segundos.
-		clock_t start = clock();
-		int repetitions = 0;
-
-		do {
-			f_n = fibonacci(n);
-			repetitions++;
-		} while (clock() < start + minimum_accumulated_clocks);
-
-		// Uma vez que o tempo de execução do ciclo anterior foi
-		// afectado pelo próprio tempo de execução da função `clock()`,
-		// executamos de novo as repetições para obtermos as estimativas
-		// do tempo de execução da função de cálculo da sucessão de
-		// Fibonacci excluindo o tempo de execução da função `clock()`.
-		start = clock();
-
-		for (int r = 0; r != repetitions; r++)
-			f_n = fibonacci(n);
-
-		clock_t end = clock();
+		struct fibonacci_context context = {
+			.fibonacci = fibonacci,
+			.n = n
+		};
+		struct benchmark_statistics statistics;
 
 		// Estimamos o tempo de execução da função de cálculo da
-		// sucessão de Fibonacci dividindo o tempo total de execução do
-		// ciclo pelo seu número de iterações (`repetitions`). O tempo
-		// de execução do ciclo em segundos é calculado dividindo o
-		// número total de _clocks_ ou tiques do relógio decorridos
-		// entre o início e o fim do ciclo pelo número de tiques por
-		// segundo.
-		double time =
-			(double) (end - start) / CLOCKS_PER_SEC / repetitions;
+		// sucessão de Fibonacci. A biblioteca `benchmark` encarrega-se
+		// de determinar o número de execuções necessárias para
+		// acumular o tempo mínimo e de dividir o tempo total pelo
+		// número de execuções realizadas.
+		if (bench(calculate_term, NULL, NULL, &context, &settings,
+			  &statistics)) {
+			fprintf(stderr, "Error: could not estimate the time of "
+				"F(%d).\n", n);
+			return;
+		}
+
+		double time = statistics.median;
 
 		// Imprimimos o valor do termo da sucessão calculado bem como a
 		// estimativa do tempo necessário para efectuar esse cálculo. Se
@@ -1008,10 +1017,11 @@ void experiment_efficiency_of(char title[], long fibonacci(int),
 		// também a variação percentual desse tempo face ao necessário
 		// para o cálculo do termo anterior.
 		if (previous_time == 0.0)
-			printf("F(%d) = %ld in %g s\n", n, f_n, time);
+			printf("F(%d) = %ld in %g s\n", n, context.f_n, time);
 		else
-			printf("F(%d) = %ld in %.3g seconds, %+.1f%%\n", n, f_n,
-				time, time / previous_time * 100.0 - 100.0);
+			printf("F(%d) = %ld in %.3g seconds, %+.1f%%\n", n,
+				context.f_n, time,
+				time / previous_time * 100.0 - 100.0);
 
 		// Guardamos o tempo estimado como tempo anterior a usar na
 		// próxima iteração do ciclo.
@@ -1028,27 +1038,37 @@ int main(void)
 	// nosso programa não terminaria em tempo útil.
 	const int last_term_to_test_with_stupid_algorithm = 42;
 
+	// Definimos uma constante que guarda o tempo mínimo, em segundos, a
+	// acumular nas execuções repetidas usadas para estimar cada tempo de
+	// execução.
+	const double minimum_accumulated_time = 0.1;
+
 	// Realizamos experiências com cada uma das funções, para obter
 	// estimativas do seu tempo de execução.
 	experiment_efficiency_of(
 		"Stupidly recursive implementation of the fibonacci sequence:",
 		stupidly_recursive_fibonacci,
-		last_term_to_test_with_stupid_algorithm);
+		last_term_to_test_with_stupid_algorithm,
+		minimum_accumulated_time);
 	experiment_efficiency_of(
 		"Recursive implementation of the fibonacci sequence using array"
 		" for storage:",
-		recursive_fibonacci, MAXIMUM_TERM_FITTING_A_LONG);
+		recursive_fibonacci, MAXIMUM_TERM_FITTING_A_LONG,
+		minimum_accumulated_time);
 	experiment_efficiency_of(
 		"Recursive implementation of the fibonacci sequence using ADT"
 		" for storage:",
-		recursive_fibonacci_using_ADT, MAXIMUM_TERM_FITTING_A_LONG);
+		recursive_fibonacci_using_ADT, MAXIMUM_TERM_FITTING_A_LONG,
+		minimum_accumulated_time);
 	experiment_efficiency_of(
 		"Tail recursive implementation of the fibonacci sequence:",
-		iterative_fibonacci, MAXIMUM_TERM_FITTING_A_LONG);
+		iterative_fibonacci, MAXIMUM_TERM_FITTING_A_LONG,
+		minimum_accumulated_time);
 	experiment_efficiency_of(
 		"Two variable iterative implementation of the fibonacci"
 		" sequence:",
-		iterative_fibonacci, MAXIMUM_TERM_FITTING_A_LONG);
+		iterative_fibonacci, MAXIMUM_TERM_FITTING_A_LONG,
+		minimum_accumulated_time);
 
 	// Finalmente, usamos cada uma das funções para obter os termos da
 	// sucessão, podendo assim mais facilmente confirmar que os cálculos
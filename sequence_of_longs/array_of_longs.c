@@ -0,0 +1,436 @@
+// `array_of_longs.c` &ndash; Implementação dos núcleos de cálculo sobre _arrays_ de `long`
+// ======================================================================================
+
+// Implementação do módulo físico `array_of_longs`
+// -----------------------------------------------
+//
+// Este ficheiro de implementação contém a implementação do módulo físico
+// `array_of_longs`. A interface deste módulo encontra-se no ficheiro de
+// cabeçalho ou de interface [`array_of_longs.h`](array_of_longs.h.html).
+//
+// Cada núcleo tem uma versão escalar, portável, e, em x86-64, uma versão AVX2,
+// compilada através do atributo `target`, que permite compilar rotinas
+// individuais para AVX2 sem exigir esse conjunto de instruções ao restante
+// programa. A escolha entre as versões é feita durante a execução (ver
+// `has_avx2()`). As versões escalares usam aritmética sem sinal nas somas, pois
+// os transbordamentos de inteiros com sinal têm comportamento indefinido em C.
+
+// ### Inclusão do cabeçalho correspondente a esta implementação
+//
+#include "array_of_longs.h"
+
+// ### Inclusão de ficheiros de cabeçalho necessários no código de implementação
+//
+// - `assert.h` &ndash; Necessário para se poder usar a macro `assert()`.
+//
+// - `pthread.h` &ndash; Necessário para se poder usar _threads_ POSIX na soma
+//   paralela e `pthread_once()` na detecção do AVX2.
+//
+// - `unistd.h` &ndash; Necessário para se poder usar a rotina `sysconf()`, que
+//   nos dá o número de processadores disponíveis.
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define ISLA_EDA_ARRAY_OF_LONGS_AVX2 1
+#include <immintrin.h>
+#endif
+
+// ### Definição de constantes
+//
+// O número mínimo de itens por _thread_ na soma paralela. Abaixo disto, o custo
+// de criar as _threads_ excede o ganho obtido (a soma de 2<sup>18</sup> itens
+// demora da ordem de 0,1 ms).
+static const long minimum_items_per_thread = 1L << 18;
+
+// O número máximo de _threads_ usadas na soma paralela.
+#define maximum_threads 256
+
+// ### Versões escalares
+
+static long sum_scalar(const long length, const long items[length])
+{
+	unsigned long sum = 0UL;
+	for (long i = 0L; i != length; i++)
+		sum += (unsigned long)items[i];
+	return (long)sum;
+}
+
+static long minimum_scalar(const long length, const long items[length])
+{
+	long minimum = items[0];
+	for (long i = 1L; i < length; i++)
+		minimum = items[i] < minimum ? items[i] : minimum;
+	return minimum;
+}
+
+static long maximum_scalar(const long length, const long items[length])
+{
+	long maximum = items[0];
+	for (long i = 1L; i < length; i++)
+		maximum = items[i] > maximum ? items[i] : maximum;
+	return maximum;
+}
+
+static long count_in_range_scalar(const long length, const long items[length],
+				  const long minimum, const long maximum)
+{
+	long count = 0L;
+	for (long i = 0L; i != length; i++)
+		count += minimum <= items[i] && items[i] <= maximum;
+	return count;
+}
+
+static void prefix_sums_scalar(const long length, const long items[length],
+			       long sums[length], const long carry)
+{
+	unsigned long sum = (unsigned long)carry;
+	for (long i = 0L; i != length; i++) {
+		sum += (unsigned long)items[i];
+		sums[i] = (long)sum;
+	}
+}
+
+// ### Versões AVX2
+//
+// Cada registo AVX2 guarda 4 `long`. As reduções usam dois acumuladores,
+// processando 8 itens por iteração, de modo a sobrepor a latência das
+// instruções consecutivas. Os itens que sobram no final são tratados pelas
+// versões escalares.
+#if defined(ISLA_EDA_ARRAY_OF_LONGS_AVX2)
+
+// O resultado da detecção do suporte das instruções AVX2, feita uma única vez
+// através de `pthread_once()`, uma vez que `has_avx2()` pode ser invocado em
+// simultâneo pelas várias _threads_ da soma paralela.
+static pthread_once_t avx2_detection = PTHREAD_ONCE_INIT;
+static bool avx2_supported = false;
+
+// Detecta se o processador em que o programa está a ser executado suporta as
+// instruções AVX2, guardando o resultado em `avx2_supported`.
+static void detect_avx2(void)
+{
+	__builtin_cpu_init();
+	avx2_supported = __builtin_cpu_supports("avx2");
+}
+
+// Predicado que devolve `true` se o processador em que o programa está a
+// ser executado suportar as instruções AVX2.
+static bool has_avx2(void)
+{
+	pthread_once(&avx2_detection, detect_avx2);
+
+	return avx2_supported;
+}
+
+// Devolve os 4 itens a partir de `items`, que não precisam de estar alinhados.
+__attribute__((target("avx2")))
+static inline __m256i load(const long items[4])
+{
+	return _mm256_loadu_si256((const __m256i *)items);
+}
+
+// Devolve a soma das 4 vias de `x`.
+__attribute__((target("avx2")))
+static long horizontal_sum(const __m256i x)
+{
+	long lanes[4];
+	_mm256_storeu_si256((__m256i *)lanes, x);
+	return (long)((unsigned long)lanes[0] + (unsigned long)lanes[1] +
+		      (unsigned long)lanes[2] + (unsigned long)lanes[3]);
+}
+
+__attribute__((target("avx2")))
+static long sum_avx2(const long length, const long items[length])
+{
+	__m256i low = _mm256_setzero_si256();
+	__m256i high = _mm256_setzero_si256();
+	long i = 0L;
+	for (; i + 8L <= length; i += 8L) {
+		low = _mm256_add_epi64(low, load(items + i));
+		high = _mm256_add_epi64(high, load(items + i + 4));
+	}
+
+	const long sum = horizontal_sum(_mm256_add_epi64(low, high));
+
+	return (long)((unsigned long)sum +
+		      (unsigned long)sum_scalar(length - i, items + i));
+}
+
+// O AVX2 não tem mínimo nem máximo de inteiros de 64 _bits_, pelo que são
+// obtidos através de uma comparação seguida de uma selecção (_blend_).
+__attribute__((target("avx2")))
+static long minimum_avx2(const long length, const long items[length])
+{
+	if (length < 8L)
+		return minimum_scalar(length, items);
+
+	__m256i low = load(items);
+	__m256i high = load(items + 4);
+	long i = 8L;
+	for (; i + 8L <= length; i += 8L) {
+		const __m256i x = load(items + i);
+		const __m256i y = load(items + i + 4);
+		low = _mm256_blendv_epi8(low, x, _mm256_cmpgt_epi64(low, x));
+		high = _mm256_blendv_epi8(high, y,
+					  _mm256_cmpgt_epi64(high, y));
+	}
+	low = _mm256_blendv_epi8(low, high, _mm256_cmpgt_epi64(low, high));
+
+	long lanes[4];
+	_mm256_storeu_si256((__m256i *)lanes, low);
+	long minimum = minimum_scalar(4L, lanes);
+	if (i != length) {
+		const long rest = minimum_scalar(length - i, items + i);
+		minimum = rest < minimum ? rest : minimum;
+	}
+
+	return minimum;
+}
+
+__attribute__((target("avx2")))
+static long maximum_avx2(const long length, const long items[length])
+{
+	if (length < 8L)
+		return maximum_scalar(length, items);
+
+	__m256i low = load(items);
+	__m256i high = load(items + 4);
+	long i = 8L;
+	for (; i + 8L <= length; i += 8L) {
+		const __m256i x = load(items + i);
+		const __m256i y = load(items + i + 4);
+		low = _mm256_blendv_epi8(low, x, _mm256_cmpgt_epi64(x, low));
+		high = _mm256_blendv_epi8(high, y,
+					  _mm256_cmpgt_epi64(y, high));
+	}
+	low = _mm256_blendv_epi8(low, high, _mm256_cmpgt_epi64(high, low));
+
+	long lanes[4];
+	_mm256_storeu_si256((__m256i *)lanes, low);
+	long maximum = maximum_scalar(4L, lanes);
+	if (i != length) {
+		const long rest = maximum_scalar(length - i, items + i);
+		maximum = rest > maximum ? rest : maximum;
+	}
+
+	return maximum;
+}
+
+// Um item está fora do intervalo se for menor do que o mínimo ou maior do que o
+// máximo. As comparações dão -1 (todos os _bits_ a 1) nas vias em que são
+// verdadeiras e 0 nas restantes, pelo que, subtraindo aos contadores de cada
+// via as máscaras dos itens dentro do intervalo, se contam esses itens.
+__attribute__((target("avx2")))
+static long count_in_range_avx2(const long length, const long items[length],
+				const long minimum, const long maximum)
+{
+	const __m256i minimums = _mm256_set1_epi64x(minimum);
+	const __m256i maximums = _mm256_set1_epi64x(maximum);
+	const __m256i ones = _mm256_set1_epi64x(-1L);
+	__m256i counts = _mm256_setzero_si256();
+	long i = 0L;
+	for (; i + 4L <= length; i += 4L) {
+		const __m256i x = load(items + i);
+		const __m256i outside =
+			_mm256_or_si256(_mm256_cmpgt_epi64(minimums, x),
+					_mm256_cmpgt_epi64(x, maximums));
+		counts = _mm256_sub_epi64(counts,
+					  _mm256_xor_si256(outside, ones));
+	}
+
+	return horizontal_sum(counts) +
+		count_in_range_scalar(length - i, items + i, minimum, maximum);
+}
+
+// Em cada grupo de 4 itens, as somas prefixas calculam-se em dois passos:
+// soma-se a cada via a via anterior e, depois, a via duas posições antes.
+// Finalmente, soma-se a todas as vias a soma acumulada dos grupos anteriores
+// (_carry_), que passa a ser a última via do resultado.
+__attribute__((target("avx2")))
+static void prefix_sums_avx2(const long length, const long items[length],
+			     long sums[length])
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i carry = zero;
+	long i = 0L;
+	for (; i + 4L <= length; i += 4L) {
+		__m256i x = load(items + i);
+		const __m256i shifted_by_one =
+			_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0));
+		x = _mm256_add_epi64(x, _mm256_blend_epi32(shifted_by_one, zero,
+							   0x03));
+		const __m256i shifted_by_two =
+			_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0));
+		x = _mm256_add_epi64(x, _mm256_blend_epi32(shifted_by_two, zero,
+							   0x0F));
+		x = _mm256_add_epi64(x, carry);
+		_mm256_storeu_si256((__m256i *)(sums + i), x);
+		carry = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+	}
+
+	prefix_sums_scalar(length - i, items + i, sums + i,
+			   i == 0L ? 0L : sums[i - 1]);
+}
+
+#endif // ISLA_EDA_ARRAY_OF_LONGS_AVX2
+
+// ### Implementação das reduções
+
+long long_array_sum(const long length, const long items[length])
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+
+#if defined(ISLA_EDA_ARRAY_OF_LONGS_AVX2)
+	if (has_avx2())
+		return sum_avx2(length, items);
+#endif
+
+	return sum_scalar(length, items);
+}
+
+// Cada tarefa da soma paralela soma um troço contíguo do _array_.
+struct sum_task {
+	const long *items;
+	long length;
+	long sum;
+};
+
+static void *sum_part(void *const generic_task)
+{
+	struct sum_task *const task = generic_task;
+
+	task->sum = long_array_sum(task->length, task->items);
+
+	return NULL;
+}
+
+long long_array_parallel_sum(const long length, const long items[length],
+			     const int threads)
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+	assert(threads >= 0);
+
+	long number_of_tasks = threads != 0 ? threads :
+		sysconf(_SC_NPROCESSORS_ONLN);
+	if (number_of_tasks > length / minimum_items_per_thread)
+		number_of_tasks = length / minimum_items_per_thread;
+	if (number_of_tasks > maximum_threads)
+		number_of_tasks = maximum_threads;
+	if (number_of_tasks <= 1L)
+		return long_array_sum(length, items);
+
+	struct sum_task tasks[number_of_tasks];
+	pthread_t thread_ids[number_of_tasks];
+	bool started[number_of_tasks];
+
+	for (long t = 0L; t != number_of_tasks; t++) {
+		const long first = length / number_of_tasks * t;
+		const long end = t == number_of_tasks - 1L ?
+			length : length / number_of_tasks * (t + 1L);
+		tasks[t].items = items + first;
+		tasks[t].length = end - first;
+		// A primeira tarefa é executada pela própria _thread_ que
+		// invocou a rotina.
+		started[t] = t != 0L && pthread_create(&thread_ids[t], NULL,
+						       sum_part,
+						       &tasks[t]) == 0;
+	}
+
+	for (long t = 0L; t != number_of_tasks; t++)
+		if (!started[t])
+			sum_part(&tasks[t]);
+
+	unsigned long sum = 0UL;
+	for (long t = 0L; t != number_of_tasks; t++) {
+		if (started[t])
+			pthread_join(thread_ids[t], NULL);
+		sum += (unsigned long)tasks[t].sum;
+	}
+
+	return (long)sum;
+}
+
+long long_array_minimum(const long length, const long items[length])
+{
+	assert(length > 0L);
+	assert(items != NULL);
+
+#if defined(ISLA_EDA_ARRAY_OF_LONGS_AVX2)
+	if (has_avx2())
+		return minimum_avx2(length, items);
+#endif
+
+	return minimum_scalar(length, items);
+}
+
+long long_array_maximum(const long length, const long items[length])
+{
+	assert(length > 0L);
+	assert(items != NULL);
+
+#if defined(ISLA_EDA_ARRAY_OF_LONGS_AVX2)
+	if (has_avx2())
+		return maximum_avx2(length, items);
+#endif
+
+	return maximum_scalar(length, items);
+}
+
+// ### Implementação das contagens
+//
+// A contagem genérica invoca o predicado indirectamente, através de um
+// ponteiro, para cada item, pelo que o compilador não a consegue vectorizar
+// nem expandir o predicado em linha. É, por isso, o caminho lento, a usar
+// apenas quando nenhuma das contagens especializadas serve. A contagem dos
+// itens num intervalo, a mais comum, tem uma versão vectorial própria,
+// `long_array_count_in_range()`.
+
+long long_array_count_if(const long length, const long items[length],
+			 bool predicate(long item, void *context),
+			 void *const context)
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+	assert(predicate != NULL);
+
+	long count = 0L;
+	for (long i = 0L; i != length; i++)
+		count += predicate(items[i], context);
+
+	return count;
+}
+
+long long_array_count_in_range(const long length, const long items[length],
+			       const long minimum, const long maximum)
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+
+#if defined(ISLA_EDA_ARRAY_OF_LONGS_AVX2)
+	if (has_avx2())
+		return count_in_range_avx2(length, items, minimum, maximum);
+#endif
+
+	return count_in_range_scalar(length, items, minimum, maximum);
+}
+
+// ### Implementação das somas prefixas
+
+void long_array_prefix_sums(const long length, const long items[length],
+			    long sums[length])
+{
+	assert(length >= 0L);
+	assert(length == 0L || (items != NULL && sums != NULL));
+
+#if defined(ISLA_EDA_ARRAY_OF_LONGS_AVX2)
+	if (has_avx2()) {
+		prefix_sums_avx2(length, items, sums);
+		return;
+	}
+#endif
+
+	prefix_sums_scalar(length, items, sums, 0L);
+}
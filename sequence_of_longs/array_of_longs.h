@@ -0,0 +1,150 @@
+// `array_of_longs.h` &ndash; Interface dos núcleos de cálculo sobre _arrays_ de `long`
+// ==================================================================================
+
+// Interface do módulo físico `array_of_longs`
+// -------------------------------------------
+//
+// Este ficheiro de cabeçalho destina-se a ser utilizado pelo código cliente do
+// módulo físico `array_of_longs`. A implementação deste módulo encontra-se no
+// ficheiro de implementação [`array_of_longs.c`](array_of_longs.c.html). O
+// módulo fornece os núcleos de cálculo (_kernels_) habituais sobre _arrays_ de
+// `long`: soma, mínimo, máximo, contagens e somas prefixas. Podem ser usados
+// sobre os termos de uma sucessão de `long`, obtidos sem cópias através de
+// `SEQL_terms()` (ver [`sequence_of_longs.h`](sequence_of_longs.h.html)), ou
+// sobre quaisquer outros _arrays_ de `long`.
+//
+// Os núcleos usam instruções AVX2 quando o processador as suporta, escolhendo a
+// versão a usar durante a execução. As somas são modulares, i.e., os
+// transbordamentos dão a volta, tal como acontece com os tipos sem sinal do C.
+
+// ### Comentário de documentação do ficheiro de cabeçalho
+//
+/**
+ * \file array_of_longs.h
+ * \brief Header file for the `array_of_longs` module, containing computational
+ * kernels over arrays of `long`s.
+ *
+ * This header file declares the routines that compute sums, minima, maxima,
+ * counts and prefix sums of arrays of `long`s.
+ */
+
+// ### Protecção contra inclusões múltiplas
+//
+#ifndef ISLA_EDA_ARRAY_OF_LONGS_H_INCLUDED
+#define ISLA_EDA_ARRAY_OF_LONGS_H_INCLUDED
+
+// Incluímos o ficheiro de interface `stdbool.h` para podermos usar o tipo
+// `bool` e os seus dois valores `true` e `false`.
+#include <stdbool.h>
+
+// ### Reduções
+
+/** \brief Returns the sum of the items of the given array.
+ *
+ * \param length The number of items in the array.
+ * \param items The array whose items will be summed.
+ * \return The sum of the items, modulo 2<sup>64</sup>.
+ * \pre `length` ≥ 0
+ * \pre `items` ≠ null or `length` = 0
+ */
+long long_array_sum(long length, const long items[length]);
+
+/** \brief Returns the sum of the items of the given array, computed by several
+ * threads in parallel.
+ *
+ * \param length The number of items in the array.
+ * \param items The array whose items will be summed.
+ * \param threads The number of threads to use, or 0 to use one per online
+ * processor.
+ * \return The sum of the items, modulo 2<sup>64</sup>.
+ * \pre `length` ≥ 0
+ * \pre `items` ≠ null or `length` = 0
+ * \pre `threads` ≥ 0
+ *
+ * Each thread sums a contiguous part of the array. Small arrays are summed by
+ * the calling thread alone, since starting threads would cost more than the
+ * sum itself. If a thread cannot be started, its part is summed by the calling
+ * thread.
+ */
+long long_array_parallel_sum(long length, const long items[length],
+			     int threads);
+
+/** \brief Returns the smallest item of the given array.
+ *
+ * \param length The number of items in the array.
+ * \param items The array whose smallest item will be returned.
+ * \return The smallest item.
+ * \pre `length` > 0
+ * \pre `items` ≠ null
+ */
+long long_array_minimum(long length, const long items[length]);
+
+/** \brief Returns the largest item of the given array.
+ *
+ * \param length The number of items in the array.
+ * \param items The array whose largest item will be returned.
+ * \return The largest item.
+ * \pre `length` > 0
+ * \pre `items` ≠ null
+ */
+long long_array_maximum(long length, const long items[length]);
+
+// ### Contagens
+
+/** \brief Returns the number of items of the given array that satisfy the
+ * given predicate.
+ *
+ * \param length The number of items in the array.
+ * \param items The array whose items will be counted.
+ * \param predicate The predicate, which receives each item and `context`.
+ * \param context A pointer passed unchanged to the predicate.
+ * \return The number of items for which the predicate returns `true`.
+ * \pre `length` ≥ 0
+ * \pre `items` ≠ null or `length` = 0
+ * \pre `predicate` ≠ null
+ *
+ * This is the slow, generic path: the predicate is called through a pointer
+ * once per item, so the loop is never vectorised nor parallelised. Use it only
+ * for conditions that no specialised kernel covers. To count the items in a
+ * range of values, use `long_array_count_in_range()`, which is vectorised and
+ * several times faster.
+ */
+long long_array_count_if(long length, const long items[length],
+			 bool predicate(long item, void *context),
+			 void *context);
+
+/** \brief Returns the number of items of the given array that lie in the
+ * given closed range.
+ *
+ * \param length The number of items in the array.
+ * \param items The array whose items will be counted.
+ * \param minimum The lower limit of the range.
+ * \param maximum The upper limit of the range.
+ * \return The number of items `item` such that `minimum` ≤ `item` ≤
+ * `maximum`.
+ * \pre `length` ≥ 0
+ * \pre `items` ≠ null or `length` = 0
+ */
+long long_array_count_in_range(long length, const long items[length],
+			       long minimum, long maximum);
+
+// ### Somas prefixas
+
+/** \brief Computes the inclusive prefix sums of the given array.
+ *
+ * \param length The number of items in the array.
+ * \param items The array whose prefix sums will be computed.
+ * \param sums The array where the prefix sums will be stored, which may be
+ * `items` itself.
+ * \pre `length` ≥ 0
+ * \pre `items` ≠ null and `sums` ≠ null, or `length` = 0
+ * \post `sums[i]` = `items[0]` + ... + `items[i]` (modulo 2<sup>64</sup>), for
+ * 0 ≤ `i` < `length`.
+ */
+void long_array_prefix_sums(long length, const long items[length],
+			    long sums[length]);
+
+// ### Fim do ficheiro
+//
+// Final da instrução condicional do pré-processador.
+#endif // ISLA_EDA_ARRAY_OF_LONGS_H_INCLUDED
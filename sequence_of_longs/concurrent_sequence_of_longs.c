@@ -0,0 +1,330 @@
+// `concurrent_sequence_of_longs.c` &ndash; Implementação das sucessões concorrentes de `long`
+// =========================================================================================
+
+// Implementação do módulo físico `concurrent_sequence_of_longs`
+// -------------------------------------------------------------
+//
+// Para uma explicação mais pormenorizada das várias partes deste ficheiro, e da
+// implementação das várias rotinas, consultar a explicação dos correspondentes
+// ficheiros [`sequence_of_longs.c`](sequence_of_longs.c.html) e
+// [`segmented_sequence_of_longs.c`](segmented_sequence_of_longs.c.html). Neste
+// ficheiro explica-se apenas aquilo que é específico desta implementação
+// concorrente do TAD sucessão de `long`.
+//
+// Este ficheiro de implementação contém a implementação do módulo físico
+// `concurrent_sequence_of_longs`. A interface deste módulo encontra-se no
+// ficheiro de cabeçalho ou de interface
+// [`concurrent_sequence_of_longs.h`](concurrent_sequence_of_longs.h.html).
+
+// ### Inclusão do cabeçalho correspondente a esta implementação
+//
+#include "concurrent_sequence_of_longs.h"
+
+// ### Inclusão de ficheiros de cabeçalho necessários no código de implementação
+//
+// - `stdatomic.h` &ndash; Necessário para se poder usar os tipos e as operações
+//   atómicas do C11.
+//
+// - `limits.h` &ndash; Necessário para se poder usar as macros `INT_MAX` e
+//   `CHAR_BIT`.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <limits.h>
+
+#include "buffered_output.h"
+
+// ### Definição de constantes
+//
+// Os segmentos seguem o mesmo esquema que no TAD
+// `segmented_sequence_of_longs`, mas com um primeiro segmento maior, pois as
+// sucessões concorrentes destinam-se a receber muitos termos. Bastam 22
+// segmentos para guardar `INT_MAX` termos.
+#define first_chunk_length_log2 10
+#define first_chunk_length (1 << first_chunk_length_log2)
+#define maximum_number_of_chunks (32 - first_chunk_length_log2)
+
+// ### Definição da estrutura `struct concurrent_sequence_of_long`
+//
+// Esta estrutura contém os seguintes campos ou atributos, todos atómicos:
+//
+// - `chunks` &ndash; O directório dos segmentos. Cada ponteiro é nulo até o
+//   segmento correspondente ser reservado, ou `failed_chunk` se a sua reserva
+//   tiver falhado. Cada segmento contém os seus termos seguidos de um
+//   indicador por termo, que passa a 1 quando o termo correspondente já foi
+//   escrito.
+//
+// - `reserved` &ndash; O número de posições já reservadas por adições, cujos
+//   termos podem ainda não ter sido escritos.
+//
+// - `published` &ndash; O número de termos publicados, i.e., o comprimento da
+//   sucessão visto pelos leitores. Todos os termos publicados foram escritos.
+//
+// - `first_failure` &ndash; A menor posição cuja adição falhou por falta de
+//   memória, ou `LONG_MAX` se nenhuma adição falhou.
+//
+// Os contadores são `long`, e não `int`, para que as reservas para lá de
+// `INT_MAX` possam ser detectadas sem transbordamentos.
+struct concurrent_sequence_of_longs {
+	_Atomic(long *) chunks[maximum_number_of_chunks];
+	atomic_long reserved;
+	atomic_long published;
+	atomic_long first_failure;
+};
+
+// Marca registada no directório no lugar de um segmento cuja reserva falhou.
+// Desta forma, todas as adições com posições nesse segmento falham, e não
+// apenas a que tentou reservá-lo primeiro.
+static long failed_chunk_marker;
+#define failed_chunk (&failed_chunk_marker)
+
+// ### Rotinas auxiliares
+
+// Esta função devolve ⌊log<sub>2</sub>(_n_)⌋, para _n_ > 0.
+static inline int floor_log2(const unsigned n)
+{
+#if defined(__GNUC__)
+	return (int)(sizeof(unsigned) * CHAR_BIT) - 1 - __builtin_clz(n);
+#else
+	int log2 = 0;
+	for (unsigned m = n; m > 1U; m >>= 1)
+		log2++;
+	return log2;
+#endif
+}
+
+// Esta função devolve o comprimento do segmento `k`.
+static inline size_t chunk_length(const int k)
+{
+	return (size_t)first_chunk_length << k;
+}
+
+// Esta função devolve os indicadores de escrita dos termos do segmento `k`,
+// que se encontram no próprio segmento, depois dos seus termos.
+static inline atomic_char *written_flags(long *const chunk, const int k)
+{
+	return (atomic_char *)(chunk + chunk_length(k));
+}
+
+// Esta função devolve o segmento `k`, reservando-o se ainda não existir, ou
+// `NULL` em caso de erro. Várias _threads_ podem tentar reservar o mesmo
+// segmento em simultâneo. Cada uma reserva o seu e tenta registá-lo no
+// directório através de uma comparação e troca (_compare and swap_). Apenas uma
+// o consegue. As restantes libertam o segmento que reservaram e usam o
+// registado. Os segmentos são reservados pela `calloc()`, para que os
+// indicadores de escrita comecem a zero. Os segmentos grandes são obtidos
+// directamente do sistema operativo, já a zero e sem que a sua memória seja
+// tocada, pelo que estas reservas perdidas são baratas. Se a reserva falhar, a
+// _thread_ tenta registar `failed_chunk` no directório, para que as restantes
+// não voltem a tentar reservar o segmento e falhem também.
+static long *chunk_for(struct concurrent_sequence_of_longs *sl, const int k)
+{
+	long *chunk = atomic_load_explicit(&sl->chunks[k],
+					   memory_order_acquire);
+
+	if (chunk != NULL)
+		return chunk == failed_chunk ? NULL : chunk;
+
+	long *const new_chunk = calloc(chunk_length(k),
+				       sizeof(long) + sizeof(atomic_char));
+
+	if (atomic_compare_exchange_strong_explicit(&sl->chunks[k], &chunk,
+						    new_chunk == NULL ?
+						    failed_chunk : new_chunk,
+						    memory_order_acq_rel,
+						    memory_order_acquire))
+		return new_chunk;
+
+	free(new_chunk);
+
+	return chunk == failed_chunk ? NULL : chunk;
+}
+
+// Este procedimento regista `index` como posição cuja adição falhou, caso seja
+// menor do que todas as posições registadas anteriormente.
+static void record_failure(struct concurrent_sequence_of_longs *sl,
+			   const long index)
+{
+	long first_failure = atomic_load(&sl->first_failure);
+
+	while (index < first_failure &&
+	       !atomic_compare_exchange_weak(&sl->first_failure,
+					     &first_failure, index))
+		;
+}
+
+// Este procedimento publica todos os termos já escritos a seguir aos termos
+// já publicados, i.e., avança o comprimento publicado enquanto o termo na
+// posição seguinte já tiver sido escrito. Várias _threads_ podem fazê-lo em
+// simultâneo: cada avanço é feito através de uma comparação e troca, pelo que
+// apenas uma delas publica cada termo.
+//
+// Uma adição escreve o seu indicador antes de invocar este procedimento, e
+// este lê o comprimento publicado antes de ler os indicadores. Com a ordem de
+// memória sequencialmente consistente, usada por omissão, não pode acontecer
+// que duas adições a posições consecutivas deixem ambas de ver o indicador da
+// outra. Assim, um termo escrito acaba sempre por ser publicado, logo que os
+// termos anteriores o sejam, sem que nenhuma adição tenha de esperar por
+// outra.
+static void publish_written_terms(struct concurrent_sequence_of_longs *sl)
+{
+	long published = atomic_load(&sl->published);
+
+	while (published < INT_MAX) {
+		const unsigned shifted_index =
+			(unsigned)published + first_chunk_length;
+		const int k = floor_log2(shifted_index) -
+			first_chunk_length_log2;
+		long *const chunk = atomic_load(&sl->chunks[k]);
+
+		if (chunk == NULL || chunk == failed_chunk ||
+		    !atomic_load(&written_flags(chunk, k)[shifted_index -
+						 chunk_length(k)]))
+			return;
+
+		if (atomic_compare_exchange_weak(&sl->published, &published,
+						 published + 1L))
+			published++;
+	}
+}
+
+// ### Implementação dos procedimentos que imprimem as sucessões
+//
+void CSEQL_print(struct concurrent_sequence_of_longs *sl)
+{
+	const int length = CSEQL_length(sl);
+
+	struct buffered_output output;
+
+	buffered_output_start(&output, stdout);
+	buffered_output_char(&output, '{');
+	for (int i = 0; i != length; i++) {
+		if (i != 0)
+			buffered_output_string(&output, ", ");
+		buffered_output_long(&output, CSEQL_term(sl, i));
+	}
+	buffered_output_char(&output, '}');
+	buffered_output_finish(&output);
+}
+
+void CSEQL_println(struct concurrent_sequence_of_longs *sl)
+{
+	CSEQL_print(sl);
+	putchar('\n');
+}
+
+// ### Implementação do construtor do TAD
+//
+struct concurrent_sequence_of_longs *CSEQL_new(void)
+{
+	struct concurrent_sequence_of_longs *sl =
+		malloc(sizeof(struct concurrent_sequence_of_longs));
+
+	if (sl == NULL)
+		return NULL;
+
+	for (int k = 0; k != maximum_number_of_chunks; k++)
+		atomic_init(&sl->chunks[k], NULL);
+	atomic_init(&sl->reserved, 0L);
+	atomic_init(&sl->published, 0L);
+	atomic_init(&sl->first_failure, LONG_MAX);
+
+	return sl;
+}
+
+// ### Implementação do destrutor do TAD
+//
+void CSEQL_free(struct concurrent_sequence_of_longs *sl)
+{
+	if (sl == NULL)
+		return;
+
+	for (int k = 0; k != maximum_number_of_chunks; k++) {
+		long *const chunk = atomic_load_explicit(&sl->chunks[k],
+							 memory_order_relaxed);
+		if (chunk != failed_chunk)
+			free(chunk);
+	}
+
+	free(sl);
+}
+
+// ### Implementação do _inspector_ do comprimento
+//
+// A leitura com semântica de aquisição (_acquire_) emparelha com a comparação
+// e troca que publicou o último termo, a qual, por sua vez, foi precedida pela
+// leitura dos indicadores de escrita dos termos publicados. Assim, todas as
+// escritas feitas antes da publicação, incluindo as dos termos e as dos
+// ponteiros para os segmentos, são visíveis para quem lê o comprimento.
+int CSEQL_length(struct concurrent_sequence_of_longs *sl)
+{
+	return (int)atomic_load_explicit(&sl->published, memory_order_acquire);
+}
+
+// ### Implementação do _modificador_ de adição de um novo termo à sucessão
+//
+// A adição decorre em três passos:
+//
+// 1. Reserva da posição `index` do novo termo, através de um incremento
+//    atómico. A ordem de memória pode ser relaxada, pois o contador não
+//    protege quaisquer outros dados.
+//
+// 2. Escrita do termo no seu segmento, reservando-o se necessário, seguida da
+//    escrita do seu indicador. Nenhuma outra _thread_ escreve nesta posição.
+//
+// 3. Publicação dos termos escritos, incluindo o novo termo, se todos os
+//    anteriores já tiverem sido escritos. Caso contrário, o novo termo será
+//    publicado pela adição que escrever o último dos termos anteriores em
+//    falta.
+//
+// Se a reserva de um segmento falhar, os termos nas posições desse segmento
+// nunca serão escritos, pelo que nenhum dos termos seguintes será publicado: o
+// comprimento publicado fica parado na primeira posição cuja adição falhou.
+// Todas as adições com posições no segmento em falta falham (ver
+// `chunk_for()`). Uma adição a uma posição posterior que, depois de escrever o
+// seu termo, veja já registada a falha de uma posição anterior falha também,
+// pois o seu termo nunca será publicado. As adições que comecem depois de uma
+// falha falham logo à partida.
+bool CSEQL_add(struct concurrent_sequence_of_longs *sl, long new_term)
+{
+	if (atomic_load_explicit(&sl->first_failure, memory_order_relaxed) !=
+	    LONG_MAX)
+		return true;
+
+	const long index = atomic_fetch_add_explicit(&sl->reserved, 1L,
+						     memory_order_relaxed);
+
+	if (index >= INT_MAX)
+		return true;
+
+	const unsigned shifted_index = (unsigned)index + first_chunk_length;
+	const int k = floor_log2(shifted_index) - first_chunk_length_log2;
+	long *const chunk = chunk_for(sl, k);
+
+	if (chunk == NULL) {
+		record_failure(sl, index);
+		return true;
+	}
+
+	chunk[shifted_index - chunk_length(k)] = new_term;
+	atomic_store(&written_flags(chunk, k)[shifted_index - chunk_length(k)],
+		     1);
+
+	publish_written_terms(sl);
+
+	return index > atomic_load(&sl->first_failure);
+}
+
+// ### Implementação do _inspector_ de termo
+//
+// O ponteiro para o segmento foi registado antes da publicação do termo, pelo
+// que uma leitura relaxada basta (ver `CSEQL_length()`).
+long CSEQL_term(struct concurrent_sequence_of_longs *sl, int index)
+{
+	const unsigned shifted_index = (unsigned)index + first_chunk_length;
+	const int k = floor_log2(shifted_index) - first_chunk_length_log2;
+	const long *const chunk = atomic_load_explicit(&sl->chunks[k],
+						       memory_order_relaxed);
+
+	return chunk[shifted_index - chunk_length(k)];
+}
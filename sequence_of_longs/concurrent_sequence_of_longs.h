@@ -0,0 +1,169 @@
+// `concurrent_sequence_of_longs.h` &ndash; Interface das sucessões concorrentes de `long`
+// ====================================================================================
+
+// Interface do módulo físico `concurrent_sequence_of_longs`
+// ---------------------------------------------------------
+//
+// Para uma explicação mais pormenorizada das várias partes deste ficheiro,
+// consultar a explicação do correspondente ficheiro
+// [`sequence_of_longs.h`](sequence_of_longs.h.html).
+//
+// Este ficheiro de cabeçalho destina-se a ser utilizado pelo código cliente do
+// módulo físico `concurrent_sequence_of_longs`. A implementação deste módulo
+// encontra-se no ficheiro de implementação
+// [`concurrent_sequence_of_longs.c`](concurrent_sequence_of_longs.c.html).
+// Este módulo físico contém o TAD (Tipo Abstracto de Dados) sucessão
+// concorrente de `long`, com o mesmo nome que o módulo físico, i.e.,
+// `concurrent_sequence_of_longs`.
+//
+// Trata-se de um TAD com a mesma funcionalidade que o TAD `sequence_of_longs`,
+// mas cujas operações podem ser invocadas em simultâneo por várias _threads_,
+// sem necessidade de qualquer sincronização por parte do código cliente (com
+// excepção do destrutor) e sem recurso a trincos (_locks_). Tal como no TAD
+// `segmented_sequence_of_longs`, os termos são guardados em segmentos de
+// comprimento crescente, que nunca são movidos, cujos endereços se guardam num
+// directório de comprimento fixo. Cada adição reserva a posição do novo termo
+// incrementando atomicamente um contador, pelo que nenhuma adição tem de
+// esperar por outra. O comprimento da sucessão visto pelos leitores é o
+// comprimento _publicado_: os termos são publicados pela ordem das suas
+// posições, logo que estejam escritos, pelo que os leitores vêem sempre um
+// prefixo consistente da sucessão, com todos os termos já escritos.
+
+// ### Comentário de documentação do ficheiro de cabeçalho
+//
+/**
+ * \file concurrent_sequence_of_longs.h
+ * \brief Header file for the `concurrent_sequence_of_longs` module, containing
+ * the ADT (Abstract Data Type) with the same name:
+ * `concurrent_sequence_of_longs`.
+ *
+ * This header file declares the basic structure used to store the concurrent
+ * sequences of longs and all the routines used to manipulate these sequences.
+ */
+
+// ### Protecção contra inclusões múltiplas
+//
+#ifndef ISLA_EDA_CONCURRENT_SEQUENCE_OF_LONGS_H_INCLUDED
+#define ISLA_EDA_CONCURRENT_SEQUENCE_OF_LONGS_H_INCLUDED
+
+// Incluímos o ficheiro de interface `stdbool.h` para podermos usar o tipo
+// `bool` e os seus dois valores `true` e `false`.
+#include <stdbool.h>
+
+// ### Comentário de documentação da `struct` `concurrent_sequence_of_longs`
+//
+/** \brief C structure used to represent the concurrent sequence of `long`s and
+ * to store its terms.
+ *
+ * This TAD allows several threads to add terms and to read the sequence
+ * simultaneously, without locks. The terms are stored in chunks whose lengths
+ * double from one chunk to the next, and are never moved.
+ */
+// ### Declaração da `struct` que representa as sucessões concorrentes de `long`
+//
+struct concurrent_sequence_of_longs;
+
+// ### Construtor do TAD
+//
+/** \brief Returns a pointer to a newly created and initialized
+ * `concurrent_sequence_of_longs`.
+ *
+ * \return A pointer to a newly (heap) allocated and initialized
+ * `struct concurrent_sequence_of_longs`, or `NULL` if memory could not be
+ * allocated.
+ * \post The returned pointer, if not null, refers to a new
+ * `struct concurrent_sequence_of_longs` representing an empty (i.e., length 0)
+ * sequence of `long`s.
+ *
+ * This function is a constructor of the concurrent sequence of `long`s ADT.
+ */
+struct concurrent_sequence_of_longs *CSEQL_new(void);
+
+// ### Destrutor do TAD
+//
+/** \brief Destroys the given sequence of `long`s, releasing all the memory it
+ * uses.
+ *
+ * \param sl A pointer to the sequence of `long`s to destroy, or `NULL`, in
+ * which case nothing is done.
+ * \pre No other thread is using the sequence.
+ * \post `sl` no longer refers to a valid sequence.
+ *
+ * This procedure is the destructor of the concurrent sequence of `long`s ADT.
+ */
+void CSEQL_free(struct concurrent_sequence_of_longs *sl);
+
+// ### Operações do TAD
+
+/** \brief Prints the published terms of the sequence of longs in the format
+ * `{term_1, ... term_n}`.
+ *
+ * \param sl A pointer to the sequence of `long`s to print.
+ * \pre `sl` ≠ null
+ */
+void CSEQL_print(struct concurrent_sequence_of_longs *sl);
+
+/** \brief Prints the published terms of the sequence of longs in the format
+ * `{term_1, ... term_n}` and ends the line with `\n`.
+ *
+ * \param sl A pointer to the sequence of `long`s to print.
+ * \pre `sl` ≠ null
+ */
+void CSEQL_println(struct concurrent_sequence_of_longs *sl);
+
+/** \brief Returns the number of terms published so far in a given sequence of
+ * `long`s.
+ *
+ * \param sl A pointer to the sequence of `long`s whose length will be returned.
+ * \return The number of published terms in the sequence.
+ * \pre `sl` ≠ null
+ *
+ * All the terms with indices smaller than the returned length have been
+ * completely written and can be read through `CSEQL_term()`. The length never
+ * decreases.
+ */
+int CSEQL_length(struct concurrent_sequence_of_longs *sl);
+
+/** \brief Adds a given value as a further term of the given sequence of
+ * `long`s.
+ *
+ * \param sl A pointer to the sequence of `long`s to which the new term will be
+ * added.
+ * \param new_term The new term to add to the sequence.
+ * \return `true` if memory could not be allocated for this or for a previous
+ * addition, `false` otherwise.
+ * \post If `false` is returned, the new term has been written and will be
+ * published (i.e., counted in the length) as soon as all the additions to
+ * previous positions complete. If no addition failed, when all the additions
+ * have completed, the length equals the number of successful additions. The
+ * relative order of terms added simultaneously by different threads is
+ * unspecified.
+ * \pre `sl` ≠ null
+ *
+ * The addition reserves a position with an atomic increment and writes the
+ * term without locks, never waiting for other additions. After an allocation
+ * failure, the published length stalls at the first position whose addition
+ * failed: the terms at later positions are never published, even if they were
+ * written. All the additions to positions in the chunk that could not be
+ * allocated fail, as do the additions that start after the failure or that
+ * see it after writing their term. An addition to a later position that
+ * completes before the failure is recorded may still return `false`, even
+ * though its term will never be published.
+ */
+bool CSEQL_add(struct concurrent_sequence_of_longs *sl, long new_term);
+
+/** \brief Returns the term of the given sequence at the given position or
+ * index.
+ *
+ * \param sl A pointer to the sequence of `long`s whose term will be returned.
+ * \param index The index or position of the term of the sequence to return.
+ * \return The term of the sequence given in the position or index given.
+ * \pre `sl` ≠ null
+ * \pre 0 ≤ `index` < `CSEQL_length(sl)`
+ */
+long CSEQL_term(struct concurrent_sequence_of_longs *sl, int index);
+
+// ### Fim do ficheiro
+//
+// Final da instrução condicional do pré-processador.
+#endif // ISLA_EDA_CONCURRENT_SEQUENCE_OF_LONGS_H_INCLUDED
@@ -1,18 +1,495 @@
 // `experiments.c` &ndash; Experiências com sucessões de `long`
 // ============================================================
+//
+// Este programa começa por demonstrar a utilização das sucessões de `long`
+// (ver [`sequence_of_longs.h`](sequence_of_longs.h.html) e
+// [`naive_sequence_of_longs.h`](naive_sequence_of_longs.h.html)). Depois, mede
+// o débito da adição de termos, um a um, a sucessões com 10<sup>6</sup>,
+// 10<sup>7</sup>, ... termos, até um máximo que pode ser passado como
+// argumento (por omissão, 10<sup>9</sup>). São comparadas três variantes: a
+// sucessão com os termos grandes em páginas mapeadas (estendidas sem cópias
+// através de `mremap()`), a mesma sucessão com os termos sempre no monte
+// (estendidos através de `realloc()`) e a sucessão ingénua, esta apenas até
+// 10<sup>6</sup> termos, pois o seu tempo de adição cresce com o comprimento.
+//
+// Antes disso, mede a latência de cada uma de 10<sup>7</sup> adições à
+// sucessão e à sucessão segmentada (ver
+// [`segmented_sequence_of_longs.h`](segmented_sequence_of_longs.h.html)),
+// apresentando a mediana, os percentis 99 e 99,9 e o máximo. Na sucessão, as
+// adições que obrigam a aumentar a capacidade demoram um tempo proporcional ao
+// comprimento; na sucessão segmentada, nenhuma adição move os termos.
+//
+// Mede ainda, para 10<sup>7</sup> termos crescentes com diferenças aleatórias
+// inferiores a 1000 (como instantes de tempo), a memória usada pela sucessão e
+// pela sucessão compactada (ver
+// [`packed_sequence_of_longs.h`](packed_sequence_of_longs.h.html)) e o tempo
+// de uma soma sequencial de todos os termos, acedidos um a um ou, na sucessão
+// compactada, copiados por lotes. Na sucessão, mede também o tempo das somas
+// sobre a vista dos seus termos (ver `SEQL_terms()`), usando os núcleos de
+// cálculo de [`array_of_longs.h`](array_of_longs.h.html), sequencial e
+// paralelo.
+//
+// Mede ainda, para uma tabela com os menores factores primos dos inteiros de 0
+// a 10<sup>7</sup> - 1, o tempo da sua construção, o da sua gravação num
+// ficheiro (ver `SEQL_save()`), o da sua recuperação a partir do ficheiro
+// mapeado em memória (ver `SEQL_open_mapped()`), sem e com a verificação da
+// soma de verificação, e o da primeira adição à sucessão recuperada, que
+// obriga a copiar os termos.
+//
+// Mede também o débito de 10<sup>7</sup> adições repartidas por 1, 2, 4, ...,
+// 32 _threads_, feitas à sucessão concorrente (ver
+// [`concurrent_sequence_of_longs.h`](concurrent_sequence_of_longs.h.html)),
+// sem trincos, e à sucessão protegida por um trinco (_mutex_).
+//
+// Compara ainda várias políticas de crescimento da sucessão, com factores de
+// crescimento de 1,25 a 4 e capacidades iniciais de `SEQL_SMALL_CAPACITY` (a
+// mínima), 1024 e 2<sup>20</sup> termos, medindo o débito de 10<sup>7</sup>
+// adições, o histograma das suas latências, a memória reservada por termo no
+// final e as estatísticas das alterações da capacidade (ver
+// `SEQL_set_statistics()`). A sucessão ingénua é medida nas mesmas condições,
+// mas apenas com 10<sup>5</sup> termos.
+//
+// Finalmente, mede o tempo médio da construção, do preenchimento com 4 termos
+// e da destruição de 10<sup>7</sup> sucessões curtas, construídas no monte
+// (ver `SEQL_new()`) ou na pilha (ver `SEQL_init()`).
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
 
 #include "sequence_of_longs.h"
 #include "naive_sequence_of_longs.h"
+#include "segmented_sequence_of_longs.h"
+#include "packed_sequence_of_longs.h"
+#include "array_of_longs.h"
+#include "concurrent_sequence_of_longs.h"
 
-int main(void)
+// Os comprimentos das sucessões usadas nas medições.
+static const long minimum_benchmark_length = 1000000L;
+static const long default_maximum_benchmark_length = 1000000000L;
+static const long maximum_naive_length = 1000000L;
+static const int latency_length = 10000000;
+static const int packing_length = 10000000;
+static const int concurrent_length = 10000000;
+static const int persistence_length = 10000000;
+static const int growth_length = 10000000;
+static const int naive_growth_length = 100000;
+static const int short_sequences_count = 10000000;
+static const int short_sequence_length = 4;
+
+// O nome do ficheiro temporário usado nas medições da gravação e da
+// recuperação das sucessões.
+static const char *const persistence_path = "experiments.seql";
+
+// O número máximo de _threads_ nas medições das adições concorrentes.
+#define maximum_number_of_adders 32
+
+// O número de termos copiados em cada lote nas somas sobre a sucessão
+// compactada.
+#define scan_batch_length 4096
+
+// Os factores de crescimento e as capacidades iniciais comparados nas
+// medições das políticas de crescimento.
+static const double growth_factors[] = {1.25, 1.5, 2.0, 3.0, 4.0};
+static const int initial_capacities[] = {SEQL_SMALL_CAPACITY, 1024, 1 << 20};
+
+// O histograma das latências das adições tem `histogram_size` classes. A
+// primeira contém as latências inferiores a `histogram_first_limit`
+// nanossegundos e os limites das restantes crescem geometricamente, com razão
+// `histogram_ratio`. A última classe contém todas as latências a partir do
+// seu limite inferior.
+#define histogram_size 7
+#define histogram_first_limit 32L
+#define histogram_ratio 4L
+
+// As variantes medidas.
+enum variant {
+	mapped_variant,
+	heap_variant,
+	naive_variant,
+	number_of_variants
+};
+
+static const char *const variant_names[number_of_variants] = {
+	"mapped",
+	"heap",
+	"naive"
+};
+
+// Devolve o tempo corrente, em segundos, de um relógio monotónico.
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// Devolve o tempo corrente, em nanossegundos, do mesmo relógio.
+static long now_in_nanoseconds(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec * 1000000000L + time.tv_nsec;
+}
+
+// Função de comparação de `long`, para usar com `qsort()`.
+static int compare_longs(const void *const first_generic,
+			 const void *const second_generic)
+{
+	const long first = *(const long *)first_generic;
+	const long second = *(const long *)second_generic;
+
+	return (first > second) - (first < second);
+}
+
+// Mede a latência, em nanossegundos, de cada uma das `length` adições à
+// sucessão (se `segmented` for `false`) ou à sucessão segmentada (caso
+// contrário), e imprime a mediana, os percentis 99 e 99,9 e o máximo das
+// latências. Devolve `true` em caso de erro.
+static bool report_latencies(const bool segmented, const int length)
+{
+	long *const latencies = malloc((size_t)length * sizeof(long));
+	struct sequence_of_longs *const sequence =
+		segmented ? NULL : SEQL_new();
+	struct segmented_sequence_of_longs *const segmented_sequence =
+		segmented ? SSEQL_new() : NULL;
+
+	bool error = latencies == NULL ||
+		(sequence == NULL && segmented_sequence == NULL);
+
+	for (int i = 0; !error && i != length; i++) {
+		const long start = now_in_nanoseconds();
+		error = segmented ? SSEQL_add(segmented_sequence, i) :
+			SEQL_add(sequence, i);
+		latencies[i] = now_in_nanoseconds() - start;
+	}
+
+	if (!error) {
+		qsort(latencies, length, sizeof(long), compare_longs);
+		printf("%d;%s;%ld;%ld;%ld;%ld\n", length,
+		       segmented ? "segmented" : "contiguous",
+		       latencies[length / 2], latencies[length / 100 * 99],
+		       latencies[length / 1000 * 999], latencies[length - 1]);
+	}
+
+	SSEQL_free(segmented_sequence);
+	SEQL_free(sequence);
+	free(latencies);
+
+	return error;
+}
+
+// Acrescenta a latência `latency`, em nanossegundos, ao histograma
+// `histogram`.
+static void record_latency(long histogram[histogram_size], const long latency)
+{
+	int bin = 0;
+
+	for (long limit = histogram_first_limit;
+	     bin != histogram_size - 1 && latency >= limit;
+	     limit *= histogram_ratio)
+		bin++;
+
+	histogram[bin]++;
+}
+
+// Imprime as classes do histograma `histogram`, separadas por `;`.
+static void print_histogram(const long histogram[histogram_size])
+{
+	for (int bin = 0; bin != histogram_size; bin++)
+		printf(";%ld", histogram[bin]);
+}
+
+// Imprime o cabeçalho das medições das políticas de crescimento, incluindo os
+// limites das classes do histograma.
+static void print_growth_header(void)
+{
+	printf("Length;Policy;Initial capacity;Throughput [terms/second]");
+
+	long limit = 0L;
+	for (int bin = 0; bin != histogram_size - 1; bin++) {
+		const long next_limit = bin == 0 ? histogram_first_limit :
+			limit * histogram_ratio;
+		printf(";Latency [%ld, %ld[ [nanoseconds]", limit, next_limit);
+		limit = next_limit;
+	}
+	printf(";Latency >= %ld [nanoseconds]", limit);
+
+	printf(";Memory per term [bytes];Reallocations;Bytes copied;Peak slack "
+	       "[bytes]\n");
+}
+
+// Mede e imprime o débito de `length` adições à sucessão, com o factor de
+// crescimento `factor` e a capacidade inicial `initial_capacity`, o
+// histograma das suas latências, a memória reservada por termo no final e as
+// estatísticas das alterações da capacidade a partir da inicial. Devolve
+// `true` em caso de erro.
+static bool report_growth(const double factor, const int initial_capacity,
+			  const int length)
+{
+	struct sequence_of_longs *const sequence = SEQL_new();
+	struct SEQL_statistics statistics = {0L, 0L, 0L};
+	long histogram[histogram_size] = {0L};
+
+	bool error = sequence == NULL ||
+		SEQL_reserve(sequence, initial_capacity);
+
+	if (!error) {
+		SEQL_set_growth_factor(sequence, factor);
+		SEQL_set_statistics(sequence, &statistics);
+	}
+
+	const double start = now();
+	for (int i = 0; !error && i != length; i++) {
+		const long addition_start = now_in_nanoseconds();
+		error = SEQL_add(sequence, i);
+		record_latency(histogram,
+			       now_in_nanoseconds() - addition_start);
+	}
+	const double seconds = now() - start;
+
+	if (!error) {
+		printf("%d;factor %g;%d;%g", length, factor, initial_capacity,
+		       length / seconds);
+		print_histogram(histogram);
+		printf(";%g;%ld;%ld;%ld\n",
+		       (double)SEQL_capacity(sequence) * sizeof(long) / length,
+		       statistics.reallocations, statistics.bytes_copied,
+		       statistics.peak_slack);
+		fflush(stdout);
+	}
+
+	SEQL_free(sequence);
+
+	return error;
+}
+
+// Mede e imprime o mesmo que `report_growth()`, mas para `length` adições à
+// sucessão ingénua, cuja capacidade é sempre igual ao comprimento.
+static void report_naive_growth(const int length)
+{
+	struct naive_sequence_of_longs *const sequence = NSEQL_new();
+	struct NSEQL_statistics statistics = {0L, 0L};
+	long histogram[histogram_size] = {0L};
+
+	NSEQL_set_statistics(sequence, &statistics);
+
+	const double start = now();
+	for (int i = 0; i != length; i++) {
+		const long addition_start = now_in_nanoseconds();
+		NSEQL_add(sequence, i);
+		record_latency(histogram,
+			       now_in_nanoseconds() - addition_start);
+	}
+	const double seconds = now() - start;
+
+	printf("%d;naive;0;%g", length, length / seconds);
+	print_histogram(histogram);
+	printf(";%g;%ld;%ld;0\n", (double)sizeof(long),
+	       statistics.reallocations, statistics.bytes_copied);
+	fflush(stdout);
+
+	NSEQL_free(sequence);
+}
+
+// Mede e imprime o tempo médio, em nanossegundos, da construção de uma
+// sucessão no monte (se `on_stack` for `false`) ou na pilha (caso contrário),
+// da adição de `length` termos e da sua destruição, repetidas `count` vezes.
+// Verifica ainda a soma dos últimos termos de todas as sucessões. Devolve
+// `true` em caso de erro.
+static bool report_short_sequences(const bool on_stack, const int count,
+				   const int length)
+{
+	bool error = false;
+	long sum = 0L;
+
+	const double start = now();
+	for (int i = 0; !error && i != count; i++) {
+		struct SEQL_storage storage;
+		struct sequence_of_longs *const sequence =
+			on_stack ? SEQL_init(&storage) : SEQL_new();
+
+		error = sequence == NULL;
+		for (int j = 0; !error && j != length; j++)
+			error = SEQL_add(sequence, (long)i + j);
+		if (!error)
+			sum += SEQL_term(sequence, length - 1);
+
+		if (on_stack)
+			SEQL_fini(sequence);
+		else
+			SEQL_free(sequence);
+	}
+	const double seconds = now() - start;
+
+	const long expected_sum = (long)count * (count - 1) / 2 +
+		(long)count * (length - 1);
+
+	error = error || sum != expected_sum;
+
+	if (!error)
+		printf("%d;%d;%s;%g\n", count, length,
+		       on_stack ? "stack" : "heap", seconds / count * 1e9);
+
+	return error;
+}
+
+// Constrói uma sucessão e uma sucessão compactada com os mesmos `length`
+// termos crescentes, com diferenças aleatórias inferiores a 1000, e imprime a
+// memória usada por cada uma e os tempos das somas de todos os termos. Devolve
+// `true` em caso de erro.
+static bool report_packing(const int length)
+{
+	struct sequence_of_longs *const sequence = SEQL_new();
+	struct packed_sequence_of_longs *const packed_sequence = PSEQL_new();
+
+	bool error = sequence == NULL || packed_sequence == NULL;
+
+	long term = 0L;
+	for (int i = 0; !error && i != length; i++) {
+		term += rand() % 1000;
+		error = SEQL_add(sequence, term) ||
+			PSEQL_add(packed_sequence, term);
+	}
+
+	if (!error) {
+		double start = now();
+		long sum = 0L;
+		for (int i = 0; i != length; i++)
+			sum += SEQL_term(sequence, i);
+		const double sequence_seconds = now() - start;
+
+		start = now();
+		long packed_sum = 0L;
+		for (int i = 0; i != length; i++)
+			packed_sum += PSEQL_term(packed_sequence, i);
+		const double packed_seconds = now() - start;
+
+		start = now();
+		long batch_sum = 0L;
+		for (int first = 0; first < length;
+		     first += scan_batch_length) {
+			long batch[scan_batch_length];
+			const int count = length - first < scan_batch_length ?
+				length - first : scan_batch_length;
+			PSEQL_copy(packed_sequence, first, count, batch);
+			for (int i = 0; i != count; i++)
+				batch_sum += batch[i];
+		}
+		const double batch_seconds = now() - start;
+
+		const struct SEQL_span span = SEQL_terms(sequence);
+
+		start = now();
+		const long span_sum = long_array_sum(span.length, span.terms);
+		const double span_seconds = now() - start;
+
+		start = now();
+		const long parallel_sum =
+			long_array_parallel_sum(span.length, span.terms, 0);
+		const double parallel_seconds = now() - start;
+
+		error = packed_sum != sum || batch_sum != sum ||
+			span_sum != sum || parallel_sum != sum;
+
+		printf("%d;%zu;%zu;%g;%g;%g;%g;%g\n", length,
+		       (size_t)SEQL_capacity(sequence) * sizeof(long),
+		       PSEQL_memory(packed_sequence), sequence_seconds,
+		       packed_seconds, batch_seconds, span_seconds,
+		       parallel_seconds);
+	}
+
+	PSEQL_free(packed_sequence);
+	SEQL_free(sequence);
+
+	return error;
+}
+
+// Constrói uma sucessão com os menores factores primos dos inteiros de 0 a
+// `length` - 1 (0 e 1 para 0 e 1), através do crivo de Eratóstenes, guarda-a
+// num ficheiro, recupera-a a partir do ficheiro, sem e com a verificação da
+// soma de verificação, e imprime os tempos de cada uma destas operações e da
+// primeira adição à sucessão recuperada. Devolve `true` em caso de erro.
+static bool report_persistence(const int length)
+{
+	long *const factors = malloc((size_t)length * sizeof(long));
+	struct sequence_of_longs *const sequence = SEQL_new();
+	struct sequence_of_longs *reopened = NULL;
+	struct sequence_of_longs *verified = NULL;
+
+	bool error = factors == NULL || sequence == NULL;
+
+	if (!error) {
+		double start = now();
+		for (int i = 0; i != length; i++)
+			factors[i] = i;
+		for (long p = 2L; p * p < length; p++)
+			if (factors[p] == p)
+				for (long m = p * p; m < length; m += p)
+					if (factors[m] == m)
+						factors[m] = p;
+		error = SEQL_add_many(sequence, length, factors);
+		const double build_seconds = now() - start;
+
+		start = now();
+		error = error || SEQL_save(sequence, persistence_path);
+		const double save_seconds = now() - start;
+
+		start = now();
+		reopened = error ? NULL :
+			SEQL_open_mapped(persistence_path, false);
+		const double open_seconds = now() - start;
+
+		start = now();
+		verified = error ? NULL :
+			SEQL_open_mapped(persistence_path, true);
+		const double verified_open_seconds = now() - start;
+
+		start = now();
+		error = reopened == NULL || verified == NULL ||
+			SEQL_add(reopened, 0L);
+		const double promotion_seconds = now() - start;
+
+		for (int i = 0; !error && i != length; i++)
+			error = SEQL_term(reopened, i) != factors[i];
+
+		if (!error)
+			printf("%d;%g;%g;%g;%g;%g\n", length, build_seconds,
+			       save_seconds, open_seconds,
+			       verified_open_seconds, promotion_seconds);
+	}
+
+	remove(persistence_path);
+	SEQL_free(verified);
+	SEQL_free(reopened);
+	SEQL_free(sequence);
+	free(factors);
+
+	return error;
+}
+
+// Demonstra a utilização das sucessões. Devolve `true` em caso de erro.
+static bool demonstrate(void)
 {
 	struct sequence_of_longs *sequence = SEQL_new();
 
+	if (sequence == NULL || SEQL_reserve(sequence, 1000)) {
+		fprintf(stderr, "Error: Could not create the sequence.\n");
+		SEQL_free(sequence);
+		return true;
+	}
+
 	for (long i = 0L; i != 1000L; i++)
-		SEQL_add(sequence, i);
+		if (SEQL_add(sequence, i)) {
+			fprintf(stderr, "Error: Could not add term %ld.\n", i);
+			SEQL_free(sequence);
+			return true;
+		}
 
 	printf("The length is: %d\n", SEQL_length(sequence));
 
@@ -20,11 +497,26 @@ int main(void)
 	SEQL_println(sequence);
 
 	printf("The items are:");
-	for (int i = 0; i != SEQL_length(sequence); i++)
-		printf(" %ld", SEQL_term(sequence, i));
+	const struct SEQL_span span = SEQL_terms(sequence);
+	for (int i = 0; i != span.length; i++)
+		printf(" %ld", span.terms[i]);
 	putchar('\n');
 
-	free(sequence);
+	long more_terms[1000];
+	for (int i = 0; i != 1000; i++)
+		more_terms[i] = 1000L + i;
+
+	if (SEQL_add_many(sequence, 1000, more_terms) ||
+	    SEQL_shrink_to_fit(sequence)) {
+		fprintf(stderr, "Error: Could not add the terms.\n");
+		SEQL_free(sequence);
+		return true;
+	}
+
+	printf("The length after adding many is: %d (capacity %d)\n",
+	       SEQL_length(sequence), SEQL_capacity(sequence));
+
+	SEQL_free(sequence);
 
 	struct naive_sequence_of_longs *naive_sequence = NSEQL_new();
 
@@ -41,7 +533,248 @@ int main(void)
 		printf(" %ld", NSEQL_term(naive_sequence, i));
 	putchar('\n');
 
-	free(naive_sequence);
+	NSEQL_free(naive_sequence);
+
+	return false;
+}
+
+// A tarefa de cada _thread_ nas medições das adições concorrentes: adicionar
+// os termos `first`, `first` + 1, ..., `first` + `count` - 1 à sucessão
+// concorrente `concurrent_sequence` ou, se esta for nula, à sucessão
+// `sequence`, protegida pelo trinco `mutex`.
+struct addition_task {
+	struct concurrent_sequence_of_longs *concurrent_sequence;
+	struct sequence_of_longs *sequence;
+	pthread_mutex_t *mutex;
+	long first;
+	long count;
+	bool error;
+};
+
+static void *run_addition_task(void *const generic_task)
+{
+	struct addition_task *const task = generic_task;
+
+	for (long i = task->first; !task->error &&
+		     i != task->first + task->count; i++)
+		if (task->concurrent_sequence != NULL)
+			task->error = CSEQL_add(task->concurrent_sequence, i);
+		else {
+			pthread_mutex_lock(task->mutex);
+			task->error = SEQL_add(task->sequence, i);
+			pthread_mutex_unlock(task->mutex);
+		}
+
+	return NULL;
+}
+
+// Mede e imprime o débito de `length` adições repartidas por `threads`
+// _threads_, à sucessão concorrente (se `concurrent` for `true`) ou à sucessão
+// protegida por um trinco (caso contrário). Verifica ainda que a sucessão
+// resultante tem todos os termos adicionados, através da sua soma. Devolve
+// `true` em caso de erro.
+static bool report_concurrent_additions(const bool concurrent,
+					const int threads, const int length)
+{
+	struct concurrent_sequence_of_longs *const concurrent_sequence =
+		concurrent ? CSEQL_new() : NULL;
+	struct sequence_of_longs *const sequence =
+		concurrent ? NULL : SEQL_new();
+	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+	struct addition_task tasks[maximum_number_of_adders];
+	pthread_t thread_ids[maximum_number_of_adders];
+	bool started[maximum_number_of_adders] = {false};
+
+	bool error = concurrent_sequence == NULL && sequence == NULL;
+
+	const double start = now();
+	for (int t = 0; !error && t != threads; t++) {
+		tasks[t] = (struct addition_task){
+			.concurrent_sequence = concurrent_sequence,
+			.sequence = sequence,
+			.mutex = &mutex,
+			.first = (long)length * t / threads,
+			.count = (long)length * (t + 1) / threads -
+				(long)length * t / threads,
+			.error = false
+		};
+		started[t] = pthread_create(&thread_ids[t], NULL,
+					    run_addition_task, &tasks[t]) == 0;
+		error = !started[t];
+	}
+	for (int t = 0; t != threads; t++)
+		if (started[t]) {
+			pthread_join(thread_ids[t], NULL);
+			error = error || tasks[t].error;
+		}
+	const double seconds = now() - start;
+
+	if (!error) {
+		const int final_length = concurrent ?
+			CSEQL_length(concurrent_sequence) :
+			SEQL_length(sequence);
+		long sum = 0L;
+		for (int i = 0; i != final_length; i++)
+			sum += concurrent ? CSEQL_term(concurrent_sequence, i) :
+				SEQL_term(sequence, i);
+		error = final_length != length ||
+			sum != (long)length * (length - 1) / 2;
+	}
+
+	if (!error)
+		printf("%d;%s;%g;%g\n", threads,
+		       concurrent ? "lock-free" : "mutex", seconds,
+		       length / seconds);
+
+	CSEQL_free(concurrent_sequence);
+	SEQL_free(sequence);
+
+	return error;
+}
+
+// Mede o tempo, em segundos, que a variante `variant` demora a construir uma
+// sucessão com `length` termos, adicionados um a um, guardando-o em `*seconds`.
+// Devolve `true` em caso de erro (tipicamente, falta de memória).
+static bool time_additions(const enum variant variant, const long length,
+			   double *const seconds)
+{
+	if (variant == naive_variant) {
+		struct naive_sequence_of_longs *const sequence = NSEQL_new();
+
+		const double start = now();
+		for (long i = 0L; i != length; i++)
+			NSEQL_add(sequence, i);
+		*seconds = now() - start;
+
+		NSEQL_free(sequence);
+
+		return false;
+	}
+
+	struct sequence_of_longs *const sequence = SEQL_new();
+	if (sequence == NULL)
+		return true;
+
+	if (variant == heap_variant)
+		SEQL_set_mapping_threshold(sequence, SIZE_MAX);
+
+	bool error = false;
+
+	const double start = now();
+	for (long i = 0L; !error && i != length; i++)
+		error = SEQL_add(sequence, i);
+	*seconds = now() - start;
+
+	SEQL_free(sequence);
+
+	return error;
+}
+
+int main(const int argument_count,
+	 const char *const argument_values[argument_count])
+{
+	long maximum_length = default_maximum_benchmark_length;
+
+	if (argument_count > 2 ||
+	    (argument_count == 2 &&
+	     ((maximum_length = atol(argument_values[1])) <= 0L ||
+	      maximum_length > INT_MAX))) {
+		fprintf(stderr, "Usage: %s [MAXIMUM_LENGTH]\n",
+			argument_values[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (demonstrate())
+		return EXIT_FAILURE;
+
+	printf("Length;Variant;Latency median [nanoseconds];Latency p99 "
+	       "[nanoseconds];Latency p99.9 [nanoseconds];Latency maximum "
+	       "[nanoseconds]\n");
+
+	if (report_latencies(false, latency_length) ||
+	    report_latencies(true, latency_length)) {
+		fprintf(stderr, "Error: Could not measure the latencies.\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("Length;Memory [bytes];Memory (packed) [bytes];Sum time "
+	       "[seconds];Sum time (packed) [seconds];Sum time (packed, "
+	       "batches) [seconds];Sum time (span) [seconds];Sum time (span, "
+	       "parallel) [seconds]\n");
+
+	if (report_packing(packing_length)) {
+		fprintf(stderr, "Error: Could not measure the packing.\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("Length;Build time [seconds];Save time [seconds];Open time "
+	       "[seconds];Verified open time [seconds];First addition time "
+	       "[seconds]\n");
+
+	if (report_persistence(persistence_length)) {
+		fprintf(stderr, "Error: Could not measure the persistence.\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("Threads;Variant;Time [seconds];Throughput [terms/second]\n");
+
+	for (int threads = 1; threads <= maximum_number_of_adders;
+	     threads *= 2)
+		if (report_concurrent_additions(true, threads,
+						concurrent_length) ||
+		    report_concurrent_additions(false, threads,
+						concurrent_length)) {
+			fprintf(stderr, "Error: Could not measure the "
+				"concurrent additions.\n");
+			return EXIT_FAILURE;
+		}
+
+	print_growth_header();
+
+	for (size_t c = 0; c != sizeof(initial_capacities) /
+		     sizeof(initial_capacities[0]); c++)
+		for (size_t f = 0; f != sizeof(growth_factors) /
+			     sizeof(growth_factors[0]); f++)
+			if (report_growth(growth_factors[f],
+					  initial_capacities[c],
+					  growth_length)) {
+				fprintf(stderr, "Error: Could not measure the "
+					"growth policies.\n");
+				return EXIT_FAILURE;
+			}
+
+	report_naive_growth(naive_growth_length);
+
+	printf("Sequences;Length;Placement;Time per sequence [nanoseconds]\n");
+
+	if (report_short_sequences(false, short_sequences_count,
+				   short_sequence_length) ||
+	    report_short_sequences(true, short_sequences_count,
+				   short_sequence_length)) {
+		fprintf(stderr, "Error: Could not measure the short "
+			"sequences.\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("Length;Variant;Time [seconds];Throughput [terms/second]\n");
+
+	for (long length = minimum_benchmark_length; length <= maximum_length;
+	     length *= 10L)
+		for (int v = 0; v != number_of_variants; v++) {
+			if (v == naive_variant && length > maximum_naive_length)
+				continue;
+
+			double seconds;
+			if (time_additions(v, length, &seconds)) {
+				fprintf(stderr, "Error: Could not add %ld terms "
+					"(%s).\n", length, variant_names[v]);
+				return EXIT_FAILURE;
+			}
+
+			printf("%ld;%s;%g;%g\n", length, variant_names[v],
+			       seconds, length / seconds);
+			fflush(stdout);
+		}
 
 	return EXIT_SUCCESS;
 }
@@ -23,10 +23,13 @@
 //
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+
+#include "buffered_output.h"
 
 // ### Definição da estrutura `struct naive_sequence_of_long`
 //
-// Esta estrutura contém dois campos ou atributos:
+// Esta estrutura contém três campos ou atributos:
 //
 // - `terms` &ndash; Um ponteiro para o _array_ dinâmico que contém os termos da
 //   sucessão.
@@ -34,22 +37,50 @@
 // - `length` &ndash; Inteiro guardando o comprimento actual da sucessão, i.e.,
 //   o seu número de termos. Note que o comprimento da sucessão é sempre
 //   igual ao comprimento do `array` que guarda os termos.
+//
+// - `statistics` &ndash; Um ponteiro para a estrutura onde se acumulam as
+//   estatísticas das re-reservas, ou `NULL`, se estas não estiverem a ser
+//   recolhidas.
 struct naive_sequence_of_longs {
 	long *terms;
 	int length;
+	struct NSEQL_statistics *statistics;
 };
 
+// ### Rotinas auxiliares
+
+// Este procedimento actualiza as estatísticas da sucessão, se estiverem a ser
+// recolhidas, depois de uma re-reserva dos seus termos, que se encontravam no
+// endereço `old_address`. Os termos só podem ter sido copiados se tiverem
+// mudado de endereço. O endereço original é passado como inteiro, pois o valor
+// de um ponteiro para memória libertada é indeterminado.
+static void record_reallocation(struct naive_sequence_of_longs *sl,
+				const uintptr_t old_address)
+{
+	struct NSEQL_statistics *const statistics = sl->statistics;
+
+	if (statistics == NULL)
+		return;
+
+	statistics->reallocations++;
+	if ((uintptr_t)sl->terms != old_address)
+		statistics->bytes_copied += (long)(sl->length * sizeof(long));
+}
+
 // ### Implementação dos procedimentos que imprimem as sucessões
 //
 void NSEQL_print(struct naive_sequence_of_longs *sl)
 {
-	putchar('{');
+	struct buffered_output output;
+	buffered_output_start(&output, stdout);
+	buffered_output_char(&output, '{');
 	for (int i = 0; i != sl->length; i++) {
 		if (i != 0)
-			printf(", ");
-		printf("%ld", sl->terms[i]);
+			buffered_output_string(&output, ", ");
+		buffered_output_long(&output, sl->terms[i]);
 	}
-	putchar('}');
+	buffered_output_char(&output, '}');
+	buffered_output_finish(&output);
 }
 
 void NSEQL_println(struct naive_sequence_of_longs *sl)
@@ -78,12 +109,24 @@ struct naive_sequence_of_longs *NSEQL_new(void)
 	// para o primeiro item desse _array_ com o valor `NULL`.
 	sl->length = 0;
 	sl->terms = NULL;
+	sl->statistics = NULL;
 
 	// Terminada a construção da nova sucessão, há que devolver o seu
 	// endereço (ou ponteiro), guardado na variável `sl`.
 	return sl;
 }
 
+// ### Implementação do destrutor do TAD
+//
+void NSEQL_free(struct naive_sequence_of_longs *sl)
+{
+	if (sl == NULL)
+		return;
+
+	free(sl->terms);
+	free(sl);
+}
+
 // ### Implementação do _inspector_ do comprimento
 //
 int NSEQL_length(struct naive_sequence_of_longs *sl)
@@ -106,8 +149,12 @@ void NSEQL_add(struct naive_sequence_of_longs *sl, long new_term)
 	// existente, copiará automaticamente os termos da memória original. É
 	// por isso que o primeiro argumento passado a `realloc()` é um ponteiro
 	// para o _array_ original.
+	const uintptr_t old_address = (uintptr_t)sl->terms;
+
 	sl->terms = realloc(sl->terms, (sl->length + 1) * sizeof(long));
 
+	record_reallocation(sl, old_address);
+
  	// Finalmente, guardamos o novo termo `new_term` no local apropriado do
  	// _array_, que neste ponto já tem certamente (hmmmm... será?)
  	// capacidade suficiente, i.e., na posição `sl->length`. Depois,
@@ -122,4 +169,12 @@ long NSEQL_term(struct naive_sequence_of_longs *sl, int index)
 	return sl->terms[index];
 }
 
+// ### Implementação do _modificador_ da recolha de estatísticas
+//
+void NSEQL_set_statistics(struct naive_sequence_of_longs *sl,
+			  struct NSEQL_statistics *const statistics)
+{
+	sl->statistics = statistics;
+}
+
 
@@ -60,6 +60,22 @@
 //
 struct naive_sequence_of_longs;
 
+// ### Estatísticas
+//
+// Tal como no TAD `sequence_of_longs`, as estatísticas das re-reservas são
+// recolhidas apenas se o código cliente o pedir. Como a capacidade está
+// sempre esgotada, não há folga a registar.
+//
+/** \brief Statistics of the reallocations of a naive sequence of `long`s.
+ */
+struct NSEQL_statistics {
+	/** The number of reallocations of the terms. */
+	long reallocations;
+	/** The number of bytes of terms moved by `realloc()` to a new
+	 * address, and thus possibly copied. */
+	long bytes_copied;
+};
+
 // ### Construtor do TAD
 //
 /** \brief Returns a pointer to a newly created and initialized
@@ -74,6 +90,19 @@ struct naive_sequence_of_longs;
  */
 struct naive_sequence_of_longs *NSEQL_new(void);
 
+// ### Destrutor do TAD
+//
+/** \brief Destroys the given sequence of `long`s, releasing all the memory it
+ * uses.
+ *
+ * \param sl A pointer to the sequence of `long`s to destroy, or `NULL`, in
+ * which case nothing is done.
+ * \post `sl` no longer refers to a valid sequence.
+ *
+ * This procedure is the destructor of the sequence of `long`s ADT.
+ */
+void NSEQL_free(struct naive_sequence_of_longs *sl);
+
 // ### Operações do TAD
 
 /** \brief Prints the sequence of longs in the format `{term_1, ... term_n}`.
@@ -125,6 +154,19 @@ void NSEQL_add(struct naive_sequence_of_longs *sl, long new_term);
  */
 long NSEQL_term(struct naive_sequence_of_longs *sl, int index);
 
+/** \brief Starts or stops collecting statistics of the reallocations of the
+ * given sequence of `long`s.
+ *
+ * \param sl A pointer to the sequence of `long`s whose statistics will be
+ * collected.
+ * \param statistics A pointer to the structure where the statistics will be
+ * accumulated, or `NULL` to stop collecting them (the default).
+ * \pre `sl` ≠ null
+ * \pre `statistics` remains valid while it is being used by the sequence.
+ */
+void NSEQL_set_statistics(struct naive_sequence_of_longs *sl,
+			  struct NSEQL_statistics *statistics);
+
 // ### Fim do ficheiro
 //
 // Final da instrução condicional do pré-processador.
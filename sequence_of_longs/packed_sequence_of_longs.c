@@ -0,0 +1,432 @@
+// `packed_sequence_of_longs.c` &ndash; Implementação das sucessões compactadas de `long`
+// ===================================================================================
+
+// Implementação do módulo físico `packed_sequence_of_longs`
+// ---------------------------------------------------------
+//
+// Para uma explicação mais pormenorizada das várias partes deste ficheiro, e da
+// implementação das várias rotinas, consultar a explicação do correspondente
+// ficheiro [`sequence_of_longs.c`](sequence_of_longs.c.html). Neste ficheiro
+// explica-se apenas aquilo que é específico desta implementação compactada do
+// TAD sucessão de `long`.
+//
+// Este ficheiro de implementação contém a implementação do módulo físico
+// `packed_sequence_of_longs`. A interface deste módulo encontra-se no ficheiro
+// de cabeçalho ou de interface
+// [`packed_sequence_of_longs.h`](packed_sequence_of_longs.h.html).
+
+// ### Inclusão do cabeçalho correspondente a esta implementação
+//
+#include "packed_sequence_of_longs.h"
+
+// ### Inclusão de ficheiros de cabeçalho necessários no código de implementação
+//
+// - `stdint.h` &ndash; Necessário para se poder usar o tipo `uint64_t`.
+//
+// - `string.h` &ndash; Necessário para se poder usar as rotinas `memcpy()` e
+//   `memset()`.
+//
+// - `limits.h` &ndash; Necessário para se poder usar a macro `INT_MAX`.
+//
+// - `emmintrin.h` &ndash; Necessário para se poder usar as instruções SSE2,
+//   disponíveis em todos os processadores x86-64.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+
+#include "buffered_output.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ### Definição de constantes
+//
+// O número de termos de cada bloco. Os valores empacotados de cada bloco são
+// distribuídos por duas vias (_lanes_): a via 0 com os termos de índice par e a
+// via 1 com os termos de índice ímpar. Cada via tem 64 valores, pelo que,
+// empacotados com _w_ _bits_ cada, ocupam exactamente _w_ palavras de 64
+// _bits_. As palavras das duas vias são intercaladas, pelo que a palavra _r_ da
+// via _l_ fica no índice 2_r_ + _l_. Assim, as duas vias podem ser
+// descompactadas em simultâneo por instruções SIMD sobre 128 _bits_, sendo
+// iguais os deslocamentos necessários em ambas.
+#define block_length 128
+
+// ### Definição das estruturas
+//
+// Cada entrada do índice dos blocos contém:
+//
+// - `first` &ndash; O primeiro termo do bloco.
+//
+// - `minimum_delta` &ndash; A menor das diferenças entre termos consecutivos do
+//   bloco, que é subtraída de todas antes de estas serem empacotadas.
+//
+// - `offset` &ndash; O índice da primeira palavra do bloco no _array_ das
+//   palavras.
+//
+// - `width` &ndash; O número de _bits_ de cada valor empacotado (entre 0 e
+//   64).
+struct block_entry {
+	long first;
+	long minimum_delta;
+	size_t offset;
+	int width;
+};
+
+// A estrutura da sucessão contém:
+//
+// - `blocks`, `number_of_blocks` e `blocks_capacity` &ndash; O índice dos
+//   blocos compactados, o seu número e a capacidade do _array_ do índice.
+//
+// - `words`, `number_of_words` e `words_capacity` &ndash; O _array_ com as
+//   palavras de todos os blocos compactados, o seu número e a sua capacidade.
+//
+// - `tail` e `tail_length` &ndash; O bloco final, ainda não compactado, e o seu
+//   comprimento.
+//
+// - `decoded` e `decoded_block` &ndash; O último bloco descompactado por
+//   `PSEQL_term()` e o seu índice (ou -1, se não houver nenhum).
+struct packed_sequence_of_longs {
+	struct block_entry *blocks;
+	int number_of_blocks;
+	int blocks_capacity;
+	uint64_t *words;
+	size_t number_of_words;
+	size_t words_capacity;
+	long tail[block_length];
+	int tail_length;
+	long decoded[block_length];
+	int decoded_block;
+};
+
+// ### Rotinas auxiliares
+//
+// As diferenças entre termos são calculadas com aritmética sem sinal, que em C
+// é modular, pelo que nunca transbordam. Ao somar as diferenças aos termos
+// anteriores, na descompactação, obtêm-se de novo os termos originais.
+
+// Esta função devolve o número de _bits_ necessários para representar `value`.
+static int bit_width(const uint64_t value)
+{
+	if (value == 0U)
+		return 0;
+#if defined(__GNUC__)
+	return 64 - __builtin_clzll(value);
+#else
+	int width = 0;
+	for (uint64_t v = value; v != 0U; v >>= 1)
+		width++;
+	return width;
+#endif
+}
+
+// Este procedimento garante que há espaço para mais uma entrada no índice e
+// para mais `extra_words` palavras. Devolve `true` em caso de erro.
+static bool ensure_capacity(struct packed_sequence_of_longs *sl,
+			    const size_t extra_words)
+{
+	if (sl->number_of_blocks == sl->blocks_capacity) {
+		const int new_capacity = sl->blocks_capacity == 0 ?
+			16 : 2 * sl->blocks_capacity;
+		struct block_entry *const new_blocks =
+			realloc(sl->blocks, new_capacity *
+				sizeof(struct block_entry));
+		if (new_blocks == NULL)
+			return true;
+		sl->blocks = new_blocks;
+		sl->blocks_capacity = new_capacity;
+	}
+
+	if (sl->number_of_words + extra_words > sl->words_capacity) {
+		size_t new_capacity = sl->words_capacity == 0 ?
+			256 : 2 * sl->words_capacity;
+		if (new_capacity < sl->number_of_words + extra_words)
+			new_capacity = sl->number_of_words + extra_words;
+		uint64_t *const new_words =
+			realloc(sl->words, new_capacity * sizeof(uint64_t));
+		if (new_words == NULL)
+			return true;
+		sl->words = new_words;
+		sl->words_capacity = new_capacity;
+	}
+
+	return false;
+}
+
+// Este procedimento compacta o bloco final, completo, acrescentando-o aos
+// blocos compactados. Devolve `true` em caso de erro, deixando a sucessão
+// inalterada.
+static bool pack_tail(struct packed_sequence_of_longs *sl)
+{
+	const long *const terms = sl->tail;
+	uint64_t values[block_length];
+
+	long minimum_delta = (long)((uint64_t)terms[1] - (uint64_t)terms[0]);
+	for (int i = 2; i != block_length; i++) {
+		const long delta = (long)((uint64_t)terms[i] -
+					  (uint64_t)terms[i - 1]);
+		if (delta < minimum_delta)
+			minimum_delta = delta;
+	}
+
+	// O primeiro termo é guardado no índice, pelo que o seu valor
+	// empacotado é sempre 0.
+	uint64_t all_values = 0U;
+	values[0] = 0U;
+	for (int i = 1; i != block_length; i++) {
+		values[i] = (uint64_t)terms[i] - (uint64_t)terms[i - 1] -
+			(uint64_t)minimum_delta;
+		all_values |= values[i];
+	}
+
+	const int width = bit_width(all_values);
+	const size_t number_of_words = 2 * (size_t)width;
+
+	if (ensure_capacity(sl, number_of_words))
+		return true;
+
+	uint64_t *const words = sl->words + sl->number_of_words;
+
+	for (size_t r = 0; r != number_of_words; r++)
+		words[r] = 0U;
+
+	for (int v = 0; width != 0 && v != block_length / 2; v++) {
+		const int position = v * width;
+		const int r = position / 64;
+		const int shift = position % 64;
+		for (int lane = 0; lane != 2; lane++) {
+			const uint64_t value = values[2 * v + lane];
+			words[2 * r + lane] |= value << shift;
+			if (shift + width > 64)
+				words[2 * (r + 1) + lane] |=
+					value >> (64 - shift);
+		}
+	}
+
+	sl->blocks[sl->number_of_blocks++] = (struct block_entry){
+		.first = terms[0],
+		.minimum_delta = minimum_delta,
+		.offset = sl->number_of_words,
+		.width = width
+	};
+	sl->number_of_words += number_of_words;
+	sl->tail_length = 0;
+
+	return false;
+}
+
+// Este procedimento descompacta os valores empacotados do bloco `block` para
+// `values`. Com SSE2, cada iteração extrai o valor _v_ de ambas as vias, ou
+// seja, os valores de índices 2_v_ e 2_v_ + 1, com os mesmos deslocamentos.
+static void unpack_values(const struct packed_sequence_of_longs *sl,
+			  const struct block_entry *const block,
+			  uint64_t values[block_length])
+{
+	const int width = block->width;
+
+	if (width == 0) {
+		memset(values, 0, block_length * sizeof(uint64_t));
+		return;
+	}
+
+	const uint64_t *const words = sl->words + block->offset;
+	const uint64_t mask = width == 64 ? ~(uint64_t)0 :
+		((uint64_t)1 << width) - 1U;
+
+#if defined(__SSE2__)
+	const __m128i masks = _mm_set1_epi64x((long long)mask);
+
+	for (int v = 0; v != block_length / 2; v++) {
+		const int position = v * width;
+		const int r = position / 64;
+		const int shift = position % 64;
+		__m128i x = _mm_loadu_si128((const __m128i *)(words + 2 * r));
+		x = _mm_srl_epi64(x, _mm_cvtsi32_si128(shift));
+		if (shift + width > 64) {
+			__m128i y = _mm_loadu_si128((const __m128i *)
+						    (words + 2 * (r + 1)));
+			y = _mm_sll_epi64(y, _mm_cvtsi32_si128(64 - shift));
+			x = _mm_or_si128(x, y);
+		}
+		_mm_storeu_si128((__m128i *)(values + 2 * v),
+				 _mm_and_si128(x, masks));
+	}
+#else
+	for (int v = 0; v != block_length / 2; v++) {
+		const int position = v * width;
+		const int r = position / 64;
+		const int shift = position % 64;
+		for (int lane = 0; lane != 2; lane++) {
+			uint64_t value = words[2 * r + lane] >> shift;
+			if (shift + width > 64)
+				value |= words[2 * (r + 1) + lane] <<
+					(64 - shift);
+			values[2 * v + lane] = value & mask;
+		}
+	}
+#endif
+}
+
+// Este procedimento descompacta o bloco `b` para `terms`, somando as diferenças
+// aos termos anteriores a partir do primeiro termo do bloco.
+static void unpack_block(const struct packed_sequence_of_longs *sl,
+			 const int b, long terms[block_length])
+{
+	const struct block_entry *const block = sl->blocks + b;
+	uint64_t values[block_length];
+
+	unpack_values(sl, block, values);
+
+	uint64_t term = (uint64_t)block->first;
+	terms[0] = block->first;
+	for (int i = 1; i != block_length; i++) {
+		term += values[i] + (uint64_t)block->minimum_delta;
+		terms[i] = (long)term;
+	}
+}
+
+// ### Implementação dos procedimentos que imprimem as sucessões
+//
+void PSEQL_print(struct packed_sequence_of_longs *sl)
+{
+	struct buffered_output output;
+	buffered_output_start(&output, stdout);
+	buffered_output_char(&output, '{');
+	for (int i = 0; i != PSEQL_length(sl); i++) {
+		if (i != 0)
+			buffered_output_string(&output, ", ");
+		buffered_output_long(&output, PSEQL_term(sl, i));
+	}
+	buffered_output_char(&output, '}');
+	buffered_output_finish(&output);
+}
+
+void PSEQL_println(struct packed_sequence_of_longs *sl)
+{
+	PSEQL_print(sl);
+	putchar('\n');
+}
+
+// ### Implementação do construtor do TAD
+//
+struct packed_sequence_of_longs *PSEQL_new(void)
+{
+	struct packed_sequence_of_longs *sl =
+		malloc(sizeof(struct packed_sequence_of_longs));
+
+	if (sl == NULL)
+		return NULL;
+
+	sl->blocks = NULL;
+	sl->number_of_blocks = 0;
+	sl->blocks_capacity = 0;
+	sl->words = NULL;
+	sl->number_of_words = 0;
+	sl->words_capacity = 0;
+	sl->tail_length = 0;
+	sl->decoded_block = -1;
+
+	return sl;
+}
+
+// ### Implementação do destrutor do TAD
+//
+void PSEQL_free(struct packed_sequence_of_longs *sl)
+{
+	if (sl == NULL)
+		return;
+
+	free(sl->words);
+	free(sl->blocks);
+	free(sl);
+}
+
+// ### Implementação dos _inspectores_ do comprimento e da memória usada
+//
+int PSEQL_length(struct packed_sequence_of_longs *sl)
+{
+	return sl->number_of_blocks * block_length + sl->tail_length;
+}
+
+size_t PSEQL_memory(struct packed_sequence_of_longs *sl)
+{
+	return sizeof(struct packed_sequence_of_longs) +
+		sl->blocks_capacity * sizeof(struct block_entry) +
+		sl->words_capacity * sizeof(uint64_t);
+}
+
+// ### Implementação do _modificador_ de adição de um novo termo à sucessão
+//
+// O novo termo é acrescentado ao bloco final. Quando este fica completo, é
+// compactado. Se a compactação falhar, o novo termo é retirado, deixando a
+// sucessão inalterada.
+bool PSEQL_add(struct packed_sequence_of_longs *sl, long new_term)
+{
+	if (PSEQL_length(sl) == INT_MAX)
+		return true;
+
+	sl->tail[sl->tail_length++] = new_term;
+
+	if (sl->tail_length == block_length && pack_tail(sl)) {
+		sl->tail_length--;
+		return true;
+	}
+
+	return false;
+}
+
+// ### Implementação do _inspector_ de termo
+//
+// O bloco de um termo obtém-se directamente a partir do seu índice. Os termos
+// do bloco final são acedidos directamente. Os restantes obrigam a
+// descompactar o seu bloco, excepto se este for o último descompactado.
+long PSEQL_term(struct packed_sequence_of_longs *sl, int index)
+{
+	const int b = index / block_length;
+	const int i = index % block_length;
+
+	if (b == sl->number_of_blocks)
+		return sl->tail[i];
+
+	if (b != sl->decoded_block) {
+		unpack_block(sl, b, sl->decoded);
+		sl->decoded_block = b;
+	}
+
+	return sl->decoded[i];
+}
+
+// ### Implementação do procedimento de cópia de termos
+//
+// Os blocos completamente abrangidos são descompactados directamente para o
+// destino. Os blocos parcialmente abrangidos, no início e no fim do intervalo,
+// são descompactados para um _array_ auxiliar.
+void PSEQL_copy(struct packed_sequence_of_longs *sl, const int first,
+		const int number_of_terms, long terms[number_of_terms])
+{
+	int index = first;
+	const int end = first + number_of_terms;
+
+	while (index != end) {
+		const int b = index / block_length;
+		const int i = index % block_length;
+		const int count = end - index < block_length - i ?
+			end - index : block_length - i;
+		long *const destination = terms + (index - first);
+
+		if (b == sl->number_of_blocks)
+			memcpy(destination, sl->tail + i, count * sizeof(long));
+		else if (count == block_length)
+			unpack_block(sl, b, destination);
+		else {
+			long block_terms[block_length];
+			unpack_block(sl, b, block_terms);
+			memcpy(destination, block_terms + i,
+			       count * sizeof(long));
+		}
+
+		index += count;
+	}
+}
@@ -0,0 +1,182 @@
+// `packed_sequence_of_longs.h` &ndash; Interface das sucessões compactadas de `long`
+// ================================================================================
+
+// Interface do módulo físico `packed_sequence_of_longs`
+// -----------------------------------------------------
+//
+// Para uma explicação mais pormenorizada das várias partes deste ficheiro,
+// consultar a explicação do correspondente ficheiro
+// [`sequence_of_longs.h`](sequence_of_longs.h.html).
+//
+// Este ficheiro de cabeçalho destina-se a ser utilizado pelo código cliente do
+// módulo físico `packed_sequence_of_longs`. A implementação deste módulo
+// encontra-se no ficheiro de implementação
+// [`packed_sequence_of_longs.c`](packed_sequence_of_longs.c.html). Este módulo
+// físico contém o TAD (Tipo Abstracto de Dados) sucessão compactada de `long`,
+// com o mesmo nome que o módulo físico, i.e., `packed_sequence_of_longs`.
+//
+// Trata-se de um TAD com a mesma funcionalidade que o TAD `sequence_of_longs`,
+// mas em que os termos são guardados de forma compacta, em blocos de 128
+// termos. Em cada bloco guardam-se as diferenças entre termos consecutivos
+// (_deltas_), subtraídas da menor delas (_frame of reference_) e empacotadas
+// com apenas os _bits_ necessários para a maior (_bit-packing_). Por exemplo,
+// nas sucessões crescentes com diferenças inferiores a 1024, como muitas
+// sucessões de instantes de tempo, cada termo ocupa cerca de 10 _bits_, e não
+// 64. Um índice com uma entrada por bloco permite chegar ao bloco de qualquer
+// termo em tempo constante. O acesso a um termo obriga a descompactar o seu
+// bloco, o que é feito de uma vez só, recorrendo a instruções SIMD quando
+// disponíveis. O último bloco descompactado é guardado, pelo que os acessos
+// sequenciais através de `PSEQL_term()` descompactam cada bloco apenas uma vez.
+// Os termos são adicionados a um bloco final não compactado, que é compactado
+// quando fica completo.
+
+// ### Comentário de documentação do ficheiro de cabeçalho
+//
+/**
+ * \file packed_sequence_of_longs.h
+ * \brief Header file for the `packed_sequence_of_longs` module, containing the
+ * ADT (Abstract Data Type) with the same name: `packed_sequence_of_longs`.
+ *
+ * This header file declares the basic structure used to store the packed
+ * sequences of longs and all the routines used to manipulate these sequences.
+ */
+
+// ### Protecção contra inclusões múltiplas
+//
+#ifndef ISLA_EDA_PACKED_SEQUENCE_OF_LONGS_H_INCLUDED
+#define ISLA_EDA_PACKED_SEQUENCE_OF_LONGS_H_INCLUDED
+
+// Incluímos os ficheiros de interface `stdbool.h` e `stddef.h` para podermos
+// usar os tipos `bool` e `size_t`.
+#include <stdbool.h>
+#include <stddef.h>
+
+// ### Comentário de documentação da `struct` `packed_sequence_of_longs`
+//
+/** \brief C structure used to represent the packed sequence of `long`s and to
+ * store its terms.
+ *
+ * This TAD stores the terms in blocks of 128 terms, each holding the
+ * differences between consecutive terms, offset by their minimum and
+ * bit-packed. Sequences whose consecutive terms differ little from each other
+ * use much less memory than with the `sequence_of_longs` ADT.
+ */
+// ### Declaração da `struct` que representa as sucessões compactadas de `long`
+//
+struct packed_sequence_of_longs;
+
+// ### Construtor do TAD
+//
+/** \brief Returns a pointer to a newly created and initialized
+ * `packed_sequence_of_longs`.
+ *
+ * \return A pointer to a newly (heap) allocated and initialized
+ * `struct packed_sequence_of_longs`, or `NULL` if memory could not be
+ * allocated.
+ * \post The returned pointer, if not null, refers to a new
+ * `struct packed_sequence_of_longs` representing an empty (i.e., length 0)
+ * sequence of `long`s.
+ *
+ * This function is a constructor of the packed sequence of `long`s ADT.
+ */
+struct packed_sequence_of_longs *PSEQL_new(void);
+
+// ### Destrutor do TAD
+//
+/** \brief Destroys the given sequence of `long`s, releasing all the memory it
+ * uses.
+ *
+ * \param sl A pointer to the sequence of `long`s to destroy, or `NULL`, in
+ * which case nothing is done.
+ * \post `sl` no longer refers to a valid sequence.
+ *
+ * This procedure is the destructor of the packed sequence of `long`s ADT.
+ */
+void PSEQL_free(struct packed_sequence_of_longs *sl);
+
+// ### Operações do TAD
+
+/** \brief Prints the sequence of longs in the format `{term_1, ... term_n}`.
+ *
+ * \param sl A pointer to the sequence of `long`s to print.
+ * \pre `sl` ≠ null
+ */
+void PSEQL_print(struct packed_sequence_of_longs *sl);
+
+/** \brief Prints the sequence of longs in the format `{term_1, ... term_n}` and
+ * ends the line with `\n`.
+ *
+ * \param sl A pointer to the sequence of `long`s to print.
+ * \pre `sl` ≠ null
+ */
+void PSEQL_println(struct packed_sequence_of_longs *sl);
+
+/** \brief Returns the number of terms so far in a given sequence of `long`s.
+ *
+ * \param sl A pointer to the sequence of `long`s whose length will be returned.
+ * \return The number of terms in the sequence so far.
+ * \pre `sl` ≠ null
+ */
+int PSEQL_length(struct packed_sequence_of_longs *sl);
+
+/** \brief Returns the number of bytes of memory used by the given sequence of
+ * `long`s, including the memory reserved but not yet used.
+ *
+ * \param sl A pointer to the sequence of `long`s whose memory usage will be
+ * returned.
+ * \return The number of bytes used by the sequence.
+ * \pre `sl` ≠ null
+ */
+size_t PSEQL_memory(struct packed_sequence_of_longs *sl);
+
+/** \brief Adds a given value as a further term of the given sequence of
+ * `long`s.
+ *
+ * \param sl A pointer to the sequence of `long`s to which the new term will be
+ * added.
+ * \param new_term The new term to add to the sequence.
+ * \return `true` if memory could not be allocated, `false` otherwise.
+ * \post If `false` is returned, the sequence contains the same terms it
+ * contained before, in the same order, plus the new term in its last position.
+ * Otherwise, the sequence is unchanged.
+ * \pre `sl` ≠ null
+ *
+ * Every 128 additions, the last block is packed, which takes time proportional
+ * to its 128 terms. The amortized time of each addition is thus constant.
+ */
+bool PSEQL_add(struct packed_sequence_of_longs *sl, long new_term);
+
+/** \brief Returns the term of the given sequence at the given position or
+ * index.
+ *
+ * \param sl A pointer to the sequence of `long`s whose term will be returned.
+ * \param index The index or position of the term of the sequence to return.
+ * \return The term of the sequence given in the position or index given.
+ * \pre `sl` ≠ null
+ * \pre 0 ≤ `index` < `PSEQL_length(sl)`
+ *
+ * Unless the term belongs to the last block accessed, its whole block is
+ * unpacked.
+ */
+long PSEQL_term(struct packed_sequence_of_longs *sl, int index);
+
+/** \brief Copies a range of consecutive terms of the given sequence to an
+ * array.
+ *
+ * \param sl A pointer to the sequence of `long`s whose terms will be copied.
+ * \param first The index of the first term to copy.
+ * \param number_of_terms The number of terms to copy.
+ * \param terms The array to which the terms will be copied.
+ * \pre `sl` ≠ null
+ * \pre 0 ≤ `first` ≤ `first` + `number_of_terms` ≤ `PSEQL_length(sl)`
+ *
+ * This is the fastest way to scan the sequence, since the blocks are unpacked
+ * directly into `terms`.
+ */
+void PSEQL_copy(struct packed_sequence_of_longs *sl, int first,
+		int number_of_terms, long terms[number_of_terms]);
+
+// ### Fim do ficheiro
+//
+// Final da instrução condicional do pré-processador.
+#endif // ISLA_EDA_PACKED_SEQUENCE_OF_LONGS_H_INCLUDED
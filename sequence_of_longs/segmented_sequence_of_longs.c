@@ -0,0 +1,241 @@
+// `segmented_sequence_of_longs.c` &ndash; Implementação das sucessões segmentadas de `long`
+// =======================================================================================
+
+// Implementação do módulo físico `segmented_sequence_of_longs`
+// ------------------------------------------------------------
+//
+// Para uma explicação mais pormenorizada das várias partes deste ficheiro, e da
+// implementação das várias rotinas, consultar a explicação do correspondente
+// ficheiro [`sequence_of_longs.c`](sequence_of_longs.c.html). Neste ficheiro
+// explica-se apenas aquilo que é específico desta implementação segmentada do
+// TAD sucessão de `long`.
+//
+// Este ficheiro de implementação contém a implementação do módulo físico
+// `segmented_sequence_of_longs`. A interface deste módulo encontra-se no
+// ficheiro de cabeçalho ou de interface
+// [`segmented_sequence_of_longs.h`](segmented_sequence_of_longs.h.html).
+
+// ### Pedido das extensões GNU
+//
+// A rotina `posix_memalign()` e a macro `MADV_HUGEPAGE` só ficam visíveis se a
+// macro `_GNU_SOURCE` for definida antes de qualquer inclusão.
+#define _GNU_SOURCE
+
+// ### Inclusão do cabeçalho correspondente a esta implementação
+//
+#include "segmented_sequence_of_longs.h"
+
+// ### Inclusão de ficheiros de cabeçalho necessários no código de implementação
+//
+// - `limits.h` &ndash; Necessário para se poder usar a macro `INT_MAX`.
+//
+// - `sys/mman.h` &ndash; Necessário para se poder usar a rotina `madvise()`.
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <sys/mman.h>
+
+#include "buffered_output.h"
+
+// ### Definição de constantes
+//
+// O segmento _k_ (com _k_ = 0, 1, ...) tem 2<sup>_k_ + _s_</sup> termos,
+// sendo 2<sup>_s_</sup> o comprimento do primeiro segmento. Os segmentos 0 a
+// _k_ - 1 guardam, no total, 2<sup>_k_ + _s_</sup> - 2<sup>_s_</sup> termos.
+// Logo, o termo de índice _i_ encontra-se no segmento _k_ = ⌊log<sub>2</sub>(_i_
+// + 2<sup>_s_</sup>)⌋ - _s_, na posição _i_ + 2<sup>_s_</sup> -
+// 2<sup>_k_ + _s_</sup>. O logaritmo calcula-se contando os _bits_ a zero à
+// esquerda do primeiro _bit_ a um. Usando _s_ = 3, evitam-se segmentos
+// minúsculos, e bastam 29 segmentos para guardar `INT_MAX` termos, pelo que o
+// directório dos segmentos pode ter um comprimento fixo e nunca tem de crescer.
+#define first_chunk_length_log2 3
+#define first_chunk_length (1 << first_chunk_length_log2)
+#define maximum_number_of_chunks (32 - first_chunk_length_log2)
+
+// A dimensão, em _bytes_, das páginas enormes (_huge pages_) usuais. Os
+// segmentos pelo menos desta dimensão ficam alinhados com ela e são candidatos
+// a usar páginas enormes (ver `new_chunk()`).
+static const size_t huge_page_size = 2UL << 20;
+
+// ### Definição da estrutura `struct segmented_sequence_of_long`
+//
+// Esta estrutura contém os seguintes campos ou atributos:
+//
+// - `chunks` &ndash; O directório dos segmentos, i.e., um _array_ com os
+//   ponteiros para os segmentos já reservados.
+//
+// - `number_of_chunks` &ndash; O número de segmentos já reservados.
+//
+// - `length` &ndash; O comprimento actual da sucessão.
+//
+// - `next` e `end` &ndash; Os ponteiros para a posição do último segmento
+//   onde será guardado o próximo termo e para o final desse segmento. Permitem
+//   que as adições não tenham de calcular o segmento e a posição do novo termo.
+struct segmented_sequence_of_longs {
+	long *chunks[maximum_number_of_chunks];
+	int number_of_chunks;
+	int length;
+	long *next;
+	long *end;
+};
+
+// ### Rotinas auxiliares
+//
+// Esta função devolve ⌊log<sub>2</sub>(_n_)⌋, para _n_ > 0. Com o GCC (e
+// compiladores compatíveis) usa-se a contagem dos _bits_ a zero à esquerda,
+// que corresponde a uma única instrução na maior parte dos processadores.
+static inline int floor_log2(const unsigned n)
+{
+#if defined(__GNUC__)
+	return (int)(sizeof(unsigned) * CHAR_BIT) - 1 - __builtin_clz(n);
+#else
+	int log2 = 0;
+	for (unsigned m = n; m > 1U; m >>= 1)
+		log2++;
+	return log2;
+#endif
+}
+
+// Esta função reserva um novo segmento com `chunk_length` termos, devolvendo
+// `NULL` em caso de erro. A memória dos segmentos grandes só é realmente
+// obtida quando os termos são escritos pela primeira vez, através de uma falha
+// de página por cada página tocada. Com páginas de 4 KiB, isso aconteceria em
+// cada 512 adições, o que se reflectiria nos percentis mais altos das
+// latências. Por isso, os segmentos grandes são alinhados com as páginas
+// enormes e sugere-se ao núcleo que as use, tal como no TAD
+// `sequence_of_longs`.
+static long *new_chunk(const size_t chunk_length)
+{
+	const size_t size = chunk_length * sizeof(long);
+
+	if (size < huge_page_size)
+		return malloc(size);
+
+	void *chunk;
+	if (posix_memalign(&chunk, huge_page_size, size) != 0)
+		return NULL;
+
+#ifdef MADV_HUGEPAGE
+	madvise(chunk, size, MADV_HUGEPAGE);
+#endif
+
+	return chunk;
+}
+
+// ### Implementação dos procedimentos que imprimem as sucessões
+//
+// Percorre-se os termos segmento a segmento, evitando o cálculo do segmento e
+// da posição de cada termo.
+void SSEQL_print(struct segmented_sequence_of_longs *sl)
+{
+	struct buffered_output output;
+	buffered_output_start(&output, stdout);
+	buffered_output_char(&output, '{');
+	int printed = 0;
+	for (int k = 0; printed != sl->length; k++) {
+		const int chunk_length = first_chunk_length << k;
+		for (int j = 0; j != chunk_length && printed != sl->length; j++) {
+			if (printed++ != 0)
+				buffered_output_string(&output, ", ");
+			buffered_output_long(&output, sl->chunks[k][j]);
+		}
+	}
+	buffered_output_char(&output, '}');
+	buffered_output_finish(&output);
+}
+
+void SSEQL_println(struct segmented_sequence_of_longs *sl)
+{
+	SSEQL_print(sl);
+	putchar('\n');
+}
+
+// ### Implementação do construtor do TAD
+//
+// Os segmentos só são reservados quando são necessários, pelo que a construção
+// de uma sucessão vazia não reserva qualquer segmento.
+struct segmented_sequence_of_longs *SSEQL_new(void)
+{
+	struct segmented_sequence_of_longs *sl =
+		malloc(sizeof(struct segmented_sequence_of_longs));
+
+	if (sl == NULL)
+		return NULL;
+
+	sl->number_of_chunks = 0;
+	sl->length = 0;
+	sl->next = NULL;
+	sl->end = NULL;
+
+	return sl;
+}
+
+// ### Implementação do destrutor do TAD
+//
+void SSEQL_free(struct segmented_sequence_of_longs *sl)
+{
+	if (sl == NULL)
+		return;
+
+	for (int k = 0; k != sl->number_of_chunks; k++)
+		free(sl->chunks[k]);
+
+	free(sl);
+}
+
+// ### Implementação do _inspector_ do comprimento
+//
+int SSEQL_length(struct segmented_sequence_of_longs *sl)
+{
+	return sl->length;
+}
+
+// ### Implementação do _modificador_ de adição de um novo termo à sucessão
+//
+// Quando o último segmento está cheio, reserva-se o segmento seguinte, com o
+// dobro do comprimento, e regista-se o seu endereço no directório. Os termos
+// existentes não são copiados. O comprimento é verificado antes de cada adição,
+// e não apenas quando o segmento está cheio, pois o último segmento tem espaço
+// para mais do que `INT_MAX` termos.
+bool SSEQL_add(struct segmented_sequence_of_longs *sl, long new_term)
+{
+	if (sl->length == INT_MAX)
+		return true;
+
+	if (sl->next == sl->end) {
+		const int k = sl->number_of_chunks;
+		const size_t chunk_length = (size_t)first_chunk_length << k;
+		long *const chunk = new_chunk(chunk_length);
+
+		if (chunk == NULL)
+			return true;
+
+		sl->chunks[k] = chunk;
+		sl->number_of_chunks++;
+		sl->next = chunk;
+		sl->end = chunk + chunk_length;
+	}
+
+	*sl->next++ = new_term;
+	sl->length++;
+
+	return false;
+}
+
+// ### Implementação dos _inspectores_ de termo
+//
+// O cálculo é feito com aritmética sem sinal, para que `index` +
+// 2<sup>_s_</sup> não transborde quando `index` está próximo de `INT_MAX`.
+long *SSEQL_term_address(struct segmented_sequence_of_longs *sl, int index)
+{
+	const unsigned shifted_index = (unsigned)index + first_chunk_length;
+	const int k = floor_log2(shifted_index) - first_chunk_length_log2;
+
+	return sl->chunks[k] + (shifted_index -
+				((unsigned)first_chunk_length << k));
+}
+
+long SSEQL_term(struct segmented_sequence_of_longs *sl, int index)
+{
+	return *SSEQL_term_address(sl, index);
+}
@@ -0,0 +1,177 @@
+// `segmented_sequence_of_longs.h` &ndash; Interface das sucessões segmentadas de `long`
+// ===================================================================================
+
+// Interface do módulo físico `segmented_sequence_of_longs`
+// --------------------------------------------------------
+//
+// Para uma explicação mais pormenorizada das várias partes deste ficheiro,
+// consultar a explicação do correspondente ficheiro
+// [`sequence_of_longs.h`](sequence_of_longs.h.html).
+//
+// Este ficheiro de cabeçalho destina-se a ser utilizado pelo código cliente do
+// módulo físico `segmented_sequence_of_longs`. A implementação deste módulo
+// encontra-se no ficheiro de implementação
+// [`segmented_sequence_of_longs.c`](segmented_sequence_of_longs.c.html). Este
+// módulo físico contém o TAD (Tipo Abstracto de Dados) sucessão segmentada de
+// `long`, com o mesmo nome que o módulo físico, i.e.,
+// `segmented_sequence_of_longs`.
+//
+// Trata-se de um TAD com a mesma funcionalidade que o TAD `sequence_of_longs`,
+// mas em que os termos são guardados em vários segmentos (_chunks_), cada um
+// com o dobro do comprimento do anterior, em vez de num único _array_ dinâmico.
+// Quando a capacidade se esgota, reserva-se um novo segmento, sem mover os
+// termos existentes. Daí que:
+//
+// - o tempo de adição de um novo termo seja constante no pior caso, e não
+//   apenas em termos amortizados, não havendo picos de latência proporcionais
+//   ao comprimento da sucessão;
+//
+// - os endereços dos termos nunca mudem, pelo que os ponteiros para termos
+//   obtidos através de `SSEQL_term_address()` se mantêm válidos enquanto a
+//   sucessão existir;
+//
+// - a memória reservada e não usada nunca exceda o comprimento do último
+//   segmento, tal como no TAD `sequence_of_longs`.
+//
+// O preço a pagar é um acesso aos termos ligeiramente mais caro: o segmento e
+// a posição de um termo no segmento obtêm-se a partir do seu índice através de
+// algumas operações sobre _bits_, em tempo constante.
+
+// ### Comentário de documentação do ficheiro de cabeçalho
+//
+/**
+ * \file segmented_sequence_of_longs.h
+ * \brief Header file for the `segmented_sequence_of_longs` module, containing
+ * the ADT (Abstract Data Type) with the same name:
+ * `segmented_sequence_of_longs`.
+ *
+ * This header file declares the basic structure used to store the segmented
+ * sequences of longs and all the routines used to manipulate these sequences.
+ */
+
+// ### Protecção contra inclusões múltiplas
+//
+#ifndef ISLA_EDA_SEGMENTED_SEQUENCE_OF_LONGS_H_INCLUDED
+#define ISLA_EDA_SEGMENTED_SEQUENCE_OF_LONGS_H_INCLUDED
+
+// Incluímos o ficheiro de interface `stdbool.h` para podermos usar o tipo
+// `bool` e os seus dois valores `true` e `false`.
+#include <stdbool.h>
+
+// ### Comentário de documentação da `struct` `segmented_sequence_of_longs`
+//
+/** \brief C structure used to represent the segmented sequence of `long`s and
+ * to store its terms.
+ *
+ * This TAD guarantees constant time additions of new terms in the worst case
+ * and terms whose addresses never change. The terms are stored in chunks whose
+ * lengths double from one chunk to the next. The memory allocated may approach
+ * the double of the minimum strictly necessary memory.
+ */
+// ### Declaração da `struct` que representa as sucessões segmentadas de `long`
+//
+struct segmented_sequence_of_longs;
+
+// ### Construtor do TAD
+//
+/** \brief Returns a pointer to a newly created and initialized
+ * `segmented_sequence_of_longs`.
+ *
+ * \return A pointer to a newly (heap) allocated and initialized
+ * `struct segmented_sequence_of_longs`, or `NULL` if memory could not be
+ * allocated.
+ * \post The returned pointer, if not null, refers to a new
+ * `struct segmented_sequence_of_longs` representing an empty (i.e., length 0)
+ * sequence of `long`s.
+ *
+ * This function is a constructor of the segmented sequence of `long`s ADT.
+ */
+struct segmented_sequence_of_longs *SSEQL_new(void);
+
+// ### Destrutor do TAD
+//
+/** \brief Destroys the given sequence of `long`s, releasing all the memory it
+ * uses.
+ *
+ * \param sl A pointer to the sequence of `long`s to destroy, or `NULL`, in
+ * which case nothing is done.
+ * \post `sl` no longer refers to a valid sequence.
+ *
+ * This procedure is the destructor of the segmented sequence of `long`s ADT.
+ */
+void SSEQL_free(struct segmented_sequence_of_longs *sl);
+
+// ### Operações do TAD
+
+/** \brief Prints the sequence of longs in the format `{term_1, ... term_n}`.
+ *
+ * \param sl A pointer to the sequence of `long`s to print.
+ * \pre `sl` ≠ null
+ */
+void SSEQL_print(struct segmented_sequence_of_longs *sl);
+
+/** \brief Prints the sequence of longs in the format `{term_1, ... term_n}` and
+ * ends the line with `\n`.
+ *
+ * \param sl A pointer to the sequence of `long`s to print.
+ * \pre `sl` ≠ null
+ */
+void SSEQL_println(struct segmented_sequence_of_longs *sl);
+
+/** \brief Returns the number of terms so far in a given sequence of `long`s.
+ *
+ * \param sl A pointer to the sequence of `long`s whose length will be returned.
+ * \return The number of terms in the sequence so far.
+ * \pre `sl` ≠ null
+ */
+int SSEQL_length(struct segmented_sequence_of_longs *sl);
+
+/** \brief Adds a given value as a further term of the given sequence of
+ * `long`s.
+ *
+ * \param sl A pointer to the sequence of `long`s to which the new term will be
+ * added.
+ * \param new_term The new term to add to the sequence.
+ * \return `true` if memory could not be allocated, `false` otherwise.
+ * \post If `false` is returned, the sequence contains the same terms it
+ * contained before, in the same order and at the same addresses, plus the new
+ * term in its last position. Otherwise, the sequence is unchanged.
+ * \pre `sl` ≠ null
+ *
+ * The time required to add the new term is constant in the worst case (not
+ * counting the time taken by `malloc()` when a new chunk is needed), since the
+ * existing terms are never moved.
+ */
+bool SSEQL_add(struct segmented_sequence_of_longs *sl, long new_term);
+
+/** \brief Returns the term of the given sequence at the given position or
+ * index.
+ *
+ * \param sl A pointer to the sequence of `long`s whose term will be returned.
+ * \param index The index or position of the term of the sequence to return.
+ * \return The term of the sequence given in the position or index given.
+ * \pre `sl` ≠ null
+ * \pre 0 ≤ `index` < `SSEQL_length(sl)`
+ */
+long SSEQL_term(struct segmented_sequence_of_longs *sl, int index);
+
+/** \brief Returns the address of the term of the given sequence at the given
+ * position or index.
+ *
+ * \param sl A pointer to the sequence of `long`s whose term address will be
+ * returned.
+ * \param index The index or position of the term of the sequence.
+ * \return The address of the term of the sequence given in the position or
+ * index given.
+ * \pre `sl` ≠ null
+ * \pre 0 ≤ `index` < `SSEQL_length(sl)`
+ *
+ * The address remains valid, and keeps referring to the same term, until the
+ * sequence is destroyed.
+ */
+long *SSEQL_term_address(struct segmented_sequence_of_longs *sl, int index);
+
+// ### Fim do ficheiro
+//
+// Final da instrução condicional do pré-processador.
+#endif // ISLA_EDA_SEGMENTED_SEQUENCE_OF_LONGS_H_INCLUDED
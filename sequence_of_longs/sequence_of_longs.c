@@ -18,6 +18,13 @@
 // relevante na documentação do módulo físico, já que esta está relacionada
 // apenas com a sua interface.
   
+// ### Pedido das extensões GNU
+//
+// A rotina `mremap()`, usada para estender os _arrays_ dos termos das sucessões
+// grandes, é uma extensão do Linux. Para que a sua declaração fique visível, a
+// macro `_GNU_SOURCE` tem de ser definida antes de qualquer inclusão.
+#define _GNU_SOURCE
+
 // ### Inclusão do cabeçalho correspondente a esta implementação
 //
 // Antes de qualquer outra inclusão, incluímos o ficheiro de cabeçalho
@@ -31,20 +38,98 @@
 // Estas inclusões ser feita apenas _após_ se incluir o ficheiro de cabeçalho
 // corresponde ao próprio ficheiro de implementação. Neste caso temos:
 //
-// - `stdio.h` &ndash; Necessário para poder usar os procedimentos `printf()` e
-//   `putchar()`.
+// - `stdio.h` &ndash; Necessário para poder usar o procedimento `putchar()`, o
+//   canal `stdout` e as rotinas de escrita em ficheiros `fopen()`, `fwrite()`,
+//   `fclose()` e `remove()`.
+//
+// - `stdlib.h` &ndash; Necessário para se poder usar a macro `NULL` e as
+//   rotinas  `malloc()`, `free()` e `realloc()`.
+//
+// - `string.h` &ndash; Necessário para se poder usar as rotinas `memcpy()` e
+//   `memcmp()`.
+//
+// - `stdint.h` &ndash; Necessário para se poder usar os tipos `uint32_t` e
+//   `uint64_t`, com dimensões fixas, usados no cabeçalho dos ficheiros.
+//
+// - `limits.h` &ndash; Necessário para se poder usar a macro `INT_MAX`.
+//
+// - `unistd.h` &ndash; Necessário para se poder usar a rotina `sysconf()`, que
+//   nos dá a dimensão das páginas de memória, e a rotina `close()`.
 //
-// - `stdlib.h` &ndash; Necessário para se poder usar a macro `NULL` (que será
-//   usada no futuro) e as rotinas  `malloc()`, `free()` e `realloc()`.
+// - `fcntl.h` e `sys/stat.h` &ndash; Necessários para se poder usar as rotinas
+//   `open()` e `fstat()`.
+//
+// - `sys/mman.h` &ndash; Necessário para se poder usar as rotinas `mmap()`,
+//   `mremap()`, `munmap()` e `madvise()`.
+//
+// - `buffered_output.h` &ndash; Necessário para se poder usar a biblioteca de
+//   escrita com _buffer_ (ver
+//   [`buffered_output.h`](../buffered_output/buffered_output.h.html)).
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "buffered_output.h"
+
+// ### Definição de constantes
+//
+// A dimensão, em _bytes_, a partir da qual, por omissão, os termos das
+// sucessões são guardados em páginas de memória mapeadas directamente através
+// de `mmap()`, e não no monte. Corresponde a 512 Ki termos.
+static const size_t default_mapping_threshold = 4UL << 20;
+
+// ### Definição do formato dos ficheiros
+//
+// Os ficheiros escritos por `SEQL_save()` começam por um cabeçalho com 64
+// _bytes_, seguido dos termos, tal como estão guardados em memória. Como a
+// dimensão do cabeçalho é múltipla da dimensão de um `long` e os mapeamentos
+// começam sempre no início de uma página, os termos mapeados ficam alinhados e
+// podem ser usados directamente. O cabeçalho contém:
+//
+// - `magic` &ndash; A cadeia `EDASEQL`, que identifica o formato.
+//
+// - `version` &ndash; A versão do formato, a alterar sempre que o formato
+//   mudar de forma incompatível.
+//
+// - `term_size` &ndash; A dimensão de um `long`, em _bytes_.
+//
+// - `byte_order_mark` &ndash; Um valor conhecido, cujos _bytes_ ficam por ordem
+//   diferente em máquinas com ordenações diferentes (_endianness_).
+//
+// - `length` &ndash; O comprimento da sucessão.
+//
+// - `sum` e `weighted_sum` &ndash; A soma de verificação dos termos (ver
+//   `checksum()`).
+//
+// - `reserved` &ndash; Espaço reservado para futuras versões, a zero.
+struct file_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t term_size;
+	uint64_t byte_order_mark;
+	uint64_t length;
+	uint64_t sum;
+	uint64_t weighted_sum;
+	uint64_t reserved[2];
+};
+
+static const char file_magic[8] = "EDASEQL";
+static const uint32_t file_version = 1;
+static const uint64_t file_byte_order_mark = 0x0102030405060708ULL;
 
 // ### Definição da estrutura `struct sequence_of_long`
 //
-// Esta estrutura contém três campos ou atributos:
+// Esta estrutura contém onze campos ou atributos:
 //
 // - `terms` &ndash; Um ponteiro para o _array_ dinâmico que contém os termos da
-//   sucessão.
+//   sucessão, ou para o _array_ `small_terms`, se os termos ainda lá
+//   couberem.
 //
 // - `length` &ndash; Inteiro guardando o comprimento actual da sucessão, i.e.,
 //   o seu número de termos. Note que o comprimento da sucessão é sempre
@@ -53,12 +138,361 @@
 //
 // - `capacity` &ndash; Inteiro guardando o comprimento actual do `array`
 //   dinâmico que guarda os `length` termos actualmente na sucessão.
+//
+// - `growth_policy` &ndash; A política usada para aumentar a capacidade quando
+//   esta se esgota.
+//
+// - `growth_factor` &ndash; O factor de crescimento usado pela política
+//   `SEQL_factor_growth`.
+//
+// - `mapping_threshold` &ndash; A dimensão, em _bytes_, a partir da qual o
+//   _array_ dos termos é guardado em páginas mapeadas.
+//
+// - `mapped` &ndash; Booleano indicando se o _array_ dos termos está guardado
+//   em páginas mapeadas (`true`) ou no monte (`false`).
+//
+// - `file_mapping` &ndash; O endereço do mapeamento do ficheiro de onde os
+//   termos são lidos, se a sucessão tiver sido construída através de
+//   `SEQL_open_mapped()` e os seus termos ainda não tiverem sido copiados, ou
+//   `NULL`, caso contrário. Nesse caso, `terms` aponta para os termos dentro
+//   do mapeamento, que só pode ser lido, e `mapped` é `false`.
+//
+// - `file_mapping_size` &ndash; A dimensão, em _bytes_, desse mapeamento.
+//
+// - `statistics` &ndash; Um ponteiro para a estrutura onde se acumulam as
+//   estatísticas das alterações da capacidade, ou `NULL`, se estas não
+//   estiverem a ser recolhidas.
+//
+// - `small_terms` &ndash; O _array_ onde se guardam os termos enquanto a
+//   capacidade necessária não exceder `SEQL_SMALL_CAPACITY`. Assim, uma
+//   sucessão curta ocupa um único bloco de memória, reservado de uma só vez,
+//   e o acesso aos seus termos não obriga a seguir um ponteiro para outro
+//   bloco, possivelmente distante. Como `terms` aponta para dentro da
+//   própria estrutura, esta não pode ser copiada nem movida.
 struct sequence_of_longs {
 	long *terms;
 	int length;
 	int capacity;
+	enum SEQL_growth_policy growth_policy;
+	double growth_factor;
+	size_t mapping_threshold;
+	bool mapped;
+	void *file_mapping;
+	size_t file_mapping_size;
+	struct SEQL_statistics *statistics;
+	long small_terms[SEQL_SMALL_CAPACITY];
 };
 
+// O armazenamento fornecido pelo código cliente a `SEQL_init()` tem de ter
+// espaço para a estrutura. Se não tiver, a compilação falha, devendo
+// aumentar-se `SEQL_STORAGE_SIZE` no ficheiro de interface.
+_Static_assert(sizeof(struct sequence_of_longs) <= SEQL_STORAGE_SIZE,
+	       "SEQL_STORAGE_SIZE is too small for struct sequence_of_longs");
+
+// ### Rotinas auxiliares de gestão da capacidade
+//
+// Estas rotinas são `static`, ou seja, são privadas deste ficheiro de
+// implementação, não fazendo parte da interface do módulo.
+
+// Esta função devolve a capacidade que deve seguir-se a `capacity` de acordo
+// com a política `policy` (e o factor `factor`, se a política for
+// `SEQL_factor_growth`), nunca inferior a `minimum` nem superior a `INT_MAX`.
+// Os cálculos são feitos com `long` (ou `double`), para evitar
+// transbordamentos.
+static int grown_capacity(const int capacity, const int minimum,
+			  const enum SEQL_growth_policy policy,
+			  const double factor)
+{
+	long grown;
+
+	switch (policy) {
+	case SEQL_factor_growth: {
+		const double product = capacity * factor;
+		grown = product > INT_MAX ? INT_MAX : (long)product;
+		if (grown <= capacity)
+			grown = capacity + 1L;
+		break;
+	}
+	case SEQL_one_and_a_half_growth:
+		grown = capacity + capacity / 2L + 1L;
+		break;
+	case SEQL_page_multiple_growth: {
+		// Arredonda-se o número de termos para cima de modo a que o
+		// _array_ ocupe um número inteiro de páginas, como acontece
+		// sempre com os _arrays_ guardados em páginas mapeadas (ver
+		// `change_capacity()`).
+		const long terms_per_page = sysconf(_SC_PAGESIZE) /
+			(long)sizeof(long);
+		grown = 2L * capacity;
+		if (grown < minimum)
+			grown = minimum;
+		grown = (grown + terms_per_page - 1L) / terms_per_page *
+			terms_per_page;
+		break;
+	}
+	default:
+		grown = 2L * capacity;
+	}
+
+	if (grown < minimum)
+		grown = minimum;
+
+	return grown > INT_MAX ? INT_MAX : (int)grown;
+}
+
+// Esta função indica se os termos da sucessão estão guardados na própria
+// estrutura.
+static bool has_small_terms(struct sequence_of_longs *sl)
+{
+	return sl->terms == sl->small_terms;
+}
+
+// Esta função devolve a dimensão, em _bytes_, das páginas mapeadas necessárias
+// para guardar `capacity` termos, ou seja, a dimensão dos termos arredondada
+// para cima para um número inteiro de páginas.
+static size_t mapping_size_for(const int capacity)
+{
+	const size_t page_size = sysconf(_SC_PAGESIZE);
+
+	return ((size_t)capacity * sizeof(long) + page_size - 1) / page_size *
+		page_size;
+}
+
+// Este procedimento sugere ao núcleo do sistema operativo que use páginas
+// enormes (_huge pages_, tipicamente de 2 MiB) nas `size` _bytes_ mapeadas a
+// partir de `terms`, o que reduz as falhas de página e as falhas na TLB. É
+// apenas uma sugestão, pelo que o seu resultado é ignorado.
+static void advise_huge_pages(long *const terms, const size_t size)
+{
+#ifdef MADV_HUGEPAGE
+	madvise(terms, size, MADV_HUGEPAGE);
+#else
+	(void)terms;
+	(void)size;
+#endif
+}
+
+// Este procedimento actualiza as estatísticas da sucessão, se estiverem a ser
+// recolhidas, depois de uma alteração da capacidade que copiou `bytes_copied`
+// _bytes_ de termos.
+static void record_capacity_change(struct sequence_of_longs *sl,
+				   const size_t bytes_copied)
+{
+	struct SEQL_statistics *const statistics = sl->statistics;
+
+	if (statistics == NULL)
+		return;
+
+	const long slack = (long)(sl->capacity - sl->length) *
+		(long)sizeof(long);
+
+	statistics->reallocations++;
+	statistics->bytes_copied += (long)bytes_copied;
+	if (slack > statistics->peak_slack)
+		statistics->peak_slack = slack;
+}
+
+// Este procedimento liberta a memória onde os termos estão guardados (se não
+// estiverem na própria estrutura), através de `munmap()` ou de `free()`,
+// consoante o local onde está guardada, desfazendo o mapeamento do ficheiro, se
+// for caso disso.
+static void release_terms(struct sequence_of_longs *sl)
+{
+	if (sl->file_mapping != NULL)
+		munmap(sl->file_mapping, sl->file_mapping_size);
+	else if (sl->mapped)
+		munmap(sl->terms, mapping_size_for(sl->capacity));
+	else if (!has_small_terms(sl))
+		free(sl->terms);
+}
+
+// Este procedimento passa os termos para a própria estrutura, libertando a
+// memória onde estavam guardados. A capacidade passa a ser
+// `SEQL_SMALL_CAPACITY`, que não pode ser inferior ao comprimento.
+static void move_to_small_terms(struct sequence_of_longs *sl)
+{
+	const size_t used_size = (size_t)sl->length * sizeof(long);
+
+	memcpy(sl->small_terms, sl->terms, used_size);
+	release_terms(sl);
+
+	sl->terms = sl->small_terms;
+	sl->capacity = SEQL_SMALL_CAPACITY;
+	sl->mapped = false;
+	sl->file_mapping = NULL;
+	sl->file_mapping_size = 0;
+
+	record_capacity_change(sl, used_size);
+}
+
+// Este procedimento copia os termos de uma sucessão mapeada a partir de um
+// ficheiro para um novo _array_ com capacidade para `new_capacity` termos,
+// guardado na própria estrutura, no monte ou em páginas mapeadas, consoante a
+// sua dimensão, e desfaz o mapeamento do ficheiro. A partir daí, a sucessão é
+// igual a qualquer outra. Devolve `true` em caso de erro, deixando a sucessão
+// inalterada.
+static bool copy_file_terms(struct sequence_of_longs *sl,
+			    const int new_capacity)
+{
+	if (new_capacity <= SEQL_SMALL_CAPACITY) {
+		move_to_small_terms(sl);
+		return false;
+	}
+
+	const size_t size = (size_t)new_capacity * sizeof(long);
+	const bool mapped = size >= sl->mapping_threshold;
+	const size_t new_size = mapped ? mapping_size_for(new_capacity) : size;
+	long *new_terms;
+
+	if (mapped) {
+		new_terms = mmap(NULL, new_size, PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (new_terms == MAP_FAILED)
+			return true;
+		advise_huge_pages(new_terms, new_size);
+	} else {
+		new_terms = malloc(size);
+		if (new_terms == NULL)
+			return true;
+	}
+
+	memcpy(new_terms, sl->terms, (size_t)sl->length * sizeof(long));
+	munmap(sl->file_mapping, sl->file_mapping_size);
+
+	sl->terms = new_terms;
+	sl->capacity = new_size / sizeof(long) > INT_MAX ?
+		INT_MAX : (int)(new_size / sizeof(long));
+	sl->mapped = mapped;
+	sl->file_mapping = NULL;
+	sl->file_mapping_size = 0;
+
+	record_capacity_change(sl, (size_t)sl->length * sizeof(long));
+
+	return false;
+}
+
+// Este procedimento altera a capacidade do _array_ dinâmico que guarda os
+// termos da sucessão para `new_capacity`, que não pode ser inferior ao
+// comprimento da sucessão. Devolve `true` em caso de erro, deixando a sucessão
+// inalterada.
+//
+// Os termos cuja capacidade não excede `SEQL_SMALL_CAPACITY` são guardados na
+// própria estrutura. A capacidade só desce até esse valor por redução (ver
+// `SEQL_shrink_to_fit()`), pois nunca é inferior a `SEQL_SMALL_CAPACITY`.
+// Quando os termos deixam de caber na estrutura, são copiados para um novo
+// _array_, pois `realloc()` só pode ser usada sobre memória reservada no
+// monte.
+//
+// Os restantes _arrays_ pequenos são guardados no monte. Ao contrário do
+// idiomático (mas perigoso) `sl->terms = realloc(sl->terms, ...)`, o resultado
+// de `realloc()` é guardado num ponteiro auxiliar: em caso de falha,
+// `realloc()` devolve `NULL` mas não liberta o _array_ original, que se
+// perderia se o seu endereço fosse imediatamente substituído.
+//
+// Os _arrays_ grandes são guardados em páginas mapeadas através de `mmap()` e
+// estendidos através de `mremap()`. Com a opção `MREMAP_MAYMOVE`, o núcleo pode
+// mudar as páginas de endereço quando não as consegue estender no local, mas
+// fá-lo alterando apenas a tabela de páginas, sem copiar os termos. Assim,
+// depois da passagem do monte para as páginas mapeadas, que obriga a uma
+// cópia, as re-reservas deixam de ter um custo proporcional ao comprimento da
+// sucessão. A capacidade aproveita as páginas mapeadas por inteiro.
+//
+// Para as estatísticas, considera-se que `realloc()` copiou os termos se os
+// mudou de endereço. O endereço original é guardado como inteiro antes da
+// invocação, pois o valor de um ponteiro para memória libertada é
+// indeterminado.
+static bool change_capacity(struct sequence_of_longs *sl,
+			    const int new_capacity)
+{
+	if (sl->file_mapping != NULL)
+		return copy_file_terms(sl, new_capacity);
+
+	if (new_capacity <= SEQL_SMALL_CAPACITY) {
+		if (!has_small_terms(sl))
+			move_to_small_terms(sl);
+		return false;
+	}
+
+	const size_t size = (size_t)new_capacity * sizeof(long);
+	const size_t used_size = (size_t)sl->length * sizeof(long);
+	long *new_terms;
+
+	if (size < sl->mapping_threshold) {
+		size_t bytes_copied = used_size;
+
+		if (has_small_terms(sl)) {
+			new_terms = malloc(size);
+			if (new_terms == NULL)
+				return true;
+			memcpy(new_terms, sl->terms, used_size);
+		} else if (!sl->mapped) {
+			const uintptr_t old_address = (uintptr_t)sl->terms;
+			new_terms = realloc(sl->terms, size);
+			if (new_terms == NULL)
+				return true;
+			if ((uintptr_t)new_terms == old_address)
+				bytes_copied = 0;
+		} else {
+			new_terms = malloc(size);
+			if (new_terms == NULL)
+				return true;
+			memcpy(new_terms, sl->terms, used_size);
+			munmap(sl->terms, mapping_size_for(sl->capacity));
+		}
+
+		sl->terms = new_terms;
+		sl->capacity = new_capacity;
+		sl->mapped = false;
+
+		record_capacity_change(sl, bytes_copied);
+
+		return false;
+	}
+
+	const size_t new_size = mapping_size_for(new_capacity);
+	size_t bytes_copied = 0;
+
+	if (sl->mapped) {
+		new_terms = mremap(sl->terms, mapping_size_for(sl->capacity),
+				   new_size, MREMAP_MAYMOVE);
+		if (new_terms == MAP_FAILED)
+			return true;
+	} else {
+		new_terms = mmap(NULL, new_size, PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (new_terms == MAP_FAILED)
+			return true;
+		memcpy(new_terms, sl->terms, used_size);
+		if (!has_small_terms(sl))
+			free(sl->terms);
+		bytes_copied = used_size;
+	}
+
+	advise_huge_pages(new_terms, new_size);
+
+	sl->terms = new_terms;
+	sl->capacity = new_size / sizeof(long) > INT_MAX ?
+		INT_MAX : (int)(new_size / sizeof(long));
+	sl->mapped = true;
+
+	record_capacity_change(sl, bytes_copied);
+
+	return false;
+}
+
+// Este procedimento garante que a sucessão tem capacidade para pelo menos
+// `minimum` termos, aumentando-a de acordo com a política de crescimento da
+// sucessão, se necessário. Devolve `true` em caso de erro.
+static bool ensure_capacity(struct sequence_of_longs *sl, const int minimum)
+{
+	if (minimum <= sl->capacity)
+		return false;
+
+	return change_capacity(sl, grown_capacity(sl->capacity, minimum,
+						  sl->growth_policy,
+						  sl->growth_factor));
+}
+
 // ### Implementação dos procedimentos que imprimem as sucessões
 //
 // Note-se que todas as rotinas de manipulação das sucessões, com excepção
@@ -67,10 +501,20 @@ struct sequence_of_longs {
 // em todas as definições de rotinas abaixo, com a excepção referida.
 void SEQL_print(struct sequence_of_longs *sl)
 {
-	// O procedimento `putchar()` imprime no ecrã o caractere que recebe
-	// como argumento. Neste caso trata-se da chaveta inicial da
-	// representação textual da sucessão.
-	putchar('{');
+	// Uma sucessão pode ter milhões de termos. Imprimir cada um através de
+	// `printf()` seria muito lento, pois cada invocação tem de interpretar
+	// a cadeia de formatação. Por isso, acumulamos a representação textual
+	// da sucessão num _buffer_ colocado na pilha, que é escrito de uma só
+	// vez sempre que fica cheio, e no final. O início da escrita esvazia o
+	// _buffer_ de `stdout`, pelo que o que tiver sido impresso antes
+	// através de `printf()` surge antes da sucessão.
+	struct buffered_output output;
+	buffered_output_start(&output, stdout);
+
+	// O procedimento `buffered_output_char()` acrescenta ao _buffer_ o
+	// caractere que recebe como argumento. Neste caso trata-se da chaveta
+	// inicial da representação textual da sucessão.
+	buffered_output_char(&output, '{');
 
 	// Depois de impressa a chaveta inicial, imprimimos cada um dos termos
 	// da sucessão usando um ciclo `for`. Note que o ciclo imprime apenas os
@@ -82,16 +526,18 @@ void SEQL_print(struct sequence_of_longs *sl)
 		// caractere `␣` para representar o espaço). Assim, podemos
 		// preceder cada termo do separador _com excepção do primeiro_.
 		if (i != 0)
-			printf(", ");
+			buffered_output_string(&output, ", ");
 
-		// Imprimimos cada termo usando a especificação de conversão
-		// `%ld`, e não simplesmente `%d`, pois os termos da sucessão
-		// são `long`.
-		printf("%ld", sl->terms[i]);
+		// Imprimimos cada termo convertendo-o directamente para
+		// decimal, tal como faria `printf()` com a especificação de
+		// conversão `%ld`.
+		buffered_output_long(&output, sl->terms[i]);
 	}
 
-	// Terminamos imprimindo a chaveta de fecho.
-	putchar('}');
+	// Terminamos imprimindo a chaveta de fecho e escrevendo o que resta no
+	// _buffer_.
+	buffered_output_char(&output, '}');
+	buffered_output_finish(&output);
 }
 
 void SEQL_println(struct sequence_of_longs *sl)
@@ -104,8 +550,42 @@ void SEQL_println(struct sequence_of_longs *sl)
 	putchar('\n');
 }
 
-// ### Implementação do construtor do TAD
+// ### Implementação dos construtores do TAD
 //
+// Este procedimento inicializa os campos ou atributos da estrutura apontada
+// por `sl` com valores apropriados para uma sucessão vazia. É usado por ambos
+// os construtores, que diferem apenas no local onde a estrutura é guardada.
+static void initialize(struct sequence_of_longs *sl)
+{
+	// O comprimento de uma sucessão vazia é naturalmente 0. A capacidade do
+	// _array_ que guarda os termos também poderia ser inicialmente 0. No
+	// entanto, como se verá mais abaixo, a estratégia usada é a de duplicar
+	// a capacidade sempre que ela está esgotada e se pretende adicionar um
+	// termo à sucessão. Ora, uma capacidade de 0 estaria esgotada logo na
+	// primeira adição de um termo e, pior, o dobro de 0 é... 0! É mais
+	// sensato, por isso, começar com um capacidade maior que zero. Quanto
+	// maior for a capacidade inicial, maior a eficiência das adições, mas
+	// pior a eficiência na utilização da memória. Neste caso, os primeiros
+	// termos são guardados no _array_ `small_terms`, que faz parte da
+	// própria estrutura e tem, por isso, de existir de qualquer forma. A
+	// capacidade inicial é, assim, `SEQL_SMALL_CAPACITY`, sem que seja
+	// necessário reservar qualquer memória adicional.
+	//
+	// Ah! E não se esqueça que o compilador traduz `sl->length` por
+	// `(*sl).length`. Ou seja, o significado de `sl->length` é «o campo
+	// `length` da estrutura apontada pelo ponteiro `sl`».
+	sl->terms = sl->small_terms;
+	sl->length = 0;
+	sl->capacity = SEQL_SMALL_CAPACITY;
+	sl->growth_policy = SEQL_doubling_growth;
+	sl->growth_factor = 2.0;
+	sl->mapping_threshold = default_mapping_threshold;
+	sl->mapped = false;
+	sl->file_mapping = NULL;
+	sl->file_mapping_size = 0;
+	sl->statistics = NULL;
+}
+
 struct sequence_of_longs *SEQL_new(void)
 {
 	// Reservamos primeiro espaço para uma nova `struct sequence_of_longs`
@@ -113,37 +593,18 @@ struct sequence_of_longs *SEQL_new(void)
 	// memória a reservar usando o operador `sizeof`. Guardamos o endereço
 	// dessa nova variável dinâmica no ponteiro `sl`, através do qual se
 	// passará a manipular a nova sucessão de `long`. No final do construtor
-	// este ponteiro será devolvido.
+	// este ponteiro será devolvido. Como os primeiros termos são guardados
+	// na própria estrutura, esta é a única reserva de memória necessária.
 	struct sequence_of_longs *sl = malloc(sizeof(struct sequence_of_longs));
 
-	// De seguida inicializamos os campos ou atributos da rotina com valores
-	// apropriados para uma sucessão vazia. O comprimento de uma sucessão
-	// vazia é naturalmente 0. A capacidade do _array_ dinâmico que guarda
-	// os termos também poderia ser inicialmente 0. No entanto, como se verá
-	// mais abaixo, a estratégia usada é a de duplicar a capacidade sempre
-	// que ela está esgotada e se pretende adicionar um termo à sucessão.
-	// Ora, uma capacidade de 0 estaria esgotada logo na primeira adição de
-	// um termo e, pior, o dobro de 0 é... 0! É mais sensato, por isso,
-	// começar com um capacidade maior que zero. Começar com 1 é uma
-	// possibilidade, embora qualquer outro valor positivo fosse igualmente
-	// eficaz. Quanto maior for a capacidade inicial, maior a eficiência das
-	// adições, mas pior a eficiência na utilização da memória. Daí que a
-	// escolha de uma capacidade inicial unitária não seja totalmente
-	// desprovida de sentido.
-	//
-	// Ah! E não se esqueça que o compilador traduz `sl->length` por
-	// `(*sl).length`. Ou seja, o significado de `sl->length` é «o campo
-	// `length` da estrutura apontada pelo ponteiro `sl`».
-	sl->length = 0;
-	sl->capacity = 1;
+	// A reserva de memória pode falhar. Nesse caso `malloc()` devolve
+	// `NULL`, que devolvemos também, assinalando assim o erro ao código
+	// cliente.
+	if (sl == NULL)
+		return NULL;
 
-	// Inicializados os campos que guardam o comprimento da sucessão e a
-	// capacidade do _array_ dinâmico que guarda os termos da sucessão, há
-	// que reservar espaço de memória para este _array_ e guardar o endereço
-	// do seu primeiro item no campo `terms`. É o que se faz aqui,
-	// recorrendo à rotina `malloc()`. Note-se que se reserva espaço
-	// suficiente para `sl->capacity` termos.
-	sl->terms = malloc(sl->capacity * sizeof(long));
+	// De seguida inicializamos os campos ou atributos da estrutura.
+	initialize(sl);
 
 	// Terminada a construção da nova sucessão, há que devolver o seu
 	// endereço (ou ponteiro), guardado na variável `sl`. Será através dele
@@ -152,6 +613,46 @@ struct sequence_of_longs *SEQL_new(void)
 	return sl;
 }
 
+// A estrutura é colocada no início do armazenamento fornecido, que tem
+// dimensão suficiente (ver a asserção estática junto à definição da
+// estrutura) e o alinhamento máximo, adequado a qualquer tipo.
+struct sequence_of_longs *SEQL_init(struct SEQL_storage *const storage)
+{
+	struct sequence_of_longs *const sl =
+		(struct sequence_of_longs *)storage->bytes;
+
+	initialize(sl);
+
+	return sl;
+}
+
+// ### Implementação dos destrutores do TAD
+//
+// O destrutor liberta o _array_ dos termos (ver `release_terms()`) e só
+// depois a própria estrutura. Note que o código cliente não pode usar
+// directamente `free()` sobre a sucessão, pois isso libertaria a estrutura mas
+// não o _array_ dos termos, cujo endereço se perderia.
+//
+void SEQL_free(struct sequence_of_longs *sl)
+{
+	if (sl == NULL)
+		return;
+
+	release_terms(sl);
+
+	free(sl);
+}
+
+// A estrutura de uma sucessão construída por `SEQL_init()` pertence ao código
+// cliente, pelo que apenas o _array_ dos termos é libertado.
+void SEQL_fini(struct sequence_of_longs *sl)
+{
+	if (sl == NULL)
+		return;
+
+	release_terms(sl);
+}
+
 // ### Implementação do _inspector_ do comprimento
 //
 // Dá-se o nome de inspector a uma função que permite obter uma propriedade de
@@ -164,66 +665,159 @@ int SEQL_length(struct sequence_of_longs *sl)
 	return sl->length;
 }
 
+// ### Implementação do _inspector_ da capacidade
+//
+int SEQL_capacity(struct sequence_of_longs *sl)
+{
+	return sl->capacity;
+}
+
+// ### Implementação do _modificador_ da política de crescimento
+//
+void SEQL_set_growth_policy(struct sequence_of_longs *sl,
+			    const enum SEQL_growth_policy policy)
+{
+	sl->growth_policy = policy;
+}
+
+void SEQL_set_growth_factor(struct sequence_of_longs *sl, const double factor)
+{
+	sl->growth_policy = SEQL_factor_growth;
+	sl->growth_factor = factor;
+}
+
+// ### Implementação do _modificador_ da recolha de estatísticas
+//
+void SEQL_set_statistics(struct sequence_of_longs *sl,
+			 struct SEQL_statistics *const statistics)
+{
+	sl->statistics = statistics;
+}
+
+// ### Implementação do _modificador_ do limiar de mapeamento
+//
+// O novo limiar só tem efeito na próxima alteração da capacidade.
+//
+void SEQL_set_mapping_threshold(struct sequence_of_longs *sl,
+				const size_t threshold)
+{
+	sl->mapping_threshold = threshold;
+}
+
 // ### Implementação do _modificador_ de adição de um novo termo à sucessão
 //
 // Dá-se o nome de modificador a um procedimento que altera uma instância de um
 // TAD. Neste caso o modificador é o procedimento `SEQL_add()`, que altera a
 // sucessão cujo ponteiro é `sl` adicionando-lhe um novo termo `new_term`.
 //
-void SEQL_add(struct sequence_of_longs *sl, long new_term)
+bool SEQL_add(struct sequence_of_longs *sl, long new_term)
 {
 	// Antes de adicionar o termo há que verificar se o _array_ dinâmico
 	// onde será guardado tem capacidade suficiente para ele. Se o
 	// comprimento actual da sucessão for igual à capacidade desse _array_,
-	// então a capacidade está esgotada, sendo necessário aumentá-la.
-	if (sl->length == sl->capacity)
-		// Para aumentar a capacidade, duplicamos o valor do campo
-		// `sl->capacity` e usamos a rotina `realloc()` para reservar um
-		// novo _array_ dinâmico com essa nova capacidade _e incluindo
-		// todos os termos que já constam na sucessão_. É este último
-		// requisito que nos leva a usar a rotina `realloc()`, e não a
-		// rotina `malloc()`. A rotina `realloc()`, se precisar de
-		// reservar nova memória, i.e., se não conseguir simplesmente
-		// estender o _array_ existente, copiará automaticamente os
-		// termos da memória original. É por isso que o primeiro
-		// argumento passado a `realloc()` é um ponteiro para o _array_
-		// original.
-		sl->terms = realloc(sl->terms,
-				    (sl->capacity *= 2) * sizeof(long));
-
-	// Estas linhas poderiam ser substituídas pelo código abaixo. À parte a
+	// então a capacidade está esgotada, sendo necessário aumentá-la. Para
+	// isso recorre-se ao procedimento auxiliar `ensure_capacity()`, que
+	// calcula a nova capacidade de acordo com a política de crescimento da
+	// sucessão (por omissão, a duplicação) e usa a rotina `realloc()` para
+	// reservar um novo _array_ dinâmico com essa nova capacidade _e
+	// incluindo todos os termos que já constam na sucessão_. É este último
+	// requisito que nos leva a usar a rotina `realloc()`, e não a rotina
+	// `malloc()`. A rotina `realloc()`, se precisar de reservar nova
+	// memória, i.e., se não conseguir simplesmente estender o _array_
+	// existente, copiará automaticamente os termos da memória original.
+	//
+	// Se o comprimento já for o maior valor que um `int` pode guardar, não
+	// há como aumentar a sucessão.
+	if (sl->length == INT_MAX || ensure_capacity(sl, sl->length + 1))
+		return true;
+
+	// A reserva poderia ser feita pelo código abaixo. À parte a
 	// possibilidade de estender o _array_ original, de que a rotina
 	// `realloc()` pode tirar partido, o resultado seria exactamente o
-	// mesmo. Preferimos, naturalmente, a versão mais curta... Quanto à
-	// duplicação da capacidade numa instrução à parte, é certamente
-	// preferível, mas é tão comum (idiomático) encontrar o código
-	// condensado numa única instrução, que optámos pela versão mais
-	// críptica.
+	// mesmo.
 	//
 	// ```C
 	// if (sl->length == sl->capacity) {
-	//	   sl->capacity *= 2;
-	//	   long *new_array = malloc(sl->capacity * sizeof(long));
+	//	   long *new_array = malloc(2 * sl->capacity * sizeof(long));
+	//	   if (new_array == NULL)
+	//		   return true;
 	//	   for (int i = 0; i != sl->length; i++)
 	//		   new_array[i] = sl->terms[i];
 	//	   free(sl->terms);
 	//	   sl->terms = new_array;
+	//	   sl->capacity *= 2;
 	// }
 	// ```
-  
- 	// Finalmente, guardamos o novo termo `new_term` no local apropriado do
- 	// _array_, que neste ponto já tem certamente (hmmmm... será?)
- 	// capacidade suficiente, i.e., na posição `sl->length`. Depois,
- 	// incrementamos o comprimento da sucessão. Mais uma vez, a condensação
- 	// de duas alterações numa única instrução é uma má prática, mas tão
- 	// generalizada na programação em C que já se tornou idiomática. A
- 	// alternativa, mais clara, seria usar:
- 	//
- 	// ```C
+
+	// Finalmente, guardamos o novo termo `new_term` no local apropriado do
+	// _array_, que neste ponto tem certamente capacidade suficiente, i.e.,
+	// na posição `sl->length`. Depois, incrementamos o comprimento da
+	// sucessão. A condensação de duas alterações numa única instrução é uma
+	// má prática, mas tão generalizada na programação em C que já se tornou
+	// idiomática. A alternativa, mais clara, seria usar:
+	//
+	// ```C
 	// sl->terms[sl->length] = new_term;
 	// sl->length++;
- 	// ```
+	// ```
 	sl->terms[sl->length++] = new_term;
+
+	return false;
+}
+
+// ### Implementação do _modificador_ de adição de vários termos à sucessão
+//
+// Adicionar os termos um a um através de `SEQL_add()` obrigaria a verificar a
+// capacidade em cada adição e poderia levar a várias re-reservas sucessivas. Em
+// vez disso, a capacidade é aumentada (no máximo) uma vez e os novos termos são
+// copiados num único bloco através de `memcpy()`, que é tipicamente tão rápida
+// quanto a memória o permite.
+//
+bool SEQL_add_many(struct sequence_of_longs *sl, const int number_of_terms,
+		   const long new_terms[number_of_terms])
+{
+	if (number_of_terms > INT_MAX - sl->length ||
+	    ensure_capacity(sl, sl->length + number_of_terms))
+		return true;
+
+	if (number_of_terms != 0)
+		memcpy(sl->terms + sl->length, new_terms,
+		       (size_t)number_of_terms * sizeof(long));
+
+	sl->length += number_of_terms;
+
+	return false;
+}
+
+// ### Implementação dos _modificadores_ da capacidade
+//
+// A reserva de capacidade, ao contrário do crescimento durante as adições, usa
+// exactamente a capacidade pedida: quem a pede conhece, em princípio, o
+// comprimento final da sucessão.
+//
+bool SEQL_reserve(struct sequence_of_longs *sl, const int capacity)
+{
+	if (capacity <= sl->capacity)
+		return false;
+
+	return change_capacity(sl, capacity);
+}
+
+// A capacidade mínima é `SEQL_SMALL_CAPACITY`, tal como na construção: os
+// termos que cabem na própria estrutura passam para lá, libertando o _array_
+// dinâmico. Se os termos continuarem a ser guardados em páginas mapeadas, a
+// capacidade final é arredondada para aproveitar as páginas por inteiro. Os
+// termos mapeados a partir de um ficheiro não ocupam memória além da
+// necessária, pelo que ficam como estão.
+bool SEQL_shrink_to_fit(struct sequence_of_longs *sl)
+{
+	const int capacity = sl->length < SEQL_SMALL_CAPACITY ?
+		SEQL_SMALL_CAPACITY : sl->length;
+
+	if (sl->file_mapping != NULL || capacity == sl->capacity)
+		return false;
+
+	return change_capacity(sl, capacity);
 }
 
 // ### Implementação do _inspector_ de termo
@@ -238,3 +832,134 @@ long SEQL_term(struct sequence_of_longs *sl, int index)
 	return sl->terms[index];
 }
 
+// ### Implementação do _inspector_ da vista dos termos
+//
+struct SEQL_span SEQL_terms(struct sequence_of_longs *sl)
+{
+	return (struct SEQL_span){
+		.terms = sl->terms,
+		.length = sl->length
+	};
+}
+
+// ### Implementação da gravação e do mapeamento de ficheiros
+
+// Este procedimento calcula a soma de verificação dos `length` termos dados,
+// guardando-a em `*sum` e `*weighted_sum`. Trata-se de uma variante da soma de
+// verificação de Fletcher, com aritmética módulo 2<sup>64</sup>: `*sum` é a
+// soma dos termos e `*weighted_sum` é a soma das sucessivas somas parciais,
+// i.e., a soma dos termos pesados pelo número de termos desde cada um até ao
+// final. A segunda soma detecta as trocas de termos, que a primeira não
+// detecta. O cálculo custa apenas duas adições por termo, pelo que é muito
+// mais rápido do que a leitura dos termos a partir do disco.
+static void checksum(const long length, const long terms[length],
+		     uint64_t *const sum, uint64_t *const weighted_sum)
+{
+	uint64_t first = 0;
+	uint64_t second = 0;
+
+	for (long i = 0; i != length; i++) {
+		first += (uint64_t)terms[i];
+		second += first;
+	}
+
+	*sum = first;
+	*weighted_sum = second;
+}
+
+// O cabeçalho e os termos são escritos através das rotinas de escrita em
+// ficheiros da biblioteca padrão, que escrevem directamente os blocos grandes,
+// sem cópias intermédias.
+bool SEQL_save(struct sequence_of_longs *sl, const char *const path)
+{
+	struct file_header header = {
+		.version = file_version,
+		.term_size = sizeof(long),
+		.byte_order_mark = file_byte_order_mark,
+		.length = (uint64_t)sl->length
+	};
+	memcpy(header.magic, file_magic, sizeof(header.magic));
+	checksum(sl->length, sl->terms, &header.sum, &header.weighted_sum);
+
+	FILE *const file = fopen(path, "wb");
+	if (file == NULL)
+		return true;
+
+	bool error = fwrite(&header, sizeof(header), 1, file) != 1 ||
+		fwrite(sl->terms, sizeof(long), (size_t)sl->length, file) !=
+		(size_t)sl->length;
+	error = fclose(file) != 0 || error;
+
+	if (error)
+		remove(path);
+
+	return error;
+}
+
+// O ficheiro é mapeado por inteiro, apenas para leitura, num mapeamento
+// privado, cujas páginas nunca são escritas. Note que um mapeamento privado
+// não protege a sucessão contra alterações ao ficheiro feitas por outros
+// processos depois da verificação da soma de verificação: os ficheiros
+// mapeados não devem, por isso, ser alterados. O descritor do ficheiro pode
+// ser fechado logo após o mapeamento, que se mantém válido. A estrutura é
+// inicializada por `initialize()`, como a de uma sucessão vazia, sendo depois
+// alterados apenas os campos relativos aos termos mapeados. O _array_
+// `small_terms` não é usado enquanto os termos não forem copiados.
+struct sequence_of_longs *SEQL_open_mapped(const char *const path,
+					   const bool verify)
+{
+	struct sequence_of_longs *sl = NULL;
+	void *mapping = MAP_FAILED;
+	size_t size = 0;
+
+	const int file_descriptor = open(path, O_RDONLY);
+	if (file_descriptor < 0)
+		return NULL;
+
+	struct stat status;
+	if (fstat(file_descriptor, &status) != 0 ||
+	    status.st_size < (off_t)sizeof(struct file_header))
+		goto terminate;
+
+	size = (size_t)status.st_size;
+	mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	if (mapping == MAP_FAILED)
+		goto terminate;
+
+	const struct file_header *const header = mapping;
+	long *const terms = (long *)(header + 1);
+
+	if (memcmp(header->magic, file_magic, sizeof(file_magic)) != 0 ||
+	    header->version != file_version ||
+	    header->term_size != sizeof(long) ||
+	    header->byte_order_mark != file_byte_order_mark ||
+	    header->length > INT_MAX ||
+	    size != sizeof(struct file_header) + header->length * sizeof(long))
+		goto terminate;
+
+	if (verify) {
+		uint64_t sum;
+		uint64_t weighted_sum;
+		checksum((long)header->length, terms, &sum, &weighted_sum);
+		if (sum != header->sum || weighted_sum != header->weighted_sum)
+			goto terminate;
+	}
+
+	sl = malloc(sizeof(struct sequence_of_longs));
+	if (sl == NULL)
+		goto terminate;
+
+	initialize(sl);
+	sl->terms = terms;
+	sl->length = (int)header->length;
+	sl->capacity = (int)header->length;
+	sl->file_mapping = mapping;
+	sl->file_mapping_size = size;
+
+terminate:
+	if (sl == NULL && mapping != MAP_FAILED)
+		munmap(mapping, size);
+	close(file_descriptor);
+
+	return sl;
+}
@@ -42,6 +42,15 @@
 #ifndef ISLA_EDA_SEQUENCE_OF_LONGS_H_INCLUDED
 #define ISLA_EDA_SEQUENCE_OF_LONGS_H_INCLUDED
 
+// Incluímos o ficheiro de interface `stdbool.h` para podermos usar o tipo
+// `bool` e os seus dois valores `true` e `false`. Seguindo a convenção usada
+// neste projecto, as rotinas que podem falhar devolvem `true` em caso de erro.
+#include <stdbool.h>
+
+// Incluímos o ficheiro de interface `stddef.h` para podermos usar o tipo
+// `size_t`.
+#include <stddef.h>
+
 // ### Comentário de documentação da `struct` `sequence_of_long`
 //
 // Este comentário de documentação serve para gerar documentação estruturada
@@ -54,7 +63,9 @@
  *
  * This TAD guarantees constant time additions of new terms, but at the cost of
  * allocating more memory than strictly necessary. The memory allocated may
- * approach the double of the minimum strictly necessary memory.
+ * approach the double of the minimum strictly necessary memory. The first
+ * `SEQL_SMALL_CAPACITY` terms are stored inside the structure itself, so that
+ * short sequences need no memory besides the structure.
  */
 // ### Declaração da `struct` que representa as sucessões de `long`
 //
@@ -75,8 +86,94 @@
 // necessidade de recompilar todo o código cliente deste módulo físico, ou seja,
 // todo o código que inclui este ficheiro de interface.
 //
+// Para que o código cliente possa, ainda assim, colocar sucessões na pilha ou
+// dentro das suas próprias estruturas, sem recorrer ao monte, este ficheiro
+// define mais abaixo a estrutura `SEQL_storage`, cujo conteúdo é privado, mas
+// cuja dimensão é conhecida (ver `SEQL_init()`).
+//
 struct sequence_of_longs;
 
+// ### Constantes da representação
+//
+// As sucessões curtas são muito frequentes. Para que não obriguem a reservar
+// um _array_ dinâmico, os primeiros `SEQL_SMALL_CAPACITY` termos são guardados
+// na própria estrutura, passando para o monte apenas quando deixam de lá
+// caber. A dimensão `SEQL_STORAGE_SIZE` da estrutura `SEQL_storage` é
+// suficiente para guardar a estrutura da sucessão, o que é verificado durante
+// a compilação do ficheiro de implementação. Qualquer alteração destas
+// constantes obriga a recompilar o código cliente.
+//
+/** \brief The number of terms stored inside the structure of a sequence of
+ * `long`s, i.e., the minimum capacity of a sequence.
+ */
+#define SEQL_SMALL_CAPACITY 8
+
+/** \brief The size, in bytes, of `struct SEQL_storage`.
+ */
+#define SEQL_STORAGE_SIZE 144
+
+// ### Armazenamento de sucessões fornecido pelo código cliente
+//
+/** \brief Storage for a sequence of `long`s provided by the client code, e.g.,
+ * on the stack or inside another structure (see `SEQL_init()`).
+ *
+ * The contents of this structure are private. It must not be copied or moved
+ * while it holds a sequence.
+ */
+struct SEQL_storage {
+	_Alignas(max_align_t) unsigned char bytes[SEQL_STORAGE_SIZE];
+};
+
+// ### Políticas de crescimento
+//
+// Quando a capacidade do _array_ que guarda os termos se esgota, a sucessão
+// reserva um novo _array_ maior. O factor de crescimento determina o
+// compromisso entre o tempo e a memória: com um factor maior há menos
+// re-reservas (e cópias), mas a memória reservada e não usada pode ser maior.
+// Com um factor menor do que a razão de ouro (≈ 1,618), como 1,5, a memória
+// libertada por re-reservas anteriores acaba por poder ser reutilizada pelas
+// seguintes. A política por omissão é a duplicação.
+//
+/** \brief The policies for growing the capacity of a sequence of `long`s.
+ */
+enum SEQL_growth_policy {
+	/** The capacity doubles whenever it is exhausted (the default). */
+	SEQL_doubling_growth,
+	/** The capacity grows by 50% whenever it is exhausted. */
+	SEQL_one_and_a_half_growth,
+	/** The capacity doubles whenever it is exhausted, but the storage is
+	 * rounded up to a whole number of memory pages. */
+	SEQL_page_multiple_growth,
+	/** The capacity is multiplied by the factor set through
+	 * `SEQL_set_growth_factor()` (by default, 2) whenever it is
+	 * exhausted. */
+	SEQL_factor_growth
+};
+
+// ### Estatísticas
+//
+// As estatísticas permitem verificar experimentalmente o custo amortizado das
+// adições e escolher a política de crescimento mais adequada a cada caso. A
+// sua recolha é opcional: o código cliente fornece a estrutura onde são
+// acumuladas através de `SEQL_set_statistics()`. Como apenas são actualizadas
+// quando a capacidade muda, a sua recolha não afecta o custo das restantes
+// adições. Ao contrário da estrutura da sucessão, esta estrutura é definida
+// aqui, pois o código cliente tem de aceder aos seus campos.
+//
+/** \brief Statistics of the capacity changes of a sequence of `long`s.
+ */
+struct SEQL_statistics {
+	/** The number of capacity changes (growing or shrinking). */
+	long reallocations;
+	/** The number of bytes of terms copied during the capacity changes.
+	 * Terms moved by `realloc()` are counted as copied, although
+	 * `realloc()` may move large blocks without copying them. */
+	long bytes_copied;
+	/** The largest number of bytes allocated but not used by terms,
+	 * measured right after each capacity change. */
+	long peak_slack;
+};
+
 // ### Construtor do TAD
 //
 // Tendo acesso apenas à declaração da estrutura `struct sequence_of_longs`, o
@@ -99,14 +196,111 @@ struct sequence_of_longs;
  * `sequence_of_longs`.
  *
  * \return A pointer to a newly (heap) allocated and initialized
- * `struct sequence_of_longs`. 
- * \post The returned pointer refers to a new `struct sequence_of_longs`
- * representing an empty (i.e., length 0) sequence of `long`s.
+ * `struct sequence_of_longs`, or `NULL` if memory could not be allocated.
+ * \post The returned pointer, if not null, refers to a new
+ * `struct sequence_of_longs` representing an empty (i.e., length 0) sequence
+ * of `long`s, using the doubling growth policy.
  *
  * This function is a constructor of the sequence of `long`s ADT.
  */
 struct sequence_of_longs *SEQL_new(void);
 
+// ### Construtor em armazenamento fornecido pelo código cliente
+//
+// Este construtor coloca a sucessão no armazenamento fornecido pelo código
+// cliente, pelo que não reserva qualquer memória e não pode falhar. As
+// sucessões assim construídas são destruídas através de `SEQL_fini()`, e não
+// de `SEQL_free()`, uma vez que a sua estrutura não pertence ao monte.
+//
+/** \brief Initializes an empty sequence of `long`s in the given storage and
+ * returns a pointer to it.
+ *
+ * \param storage A pointer to the storage where the sequence will be placed.
+ * \return A pointer to the new sequence, placed inside `*storage`.
+ * \pre `storage` ≠ null
+ * \post The returned pointer refers to a new `struct sequence_of_longs`
+ * representing an empty (i.e., length 0) sequence of `long`s, using the
+ * doubling growth policy, whose first `SEQL_SMALL_CAPACITY` terms will be
+ * stored in `*storage`.
+ *
+ * No memory is allocated until the sequence grows beyond
+ * `SEQL_SMALL_CAPACITY` terms. The sequence must be destroyed through
+ * `SEQL_fini()` before `*storage` ceases to exist.
+ *
+ * This function is a constructor of the sequence of `long`s ADT.
+ */
+struct sequence_of_longs *SEQL_init(struct SEQL_storage *storage);
+
+// ### Construtor a partir de um ficheiro
+//
+// As sucessões calculadas no arranque de um programa (e.g., tabelas
+// pré-calculadas) podem ser guardadas num ficheiro através de `SEQL_save()` e
+// recuperadas em execuções seguintes através deste construtor, sem terem de ser
+// calculadas de novo. Os termos não são lidos nem copiados: o ficheiro é
+// mapeado em memória e os termos são usados directamente a partir das páginas
+// mapeadas, que o núcleo do sistema operativo carrega à medida que são
+// acedidas. A verificação da soma de verificação dos termos é opcional, pois
+// obriga a ler o ficheiro completo durante a abertura.
+//
+/** \brief Returns a pointer to a sequence of `long`s whose terms are mapped
+ * from the given file, previously written by `SEQL_save()`.
+ *
+ * \param path The path of the file.
+ * \param verify Whether to verify the checksum of the terms.
+ * \return A pointer to a newly allocated and initialized
+ * `struct sequence_of_longs`, or `NULL` if the file could not be opened or
+ * mapped, if it is not a valid sequence file (wrong format, version, term
+ * size, byte order or size, or, if `verify` is true, wrong checksum), or if
+ * memory could not be allocated.
+ * \pre `path` ≠ null
+ * \post The returned pointer, if not null, refers to a new
+ * `struct sequence_of_longs` with the terms stored in the file, using the
+ * doubling growth policy.
+ *
+ * The terms are not copied: they are read directly from a read-only private
+ * mapping of the file. Without verification, only the file header is read
+ * when the sequence is opened, so opening takes constant time. Verifying the
+ * checksum reads the whole file once. Hence, `SEQL_capacity()`
+ * equals `SEQL_length()`. The terms are copied to memory owned by the sequence
+ * only when its capacity must change for the first time, e.g., on the first
+ * call to `SEQL_add()`. Changes to the sequence are never written to the file.
+ *
+ * This function is a constructor of the sequence of `long`s ADT.
+ */
+struct sequence_of_longs *SEQL_open_mapped(const char *path, bool verify);
+
+// ### Destrutor do TAD
+//
+// O código cliente não pode libertar uma sucessão usando directamente
+// `free()`: isso libertaria a estrutura, mas não a memória onde os termos são
+// guardados. Esta memória pode, aliás, nem sequer ter sido reservada através de
+// `malloc()`.
+//
+/** \brief Destroys the given sequence of `long`s, releasing all the memory it
+ * uses.
+ *
+ * \param sl A pointer to the sequence of `long`s to destroy, or `NULL`, in
+ * which case nothing is done.
+ * \pre `sl` was not returned by `SEQL_init()` (see `SEQL_fini()`).
+ * \post `sl` no longer refers to a valid sequence.
+ *
+ * This procedure is the destructor of the sequence of `long`s ADT.
+ */
+void SEQL_free(struct sequence_of_longs *sl);
+
+/** \brief Destroys the given sequence of `long`s, placed in storage provided
+ * by the client code, releasing all the memory it uses, but not the storage.
+ *
+ * \param sl A pointer to the sequence of `long`s to destroy, or `NULL`, in
+ * which case nothing is done.
+ * \pre `sl` was returned by `SEQL_init()`.
+ * \post `sl` no longer refers to a valid sequence. Its storage may be reused.
+ *
+ * This procedure is the destructor of the sequences of `long`s constructed by
+ * `SEQL_init()`.
+ */
+void SEQL_fini(struct sequence_of_longs *sl);
+
 // ### Operações do TAD
 //
 // Seguem-se as declarações de todas as operações do TAD, representadas aqui por
@@ -143,14 +337,85 @@ void SEQL_println(struct sequence_of_longs *sl);
  */
 int SEQL_length(struct sequence_of_longs *sl);
 
+/** \brief Returns the number of terms the given sequence of `long`s can hold
+ * without allocating more memory.
+ *
+ * \param sl A pointer to the sequence of `long`s whose capacity will be
+ * returned.
+ * \return The capacity of the sequence.
+ * \pre `sl` ≠ null
+ * \post `SEQL_length(sl)` ≤ returned value
+ */
+int SEQL_capacity(struct sequence_of_longs *sl);
+
+/** \brief Sets the policy used to grow the capacity of the given sequence of
+ * `long`s when it is exhausted.
+ *
+ * \param sl A pointer to the sequence of `long`s whose growth policy will be
+ * set.
+ * \param policy The new growth policy.
+ * \pre `sl` ≠ null
+ */
+void SEQL_set_growth_policy(struct sequence_of_longs *sl,
+			    enum SEQL_growth_policy policy);
+
+/** \brief Sets the factor by which the capacity of the given sequence of
+ * `long`s is multiplied when it is exhausted, and selects the
+ * `SEQL_factor_growth` policy.
+ *
+ * \param sl A pointer to the sequence of `long`s whose growth factor will be
+ * set.
+ * \param factor The new growth factor.
+ * \pre `sl` ≠ null
+ * \pre `factor` > 1
+ *
+ * The capacity always grows by at least one term, even when the product is
+ * rounded down to the current capacity.
+ */
+void SEQL_set_growth_factor(struct sequence_of_longs *sl, double factor);
+
+/** \brief Starts or stops collecting statistics of the capacity changes of the
+ * given sequence of `long`s.
+ *
+ * \param sl A pointer to the sequence of `long`s whose statistics will be
+ * collected.
+ * \param statistics A pointer to the structure where the statistics will be
+ * accumulated, or `NULL` to stop collecting them (the default).
+ * \pre `sl` ≠ null
+ * \pre `statistics` remains valid while it is being used by the sequence.
+ *
+ * The statistics are added to those already in `*statistics` (the peak slack
+ * is the maximum of both), which should thus be initially zeroed.
+ */
+void SEQL_set_statistics(struct sequence_of_longs *sl,
+			 struct SEQL_statistics *statistics);
+
+/** \brief Sets the size, in bytes, from which the terms of the given sequence
+ * of `long`s are stored in memory pages mapped directly from the operating
+ * system, instead of in the heap.
+ *
+ * \param sl A pointer to the sequence of `long`s whose threshold will be set.
+ * \param threshold The new threshold, in bytes. `SIZE_MAX` means that the
+ * terms are always stored in the heap.
+ * \pre `sl` ≠ null
+ *
+ * Mapped terms grow without being copied and use huge pages when available.
+ * The default threshold is 4 MiB. The new threshold takes effect the next time
+ * the capacity of the sequence changes.
+ */
+void SEQL_set_mapping_threshold(struct sequence_of_longs *sl,
+				size_t threshold);
+
 /** \brief Adds a given value as a further term of the given sequence of
  * `long`s.
  *
  * \param sl A pointer to the sequence of `long`s to which the new term will be
  * added.
  * \param new_term The new term to add to the sequence.
- * \post The sequence contains the same terms it contained before, in the same
- * order, plus the new term in its last position.
+ * \return `true` if memory could not be allocated, `false` otherwise.
+ * \post If `false` is returned, the sequence contains the same terms it
+ * contained before, in the same order, plus the new term in its last position.
+ * Otherwise, the sequence is unchanged.
  * \pre `sl` ≠ null
  *
  * The time required to add the new term depends on the non-observable state of
@@ -158,7 +423,61 @@ int SEQL_length(struct sequence_of_longs *sl);
  * addition being performed, then this time is constant with regards to the
  * length of the sequence.
  */
-void SEQL_add(struct sequence_of_longs *sl, long new_term);
+bool SEQL_add(struct sequence_of_longs *sl, long new_term);
+
+/** \brief Adds the given values as further terms of the given sequence of
+ * `long`s.
+ *
+ * \param sl A pointer to the sequence of `long`s to which the new terms will
+ * be added.
+ * \param number_of_terms The number of new terms to add.
+ * \param new_terms The new terms to add to the sequence, in order.
+ * \return `true` if memory could not be allocated, `false` otherwise.
+ * \post If `false` is returned, the sequence contains the same terms it
+ * contained before, in the same order, followed by the new terms. Otherwise,
+ * the sequence is unchanged.
+ * \pre `sl` ≠ null
+ * \pre `number_of_terms` ≥ 0
+ * \pre `new_terms` ≠ null or `number_of_terms` = 0
+ * \pre `new_terms` does not refer to terms of `sl`
+ *
+ * The capacity is grown at most once and the new terms are copied in a single
+ * block, so the time required is that of copying the new terms.
+ */
+bool SEQL_add_many(struct sequence_of_longs *sl, int number_of_terms,
+		   const long new_terms[number_of_terms]);
+
+/** \brief Ensures that the given sequence of `long`s can hold at least the
+ * given number of terms without allocating more memory.
+ *
+ * \param sl A pointer to the sequence of `long`s whose capacity will be
+ * reserved.
+ * \param capacity The minimum capacity required.
+ * \return `true` if memory could not be allocated, `false` otherwise.
+ * \post If `false` is returned, `SEQL_capacity(sl)` ≥ `capacity`. The terms of
+ * the sequence are unchanged in any case.
+ * \pre `sl` ≠ null
+ * \pre `capacity` ≥ 0
+ *
+ * Reserving the final length of the sequence before adding its terms avoids
+ * all the intermediate allocations and copies.
+ */
+bool SEQL_reserve(struct sequence_of_longs *sl, int capacity);
+
+/** \brief Releases the memory reserved by the given sequence of `long`s in
+ * excess of what is necessary to hold its terms.
+ *
+ * \param sl A pointer to the sequence of `long`s whose capacity will be
+ * reduced.
+ * \return `true` if memory could not be reallocated, `false` otherwise.
+ * \post If `false` is returned, `SEQL_capacity(sl)` =
+ * max(`SEQL_SMALL_CAPACITY`, `SEQL_length(sl)`), except for mapped terms,
+ * whose capacity is rounded up to fill whole memory pages, and for terms still
+ * mapped from a file (see `SEQL_open_mapped()`), which are left as they are.
+ * The terms of the sequence are unchanged in any case.
+ * \pre `sl` ≠ null
+ */
+bool SEQL_shrink_to_fit(struct sequence_of_longs *sl);
 
 /** \brief Returns the term of the given sequence at the given position or
  * index. 
@@ -171,6 +490,60 @@ void SEQL_add(struct sequence_of_longs *sl, long new_term);
  */
 long SEQL_term(struct sequence_of_longs *sl, int index);
 
+// ### Acesso directo aos termos
+//
+// Aceder aos termos um a um através de `SEQL_term()` obriga a uma invocação de
+// rotina por termo, que o compilador não pode eliminar, pois a definição da
+// rotina está noutro ficheiro de implementação. Para percorrer todos os termos,
+// é muito mais eficiente obter uma _vista_ (_span_) dos termos, i.e., um
+// ponteiro constante para o _array_ que os guarda e o seu comprimento, e
+// percorrê-la directamente ou através dos núcleos de cálculo do módulo
+// [`array_of_longs`](array_of_longs.h.html). Ao contrário da estrutura da
+// sucessão, a estrutura da vista é definida aqui, pois o código cliente tem de
+// aceder aos seus campos.
+//
+/** \brief A read-only view of the terms of a sequence of `long`s.
+ */
+struct SEQL_span {
+	/** A pointer to the first term of the sequence. */
+	const long *terms;
+	/** The number of terms of the sequence. */
+	int length;
+};
+
+/** \brief Returns a read-only view of the terms of the given sequence of
+ * `long`s.
+ *
+ * \param sl A pointer to the sequence of `long`s whose terms will be viewed.
+ * \return A view with the address of the first term and the length of the
+ * sequence.
+ * \pre `sl` ≠ null
+ * \post `span.terms[i]` = `SEQL_term(sl, i)`, for 0 ≤ `i` < `span.length`.
+ *
+ * The view remains valid only until the sequence is next modified (e.g., by
+ * `SEQL_add()`), since the terms may then be moved.
+ */
+struct SEQL_span SEQL_terms(struct sequence_of_longs *sl);
+
+// ### Gravação em ficheiro
+//
+/** \brief Saves the given sequence of `long`s in a file, which can later be
+ * mapped through `SEQL_open_mapped()`.
+ *
+ * \param sl A pointer to the sequence of `long`s to save.
+ * \param path The path of the file, which is created or replaced.
+ * \return `true` if the file could not be written, `false` otherwise.
+ * \pre `sl` ≠ null
+ * \pre `path` ≠ null
+ *
+ * The file contains a header, with a format identifier, the format version, the
+ * size and byte order of the terms, the length and a checksum of the terms,
+ * followed by the terms themselves, exactly as stored in memory. Files are
+ * thus portable only between machines with the same `long` representation.
+ * If an error occurs, the (partial) file is removed.
+ */
+bool SEQL_save(struct sequence_of_longs *sl, const char *path);
+
 // ### Fim do ficheiro
 //
 // Final da instrução condicional do pré-processador.
@@ -178,15 +551,10 @@ long SEQL_term(struct sequence_of_longs *sl, int index);
 
 // ### Considerações finais
 //
-// O que falta aqui? Bem, falta pelo menos um procedimento para libertação
-// disciplinada da memória associada a uma sucessão de `long`s. Isto porque a
-// utilização de `free()` pelo código cliente levará inevitavelmente a uma fuga
-// de memória, nomeadamente a memória em que os termos da sucessão são
-// armazenados.
-//
-// Falta também equipar a implementação de todas as rotinas com a correspondente
-// verificação das pré-condições e com critérios para lidarem com as respectivas
-// violações.
+// O que falta aqui? Falta equipar a implementação de todas as rotinas com a
+// correspondente verificação das pré-condições e com critérios para lidarem
+// com as respectivas violações.
 //
-// Finalmente, falta lidar de forma airosa com possível falhas durante a reserva
-// de memória.
\ No newline at end of file
+// Já as possíveis falhas durante a reserva de memória são tratadas de forma
+// airosa: as rotinas que reservam memória devolvem `true` em caso de falha,
+// deixando a sucessão inalterada.
\ No newline at end of file
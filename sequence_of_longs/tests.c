@@ -2,19 +2,53 @@
 // ======================================================
 
 #include <stdlib.h>
+#include <limits.h>
 #include <check.h>
 
+// Incluímos a implementação das sucessões segmentadas, e não apenas a sua
+// interface, para que os testes possam aceder aos campos da estrutura e simular
+// estados que seriam demasiado caros de atingir através de adições.
+#include "segmented_sequence_of_longs.c"
+
 START_TEST(one_plus_one_equals_two_test)
 {
 	fail_unless(1 + 1 == 3, "One plus one should always equal 3.");
 }
 END_TEST
 
+// Uma sucessão segmentada com `INT_MAX` - 1 termos aceita mais um termo, mas
+// não mais do que esse. Simulamos o comprimento, sem reservar os 16 GiB
+// correspondentes, fazendo o último segmento apontar para um _array_ local com
+// espaço para dois termos.
+START_TEST(segmented_sequence_stops_at_int_max_test)
+{
+	struct segmented_sequence_of_longs *sl = SSEQL_new();
+	fail_unless(sl != NULL, "The sequence should be created.");
+
+	long terms[2];
+	sl->length = INT_MAX - 1;
+	sl->next = terms;
+	sl->end = terms + 2;
+
+	fail_unless(!SSEQL_add(sl, 1L),
+		    "Adding the INT_MAX-th term should succeed.");
+	fail_unless(SSEQL_length(sl) == INT_MAX,
+		    "The length should be INT_MAX.");
+	fail_unless(SSEQL_add(sl, 2L),
+		    "Adding a term beyond INT_MAX should fail.");
+	fail_unless(SSEQL_length(sl) == INT_MAX,
+		    "The length should remain INT_MAX.");
+
+	SSEQL_free(sl);
+}
+END_TEST
+
 Suite *sequence_of_longs_suite(void)
 {
 	Suite *suite = suite_create("Sequence of longs");
 	TCase *core_test_case = tcase_create("Core");
 	tcase_add_test(core_test_case, one_plus_one_equals_two_test);
+	tcase_add_test(core_test_case, segmented_sequence_stops_at_int_max_test);
 	suite_add_tcase(suite, core_test_case);
 
 	return suite;
@@ -20,20 +20,96 @@
 // Incluímos os vários ficheiro de interface necessários:
 //
 // - `stdlib.h` &ndash; Para podermos usar o valor especial `NULL` dos ponteiros
-//   e para podemos usar as rotinas `malloc()` e `realloc()` e o procedimento
-//   `qsort()`.
+//   e para podemos usar as rotinas `malloc()` e `realloc()`.
 //
 // - `stdio.h` &ndash; Para podermos usar as rotinas `fopen()`, `fclose()` e
 //   `fscanf()`.
 //
-// - `math.h` &ndash; Para podermos usar a função `sqrt()` e as macros `NAN` e
-//   `INFINITY`.
+// - `math.h` &ndash; Para podermos usar a função `sqrt()` e as macros `NAN`,
+//   `INFINITY`, `isnan()` e `signbit()`.
 //
 // - `assert.h` &ndash; Para podermos usar a macro `assert()`.
+//
+// - `stdint.h` &ndash; Para podermos usar os tipos `uintptr_t` e `uint64_t`.
+//
+// - `string.h` &ndash; Para podermos usar os procedimentos `memset()` e
+//   `memcpy()`.
+//
+// - `pthread.h` &ndash; Para podermos usar _threads_ POSIX no toque inicial das
+//   páginas dos _arrays_ e `pthread_once()` na detecção do AVX2 e da dimensão
+//   da _cache_ de último nível.
+//
+// - `sys/mman.h`, `sys/syscall.h` e `unistd.h` &ndash; Apenas em sistemas
+//   Unix, para podermos usar as rotinas `mmap()`, `munmap()`, `madvise()`,
+//   `syscall()` e `sysconf()`.
+//
+// - `immintrin.h` &ndash; Apenas em processadores x86-64 e com o GCC ou o
+//   Clang, para podermos usar as instruções vectoriais AVX2 através das
+//   respectivas funções intrínsecas.
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 #include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__unix__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// A versão vectorial das rotinas de cópia e comparação só é compilada quando
+// o processador alvo é x86-64 e o compilador suporta o atributo `target`, que
+// permite compilar rotinas individuais para AVX2 sem exigir esse conjunto de
+// instruções ao restante programa. A escolha entre a versão vectorial e a
+// versão escalar é feita durante a execução (ver `has_avx2()`).
+#if defined(__x86_64__) && defined(__GNUC__)
+#define ISLA_EDA_ARRAY_OF_DOUBLES_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Definição de constantes
+// -----------------------
+
+// Dimensão, em _bytes_, de uma linha de _cache_. Os _arrays_ reservados de
+// acordo com indicações de reserva ficam alinhados com este valor.
+static const size_t cache_line_size = 64;
+
+// Dimensão, em _bytes_, das páginas enormes (_huge pages_) usadas pelo sistema
+// operativo Linux nos processadores x86-64.
+static const size_t huge_page_size = 2UL * 1024UL * 1024UL;
+
+// Política de memória NUMA que distribui as páginas alternadamente pelos nós,
+// tal como definida em `linux/mempolicy.h`. Definimo-la aqui para não depender
+// da biblioteca `libnuma`.
+static const int numa_interleave_policy = 3;
+
+// Definição de tipos
+// ------------------
+
+// Esta estrutura é guardada imediatamente antes do primeiro item de cada
+// _array_ reservado de acordo com indicações de reserva, ocupando uma linha de
+// _cache_ completa. Guarda a informação necessária para o libertar.
+struct placed_array_header {
+	// O endereço do início da memória reservada.
+	void *memory;
+	// O número de _bytes_ reservados através de `mmap()`, ou zero, se a
+	// memória tiver sido reservada através de `malloc()`.
+	size_t mapped_bytes;
+};
+
+// Esta estrutura contém a informação passada a cada uma das _threads_ que
+// tocam pela primeira vez nas páginas de um _array_. Cada _thread_ trata de um
+// troço do _array_. Se `original` for `NULL`, a _thread_ inicializa o troço com
+// zeros. Caso contrário, copia para o troço os itens correspondentes de
+// `original`.
+struct touch_task {
+	double *items;
+	const double *original;
+	long length;
+};
 
 // Definições de rotinas
 // ---------------------
@@ -57,6 +133,233 @@ double *resize_double_array_to(double *const items, const long new_length)
 	return realloc(items, new_length * sizeof(double));
 }
 
+// Rotina executada por cada uma das _threads_ que tocam pela primeira vez nas
+// páginas de um _array_. Recebe um ponteiro para uma `struct touch_task`.
+static void *touch_pages(void *const generic_task)
+{
+	const struct touch_task *const task = generic_task;
+
+	if (task->original == NULL)
+		memset(task->items, 0, task->length * sizeof(double));
+	else
+		memcpy(task->items, task->original,
+		       task->length * sizeof(double));
+
+	return NULL;
+}
+
+// Toca pela primeira vez em todas as páginas do _array_ `items` com `length`
+// itens, usando `threads` _threads_, cada uma tratando de um troço contíguo do
+// _array_. Se `original` não for `NULL`, copia os seus itens para `items`.
+// Caso contrário, inicializa os itens de `items` com zero. Como, por omissão, o
+// sistema operativo coloca cada página no nó NUMA do processador que lhe toca
+// primeiro, isto distribui as páginas pelos nós onde correm as _threads_. Se
+// não for possível criar uma das _threads_, o respectivo troço é tratado pela
+// _thread_ que invocou o procedimento. O número de _threads_ é limitado a
+// `maximum_touch_threads`, pois os _arrays_ com a informação de cada _thread_
+// são guardados na pilha.
+static void touch_double_array(const long length, double items[length],
+			       const double original[], const int threads)
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+	assert(threads > 0);
+
+	int number_of_tasks = threads > maximum_touch_threads ?
+		maximum_touch_threads : threads;
+	if (length < number_of_tasks)
+		number_of_tasks = length == 0L ? 1 : (int) length;
+
+	struct touch_task tasks[number_of_tasks];
+	pthread_t thread_ids[number_of_tasks];
+	bool started[number_of_tasks];
+
+	for (int t = 0; t != number_of_tasks; t++) {
+		const long first = length * t / number_of_tasks;
+		const long end = length * (t + 1) / number_of_tasks;
+		tasks[t].items = items + first;
+		tasks[t].original = original == NULL ? NULL : original + first;
+		tasks[t].length = end - first;
+		// A primeira tarefa é executada pela própria _thread_ que
+		// invocou o procedimento.
+		started[t] = t != 0 && pthread_create(&thread_ids[t], NULL,
+						      touch_pages,
+						      &tasks[t]) == 0;
+	}
+
+	for (int t = 0; t != number_of_tasks; t++)
+		if (!started[t])
+			touch_pages(&tasks[t]);
+
+	for (int t = 0; t != number_of_tasks; t++)
+		if (started[t])
+			pthread_join(thread_ids[t], NULL);
+}
+
+#if defined(__unix__)
+// Reserva directamente do sistema operativo, através de `mmap()`, `bytes`
+// _bytes_ de memória alinhados com `alignment` _bytes_, que tem de ser um
+// múltiplo da dimensão das páginas. Para obter o alinhamento, reserva-se mais
+// memória do que o necessário e devolve-se depois o excesso. Se `huge_pages`
+// for `true`, sugere-se a utilização de páginas enormes através de `madvise()`
+// ou, se o sistema operativo não suportar páginas enormes transparentes,
+// através de uma reserva com `MAP_HUGETLB`. Devolve `NULL` em caso de erro.
+static void *map_memory(const size_t bytes, const size_t alignment,
+			const bool huge_pages)
+{
+	const size_t padded_bytes = bytes + alignment;
+	char *const mapping = mmap(NULL, padded_bytes, PROT_READ | PROT_WRITE,
+				   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (mapping == MAP_FAILED)
+		return NULL;
+
+	char *const memory = (char *) (((uintptr_t) mapping + alignment - 1) /
+				       alignment * alignment);
+
+	if (memory != mapping)
+		munmap(mapping, memory - mapping);
+	if (memory + bytes != mapping + padded_bytes)
+		munmap(memory + bytes,
+		       mapping + padded_bytes - (memory + bytes));
+
+	if (!huge_pages)
+		return memory;
+
+#if defined(MADV_HUGEPAGE)
+	if (madvise(memory, bytes, MADV_HUGEPAGE) == 0)
+		return memory;
+#endif
+
+#if defined(MAP_HUGETLB)
+	// As páginas enormes transparentes não estão disponíveis. Tentamos
+	// usar as páginas enormes reservadas explicitamente pelo administrador
+	// do sistema. Se também não estiverem disponíveis, ficamos com a
+	// memória já reservada, com páginas normais.
+	void *const huge_memory =
+		mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+	if (huge_memory != MAP_FAILED) {
+		munmap(memory, bytes);
+		return huge_memory;
+	}
+#endif
+
+	return memory;
+}
+#endif
+
+double *new_placed_double_array_of(const long length,
+				   const struct allocation_hints hints)
+{
+	assert(length >= 0L);
+	assert(hints.touch_threads >= 0 &&
+	       hints.touch_threads <= maximum_touch_threads);
+
+	// O cabeçalho ocupa a linha de _cache_ que antecede o primeiro item
+	// do _array_.
+	const size_t bytes = cache_line_size + length * sizeof(double);
+
+	struct placed_array_header header = {
+		.memory = NULL,
+		.mapped_bytes = 0
+	};
+
+#if defined(__unix__)
+	// Usamos `mmap()` apenas para _arrays_ com pelo menos uma página
+	// enorme, pois para _arrays_ mais pequenos as indicações de reserva
+	// são irrelevantes.
+	if (bytes >= huge_page_size) {
+		const size_t mapped_bytes = (bytes + huge_page_size - 1) /
+			huge_page_size * huge_page_size;
+		header.memory = map_memory(mapped_bytes, huge_page_size,
+					   hints.huge_pages);
+		if (header.memory != NULL) {
+			header.mapped_bytes = mapped_bytes;
+#if defined(SYS_mbind)
+			// Tal como as restantes indicações, esta é apenas uma
+			// sugestão, pelo que se ignoram eventuais erros.
+			// Indicamos todos os nós possíveis, sendo a máscara
+			// restringida pelo sistema operativo aos nós
+			// existentes.
+			if (hints.interleaved) {
+				const unsigned long all_nodes = ~0UL;
+				syscall(SYS_mbind, header.memory, mapped_bytes,
+					numa_interleave_policy, &all_nodes,
+					sizeof(all_nodes) * 8, 0);
+			}
+#endif
+		}
+	}
+#endif
+
+	if (header.memory == NULL) {
+		header.memory = malloc(bytes + cache_line_size);
+		if (header.memory == NULL)
+			return NULL;
+	}
+
+	// O primeiro item do _array_ fica no início da primeira linha de
+	// _cache_ após o cabeçalho.
+	const uintptr_t first_line =
+		((uintptr_t) header.memory + 2 * cache_line_size - 1) /
+		cache_line_size;
+	double *const items = (double *) (first_line * cache_line_size);
+
+	((struct placed_array_header *) items)[-1] = header;
+
+	if (hints.touch_threads > 0)
+		touch_double_array(length, items, NULL, hints.touch_threads);
+
+	return items;
+}
+
+double *place_double_array(const long length, double items[length],
+			   const struct allocation_hints hints)
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+	assert(hints.touch_threads >= 0 &&
+	       hints.touch_threads <= maximum_touch_threads);
+
+	// Reservamos o novo _array_ sem tocar nas suas páginas, pois o toque
+	// inicial será feito pela própria cópia.
+	struct allocation_hints untouched_hints = hints;
+	untouched_hints.touch_threads = 0;
+
+	double *const placed_items =
+		new_placed_double_array_of(length, untouched_hints);
+
+	if (placed_items == NULL)
+		return NULL;
+
+	touch_double_array(length, placed_items, items,
+			   hints.touch_threads > 0 ? hints.touch_threads : 1);
+
+	free(items);
+
+	return placed_items;
+}
+
+void free_placed_double_array(double items[])
+{
+	if (items == NULL)
+		return;
+
+	const struct placed_array_header header =
+		((struct placed_array_header *) items)[-1];
+
+#if defined(__unix__)
+	if (header.mapped_bytes != 0) {
+		munmap(header.memory, header.mapped_bytes);
+		return;
+	}
+#endif
+
+	free(header.memory);
+}
+
 double *read_double_array_from(const char *const file_name, long *const length)
 {
 	assert(file_name != NULL);
@@ -156,6 +459,144 @@ double *read_double_array_from(const char *const file_name, long *const length)
 	return items;
 }
 
+// Procedimento que copia os itens usando um ciclo escalar simples. É usado
+// quando o processador não suporta AVX2 e para copiar os itens que sobram no
+// fim das versões vectoriais.
+static void copy_double_array_scalar(const long length, double copy[length],
+				     const double original[length])
+{
+	for (long i = 0L; i != length; i++)
+		copy[i] = original[i];
+}
+
+// Predicado equivalente a `double_arrays_equal()`, usando um ciclo escalar
+// simples. Note a utilização de um ciclo com apenas um local de terminação.
+static bool double_arrays_equal_scalar(const long length,
+				       const double first[length],
+				       const double second[length])
+{
+	long i = 0L;
+	while(i != length && first[i] == second[i])
+		i++;
+	return i == length;
+}
+
+// O limiar de utilização de escritas não temporais, calculado uma única vez
+// através de `pthread_once()`, uma vez que `streaming_threshold()` pode ser
+// invocada em simultâneo por várias _threads_ que copiem _arrays_.
+static pthread_once_t threshold_calculation = PTHREAD_ONCE_INIT;
+static size_t copy_threshold = 0;
+
+// Calcula o limiar de utilização de escritas não temporais, guardando-o em
+// `copy_threshold`.
+static void calculate_threshold(void)
+{
+	long llc_size = 0L;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+	llc_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+	copy_threshold = llc_size > 0L ? (size_t)llc_size : 8UL * 1024UL * 1024UL;
+}
+
+// Devolve o número de _bytes_ acima do qual um _array_ a copiar é considerado
+// demasiado grande para a _cache_ de último nível (LLC, _last level cache_).
+// Acima desse valor, a cópia usa escritas não temporais (_streaming stores_),
+// que não passam pela _cache_, evitando tanto a leitura prévia das linhas de
+// destino como a expulsão de dados úteis. Quando não é possível saber a
+// dimensão da LLC, admite-se que tem 8 MiB.
+static size_t streaming_threshold(void)
+{
+	pthread_once(&threshold_calculation, calculate_threshold);
+
+	return copy_threshold;
+}
+
+#if defined(ISLA_EDA_ARRAY_OF_DOUBLES_AVX2)
+
+// O resultado da detecção do suporte das instruções AVX2, feita uma única vez
+// através de `pthread_once()`, uma vez que `has_avx2()` pode ser invocado em
+// simultâneo por várias _threads_ que usem as rotinas deste módulo.
+static pthread_once_t avx2_detection = PTHREAD_ONCE_INIT;
+static bool avx2_supported = false;
+
+// Detecta se o processador em que o programa está a ser executado suporta as
+// instruções AVX2, guardando o resultado em `avx2_supported`.
+static void detect_avx2(void)
+{
+	__builtin_cpu_init();
+	avx2_supported = __builtin_cpu_supports("avx2");
+}
+
+// Predicado que devolve `true` se o processador em que o programa está a
+// ser executado suportar as instruções AVX2.
+static bool has_avx2(void)
+{
+	pthread_once(&avx2_detection, detect_avx2);
+
+	return avx2_supported;
+}
+
+// Procedimento que copia os itens usando AVX2, 8 itens (64 _bytes_, ou seja,
+// uma linha de _cache_) por iteração. Começamos por copiar de forma escalar os
+// itens necessários para alinhar o destino com 32 _bytes_, de modo a que as
+// escritas não atravessem linhas de _cache_. Se `streaming` for `true`, as
+// escritas são não temporais, sendo necessária uma barreira (`sfence`) no fim
+// para garantir que ficam visíveis pela ordem habitual.
+__attribute__((target("avx2")))
+static void copy_double_array_avx2(const long length, double copy[length],
+				   const double original[length],
+				   const bool streaming)
+{
+	long i = 0L;
+	while (i != length && (uintptr_t)(copy + i) % 32 != 0)
+		copy[i] = original[i], i++;
+
+	if (streaming) {
+		for (; i + 8L <= length; i += 8L) {
+			const __m256d low = _mm256_loadu_pd(original + i);
+			const __m256d high = _mm256_loadu_pd(original + i + 4);
+			_mm256_stream_pd(copy + i, low);
+			_mm256_stream_pd(copy + i + 4, high);
+		}
+		_mm_sfence();
+	} else
+		for (; i + 8L <= length; i += 8L) {
+			const __m256d low = _mm256_loadu_pd(original + i);
+			const __m256d high = _mm256_loadu_pd(original + i + 4);
+			_mm256_store_pd(copy + i, low);
+			_mm256_store_pd(copy + i + 4, high);
+		}
+
+	copy_double_array_scalar(length - i, copy + i, original + i);
+}
+
+// Predicado equivalente a `double_arrays_equal()`, usando AVX2. Comparamos 8
+// itens (64 _bytes_) por iteração, terminando logo que se encontre uma
+// diferença. A comparação `_CMP_EQ_OQ` tem a mesma semântica do operador `==`:
+// um NaN é diferente de tudo, e `-0.0` é igual a `0.0`.
+__attribute__((target("avx2")))
+static bool double_arrays_equal_avx2(const long length,
+				     const double first[length],
+				     const double second[length])
+{
+	long i = 0L;
+	for (; i + 8L <= length; i += 8L) {
+		const __m256d low = _mm256_cmp_pd(_mm256_loadu_pd(first + i),
+						  _mm256_loadu_pd(second + i),
+						  _CMP_EQ_OQ);
+		const __m256d high =
+			_mm256_cmp_pd(_mm256_loadu_pd(first + i + 4),
+				      _mm256_loadu_pd(second + i + 4),
+				      _CMP_EQ_OQ);
+		if (_mm256_movemask_pd(_mm256_and_pd(low, high)) != 0xF)
+			return false;
+	}
+
+	return double_arrays_equal_scalar(length - i, first + i, second + i);
+}
+
+#endif // ISLA_EDA_ARRAY_OF_DOUBLES_AVX2
+
 void copy_double_array(const long length,
 		double copy[length], const double original[length])
 {
@@ -163,8 +604,23 @@ void copy_double_array(const long length,
 	assert(length == 0L || copy != NULL);
 	assert(length == 0L || original != NULL);
 
-	for (long i = 0L; i != length; i++)
-		copy[i] = original[i];
+#if defined(ISLA_EDA_ARRAY_OF_DOUBLES_AVX2)
+	if (has_avx2()) {
+		const bool streaming =
+			length * sizeof(double) > streaming_threshold();
+		copy_double_array_avx2(length, copy, original, streaming);
+		return;
+	}
+#endif
+
+	// Sem AVX2 recorremos a `memcpy()`, cujas implementações usam
+	// geralmente as melhores instruções disponíveis, incluindo escritas não
+	// temporais para cópias de grandes dimensões. Para pequenos _arrays_, o
+	// ciclo escalar evita o custo da invocação.
+	if (length * sizeof(double) > streaming_threshold())
+		memcpy(copy, original, length * sizeof(double));
+	else
+		copy_double_array_scalar(length, copy, original);
 }
 
 bool double_arrays_equal(const long length,
@@ -174,39 +630,299 @@ bool double_arrays_equal(const long length,
 	assert(length == 0L || first != NULL);
 	assert(length == 0L || second != NULL);
 
-	// Note a utilização de um ciclo com apenas um local de terminação.
-	long i = 0L;
-	while(i != length && first[i] == second[i])
+#if defined(ISLA_EDA_ARRAY_OF_DOUBLES_AVX2)
+	if (has_avx2())
+		return double_arrays_equal_avx2(length, first, second);
+#endif
+
+	return double_arrays_equal_scalar(length, first, second);
+}
+
+// Predicado equivalente a `double_array_is_non_decreasing()`, usando um ciclo
+// escalar simples. Usa-se a comparação `<=`, que é falsa quando algum dos
+// itens é um NaN.
+static bool double_array_is_non_decreasing_scalar(const long length,
+						  const double items[length])
+{
+	long i = 1L;
+	while (i < length && items[i - 1] <= items[i])
 		i++;
-	return i == length;
+	return i >= length;
 }
 
-// Esta função é usada durante a ordenação de _arrays_ de `double` realizada
-// através do procedimento `qsort()` da biblioteca padrão do C. A utilização de
-// ponteiros para `void` como tipo dos seus parâmetros é um requisito do
-// procedimento `qsort()`, que, desta forma, é capaz de ordenar _arrays_ de
-// itens de qualquer tipo. O procedimento `qsort()` requer que esta função
-// devolva um valor inteiro que indica a relação de ordem entre o primeiro e o
-// segundo argumento. Se o primeiro for superior ao segundo, o valor `int`
-// devolvido deverá ser positivo. Se for igual, o valor devolvido deverá ser
-// nulo. Se for menor, deverá devolver um valor negativo. Sendo esta função de
-// utilidade restrita, optámos por lhe dar ligação local, usando para isso o
-// qualificador `static`.
-static int compare(const void *first_generic, const void *second_generic)
-{
-	// Os argumentos são ponteiros para os itens a comparar. Sendo o
-	// procedimento `qsort()` genérico, os parâmetros correspondentes são do
-	// tipo `void *`. Para aceder aos valores do tipo `double`, fazem-se
-	// coerções para o tipo ponteiro para `double`.
-	const double *first = first_generic;
-	const double *second = second_generic;
-
-	if (first < second)
-		return -1;
-	else if(first > second)
-		return 1;
-	else
-		return 0;
+#if defined(ISLA_EDA_ARRAY_OF_DOUBLES_AVX2)
+
+// Predicado equivalente a `double_array_is_non_decreasing()`, usando AVX2.
+// Comparamos 8 pares de itens consecutivos por iteração, carregando cada
+// grupo de 4 itens e o mesmo grupo deslocado de um item. A comparação
+// `_CMP_LE_OQ` tem a mesma semântica do operador `<=`. Como no caso da
+// comparação de _arrays_, termina-se logo que se encontre um par fora de
+// ordem.
+__attribute__((target("avx2")))
+static bool double_array_is_non_decreasing_avx2(const long length,
+						const double items[length])
+{
+	long i = 0L;
+	for (; i + 9L <= length; i += 8L) {
+		const __m256d low =
+			_mm256_cmp_pd(_mm256_loadu_pd(items + i),
+				      _mm256_loadu_pd(items + i + 1),
+				      _CMP_LE_OQ);
+		const __m256d high =
+			_mm256_cmp_pd(_mm256_loadu_pd(items + i + 4),
+				      _mm256_loadu_pd(items + i + 5),
+				      _CMP_LE_OQ);
+		if (_mm256_movemask_pd(_mm256_and_pd(low, high)) != 0xF)
+			return false;
+	}
+
+	return double_array_is_non_decreasing_scalar(length - i, items + i);
+}
+
+#endif // ISLA_EDA_ARRAY_OF_DOUBLES_AVX2
+
+bool double_array_is_non_decreasing(const long length,
+				    const double items[length])
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+
+#if defined(ISLA_EDA_ARRAY_OF_DOUBLES_AVX2)
+	if (has_avx2())
+		return double_array_is_non_decreasing_avx2(length, items);
+#endif
+
+	return double_array_is_non_decreasing_scalar(length, items);
+}
+
+// Função equivalente a `double_array_nan_count()`, usando um ciclo escalar
+// simples. Um item é um NaN se, e só se, for diferente de si próprio.
+static long double_array_nan_count_scalar(const long length,
+					  const double items[length])
+{
+	long count = 0L;
+	for (long i = 0L; i != length; i++)
+		count += items[i] != items[i];
+	return count;
+}
+
+#if defined(ISLA_EDA_ARRAY_OF_DOUBLES_AVX2)
+
+// Função equivalente a `double_array_nan_count()`, usando AVX2. Comparamos cada
+// grupo de 4 itens consigo próprio através de `_CMP_UNORD_Q`, que só é
+// verdadeira para NaN, e contamos os _bits_ a 1 da máscara resultante.
+// Processamos 8 itens por iteração, sem terminação antecipada, pois é
+// necessário percorrer todo o _array_.
+__attribute__((target("avx2,popcnt")))
+static long double_array_nan_count_avx2(const long length,
+					const double items[length])
+{
+	long count = 0L;
+	long i = 0L;
+	for (; i + 8L <= length; i += 8L) {
+		const __m256d low = _mm256_loadu_pd(items + i);
+		const __m256d high = _mm256_loadu_pd(items + i + 4);
+		const int mask =
+			_mm256_movemask_pd(_mm256_cmp_pd(low, low,
+							 _CMP_UNORD_Q)) |
+			_mm256_movemask_pd(_mm256_cmp_pd(high, high,
+							 _CMP_UNORD_Q)) << 4;
+		count += __builtin_popcount(mask);
+	}
+
+	return count + double_array_nan_count_scalar(length - i, items + i);
+}
+
+#endif // ISLA_EDA_ARRAY_OF_DOUBLES_AVX2
+
+long double_array_nan_count(const long length, const double items[length])
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+
+#if defined(ISLA_EDA_ARRAY_OF_DOUBLES_AVX2)
+	if (has_avx2())
+		return double_array_nan_count_avx2(length, items);
+#endif
+
+	return double_array_nan_count_scalar(length, items);
+}
+
+// Constante somada ao padrão de _bits_ de cada item antes de aplicar a função
+// de dispersão da segunda soma da impressão digital, de modo a que as duas
+// somas sejam independentes. Trata-se da parte fraccionária da razão de ouro
+// multiplicada por 2<sup>64</sup>.
+static const uint64_t second_fingerprint_offset = 0x9E3779B97F4A7C15ULL;
+
+// Função de dispersão usada nas impressões digitais. Trata-se da função de
+// finalização do algoritmo MurmurHash3, que mistura bem todos os _bits_ do
+// valor recebido e é muito barata.
+static inline uint64_t mix(uint64_t value)
+{
+	value ^= value >> 33;
+	value *= 0xFF51AFD7ED558CCDULL;
+	value ^= value >> 33;
+	value *= 0xC4CEB9FE1A85EC53ULL;
+	value ^= value >> 33;
+	return value;
+}
+
+// Devolve o padrão de _bits_ do item `item`. A cópia através de `memcpy()` é a
+// forma correcta de o fazer em C, sendo eliminada pelo compilador.
+static inline uint64_t bits_of(const double item)
+{
+	uint64_t bits;
+	memcpy(&bits, &item, sizeof(bits));
+	return bits;
+}
+
+// Acumula em `fingerprint` as contribuições dos primeiros `length` itens do
+// _array_ `items`. Usamos quatro acumuladores independentes para cada soma,
+// de modo a que o processador possa calcular em paralelo as funções de
+// dispersão de itens consecutivos.
+static void accumulate_fingerprint(const long length,
+				   const double items[length],
+				   struct double_array_fingerprint *const
+				   fingerprint)
+{
+	uint64_t first[4] = { 0, 0, 0, 0 };
+	uint64_t second[4] = { 0, 0, 0, 0 };
+
+	long i = 0L;
+	for (; i + 4L <= length; i += 4L)
+		for (int j = 0; j != 4; j++) {
+			const uint64_t bits = bits_of(items[i + j]);
+			first[j] += mix(bits);
+			second[j] += mix(bits + second_fingerprint_offset);
+		}
+	for (; i != length; i++) {
+		const uint64_t bits = bits_of(items[i]);
+		first[0] += mix(bits);
+		second[0] += mix(bits + second_fingerprint_offset);
+	}
+
+	fingerprint->length += length;
+	fingerprint->first_sum += first[0] + first[1] + first[2] + first[3];
+	fingerprint->second_sum +=
+		second[0] + second[1] + second[2] + second[3];
+}
+
+struct double_array_fingerprint double_array_fingerprint(const long length,
+						const double items[length])
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+
+	struct double_array_fingerprint fingerprint = {
+		.length = 0L,
+		.first_sum = 0,
+		.second_sum = 0
+	};
+
+	accumulate_fingerprint(length, items, &fingerprint);
+
+	return fingerprint;
+}
+
+// O número de itens de cada bloco verificado por
+// `double_array_is_sorted_permutation()`. Os blocos cabem folgadamente na
+// _cache_ de primeiro nível, pelo que a impressão digital de cada bloco é
+// calculada sobre itens acabados de ler durante a verificação da ordem, o que
+// corresponde, na prática, a uma única passagem pela memória.
+static const long verification_block_length = 2048L;
+
+bool double_array_is_sorted_permutation(const long length,
+					const double items[length],
+			const struct double_array_fingerprint fingerprint)
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+
+	struct double_array_fingerprint items_fingerprint = {
+		.length = 0L,
+		.first_sum = 0,
+		.second_sum = 0
+	};
+
+	// Cada bloco inclui o primeiro item do bloco seguinte na verificação
+	// da ordem, de modo a verificar também os pares que atravessam a
+	// fronteira entre blocos.
+	for (long i = 0L; i < length; i += verification_block_length) {
+		const long block_length =
+			length - i < verification_block_length ?
+			length - i : verification_block_length;
+		const long checked_length = block_length + (i + block_length <
+							    length ? 1L : 0L);
+
+		if (!double_array_is_non_decreasing(checked_length, items + i))
+			return false;
+
+		accumulate_fingerprint(block_length, items + i,
+				       &items_fingerprint);
+	}
+
+	return items_fingerprint.length == fingerprint.length &&
+		items_fingerprint.first_sum == fingerprint.first_sum &&
+		items_fingerprint.second_sum == fingerprint.second_sum;
+}
+
+// Predicado que devolve `true` se as impressões digitais `first` e `second`
+// forem iguais.
+static bool fingerprints_equal(const struct double_array_fingerprint first,
+			       const struct double_array_fingerprint second)
+{
+	return first.length == second.length &&
+		first.first_sum == second.first_sum &&
+		first.second_sum == second.second_sum;
+}
+
+// Os NaN finais são excluídos da verificação da ordem, que falharia com eles,
+// mas não da impressão digital, que depende apenas dos padrões de _bits_.
+bool double_array_is_sorted_permutation_nans_last(const long length,
+						  const double items[length],
+			const struct double_array_fingerprint fingerprint)
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+
+	long numbers = length;
+	while (numbers != 0L && isnan(items[numbers - 1]))
+		numbers--;
+
+	return double_array_is_non_decreasing(numbers, items) &&
+		fingerprints_equal(double_array_fingerprint(length, items),
+				   fingerprint);
+}
+
+// Para além de excluir os NaN iniciais (negativos) e finais (positivos) da
+// verificação da ordem, é necessário verificar que nenhum zero positivo
+// precede um zero negativo, pois o operador `<=` não os distingue.
+bool double_array_is_total_order_sorted_permutation(const long length,
+						    const double items[length],
+			const struct double_array_fingerprint fingerprint)
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+
+	long first = 0L;
+	while (first != length && isnan(items[first]) && signbit(items[first]))
+		first++;
+
+	long last = length;
+	while (last != first && isnan(items[last - 1]) &&
+	       !signbit(items[last - 1]))
+		last--;
+
+	if (!double_array_is_non_decreasing(last - first, items + first))
+		return false;
+
+	for (long i = first + 1; i < last; i++)
+		if (items[i] == 0.0 && signbit(items[i]) &&
+		    items[i - 1] == 0.0 && !signbit(items[i - 1]))
+			return false;
+
+	return fingerprints_equal(double_array_fingerprint(length, items),
+				  fingerprint);
 }
 
 double double_array_average(const long length, const double items[length])
@@ -246,14 +962,93 @@ double double_array_stddev(const long length, const double items[length])
 	return sqrt(sum / length);
 }
 
-// Usamos uma forma de cálculo muito ineficaz: ordenar o _array_ de modo
-// a obter a mediana através do ou dos valores centrais. Há formas bem
-// mais eficazes de calcular a mediana. Nomeadamente, pode-se usar uma
-// versão modificada do algoritmo de ordenação rápida que não se
-// preocupa em ordenar o _array_, mas apenas em realizar
-// particionamentos sucessivos até determinar o valor do ou dos itens
-// centrais do _array_, que não precisa por isso de ser totalmente
-// ordenado.
+// Procedimento auxiliar que troca os itens nas posições `i` e `j` do _array_
+// `items`.
+static inline void swap_items(double items[], const long i, const long j)
+{
+	const double item = items[i];
+	items[i] = items[j];
+	items[j] = item;
+}
+
+// Função auxiliar que devolve o item que ficaria na posição `n` do _array_
+// `items`, com `length` itens, se este fosse ordenado, deixando antes dessa
+// posição apenas itens menores ou iguais e depois dela apenas itens maiores ou
+// iguais. Trata-se da selecção rápida (_quickselect_): tal como na ordenação
+// rápida, o _array_ é particionado em torno de um _pivot_, mas apenas o
+// segmento que contém a posição `n` volta a ser particionado. O tempo é O(_n_)
+// em média. O _pivot_ é a mediana do primeiro, do último e do item central,
+// o que evita o pior caso, O(_n_<sup>2</sup>), com _arrays_ já ordenados ou
+// por ordem inversa. Ao contrário de `qsort()`, as comparações são feitas
+// directamente, sem invocar indirectamente uma função de comparação.
+static double select_item(const long length, double items[length], const long n)
+{
+	long first = 0L;
+	long last = length - 1;
+
+	while (first < last) {
+		const long middle = first + (last - first) / 2;
+		if (items[middle] < items[first])
+			swap_items(items, first, middle);
+		if (items[last] < items[middle]) {
+			swap_items(items, middle, last);
+			if (items[middle] < items[first])
+				swap_items(items, first, middle);
+		}
+		const double pivot = items[middle];
+
+		// No fim do particionamento, os itens em [`first`, `j`] não
+		// são maiores do que o _pivot_, os itens em [`i`, `last`] não
+		// são menores e os itens entre `j` e `i`, se existirem, são
+		// iguais ao _pivot_.
+		long i = first;
+		long j = last;
+		while (i <= j) {
+			while (items[i] < pivot)
+				i++;
+			while (pivot < items[j])
+				j--;
+			if (i <= j)
+				swap_items(items, i++, j--);
+		}
+
+		if (n <= j)
+			last = j;
+		else if (n >= i)
+			first = i;
+		else
+			return items[n];
+	}
+
+	return items[n];
+}
+
+// Se o número de itens for par, a mediana é a média dos dois itens centrais.
+// Depois de seleccionado o item central superior, os itens anteriores são
+// todos menores ou iguais, pelo que o item central inferior é o maior deles.
+double double_array_median_in_place(const long length, double items[length])
+{
+	assert(length >= 1L);
+	assert(items != NULL);
+
+	const long half = length / 2;
+	const double upper = select_item(length, items, half);
+
+	if (length % 2 != 0L)
+		return upper;
+
+	double lower = items[0];
+	for (long i = 1L; i < half; i++)
+		if (items[i] > lower)
+			lower = items[i];
+
+	return (lower + upper) / 2;
+}
+
+// Em vez de ordenar o _array_ para obter o ou os valores centrais, usamos a
+// selecção rápida (ver `double_array_median_in_place()`), que realiza
+// particionamentos sucessivos até determinar o valor do item central, sem
+// ordenar o _array_.
 double double_array_median(const long length, const double items[length])
 {
 	assert(length >= 0L);
@@ -264,23 +1059,22 @@ double double_array_median(const long length, const double items[length])
 		return NAN;
 
 	// Criamos um _array_ de trabalho que é uma cópia do _array_ original,
-	// pois este não deve ser alterado.
-	double work_items[length];
+	// pois este não deve ser alterado. É reservado no monte, e não na
+	// pilha, para que o _array_ possa ter qualquer dimensão.
+	double *const work_items = new_double_array_of(length);
+	if (work_items == NULL)
+		return NAN;
 	copy_double_array(length, work_items, items);
 
-	// Usamos o procedimento de ordenação genérico do C `qsort()`, que
-	// utiliza o algoritmo de ordenação rápida, para ordenar o _array_ de
-	// trabalho.
-	qsort(work_items, length, sizeof(double), compare);
-
 	// Se o _array_ tiver um número par de itens, a sua mediana é a média
 	// aritmética dos valores dos dois itens mais próximos do meio do
 	// _array_ ordenado. Se tiver um número ímpar de itens, então a mediana
 	// é o valor do item central do _array_ ordenado.
-	if (length % 2 == 0L)
-		return (work_items[length / 2 - 1] + work_items[length / 2]) / 2;
-	else
-		return work_items[length / 2];
+	const double median = double_array_median_in_place(length, work_items);
+
+	free(work_items);
+
+	return median;
 }
 
 // Note que esta função está definida mesmo para zero itens, devolvendo infinito
@@ -343,35 +1137,37 @@ struct double_statistics double_array_statistics(const long length,
 		return statistics;
 
 	// Uma vez que se calculam as várias estatísticas numa única função,
-	// podemos fazer algumas optimizações. Ainda assim, seria possível
-	// melhorar francamente a forma de cálculo da mediana, como referido
-	// anteriormente.
-	double work_items[length];
+	// podemos fazer algumas optimizações: a cópia para o _array_ de
+	// trabalho, as somas, o mínimo e o máximo são obtidos numa única
+	// passagem, e a mediana é obtida por selecção, sem ordenar o _array_.
+	// O _array_ de trabalho é reservado no monte. Se não for possível
+	// reservá-lo, as restantes estatísticas são calculadas na mesma, mas a
+	// mediana fica com o valor especial NaN.
+	double *const work_items = new_double_array_of(length);
 
 	double sum = 0.0;
 	double sum_of_squares = 0.0;
 
 	for (long i = 0L; i != length; i++) {
-		work_items[i] = items[i];
+		if (work_items != NULL)
+			work_items[i] = items[i];
 		sum += items[i];
 		sum_of_squares += square_of(items[i]);
+		if (items[i] < statistics.minimum)
+			statistics.minimum = items[i];
+		if (items[i] > statistics.maximum)
+			statistics.maximum = items[i];
 	}
 
 	statistics.average = sum / length;
 	statistics.stddev =
 		sqrt(sum_of_squares / length - square_of(statistics.average));
 
-	qsort(work_items, length, sizeof(double), compare);
-
-	statistics.minimum = work_items[0];
-
-	if (length % 2 == 0L)
+	if (work_items != NULL) {
 		statistics.median =
-			(work_items[length / 2 - 1] + work_items[length / 2]) / 2;
-	else
-		statistics.median = work_items[length / 2];
-
-	statistics.maximum = work_items[length - 1];
+			double_array_median_in_place(length, work_items);
+		free(work_items);
+	}
 
 	return statistics;
 }
@@ -17,6 +17,10 @@
 // `bool` e os seus dois valores `true` e `false`.
 #include <stdbool.h>
 
+// Incluímos o ficheiro de interface `stdint.h` para podermos usar o tipo
+// `uint64_t`.
+#include <stdint.h>
+
 // Para podemos calcular a partir de _arrays_ de `double`, de uma só vez, todas
 // as estatísticas em que estamos interessados, é conveniente usar uma estrutura
 // para as representar.
@@ -44,6 +48,60 @@ double *new_double_array_of(long length);
 // ser `NULL`. Nesse caso admite-se que o _array_ a dimensionar tem zero itens.
 double *resize_double_array_to(double *items, long new_length);
 
+// O número máximo de _threads_ usadas para tocar pela primeira vez nas páginas
+// de um _array_ (ver `struct allocation_hints`).
+#define maximum_touch_threads 256
+
+// Para podermos controlar a forma como a memória dos _arrays_ de maiores
+// dimensões é reservada, usamos uma estrutura com as indicações a passar ao
+// sistema operativo. Estas indicações são apenas sugestões: se o sistema
+// operativo não as suportar, a memória é reservada da forma usual.
+struct allocation_hints {
+	// Se `true`, sugere-se ao sistema operativo que use páginas enormes
+	// (_huge pages_), reduzindo assim as falhas na TLB (_translation
+	// lookaside buffer_) durante o acesso a _arrays_ de grandes dimensões.
+	bool huge_pages;
+	// Se `true`, as páginas são distribuídas alternadamente por todos os
+	// nós NUMA da máquina. Se `false`, cada página fica no nó NUMA do
+	// processador que lhe tocar primeiro.
+	bool interleaved;
+	// O número de _threads_ a usar para tocar pela primeira vez em todas
+	// as páginas do _array_ logo após a sua reserva (ou para copiar os
+	// itens, no caso de `place_double_array()`). Se for 0, as páginas não
+	// são tocadas durante a reserva, pelo que as respectivas faltas de
+	// página ocorrerão apenas durante a sua primeira utilização. Não pode
+	// exceder `maximum_touch_threads`.
+	int touch_threads;
+};
+
+// Rotina que cria um novo _array_ com `length` items `double`, seguindo as
+// indicações dadas por `hints`. Os itens são inicializados com zero se
+// `hints.touch_threads` for positivo e ficam por inicializar no caso
+// contrário. O primeiro item do _array_ fica alinhado com uma linha de _cache_
+// (64 _bytes_). Devolve um ponteiro para o novo _array_. Devolve `NULL` em caso
+// de erro. O _array_ devolvido tem de ser libertado através do procedimento
+// `free_placed_double_array()`, e não de `free()`. O valor de `length` não
+// pode ser negativo e o valor de `hints.touch_threads` tem de estar entre 0 e
+// `maximum_touch_threads`.
+double *new_placed_double_array_of(long length, struct allocation_hints hints);
+
+// Rotina que cria um novo _array_ com `length` items `double`, seguindo as
+// indicações dadas por `hints`, copia para ele os itens do _array_ `items`, e
+// liberta este último através de `free()`. Devolve um ponteiro para o novo
+// _array_. Devolve `NULL` em caso de erro, caso em que o _array_ `items` não é
+// libertado. O _array_ devolvido tem de ser libertado através do procedimento
+// `free_placed_double_array()`. O valor de `length` não pode ser negativo e o
+// valor de `hints.touch_threads` tem de estar entre 0 e
+// `maximum_touch_threads`. O valor de `items` pode ser `NULL`, mas apenas se
+// `length` for zero.
+double *place_double_array(long length, double items[length],
+			   struct allocation_hints hints);
+
+// Procedimento que liberta o _array_ `items`, que tem de ter sido criado
+// através de `new_placed_double_array_of()` ou de `place_double_array()`. O
+// valor de `items` pode ser `NULL`, não tendo nesse caso qualquer efeito.
+void free_placed_double_array(double items[]);
+
 // Rotina que lê todos os `double` que conseguir a partir do ficheiro cujo nome
 // é passado como argumento e os guarda num _array_. Devolve o _array_ com os
 // valores lidos do ficheiro. Devolve `NULL` em caso de erro. Em caso de
@@ -55,17 +113,83 @@ double *read_double_array_from(const char *file_name, long *length);
 // `original` para o _array_ de `double` `copy`. Ambos os _arrays_ têm de conter
 // pelo menos `length` items. O valor de `length` tem de ser não negativo. Os
 // valores de `original` e de `copy` podem ser nulos, mas apenas se `length`
-// tiver o valor zero.
+// tiver o valor zero. Os dois _arrays_ não se podem sobrepor. Quando o
+// processador o suporta, a cópia usa instruções vectoriais AVX2 e, para
+// _arrays_ maiores do que a _cache_ de último nível, escritas não temporais.
 void copy_double_array(long length, double copy[length],
 		const double original[length]);
 
 // Predicado que devolve `true` se os primeiros _length_ itens dos _arrays_ de
 // `double` `first` e `second` forem iguais. Devolve `false` no caso contrário.
 // O valor de `length` não pode ser negativo. Os valores de `first` e `second`
-// podem ser `NULL`, mas apenas se o valor de `length` for zero.
+// podem ser `NULL`, mas apenas se o valor de `length` for zero. Quando o
+// processador o suporta, a comparação usa instruções vectoriais AVX2,
+// comparando 64 _bytes_ de cada vez e terminando na primeira diferença.
 bool double_arrays_equal(long length, const double first[length],
 			const double second[length]);
 
+// Predicado que devolve `true` se os primeiros `length` itens do _array_ de
+// `double` `items` estiverem por ordem não decrescente. Devolve `false` no caso
+// contrário, incluindo quando algum dos itens é um NaN (desde que `length`
+// seja pelo menos dois). O valor de `length` não pode ser negativo. O valor de
+// `items` pode ser `NULL`, mas apenas se `length` for zero. Quando o
+// processador o suporta, a verificação usa instruções vectoriais AVX2.
+bool double_array_is_non_decreasing(long length, const double items[length]);
+
+// Função que devolve o número de NaN entre os primeiros `length` itens do
+// _array_ de `double` `items`. O valor de `length` não pode ser negativo. O
+// valor de `items` pode ser `NULL`, mas apenas se `length` for zero. Quando o
+// processador o suporta, a contagem usa instruções vectoriais AVX2.
+long double_array_nan_count(long length, const double items[length]);
+
+// Para verificar se um _array_ é uma permutação de outro sem guardar uma cópia
+// ordenada deste último, usamos uma impressão digital do multiconjunto dos seus
+// itens. A impressão digital é composta pelo número de itens e por duas somas
+// (módulo 2<sup>64</sup>) de funções de dispersão diferentes aplicadas ao
+// padrão de _bits_ de cada item. Sendo somas, não dependem da ordem dos itens.
+// _Arrays_ que são permutações um do outro têm sempre a mesma impressão
+// digital. _Arrays_ que não o são têm impressões digitais diferentes com uma
+// probabilidade esmagadora.
+struct double_array_fingerprint {
+	long length;
+	uint64_t first_sum;
+	uint64_t second_sum;
+};
+
+// Função que devolve a impressão digital dos primeiros `length` itens do
+// _array_ de `double` `items`. O valor de `length` não pode ser negativo. O
+// valor de `items` pode ser `NULL`, mas apenas se `length` for zero.
+struct double_array_fingerprint double_array_fingerprint(long length,
+						const double items[length]);
+
+// Predicado que devolve `true` se os primeiros `length` itens do _array_ de
+// `double` `items` estiverem por ordem não decrescente e forem uma permutação
+// dos itens do _array_ cuja impressão digital é `fingerprint`. Ambas as
+// verificações são feitas numa única passagem pelo _array_ `items`, sem
+// necessidade de memória adicional. O valor de `length` não pode ser negativo.
+// O valor de `items` pode ser `NULL`, mas apenas se `length` for zero.
+bool double_array_is_sorted_permutation(long length, const double items[length],
+				struct double_array_fingerprint fingerprint);
+
+// Predicado semelhante a `double_array_is_sorted_permutation()`, mas que admite
+// NaN no fim do _array_, i.e., que devolve `true` se os itens de `items` forem
+// uma permutação dos itens com impressão digital `fingerprint` e consistirem
+// numa sequência de itens não NaN por ordem não decrescente seguida de zero ou
+// mais NaN. As restrições sobre os argumentos são as mesmas.
+bool double_array_is_sorted_permutation_nans_last(long length,
+						  const double items[length],
+				struct double_array_fingerprint fingerprint);
+
+// Predicado semelhante a `double_array_is_sorted_permutation()`, mas que
+// verifica a ordenação de acordo com a relação de ordem total `totalOrder` da
+// norma IEEE 754: os NaN com sinal negativo no início, seguidos dos restantes
+// itens por ordem não decrescente, com os zeros negativos antes dos positivos,
+// e dos NaN com sinal positivo no fim. Os NaN com o mesmo sinal podem estar por
+// qualquer ordem. As restrições sobre os argumentos são as mesmas.
+bool double_array_is_total_order_sorted_permutation(long length,
+						    const double items[length],
+				struct double_array_fingerprint fingerprint);
+
 // Função que devolve o valor médio dos primeiros `length` itens do _array_ de
 // `double` `items`. O valor de `length` não pode ser negativo. Devolve o valor
 // especial NaN se `length` for zero. O valor de `items` pode ser `NULL`, mas
@@ -80,10 +204,18 @@ double double_array_stddev(long length, const double items[length]);
 
 // Função que devolve o valor mediano dos primeiros `length` itens do _array_ de
 // `double` `items`. O valor de `length` não pode ser negativo. Devolve o valor
-// especial NaN se `length` for zero. O valor de `items` pode ser `NULL`, mas
-// apenas se `length` for zero.
+// especial NaN se `length` for zero ou se não for possível reservar a cópia de
+// trabalho dos itens. O valor de `items` pode ser `NULL`, mas apenas se
+// `length` for zero.
 double double_array_median(long length, const double items[length]);
 
+// Função que devolve o valor mediano dos primeiros `length` itens do _array_ de
+// `double` `items`, trabalhando directamente sobre o _array_, sem reservar uma
+// cópia. Os itens do _array_ ficam reordenados, mas não necessariamente
+// ordenados. O valor de `length` tem de ser positivo. É usada também pela
+// biblioteca `benchmark` para obter a mediana dos tempos medidos.
+double double_array_median_in_place(long length, double items[length]);
+
 // Função que devolve o valor mínimo dos primeiros `length` itens do _array_ de
 // `double` `items`. O valor de `length` não pode ser negativo. Devolve o valor
 // ∞ se `length` for zero. O valor de `items` pode ser `NULL`, mas
@@ -100,8 +232,9 @@ double double_array_maximum(long length, const double items[length]);
 // contendo várias estatísticas dos primeiros `length` itens do _array_ de
 // `double` `items`. O valor de `length` não pode ser negativo. Se `length` for
 // zero, a média, o desvio padrão e a mediana têm o valor especial NaN, o mínimo
-// tem o valor ∞ e o máximo tem o valor -∞. O valor de `items` pode ser
-// `NULL`, mas apenas se `length` for zero.
+// tem o valor ∞ e o máximo tem o valor -∞. A mediana tem também o valor
+// especial NaN se não for possível reservar a cópia de trabalho dos itens. O
+// valor de `items` pode ser `NULL`, mas apenas se `length` for zero.
 struct double_statistics double_array_statistics(long length,
 						const double items[length]);
 
@@ -33,10 +33,7 @@
 //   representando um canal estabelecido para um ficheiro, e a macro `stderr`,
 //   representando o canal de escrita de mensagens de erros.
 //
-// - `string.h` &ndash; Para podermos usar a função `strcmp()`.
-//
-// - `time.h` &ndash; Para podermos usar a função `clock()`, o tipo `clock_t` e
-//   a macro `CLOCKS_PER_SEC`.
+// - `string.h` &ndash; Para podermos usar as funções `strcmp()` e `strncmp()`.
 //
 // - `stdbool.h` &ndash; Para podermos usar o tipo booleano ou lógico `bool` e
 //   os seus dois valores `false` e `true`.
@@ -48,7 +45,6 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
-#include <time.h>
 #include <stdbool.h>
 #include <math.h>
 #include <assert.h>
@@ -68,8 +64,27 @@
 //   alvo a experimentação realizada, bem como algumas ferramentas auxiliares
 //   (ver [`sorting_algorithms.h`](sorting_algorithms.h.html) e
 //   [`sorting_algorithms.c`](sorting_algorithms.c.html)).
+//
+// - `scratch_arena.h` &ndash; Ficheiro de interface do módulo `scratch_arena`,
+//   que fornece as arenas de memória de rascunho onde os algoritmos de
+//   ordenação reservam os seus _arrays_ auxiliares (ver
+//   [`scratch_arena.h`](scratch_arena.h.html) e
+//   [`scratch_arena.c`](scratch_arena.c.html)).
+//
+// - `results_file.h` &ndash; Ficheiro de interface do módulo `results_file`,
+//   que escreve os resultados em formato longo, em JSON Lines ou num formato
+//   colunar binário (ver [`results_file.h`](results_file.h.html) e
+//   [`results_file.c`](results_file.c.html)).
+//
+// - `benchmark.h` &ndash; Ficheiro de interface da biblioteca `benchmark`,
+//   partilhada pelos vários projectos, que realiza as medições dos tempos de
+//   execução (ver [`benchmark.h`](../benchmark/benchmark.h.html) e
+//   [`benchmark.c`](../benchmark/benchmark.c.html)).
 #include "array_of_doubles.h"
 #include "sorting_algorithms.h"
+#include "scratch_arena.h"
+#include "results_file.h"
+#include "benchmark.h"
 
 // Definição de constantes
 // -----------------------
@@ -77,40 +92,40 @@
 // Definimos agora algumas constantes que determinam alguns dos parâmetros
 // experimentais.
 
-// Expressa em _clocks_, ou seja, em tiques do relógio. Esta constante indica o
-// número mínimo de tiques de relógio a usar nas medições. Na máquina em que
-// este programa foi testado, o relógio (tal como medido pela função `clock()`)
-// tem um valor de `CLOCKS_PER_SEC` de 1&thinsp;000&thinsp;000. Logo, nenhuma
-// medição será feita com intervalos de tempo inferiores a 1 segundo. Em
-// ambientes onde o valor de `CLOCKS_PER_SEC` seja inferior, poderá ser
-// necessário baixar a precisão, sob pena de as experiências se tornarem
-// demasiado demoradas.
+// Os parâmetros das medições dos tempos de execução, que são realizadas através
+// da biblioteca [`benchmark`](../benchmark/benchmark.h.html):
+//
+// - A precisão, em segundos. Quando o tempo de execução de um algoritmo for
+//   inferior a esta precisão, serão realizadas tantas execuções quantas
+//   necessárias para exceder este tempo, sendo o tempo de cada uma das
+//   execuções estimado através do quociente entre o tempo total das execuções
+//   sucessivas e o número de execuções realizadas (subtraindo-se depois o tempo
+//   necessário para, através de uma cópia, colocar no seu estado inicial, antes
+//   de cada ordenação, o _array_ a ordenar). Estas execuções sucessivas
+//   destinam-se a lidar com questões de resolução do relógio usado. Não as
+//   confunda com as repetições efectuadas com fins estatísticos, pois estas
+//   lidam com as flutuações do tempo de execução devido às condições de carga
+//   da máquina e outros efeitos com origem externa ao programa.
+//
+// - O número de execuções de aquecimento, cujo tempo é ignorado.
+//
+// - O limiar do tempo acumulado das repetições das estimativas, realizadas
+//   para fins estatísticos, em segundos. Quando é excedido, as repetições são
+//   interrompidas, de modo a que as experiências não se tornem demasiado
+//   demoradas. Naturalmente, as estatísticas obtidas serão tão piores quanto
+//   menor for o número de repetições realizadas. Um valor de 300 limita as
+//   repetições a cerca de cinco minutos.
+//
+// - O número máximo de repetições a efectuar para fins estatísticos.
 //
-// Quando o tempo de execução de um algoritmo for inferior à precisão dada por
-// esta variável, serão realizadas tantas execuções quantas necessárias para
-// exceder este tempo, sendo o tempo de cada uma das execuções estimado através
-// do quociente entre o tempo total das execuções sucessivas e o número de
-// execuções realizadas (subtraindo-se depois o tempo necessário para, através
-// de uma cópia, colocar no seu estado inicial, antes de cada ordenação, o
-// _array_ a ordenar). Estas execuções sucessivas destinam-se a lidar com
-// questões de resolução do relógio usado. Não as confunda com as repetições
-// efectuadas com fins estatísticos, pois estas lidam com as flutuações do tempo
-// de execução devido às condições de carga da máquina e outros efeitos com
-// origem externa ao programa.
-static const clock_t clock_precision = 1000000U; // clocks (tics)
-
-// Quando o tempo acumulado das repetições das estimativas do tempo de execução
-// da ordenação, repetições essas realizadas para fins estatísticos, exceder
-// este limiar, as repetições são interrompidas. Este limiar está expresso em
-// segundos e tenta garantir que as experiências não se tornam demasiado
-// demoradas. Naturalmente, as estatísticas obtidas serão tão piores quanto
-// menor for o número de repetições realizadas. Um valor de 300 limita as
-// repetições a cerca de cinco minutos.
-static const double threshold_repetition_time = 300.0; // seconds
-
-// O número de repetições a efectuar para fins estatísticos é também limitado
-// pelo valor desta constante.
-static const long maximum_number_of_repetions = 1001L;
+// - Se as _caches_ devem ser esvaziadas antes de cada execução.
+static const struct benchmark_settings benchmark_settings = {
+	.precision = 1.0, // seconds
+	.warm_up_runs = 1L,
+	.maximum_repetition_time = 300.0, // seconds
+	.maximum_repetitions = 1001L,
+	.flush_cache = false
+};
 
 // Se o tempo de execução de um dado algoritmo se tornar superior a este limiar
 // para uma dada dimensão do _array_ a ordenar, esse algoritmo será excluído das
@@ -130,14 +145,86 @@ static const long maximum_file_size = 1L << 24;
 // nomes dos ficheiros seguem o padrão `_tipo___dimensão_`, em que o tipo pode
 // ser uma dos valores deste _array_ e a dimensão é uma potência de 2 entre 2 e
 // 2<sup>24</sup> (16&thinsp;777&thinsp;216) itens. O número de itens do _array_
-// é dado pela constante `number_of_file_types`.
+// é dado pela constante `number_of_file_types`. Os ficheiros do tipo
+// `with_nans` contêm itens baralhados entre os quais surgem NaN (com ambos os
+// sinais), infinitos e zeros com ambos os sinais. Servem para verificar e
+// medir a ordenação na presença de NaN (ver `nan_handling_for()`).
 const char *const file_types[] = {
 	"sorted",
 	"partially_sorted",
-	"shuffled"
+	"shuffled",
+	"with_nans"
 };
 const int number_of_file_types = sizeof(file_types) / sizeof(file_types[0]);
 
+// Estrutura de opções
+// -------------------
+
+// Esta estrutura guarda as opções experimentais escolhidas através da linha de
+// comandos. Cada opção corresponde a um argumento opcional do programa.
+struct experiment_options {
+	// Se `true` (opção `--cold-scratch`), a memória auxiliar usada pelos
+	// algoritmos de ordenação é reservada e devolvida ao sistema operativo
+	// em cada execução, sendo o respectivo custo incluído nos tempos
+	// medidos. Se `false`, essa memória é reservada uma única vez por
+	// dimensão, numa arena de memória de rascunho, e reutilizada em todas
+	// as execuções.
+	bool cold_scratch;
+	// As indicações usadas na reserva dos _arrays_ com os itens a ordenar,
+	// com os itens ordenados e de trabalho. Por omissão sugere-se o uso de
+	// páginas enormes (pode ser desligado através da opção
+	// `--no-huge-pages`), as páginas ficam no nó NUMA do processador que
+	// lhes toca primeiro (a opção `--interleave` distribui-as por todos os
+	// nós) e usa-se uma única _thread_ para lhes tocar (a opção
+	// `--touch-threads=N` permite usar `N` _threads_, até
+	// `maximum_touch_threads`).
+	struct allocation_hints allocation;
+	// Os nomes dos ficheiros onde, para além do ficheiro CSV, se escrevem
+	// os resultados em formato longo, um por cada formato suportado (opções
+	// `--jsonl=FICHEIRO` e `--columnar=FICHEIRO`). Um valor `NULL` indica
+	// que os resultados não são escritos no formato correspondente.
+	const char *results_file_names[number_of_results_formats];
+	// Se `true` (opção `--cold-cache`), os tempos de execução são medidos
+	// também com as _caches_ frias, ou seja, esvaziando-as antes de cada
+	// ordenação, e registados lado a lado com os tempos habituais, medidos
+	// com as _caches_ quentes.
+	bool cold_cache;
+	// O número de cópias independentes dos itens a ordenar pelas quais se
+	// vai rodando nas medições com as _caches_ frias (opção
+	// `--cold-copies=N`, com `N` ≥ 2). Dessa forma, o _array_ ordenado em
+	// cada execução não é o mesmo que foi ordenado (e restaurado) na
+	// execução anterior.
+	int cold_copies;
+	// Se `true` (opção `--reference`), a correcção das ordenações é
+	// verificada também por comparação com os itens ordenados lidos do
+	// ficheiro de referência `sorted_N.txt`. Se `false`, esse ficheiro nem
+	// sequer é lido, sendo a correcção verificada apenas confirmando que o
+	// resultado está por ordem não decrescente e é uma permutação dos
+	// itens a ordenar, através da sua impressão digital.
+	bool reference_check;
+	// Se `true` (opção `--total-order`), os itens são ordenados de acordo
+	// com a ordem total da norma IEEE 754, qualquer que seja o tipo de
+	// ficheiro. Se `false`, os itens dos ficheiros do tipo `with_nans` são
+	// ordenados com os NaN no fim e os restantes são ordenados
+	// directamente.
+	bool total_order;
+};
+
+// Constante usada para inicializar as opções com os seus valores por omissão.
+static const struct experiment_options default_options = {
+	.cold_scratch = false,
+	.allocation = {
+		.huge_pages = true,
+		.interleaved = false,
+		.touch_threads = 1
+	},
+	.results_file_names = { NULL, NULL },
+	.cold_cache = false,
+	.cold_copies = 2,
+	.reference_check = false,
+	.total_order = false
+};
+
 // Estrutura de estatísticas e seu valor inicial
 // ---------------------------------------------
 
@@ -159,6 +246,9 @@ struct algorithm_statistics {
 	// média, o seu desvio padrão, a mediana, o tempo mínimo e o tempo
 	// máximo.
 	struct double_statistics times;
+	// Estatísticas dos tempos de execução do algoritmo com as _caches_
+	// frias, obtidas apenas quando isso é pedido através das opções.
+	struct double_statistics cold_times;
 };
 
 // Constante usada para inicializar as variáveis de estatísticas.
@@ -176,6 +266,13 @@ static const struct algorithm_statistics initial_statistics = {
 		.median = NAN,
 		.minimum = INFINITY,
 		.maximum = -INFINITY
+	},
+	.cold_times = {
+		.average = NAN,
+		.stddev = NAN,
+		.median = NAN,
+		.minimum = INFINITY,
+		.maximum = -INFINITY
 	}
 };
 
@@ -197,156 +294,186 @@ static bool valid_file_type(const char* file_type)
 	return i != number_of_file_types;
 }
 
-// Função que devolve uma estimativa do tempo necessário para copiar o conteúdo
-// do _array_ `items` para o _array_ `work_items`. Ambos os _arrays_ têm de ter
-// pelo menos `length` itens. O tempo é devolvido em segundos. A estimativa é
-// realizada com uma precisão dada pela constante `clock_precision`.
-static double copy_time_estimate(const long length, double work_items[length],
-				 const double items[length])
+// Devolve a forma de lidar com os NaN ao ordenar os ficheiros do tipo
+// `file_type`, dadas as opções experimentais `options`. Apenas os ficheiros do
+// tipo `with_nans` contêm NaN, pelo que só esses requerem que se lide com eles,
+// excepto quando se pede a ordem total, que distingue também os zeros
+// negativos dos positivos.
+static enum nan_handling nan_handling_for(const char *const file_type,
+					  const struct experiment_options *const
+					  options)
 {
-	assert(length > 0L);
-	assert(work_items != NULL);
-	assert(items != NULL);
-
-	printf("\tEstimating copy time...\n");
+	if (options->total_order)
+		return total_order_nan_handling;
+	if (strcmp(file_type, "with_nans") == 0)
+		return nans_last_nan_handling;
+	return no_nan_handling;
+}
 
-	// Um primeiro ciclo estima o número de execuções da cópia necessárias
-	// para atingir a precisão pretendida.
-	long runs = 0L;
-	clock_t start = clock();
+// Esta estrutura guarda o contexto passado às rotinas `prepare_sort()` e
+// `run_sort()` durante as medições dos tempos de execução: o algoritmo a
+// usar, a forma de lidar com os NaN, o _array_ de trabalho `work_items`, a
+// ordenar, e o _array_ `items`, a partir do qual o _array_ de trabalho é
+// preparado antes de cada ordenação.
+struct sort_context {
+	struct sorting_algorithm algorithm;
+	enum nan_handling nan_handling;
+	long length;
+	double *work_items;
+	const double *items;
+};
 
-	do {
-		copy_double_array(length, work_items, items);
-		runs++;
-	} while(clock() - start < clock_precision);
+// Prepara uma ordenação, copiando os itens do _array_ `items` do contexto para
+// o _array_ de trabalho `work_items`. O tempo desta cópia é estimado e
+// descontado pela biblioteca `benchmark`.
+static bool prepare_sort(void *const generic_context)
+{
+	const struct sort_context *const context = generic_context;
 
-	// Uma vez que a obtenção da estimativa do número de execuções teve de
-	// recorrer a invocações repetidas da função `clock()`, o que poderia
-	// viciar uma estimativa do tempo de cópia que se baseasse no tempo de
-	// acumulado da execução do ciclo, repetimos o mesmo número de
-	// execuções, desta vez sem invocações intermédias à função `clock()`.
-	start = clock();
+	copy_double_array(context->length, context->work_items, context->items);
 
-	for (long i = 0L; i != runs; i++)
-		copy_double_array(length, work_items, items);
+	return false;
+}
 
-	double copy_time = (double) (clock() - start) / CLOCKS_PER_SEC / runs;
+// Ordena o _array_ de trabalho do contexto usando o seu algoritmo e lidando
+// com os NaN da forma indicada no contexto. Devolve `true` em caso de erro.
+static bool run_sort(void *const generic_context)
+{
+	const struct sort_context *const context = generic_context;
 
-	printf("\tCopy time estimated to be %g seconds (based on %ld runs).\n",
-	       copy_time, runs);
+	if (sort_handling_nans(context->algorithm.sort, context->nan_handling,
+			       context->length, context->work_items)) {
+		fprintf(stderr, "Error: could not run sorting algorithm "
+			"'%s'.\n", context->algorithm.name);
+		return true;
+	}
 
-	return copy_time;
+	return false;
 }
 
-// Função que devolve uma estimativa do tempo de execução do algoritmo de
-// ordenação dado por `algorithm`, quando aplicado à ordenação do _array_
-// `work_itens` com `length` itens, obtido por cópia do _array_ `items` com o
-// mesmo número de itens. A estimativa é realizada recorrendo à acumulação do
-// tempo de `runs` execuções sucessivas. Uma vez que cada execução do algoritmo
-// tem de ser precedida da cópia dos itens do _array_ `items` para o _array_
-// `work_items`, o tempo estimado para essa cópia, `copy_time`, é subtraído ao
-// quociente entre o tempo total acumulado e o número de execuções `runs`. Em
-// caso de erro, devolve um valor negativo.
-static double sort_time_estimate(struct sorting_algorithm algorithm,
-				 const long length, double work_items[length],
-				 const double items[length], const long runs,
-				 const double copy_time)
-{
-	assert(length > 0L);
-	assert(work_items != NULL);
-	assert(items != NULL);
-	assert(runs > 0L);
-	assert(copy_time > 0.0);
-
-	clock_t start = clock();
+// Esta estrutura guarda o contexto passado às rotinas `run_cold_sort()` e
+// `restore_cold_sort()` durante as medições dos tempos de execução com as
+// _caches_ frias: o algoritmo a usar, a forma de lidar com os NaN, as
+// `number_of_copies` cópias independentes dos itens a ordenar, o _array_
+// `items`, a partir do qual as cópias são restauradas depois de ordenadas, e a
+// posição `next` da cópia a ordenar na próxima execução.
+struct cold_sort_context {
+	struct sorting_algorithm algorithm;
+	enum nan_handling nan_handling;
+	long length;
+	int number_of_copies;
+	double *const *copies;
+	const double *items;
+	int next;
+};
 
-	for (long i = 0; i != runs; i++) {
-		copy_double_array(length, work_items, items);
+// Ordena a próxima cópia dos itens do contexto usando o seu algoritmo e lidando
+// com os NaN da forma indicada no contexto. Devolve `true` em caso de erro.
+static bool run_cold_sort(void *const generic_context)
+{
+	const struct cold_sort_context *const context = generic_context;
 
-		if(algorithm.sort(length, work_items)) {
-			fprintf(stderr, "Error: could not run sorting "
-				"algorithm '%s'.\n", algorithm.name);
-			return -1.0;
-		}
+	if (sort_handling_nans(context->algorithm.sort, context->nan_handling,
+			       context->length,
+			       context->copies[context->next])) {
+		fprintf(stderr, "Error: could not run sorting algorithm "
+			"'%s'.\n", context->algorithm.name);
+		return true;
 	}
 
-	return (double) (clock() - start) / CLOCKS_PER_SEC / runs - copy_time;
+	return false;
 }
 
-// Devolve uma estimativa do número de execuções do algoritmo de ordenação
-// `algorithm`, quando aplicado à ordenação do _array_ `work_itens` com `length`
-// itens, obtido por cópia do _array_ `items` com o mesmo número de itens,
-// necessárias para atingir a precisão pretendida. O efeito do tempo de cópia
-// entre os _arrays_ `copy_time` é cancelado na estimativa efectuadas. Em caso
-// de erro devolve um valor negativo.
-static long number_of_runs(const struct sorting_algorithm algorithm,
-			  const long length, double work_items[length],
-			  const double items[length], const double copy_time)
+// Restaura a cópia acabada de ordenar a partir do _array_ `items` do contexto e
+// avança para a cópia seguinte. Como o restauro ocorre depois da ordenação, e
+// antes do esvaziamento das _caches_ que precede a execução seguinte, o seu
+// tempo não é incluído nas medições.
+static void restore_cold_sort(void *const generic_context)
 {
-	assert(length > 0L);
-	assert(work_items != NULL);
-	assert(items != NULL);
-	assert(copy_time > 0.0);
-
-	long runs = 0L;
-	clock_t start = clock();
-
-	do {
-		copy_double_array(length, work_items, items);
+	struct cold_sort_context *const context = generic_context;
 
-		if(algorithm.sort(length, work_items)) {
-			fprintf(stderr, "Error: could not run sorting "
-				"algorithm '%s'.\n", algorithm.name);
-			return -1;
-		}
+	copy_double_array(context->length, context->copies[context->next],
+			  context->items);
 
-		runs++;
-	} while(clock() - start - runs * copy_time * CLOCKS_PER_SEC <
-		clock_precision);
+	context->next = (context->next + 1) % context->number_of_copies;
+}
 
-	return runs;
+// Predicado que devolve `true` se os `length` itens do _array_ `work_items`
+// estiverem ordenados por ordem não decrescente e forem uma permutação dos
+// itens cuja impressão digital é `fingerprint`. Se `sorted_items` não for
+// `NULL`, verifica-se também se os itens são iguais aos desse _array_, que
+// contém os itens ordenados lidos do ficheiro de referência. As verificações
+// são O(_n_) e não requerem memória adicional. A ordem verificada depende da
+// forma `nan_handling` de lidar com os NaN.
+static bool sorted_correctly(const long length, const double work_items[length],
+			     const double sorted_items[length],
+			     const struct double_array_fingerprint fingerprint,
+			     const enum nan_handling nan_handling)
+{
+	if (nan_handling == nans_last_nan_handling)
+		return double_array_is_sorted_permutation_nans_last(
+			length, work_items, fingerprint);
+
+	if (nan_handling == total_order_nan_handling)
+		return double_array_is_total_order_sorted_permutation(
+			length, work_items, fingerprint);
+
+	return double_array_is_sorted_permutation(length, work_items,
+						  fingerprint) &&
+		(sorted_items == NULL ||
+		 double_arrays_equal(length, sorted_items, work_items));
 }
 
 // Esta rotina escuta uma experiência com o algoritmo de ordenação `algorithm`,
 // obtendo contagens de operações e estatísticas do tempo de execução
 // resultantes da sua aplicação ao _array_ `items`, com comprimento `length`. As
-// estatísticas são optidas por aplicação repetida da função
-// `sort_time_estimate()`. O _array_ ordenado é sempre `work_itens`, para onde
+// estatísticas são obtidas através da rotina `bench()` da biblioteca
+// `benchmark`. O _array_ ordenado é sempre `work_itens`, para onde
 // os itens originais, contidos em `items`, são copiados antes de cada
 // ordenação. Para além da obtenção de contagens e estatísticas, a correcção da
-// ordenação obtida é verificada por comparação com o _array_ `sorted_items`,
-// que contém os mesmos itens de `items`, mas já ordenados por ordem crescente.
-// As estimativa dos tempo de execução são realizadas levando em conta o tempo
-// estimado `copy_time` necessário para preparar o _array_ `sorted_items` para
-// cada ordenação, copiando os seus itens a partir de `items`. As contagens e
+// ordenação obtida é verificada confirmando que o resultado está ordenado e
+// tem a impressão digital `fingerprint` dos itens de `items` e, se
+// `sorted_items` não for `NULL`, por comparação com esse _array_, que contém os
+// mesmos itens de `items`, mas já ordenados por ordem crescente. Os NaN são
+// tratados da forma indicada por `nan_handling`, sendo nesse caso ignorado o
+// _array_ `sorted_items`.
+// As estimativas dos tempos de execução descontam o tempo, estimado pela
+// biblioteca, necessário para preparar o _array_ `work_items` para cada
+// ordenação, copiando os seus itens a partir de `items`. As contagens e
 // estatísticas são guardadas na instância de `struct algorithm_statistics`
-// apontada pelo ponteiro `statistics`. Em caso de erro devolve o valor `true`.
+// apontada pelo ponteiro `statistics`. Se `number_of_copies` não for zero, os
+// tempos de execução são medidos também com as _caches_ frias, rodando pelas
+// `number_of_copies` cópias dos itens de `items` guardadas em `copies`. Em caso
+// de erro devolve o valor `true`.
 static bool experiment_algorithm(const struct sorting_algorithm algorithm,
+				const enum nan_handling nan_handling,
 				const long length, double work_items[length],
 				const double items[length],
 				const double sorted_items[length],
-				const double copy_time,
+				const struct double_array_fingerprint
+				fingerprint,
+				const int number_of_copies,
+				double *const copies[number_of_copies],
 				struct algorithm_statistics *statistics)
 {
 	assert(length > 0L);
 	assert(work_items != NULL);
 	assert(items != NULL);
-	assert(sorted_items != NULL);
-	assert(copy_time > 0.0);
 	assert(statistics != NULL);
 
 	// Preparamos o _array_ `work_items` e realizamos uma primeira ordenação
 	// invocando o procedimento de ordenação que implementa o algoritmo em
 	// causa e que efectua contagem das operações elementares. Dessa forma,
 	// não só obtemos as contagens necessárias, como podemos verificar a
-	// correcção do resultado da ordenação com essa função, comparando-o com
-	// o _array_ `sorted_items`. Em caso de erro, retornamos devolvendo o
-	// valor `true`.
+	// correcção do resultado da ordenação com essa função. Em caso de
+	// erro, retornamos devolvendo o valor `true`.
 	copy_double_array(length, work_items, items);
 
 	printf("\t\tRunning counting algorithm version.\n");
 
-	if (algorithm.sort_and_count(length, work_items, &statistics->counts)) {
+	if (sort_handling_nans_and_count(algorithm.sort_and_count, nan_handling,
+					 length, work_items,
+					 &statistics->counts)) {
 		fprintf(stderr, "Error: could not run sorting algorithm '%s' "
 			"(counting version).\n", algorithm.name);
 		return true;
@@ -354,7 +481,8 @@ static bool experiment_algorithm(const struct sorting_algorithm algorithm,
 
 	printf("\t\tChecking correctness of counting algorithm version.\n");
 
-	if (!double_arrays_equal(length, sorted_items, work_items)) {
+	if (!sorted_correctly(length, work_items, sorted_items, fingerprint,
+			      nan_handling)) {
 		fprintf(stderr, "Error: sorting algorithm '%s' (counting "
 			"version) did not sort.\n", algorithm.name);
 		return true;
@@ -371,7 +499,8 @@ static bool experiment_algorithm(const struct sorting_algorithm algorithm,
 
 	printf("\t\tRunning non-counting algorithm version.\n");
 
-	if(algorithm.sort(length, work_items)) {
+	if (sort_handling_nans(algorithm.sort, nan_handling, length,
+			       work_items)) {
 		fprintf(stderr, "Error: could not run sorting algorithm '%s'.\n",
 			algorithm.name);
 		return true;
@@ -379,7 +508,8 @@ static bool experiment_algorithm(const struct sorting_algorithm algorithm,
 
 	printf("\t\tChecking correctness of non-counting algorithm version.\n");
 
-	if (!double_arrays_equal(length, sorted_items, work_items)) {
+	if (!sorted_correctly(length, work_items, sorted_items, fingerprint,
+			      nan_handling)) {
 		fprintf(stderr, "Error: sorting algorithm '%s' did not sort.\n",
 			algorithm.name);
 		return true;
@@ -391,59 +521,75 @@ static bool experiment_algorithm(const struct sorting_algorithm algorithm,
 	// estimados usando a versão _sem contagem_ dos procedimentos.
 	printf("\t\tTime measurements:\n");
 
-	// Estimamos o número de execuções da ordenação a realizar para obter
-	// resultados com a precisão escolhida.  Em caso de erro, retornamos
-	// devolvendo o valor `true`.
-	long runs =
-		number_of_runs(algorithm, length, work_items, items, copy_time);
-
-	if (runs < 0L)
+	// Medimos os tempos de execução usando a biblioteca `benchmark`. Cada
+	// execução é precedida de uma cópia dos itens de `items` para
+	// `work_items`, cujo tempo é estimado e descontado. A biblioteca
+	// determina o número de execuções necessárias para obter resultados com
+	// a precisão escolhida e repete as estimativas para fins estatísticos.
+	// Em caso de erro, retornamos devolvendo o valor `true`.
+	struct sort_context context = {
+		.algorithm = algorithm,
+		.nan_handling = nan_handling,
+		.length = length,
+		.work_items = work_items,
+		.items = items
+	};
+	struct benchmark_statistics times;
+
+	if (bench(run_sort, prepare_sort, NULL, &context, &benchmark_settings,
+		  &times))
 		return true;
 
-	printf("\t\t\tEach time will be estimated using %ld runs.\n", runs);
-
-	// Guardamos o valor obtido na estrutura de estatísticas.
-	statistics->accumulated_runs = runs;
-
-	// Os tempos obtidos em cada uma das repetições das estimativas a
-	// realizar serão guardados neste _array_.
-	double times[maximum_number_of_repetions];
-
-	printf("\t\t\tStarting repeated estimations:\n");
-
-	// Este ciclo repete a obtenção de estimativas do tempo de execução até
-	// se atingir o limite máximo de iterações ou até se ultrapassar o
-	// limiar do tempo acumulado de execução do ciclo.
-	long repetitions = 0L;
-	clock_t start = clock();
-	double accumulated_time;
-
-	do {
-		// Obtemos uma estimativa do tempo de execução do algoritmo. Em
-		// caso de erro, retornamos devolvendo o valor `true`.
-		times[repetitions] =
-			    sort_time_estimate(algorithm, length, work_items,
-						items, runs, copy_time);
-
-		if(times[repetitions] < 0.0)
-			return true;
-
-		repetitions++;
-
-		accumulated_time = (double)(clock() - start) / CLOCKS_PER_SEC;
-	} while(repetitions != maximum_number_of_repetions &&
-		accumulated_time < threshold_repetition_time);
-
-	printf("\t\t\t%ld repetitions in %g seconds.\n", repetitions,
-	       accumulated_time);
+	printf("			Copy time estimated to be %g seconds.\n",
+	       times.overhead_time);
+	printf("			Each time estimated using %ld runs.\n",
+	       times.accumulated_runs);
+	printf("			%ld repetitions in %g seconds.\n", times.repetitions,
+	       times.repetition_time);
+
+	// Guardamos os valores obtidos na estrutura de estatísticas.
+	statistics->accumulated_runs = times.accumulated_runs;
+	statistics->repetitions = times.repetitions;
+	statistics->times.average = times.average;
+	statistics->times.stddev = times.stddev;
+	statistics->times.median = times.median;
+	statistics->times.minimum = times.minimum;
+	statistics->times.maximum = times.maximum;
+
+	// Se pedido, medimos de novo os tempos de execução, agora com as
+	// _caches_ frias. A biblioteca esvazia as _caches_ antes de cada
+	// execução e mede cada execução isoladamente. Cada execução ordena uma
+	// cópia diferente dos itens, sendo a cópia restaurada depois de
+	// ordenada, fora da medição.
+	if (number_of_copies == 0)
+		return false;
+
+	printf("\t\tCold cache time measurements:\n");
+
+	struct cold_sort_context cold_context = {
+		.algorithm = algorithm,
+		.nan_handling = nan_handling,
+		.length = length,
+		.number_of_copies = number_of_copies,
+		.copies = copies,
+		.items = items,
+		.next = 0
+	};
+	struct benchmark_settings cold_settings = benchmark_settings;
+	cold_settings.flush_cache = true;
+
+	if (bench(run_cold_sort, NULL, restore_cold_sort, &cold_context,
+		  &cold_settings, &times))
+		return true;
 
-	// Guardamos o valor obtido para as repetições na estrutura de
-	// estatísticas.
-	statistics->repetitions = repetitions;
+	printf("			%ld repetitions in %g seconds.\n", times.repetitions,
+	       times.repetition_time);
 
-	// Calculamos as estatísticas dos tempos de execução obtidos e guardamo-
-	// las na estrutura de estatísticas.
-	statistics->times = double_array_statistics(repetitions, times);
+	statistics->cold_times.average = times.average;
+	statistics->cold_times.stddev = times.stddev;
+	statistics->cold_times.median = times.median;
+	statistics->cold_times.minimum = times.minimum;
+	statistics->cold_times.maximum = times.maximum;
 
 	// Retornamos devolvendo o valor `false`, indicando que não ocorreram
 	// quaisquer erros.
@@ -451,59 +597,124 @@ static bool experiment_algorithm(const struct sorting_algorithm algorithm,
 }
 
 // Escreve no canal de saída `output` os cabeçalhos das colunas de estatísticas
-// para o algoritmo com o nome dado por `lagorithm_name`.
+// para o algoritmo com o nome dado por `algorithm_name`. Os cabeçalhos de cada
+// métrica são dados pelo _array_ `result_metric_headers` do módulo
+// `results_file`, de modo a que o ficheiro CSV e os ficheiros em formato longo
+// (e a sua conversão para CSV) sejam sempre coerentes. Escrevem-se apenas os
+// cabeçalhos das primeiras `metrics` métricas.
 static void write_statistics_headers(FILE *const output,
-				     const char *algorithm_name)
+				     const char *algorithm_name,
+				     const int metrics)
 {
 	assert(output != NULL);
 	assert(algorithm_name != NULL);
 
-	fprintf(output, ";Comparisons (%s)", algorithm_name);
-	fprintf(output, ";Swaps (%s)", algorithm_name);
-	fprintf(output, ";Copies (%s)", algorithm_name);
-	fprintf(output, ";Accumulated runs (%s)", algorithm_name);
-	fprintf(output, ";Repetitions (%s)", algorithm_name);
-	fprintf(output, ";Time Average [seconds] (%s)", algorithm_name);
-	fprintf(output, ";Time Stddev [seconds] (%s)", algorithm_name);
-	fprintf(output, ";Time Median [seconds] (%s)", algorithm_name);
-	fprintf(output, ";Time Minimum [seconds] (%s)", algorithm_name);
-	fprintf(output, ";Time Maximum [seconds] (%s)", algorithm_name);
+	for (int m = 0; m != metrics; m++)
+		fprintf(output, ";%s (%s)", result_metric_headers[m],
+			algorithm_name);
 }
 
-// Escreve no canal de saída `output` as estatísticas contidas em `statistics`
-// (que dizem respeito a um dado algoritmo).
+// Preenche o _array_ `values` com os valores de cada uma das métricas contidas
+// em `statistics`, pela ordem dada pelo tipo `enum result_metric`.
+static void statistics_values(const struct algorithm_statistics statistics,
+			      double values[number_of_result_metrics])
+{
+	values[comparisons_metric] = statistics.counts.comparisons;
+	values[swaps_metric] = statistics.counts.swaps;
+	values[copies_metric] = statistics.counts.copies;
+	values[accumulated_runs_metric] = statistics.accumulated_runs;
+	values[repetitions_metric] = statistics.repetitions;
+	values[time_average_metric] = statistics.times.average;
+	values[time_stddev_metric] = statistics.times.stddev;
+	values[time_median_metric] = statistics.times.median;
+	values[time_minimum_metric] = statistics.times.minimum;
+	values[time_maximum_metric] = statistics.times.maximum;
+	values[cold_time_average_metric] = statistics.cold_times.average;
+	values[cold_time_stddev_metric] = statistics.cold_times.stddev;
+	values[cold_time_median_metric] = statistics.cold_times.median;
+	values[cold_time_minimum_metric] = statistics.cold_times.minimum;
+	values[cold_time_maximum_metric] = statistics.cold_times.maximum;
+}
+
+// Devolve o número de métricas a escrever, dadas as opções experimentais
+// `options`. As métricas de tempo com as _caches_ frias são as últimas e só
+// são escritas quando são medidas, de modo a que o formato dos resultados não
+// se altere quando não são pedidas.
+static int written_metrics(const struct experiment_options *const options)
+{
+	return options->cold_cache ?
+		number_of_result_metrics : cold_time_average_metric;
+}
+
+// Escreve no canal de saída `output` as primeiras `metrics` métricas contidas
+// em `statistics` (que dizem respeito a um dado algoritmo).
 static void write_statistics(FILE *const output,
-			     const struct algorithm_statistics statistics)
+			     const struct algorithm_statistics statistics,
+			     const int metrics)
 {
 	assert(output != NULL);
 
-	fprintf(output, ";%ld", statistics.counts.comparisons);
-	fprintf(output, ";%ld", statistics.counts.swaps);
-	fprintf(output, ";%ld", statistics.counts.copies);
-	fprintf(output, ";%ld", statistics.accumulated_runs);
-	fprintf(output, ";%ld", statistics.repetitions);
-	fprintf(output, ";%g", statistics.times.average);
-	fprintf(output, ";%g", statistics.times.stddev);
-	fprintf(output, ";%g", statistics.times.median);
-	fprintf(output, ";%g", statistics.times.minimum);
-	fprintf(output, ";%g", statistics.times.maximum);
+	double values[number_of_result_metrics];
+	statistics_values(statistics, values);
+
+	for (int m = 0; m != metrics; m++)
+		if (result_metric_is_count[m])
+			fprintf(output, ";%ld", (long)values[m]);
+		else
+			fprintf(output, ";%g", values[m]);
+}
+
+// Escreve através de cada um dos escritores de resultados em `writers` que não
+// seja `NULL` um registo por cada uma das primeiras `metrics` métricas contidas
+// em `statistics`, que dizem respeito ao algoritmo com o nome `algorithm_name`,
+// ordenando ficheiros do tipo `file_type` com dimensão `size`. Devolve `true`
+// em caso de erro.
+static bool write_statistics_records(
+	struct results_writer *const writers[number_of_results_formats],
+	const char *const file_type, const long size,
+	const char *const algorithm_name,
+	const struct algorithm_statistics statistics, const int metrics)
+{
+	double values[number_of_result_metrics];
+	statistics_values(statistics, values);
+
+	for (int f = 0; f != number_of_results_formats; f++)
+		for (int m = 0; writers[f] != NULL &&
+				m != metrics; m++) {
+			const struct result_record record = {
+				.file_type = file_type,
+				.size = size,
+				.algorithm = algorithm_name,
+				.metric = result_metric_names[m],
+				.value = values[m]
+			};
+			if (write_result(writers[f], record))
+				return true;
+		}
+
+	return false;
 }
 
 // Esta rotina executa as experiências para os ficheiros com `size` valores a
 // ordenar e para cada algoritmo. Efectuamos as experiências apenas para os
 // ficheiros do tipo dado por `file_type` (que pode tomar os valores `sorted`,
-// `partially_sorted` e `shuffled`). Lemos os ficheiros a partir da pasta dada
-// por `path` (que tem de terminar no caractere separador de pastas
-// correspondente ao sistema operativo em que o programa é executado).
-// Escrevemos os resultados no canal de saída `output`. Se algum dos algoritmos
+// `partially_sorted`, `shuffled` e `with_nans`). Lemos os ficheiros a partir
+// da pasta dada por `path` (que tem de terminar no caractere separador de
+// pastas correspondente ao sistema operativo em que o programa é executado).
+// Escrevemos os resultados no canal de saída `output` e através dos escritores
+// de resultados em `writers` que não sejam `NULL`. Se algum dos algoritmos
 // tiver um tempo de execução superior ao limiar definido, actualizamos o
 // _array_ `excessive_time_per_sort` de modo a conter o valor `true` na posição
 // correspondente a esse algoritmo. Se alguma posição desse _array_ já tiver o
 // valor `true`, o algoritmo correspondente não chega a ser experimentado.
-// Devolvemos `true` em caso de erro.
-bool experiment_size(FILE *const output, const char *const path,
+// As opções experimentais são dadas por `options`. Devolvemos `true` em caso
+// de erro.
+bool experiment_size(FILE *const output,
+		     struct results_writer *const writers[number_of_results_formats],
+		     const char *const path,
 		     const char *const file_type, const long size,
-		     bool excessive_time_per_sort[number_of_sorting_algorithms])
+		     bool excessive_time_per_sort[number_of_sorting_algorithms],
+		     const struct experiment_options *const options)
 {
 	// Construímos o nome do ficheiro com o tipo dado por `file_type`, com a
 	// dimensão dada por `s` e na pasta dada por `path`. Este ficheiro
@@ -514,7 +725,7 @@ bool experiment_size(FILE *const output, const char *const path,
 	// Construímos o nome do ficheiro com o tipo `sorted`, com a dimensão
 	// `s` e na pasta dada por `path`. Este ficheiro contém os itens já
 	// ordenados. O seu conteúdo será usado para verificar a correcção dos
-	// algoritmos.
+	// algoritmos, mas apenas se tal for pedido através das opções.
 	char sorted_file_name[FILENAME_MAX];
 	snprintf(sorted_file_name, FILENAME_MAX, "%ssorted_%ld.txt", path, size);
 
@@ -529,6 +740,9 @@ bool experiment_size(FILE *const output, const char *const path,
 	double *items = NULL;
 	double *sorted_items = NULL;
 	double *work_items = NULL;
+	struct scratch_arena *arena = NULL;
+	double **copies = NULL;
+	int number_of_copies = 0;
 
 	// Lemos o conteúdo do ficheiro com os itens a ordenar para o _array_
 	// dinâmico `items` (na realidade um ponteiro para o seu primeiro item).
@@ -555,27 +769,86 @@ bool experiment_size(FILE *const output, const char *const path,
 
 	// Em caso de erro escrevemos em `stderr` uma mensagem apropriada e
 	// saltamos para a secção de tratamento de erros, a que daremos o nome
-	// `terminate`.
+	// `terminate`. Como o _array_ lido ainda não foi colocado (ver abaixo),
+	// libertamo-lo aqui através de `free()`.
 	if (error) {
 		fprintf(stderr, "Error: Reading file '%s'.\n", file_name);
+		free(items);
+		items = NULL;
 		goto terminate;
 	}
 
-	// Lemos o conteúdo do ficheiro com os itens já ordenados para o _array_
-	// dinâmico `sorted_items` (na realidade um ponteiro para o seu primeiro
-	// item). O número de itens lidos fica guardado em `length`. A leitura e
-	// criação do _array_ dinâmico podem falhar por falta de memória ou por
-	// o ficheiro não conter o número de itens esperado. Em caso de falha, o
-	// erro é tratado como anteriormente.
-	sorted_items = read_double_array_from(sorted_file_name, &length);
+	// Colocamos os itens lidos num _array_ reservado de acordo com as
+	// indicações em `options->allocation` (páginas enormes, distribuição
+	// pelos nós NUMA e primeiro toque pelas _threads_ indicadas). Em caso
+	// de erro, o _array_ original não é libertado por `place_double_array()`,
+	// pelo que o libertamos aqui.
+	double *placed_items = place_double_array(length, items,
+						  options->allocation);
 
-	error = sorted_items == NULL || length != size;
+	error = placed_items == NULL;
 
 	if (error) {
-		fprintf(stderr, "Error: Reading file '%s'.\n", sorted_file_name);
+		fprintf(stderr, "Error: Placing items from file '%s'.\n",
+			file_name);
+		free(items);
+		items = NULL;
 		goto terminate;
 	}
 
+	items = placed_items;
+
+	// Calculamos a impressão digital dos itens a ordenar, usada para
+	// verificar, sem guardar uma cópia ordenada, que o resultado de cada
+	// ordenação é uma permutação desses itens.
+	const struct double_array_fingerprint fingerprint =
+		double_array_fingerprint(size, items);
+
+	// A forma de lidar com os NaN depende do tipo de ficheiro e das opções.
+	const enum nan_handling nan_handling = nan_handling_for(file_type,
+								options);
+
+	// Se pedido através das opções, lemos também o ficheiro de referência,
+	// com os itens já ordenados. Quando é necessário lidar com os NaN, o
+	// ficheiro de referência não é lido, pois não contém os mesmos itens
+	// (no caso dos ficheiros do tipo `with_nans`) ou não distingue os zeros
+	// negativos dos positivos (no caso da ordem total).
+	if (options->reference_check && nan_handling == no_nan_handling) {
+		// Lemos o conteúdo do ficheiro com os itens já ordenados para
+		// o _array_ dinâmico `sorted_items` (na realidade um ponteiro
+		// para o seu primeiro item). O número de itens lidos fica
+		// guardado em `length`. A leitura e criação do _array_ dinâmico
+		// podem falhar por falta de memória ou por o ficheiro não
+		// conter o número de itens esperado. Em caso de falha, o erro é
+		// tratado como anteriormente.
+		sorted_items = read_double_array_from(sorted_file_name, &length);
+
+		error = sorted_items == NULL || length != size;
+
+		if (error) {
+			fprintf(stderr, "Error: Reading file '%s'.\n",
+				sorted_file_name);
+			free(sorted_items);
+			sorted_items = NULL;
+			goto terminate;
+		}
+
+		placed_items = place_double_array(length, sorted_items,
+						  options->allocation);
+
+		error = placed_items == NULL;
+
+		if (error) {
+			fprintf(stderr, "Error: Placing items from file '%s'.\n",
+				sorted_file_name);
+			free(sorted_items);
+			sorted_items = NULL;
+			goto terminate;
+		}
+
+		sorted_items = placed_items;
+	}
+
 	// Construímos o _array_ de trabalho, ou seja, o _array_ dinâmico para
 	// onde serão copiados os itens a ordenar sempre que necessário e que
 	// será ordenado durante as experiências a realizar. O _array_ `items`
@@ -583,7 +856,7 @@ bool experiment_size(FILE *const output, const char *const path,
 	// memória. Criar este _array_ neste local evita a necessidade de o
 	// recriar várias vezes durante as experiências. A criação do _array_
 	// pode falhar por falta de memória.
-	work_items = new_double_array_of(size);
+	work_items = new_placed_double_array_of(size, options->allocation);
 
 	error = work_items == NULL;
 
@@ -592,12 +865,47 @@ bool experiment_size(FILE *const output, const char *const path,
 		goto terminate;
 	}
 
-	// Estimamos o tempo de execução da cópia dos itens do _array_ `items`
-	// para o _array_ `work_items`. Este tempo será descontado das
-	// estimativas do tempo de execução dos algoritmos, que sem este
-	// desconto incluiriam o tempo demorado a copiar os itens para o _array_
-	// de trabalho antes de proceder à sua ordenação.
-	double copy_time = copy_time_estimate(length, work_items, items);
+	// Construímos a arena de memória de rascunho onde os algoritmos que
+	// precisam de _arrays_ auxiliares os irão reservar. A sua capacidade
+	// inicial é suficiente para um _array_ auxiliar com a dimensão dos
+	// _arrays_ a ordenar. Em modo «frio», a arena devolve a memória ao
+	// sistema operativo após cada ordenação.
+	arena = new_scratch_arena(size, options->cold_scratch);
+
+	error = arena == NULL;
+
+	if (error) {
+		fprintf(stderr, "Error: Allocating scratch arena.\n");
+		goto terminate;
+	}
+
+	set_sorting_scratch_arena(arena);
+
+	// Se os tempos de execução forem medidos também com as _caches_ frias,
+	// construímos as cópias independentes dos itens a ordenar pelas quais
+	// essas medições vão rodando. O número de cópias efectivamente
+	// construídas é guardado em `number_of_copies`, de modo a que só essas
+	// sejam libertadas em caso de erro.
+	if (options->cold_cache) {
+		copies = malloc(options->cold_copies * sizeof(double *));
+
+		error = copies == NULL;
+
+		for (int c = 0; !error && c != options->cold_copies; c++) {
+			copies[c] = new_placed_double_array_of(size,
+							       options->allocation);
+			error = copies[c] == NULL;
+			if (!error) {
+				copy_double_array(size, copies[c], items);
+				number_of_copies++;
+			}
+		}
+
+		if (error) {
+			fprintf(stderr, "Error: Allocating cold cache copies.\n");
+			goto terminate;
+		}
+	}
 
 	// Escrevemos no ficheiro CSV de resultado o valor da primeira coluna,
 	// ou seja, a dimensão do ficheiro em ordenação. Ou, o que é o mesmo, o
@@ -624,17 +932,19 @@ bool experiment_size(FILE *const output, const char *const path,
 			// experimentação e verificando se ocorreu algum erro
 			// durante o processo. A experiência é realizada com o
 			// algoritmo `sorting_algorithm[a]`, usando os _arrays_
-			// `work_items`, `items` e `sorted_items`, todos com
-			// `length` itens. O tempo de cópia `copy_time` é usado
-			// para efectuar descontos nos tempos estimados sempre
-			// que necessário. Os resultados são guardados na
-			// variável `statistics`, cujo endereço é passado à
-			// rotina de experimentação. A rotina de experimentação
-			// devolve um valor booleano que indica se ocorreu ou
-			// não algum erro.
+			// `work_items`, `items` e `sorted_items` (que pode ser
+			// `NULL`), todos com `length` itens, e com a impressão
+			// digital `fingerprint` dos itens a ordenar. Os
+			// resultados são guardados na variável `statistics`,
+			// cujo endereço é passado à rotina de experimentação. A
+			// rotina de experimentação devolve um valor booleano
+			// que indica se ocorreu ou não algum erro.
 			error = experiment_algorithm(sorting_algorithms[a],
+							nan_handling,
 							size, work_items, items,
-							sorted_items, copy_time,
+							sorted_items,
+							fingerprint,
+							number_of_copies, copies,
 							&statistics);
 			if (error)
 				goto terminate;
@@ -647,10 +957,27 @@ bool experiment_size(FILE *const output, const char *const path,
 		// realizado. Caso contrário, escreve-se o valor inicial das
 		// estatísticas, que assinalarão a experiência como não
 		// realizada.
-		write_statistics(output, statistics);
+		write_statistics(output, statistics, written_metrics(options));
+
+		error = write_statistics_records(writers, file_type, size,
+						 sorting_algorithms[a].name,
+						 statistics,
+						 written_metrics(options));
+		if (error) {
+			fprintf(stderr, "Error: Writing long-format results.\n");
+			goto terminate;
+		}
 
-		printf("\t\tEnding experiments for %s (median time = %g s).\n",
-		       sorting_algorithms[a].name, statistics.times.median);
+		if (options->cold_cache)
+			printf("\t\tEnding experiments for %s (median time = "
+			       "%g s warm, %g s cold).\n",
+			       sorting_algorithms[a].name,
+			       statistics.times.median,
+			       statistics.cold_times.median);
+		else
+			printf("\t\tEnding experiments for %s (median time = "
+			       "%g s).\n", sorting_algorithms[a].name,
+			       statistics.times.median);
 
 		// Actualizamos o _array_ que indica se o tempo de ordenação
 		// excedeu em algum momento, para o algoritmo corrente, o limiar
@@ -669,13 +996,22 @@ bool experiment_size(FILE *const output, const char *const path,
 	// caso, pode acontecer que o erro tenha ocorrido antes da criação dos
 	// _arrays_ dinâmicos. O código está construído de tal forma que, se
 	// isso acontecer, o correspondente ponteiro terá o valor `NULL`, que
-	// pode ser passado sem inconveniente à rotina `free()`.
+	// pode ser passado sem inconveniente às rotinas de libertação.
 terminate:
+	// Deixamos de usar a arena de memória de rascunho e libertamo-la.
+	set_sorting_scratch_arena(NULL);
+	free_scratch_arena(arena);
+
+	// Libertamos as cópias usadas nas medições com as _caches_ frias.
+	for (int c = 0; c != number_of_copies; c++)
+		free_placed_double_array(copies[c]);
+	free(copies);
+
 	// Libertamos a memória reservada para cada um dos _arrays_
 	// dinâmicos.
-	free(work_items);
-	free(sorted_items);
-	free(items);
+	free_placed_double_array(work_items);
+	free_placed_double_array(sorted_items);
+	free_placed_double_array(items);
 
 	// Retornamos devolvendo o valor na variável `error`, ou seja, indicando
 	// se ocorreram ou não erros.
@@ -685,18 +1021,22 @@ terminate:
 // A rotina principal do programa, que executa as experiências para cada
 // dimensão dos ficheiros com valores a ordenar e para cada algoritmo.
 // Efectuamos as experiências apenas para os ficheiros do tipo dado por
-// `file_type` (que pode tomar os valores `sorted`, `partially_sorted` e
-// `shuffled`). Lemos os ficheiros a partir da pasta dada por `path` (que tem de
-// terminar no caractere separador de pastas correspondente ao sistema operativo
-// em que o programa é executado). Escrevemos os resultados no ficheiro com nome
-// dado por `statistics_file_name`. Em caso de erro devolvemos o valor `true`.
+// `file_type` (que pode tomar os valores `sorted`, `partially_sorted`,
+// `shuffled` e `with_nans`). Lemos os ficheiros a partir da pasta dada por
+// `path` (que tem de terminar no caractere separador de pastas correspondente
+// ao sistema operativo em que o programa é executado). Escrevemos os resultados
+// no ficheiro com nome dado por `statistics_file_name`. As opções
+// experimentais são dadas por `options`. Em caso de erro devolvemos o valor
+// `true`.
 static bool experiment_all(const char *const path,
 			   const char *const file_type,
-			   const char *const statistics_file_name)
+			   const char *const statistics_file_name,
+			   const struct experiment_options *const options)
 {
 	assert(path != NULL);
 	assert(file_type != NULL);
 	assert(statistics_file_name != NULL);
+	assert(options != NULL);
 
 	// Definimos um _array_ de valores booleanos que indicam se, em alguma
 	// das experiências já realizada com o correspondente algoritmo se
@@ -708,6 +1048,12 @@ static bool experiment_all(const char *const path,
 	for (int a = 0; a != number_of_sorting_algorithms; a++)
 		excessive_time_per_sort[a] = false;
 
+	// Os escritores de resultados em formato longo, um por cada formato.
+	// Só são criados os correspondentes aos ficheiros indicados nas opções.
+	struct results_writer *writers[number_of_results_formats];
+	for (int f = 0; f != number_of_results_formats; f++)
+		writers[f] = NULL;
+
 	// Abrimos o canal para o ficheiro de resultados. O ficheiro de
 	// resultados tem o formato CSV (comma separated values) e usa o
 	// caractere «;» como separador. A sua primeira linha contém a
@@ -730,13 +1076,30 @@ static bool experiment_all(const char *const path,
 		goto terminate;
 	}
 
+	// Criamos os escritores de resultados em formato longo pedidos.
+	for (int f = 0; f != number_of_results_formats; f++) {
+		if (options->results_file_names[f] == NULL)
+			continue;
+
+		writers[f] = new_results_writer(options->results_file_names[f],
+						f);
+		error = writers[f] == NULL;
+
+		if (error) {
+			fprintf(stderr, "Error: Could not open '%s' for "
+				"writing!\n", options->results_file_names[f]);
+			goto terminate;
+		}
+	}
+
 	// Escrevemos o cabeçalho da primeira coluna, que contém a dimensão dos
 	// ficheiros usados para obter as estatísticas de cada linha.
 	fprintf(output, "Size");
 
 	// Escrevemos os cabeçalhos correspondentes a cada um dos algoritmos.
 	for (int a = 0; a != number_of_sorting_algorithms; a++)
-		write_statistics_headers(output, sorting_algorithms[a].name);
+		write_statistics_headers(output, sorting_algorithms[a].name,
+					 written_metrics(options));
 
 	// Terminamos a linha de cabeçalho.
 	fputc('\n', output);
@@ -755,8 +1118,8 @@ static bool experiment_all(const char *const path,
 
 		// Invocamos a rotina que executa as experiências para a
 		// dimensão `size` dos ficheiros e para todos os algoritmos.
-		error = experiment_size(output, path, file_type, size,
-					excessive_time_per_sort);
+		error = experiment_size(output, writers, path, file_type, size,
+					excessive_time_per_sort, options);
 		if (error)
 			goto terminate;
 
@@ -771,6 +1134,15 @@ terminate:
 	if (output != NULL)
 		fclose(output);
 
+	// Escrevemos os registos pendentes e fechamos os ficheiros em formato
+	// longo.
+	for (int f = 0; f != number_of_results_formats; f++)
+		if (free_results_writer(writers[f])) {
+			fprintf(stderr, "Error: Writing '%s'!\n",
+				options->results_file_names[f]);
+			error = true;
+		}
+
 	// Retornamos devolvendo o valor na variável `error`, ou seja, indicando
 	// se ocorreram ou não erros.
 	return error;
@@ -781,10 +1153,11 @@ int main(const int argument_count,
 	 const char *const argument_values[argument_count])
 {
 	// Os argumentos recebidos através da linha de comandos, incluindo o
-	// próprio nome do programa executável, são quatro: esse nome, a pasta
-	// onde os ficheiros a ordenar se encontram, o tipo de ficheiros a
-	// ordenar e o nome do ficheiro onde os resultados serão escritos no
-	// formato CSV, por esta ordem.
+	// próprio nome do programa executável, são pelo menos quatro: esse
+	// nome, a pasta onde os ficheiros a ordenar se encontram, o tipo de
+	// ficheiros a ordenar e o nome do ficheiro onde os resultados serão
+	// escritos no formato CSV, por esta ordem. Seguem-se as opções, que são
+	// opcionais.
 	if (argument_count < 4) {
 		fprintf(stderr, "Error: Insuficient number of arguments!\n");
 		return EXIT_FAILURE;
@@ -794,6 +1167,48 @@ int main(const int argument_count,
 	const char *const file_type = argument_values[2];
 	const char *const statistics_file_name = argument_values[3];
 
+	// Interpretamos as opções, começando pelos seus valores por omissão.
+	struct experiment_options options = default_options;
+
+	for (int i = 4; i != argument_count; i++)
+		if (strcmp(argument_values[i], "--cold-scratch") == 0)
+			options.cold_scratch = true;
+		else if (strcmp(argument_values[i], "--reference") == 0)
+			options.reference_check = true;
+		else if (strcmp(argument_values[i], "--total-order") == 0)
+			options.total_order = true;
+		else if (strcmp(argument_values[i], "--cold-cache") == 0)
+			options.cold_cache = true;
+		else if (sscanf(argument_values[i], "--cold-copies=%d",
+				&options.cold_copies) == 1 &&
+			 options.cold_copies >= 2)
+			;
+		else if (strcmp(argument_values[i], "--no-huge-pages") == 0)
+			options.allocation.huge_pages = false;
+		else if (strcmp(argument_values[i], "--interleave") == 0)
+			options.allocation.interleaved = true;
+		else if (strncmp(argument_values[i], "--jsonl=", 8) == 0)
+			options.results_file_names[json_lines_format] =
+				argument_values[i] + 8;
+		else if (strncmp(argument_values[i], "--columnar=", 11) == 0)
+			options.results_file_names[columnar_format] =
+				argument_values[i] + 11;
+		else if (sscanf(argument_values[i], "--touch-threads=%d",
+				&options.allocation.touch_threads) == 1) {
+			if (options.allocation.touch_threads < 0 ||
+			    options.allocation.touch_threads >
+			    maximum_touch_threads) {
+				fprintf(stderr, "Error: The number of touch "
+					"threads must be between 0 and %d!\n",
+					maximum_touch_threads);
+				return EXIT_FAILURE;
+			}
+		} else {
+			fprintf(stderr, "Error: Unknown option '%s'!\n",
+				argument_values[i]);
+			return EXIT_FAILURE;
+		}
+
 	// Verificamos a correcção do tipo de ficheiro passado na linha de
 	// comandos.
 	if (!valid_file_type(file_type)) {
@@ -806,7 +1221,7 @@ int main(const int argument_count,
 
 	// Executamos o procedimento principal do programa, verificando se essa
 	// execução teve sucesso.
-	if (experiment_all(path, file_type, statistics_file_name))
+	if (experiment_all(path, file_type, statistics_file_name, &options))
 		return EXIT_FAILURE;
 
 	// Terminamos assinalando sucesso.
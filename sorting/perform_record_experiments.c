@@ -0,0 +1,566 @@
+// `perform_record_experiments.c` &ndash; Experiências com ordenação de registos
+// ===========================================================================
+//
+// Este é o módulo principal do programa para realização de experiências com a
+// ordenação de registos compostos por uma chave `double` e por uma carga
+// (_payload_) (ver [`record_sorting.h`](record_sorting.h.html)). O objectivo é
+// medir o custo da dimensão da carga em cada um dos modos de ordenação (estável
+// e instável) e compará-lo com o da ordenação de índices (_argsort_), que não
+// move os registos, de modo a orientar a escolha da organização dos dados.
+// Mede também as rotinas de ordenação indirecta de `double`, `argsort_double()`
+// e `rank_double()` (ver [`sorting_algorithms.h`](sorting_algorithms.h.html)),
+// comparando-as com a ordenação dos índices através de `qsort()` com uma
+// função de comparação indirecta.
+//
+// O programa recebe a pasta onde os ficheiros a ordenar se encontram, o tipo de
+// ficheiros a ordenar e o nome do ficheiro CSV onde os resultados serão
+// escritos, tal como o programa de experiências com algoritmos de ordenação
+// (ver [`perform_experiments.c`](perform_experiments.c.html)). As chaves dos
+// registos são os valores lidos de cada ficheiro. O ficheiro CSV tem uma linha
+// por dimensão e uma coluna com a mediana dos tempos de execução por cada par de
+// variante de ordenação e dimensão da carga, seguidas de uma coluna por cada
+// variante de ordenação indirecta das chaves.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// Inclusão de ficheiros de interface
+// -----------------------------------
+//
+// - `stdlib.h` &ndash; Para podermos usar as rotinas `malloc()`, `free()` e
+//   `qsort()`, o valor especial `NULL` e as constantes `EXIT_SUCCESS` e
+//   `EXIT_FAILURE`.
+//
+// - `stdio.h` &ndash; Para podermos usar as rotinas `printf()`, `fprintf()`,
+//   `snprintf()`, `fopen()`, `fclose()`, `fflush()` e `fputc()`.
+//
+// - `string.h` &ndash; Para podermos usar os procedimentos `memcpy()` e
+//   `memset()`.
+//
+// - `math.h` &ndash; Para podermos usar a macro `NAN`.
+//
+// - `array_of_doubles.h` &ndash; Para podermos ler os ficheiros com as chaves.
+//
+// - `record_sorting.h` &ndash; Para podermos ordenar os registos.
+//
+// - `sorting_algorithms.h` &ndash; Para podermos usar as rotinas
+//   `argsort_double()` e `rank_double()`.
+//
+// - `benchmark.h` &ndash; Para podermos medir os tempos de execução.
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "array_of_doubles.h"
+#include "record_sorting.h"
+#include "sorting_algorithms.h"
+#include "benchmark.h"
+
+// Definição de constantes
+// -----------------------
+
+// Os parâmetros das medições dos tempos de execução, iguais aos usados no
+// programa de experiências com algoritmos de ordenação.
+static const struct benchmark_settings benchmark_settings = {
+	.precision = 1.0, // seconds
+	.warm_up_runs = 1L,
+	.maximum_repetition_time = 300.0, // seconds
+	.maximum_repetitions = 1001L,
+	.flush_cache = false
+};
+
+// Se a mediana dos tempos de execução de uma variante exceder este limiar para
+// uma dada dimensão, a variante deixa de ser experimentada com dimensões
+// maiores.
+static const double threshold_time_per_sort = 300.0; // seconds
+
+// A dimensão máxima dos ficheiros a usar nas experiências (ver
+// `perform_experiments.c`).
+static const long maximum_file_size = 1L << 24;
+
+// As dimensões das cargas experimentadas, em _bytes_. Cada registo tem, para
+// além da carga, a sua chave, com `sizeof(double)` _bytes_. Os primeiros
+// `sizeof(long)` _bytes_ da carga guardam o índice original do registo, usado
+// na verificação da correcção das ordenações.
+static const size_t payload_sizes[] = { 8, 16, 64 };
+#define number_of_payload_sizes \
+	((int)(sizeof(payload_sizes) / sizeof(payload_sizes[0])))
+
+// As variantes de ordenação experimentadas.
+enum variant {
+	stable_sort_variant,
+	unstable_sort_variant,
+	stable_argsort_variant,
+	unstable_argsort_variant,
+	number_of_variants
+};
+
+// Os nomes das variantes, usados nos cabeçalhos do ficheiro CSV.
+static const char *const variant_names[number_of_variants] = {
+	"stable sort",
+	"unstable sort",
+	"stable argsort",
+	"unstable argsort"
+};
+
+// As variantes de ordenação indirecta das chaves experimentadas. A última
+// ordena os índices através de `qsort()`, servindo de referência.
+enum key_variant {
+	argsort_double_variant,
+	rank_double_variant,
+	qsort_argsort_variant,
+	number_of_key_variants
+};
+
+// Os nomes das variantes de ordenação indirecta das chaves, usados nos
+// cabeçalhos do ficheiro CSV.
+static const char *const key_variant_names[number_of_key_variants] = {
+	"argsort_double",
+	"rank_double",
+	"qsort argsort"
+};
+
+// Estrutura do contexto das medições
+// ----------------------------------
+
+// Esta estrutura guarda o contexto passado às rotinas medidas: a variante, o
+// número de registos e a sua dimensão, os registos originais, os registos de
+// trabalho (ordenados nas variantes que movem os registos) e os índices
+// (ordenados nas variantes de _argsort_).
+struct record_context {
+	enum variant variant;
+	long length;
+	size_t record_size;
+	const char *records;
+	char *work_records;
+	long *index;
+};
+
+// Esta estrutura guarda o contexto passado às rotinas medidas nas variantes de
+// ordenação indirecta das chaves: a variante, o número de chaves, as chaves e o
+// resultado (a permutação que ordena as chaves ou, no caso de
+// `rank_double()`, a ordem de cada chave).
+struct key_context {
+	enum key_variant variant;
+	int length;
+	const double *keys;
+	int *result;
+};
+
+// Definição de variáveis globais
+// ------------------------------
+
+// As chaves usadas pela função de comparação `compare_indexed_keys()`, uma vez
+// que `qsort()` não permite passar um contexto a essa função.
+static const double *compared_keys = NULL;
+
+// Definição de rotinas
+// --------------------
+
+// Devolve `true` se a variante `variant` ordenar os índices em vez dos
+// registos.
+static bool is_argsort(const enum variant variant)
+{
+	return variant == stable_argsort_variant ||
+		variant == unstable_argsort_variant;
+}
+
+// Devolve `true` se a variante `variant` for estável.
+static bool is_stable(const enum variant variant)
+{
+	return variant == stable_sort_variant ||
+		variant == stable_argsort_variant;
+}
+
+// Prepara uma ordenação de registos, copiando os registos originais para os
+// registos de trabalho. O tempo desta cópia é descontado pela biblioteca
+// `benchmark`.
+static bool prepare_records(void *const generic_context)
+{
+	const struct record_context *const context = generic_context;
+
+	memcpy(context->work_records, context->records,
+	       context->length * context->record_size);
+
+	return false;
+}
+
+// Realiza a ordenação correspondente à variante do contexto. Devolve `true` em
+// caso de erro.
+static bool run_variant(void *const generic_context)
+{
+	const struct record_context *const context = generic_context;
+
+	if (is_argsort(context->variant))
+		return argsort_records(context->length, context->record_size,
+				       context->records, context->index,
+				       is_stable(context->variant));
+
+	return sort_records(context->length, context->record_size,
+			    context->work_records,
+			    is_stable(context->variant));
+}
+
+// Devolve a chave do registo na posição `i` do _array_ de registos `records`,
+// com `record_size` _bytes_ cada.
+static double key_at(const char *const records, const size_t record_size,
+		     const long i)
+{
+	double key;
+	memcpy(&key, records + i * record_size, sizeof(key));
+	return key;
+}
+
+// Devolve o índice original do registo na posição `i` do _array_ de registos
+// `records`, com `record_size` _bytes_ cada, guardado no início da sua carga.
+static long original_index_at(const char *const records,
+			      const size_t record_size, const long i)
+{
+	long index;
+	memcpy(&index, records + i * record_size + sizeof(double),
+	       sizeof(index));
+	return index;
+}
+
+// Predicado que verifica o resultado da ordenação realizada através de
+// `run_variant()`. Para as variantes que movem os registos, verifica que as
+// chaves estão por ordem não decrescente, que cada registo continua a ter a
+// sua carga (i.e., que a chave do registo com o índice original `k` é a chave
+// original desse registo) e, se a variante for estável, que os índices originais
+// dos registos com chaves iguais estão por ordem crescente. Para as variantes
+// de _argsort_, faz as mesmas verificações através dos índices.
+static bool variant_correct(const struct record_context *const context)
+{
+	const size_t size = context->record_size;
+	const bool argsort = is_argsort(context->variant);
+	const char *const sorted = argsort ? context->records :
+		context->work_records;
+
+	long previous = -1L;
+	for (long i = 0L; i != context->length; i++) {
+		const long position = argsort ? context->index[i] : i;
+		if (position < 0L || position >= context->length)
+			return false;
+
+		const long original = original_index_at(sorted, size, position);
+		const double key = key_at(sorted, size, position);
+
+		if (key != key_at(context->records, size, original))
+			return false;
+
+		if (previous >= 0L) {
+			const double previous_key =
+				key_at(sorted, size, previous);
+			if (previous_key > key)
+				return false;
+			if (is_stable(context->variant) &&
+			    previous_key == key &&
+			    original_index_at(sorted, size, previous) >
+			    original)
+				return false;
+		}
+
+		previous = position;
+	}
+
+	return true;
+}
+
+// Função de comparação dos índices `first` e `second` pelas chaves
+// correspondentes de `compared_keys`, para uso com `qsort()`.
+static int compare_indexed_keys(const void *const first,
+				const void *const second)
+{
+	const double first_key = compared_keys[*(const int *)first];
+	const double second_key = compared_keys[*(const int *)second];
+
+	return (first_key > second_key) - (first_key < second_key);
+}
+
+// Realiza a ordenação indirecta correspondente à variante do contexto. Devolve
+// `true` em caso de erro.
+static bool run_key_variant(void *const generic_context)
+{
+	const struct key_context *const context = generic_context;
+
+	switch (context->variant) {
+	case argsort_double_variant:
+		return argsort_double(context->length, context->keys,
+				      context->result);
+	case rank_double_variant:
+		return rank_double(context->length, context->keys,
+				   context->result);
+	default:
+		for (int i = 0; i != context->length; i++)
+			context->result[i] = i;
+		compared_keys = context->keys;
+		qsort(context->result, context->length, sizeof(int),
+		      compare_indexed_keys);
+		return false;
+	}
+}
+
+// Predicado que verifica o resultado da ordenação indirecta realizada através
+// de `run_key_variant()`, usando o _array_ auxiliar `order`, com o mesmo
+// comprimento. Verifica que o resultado é uma permutação dos índices, que as
+// chaves pela ordem dada por essa permutação estão por ordem não decrescente e,
+// para as rotinas `argsort_double()` e `rank_double()`, que os índices das
+// chaves iguais estão por ordem crescente. No caso de `rank_double()`, a
+// permutação que ordena as chaves é a inversa do resultado.
+static bool key_variant_correct(const struct key_context *const context,
+				int order[])
+{
+	const int length = context->length;
+	const bool ranks = context->variant == rank_double_variant;
+
+	for (int i = 0; i != length; i++)
+		order[i] = -1;
+
+	for (int i = 0; i != length; i++) {
+		const int value = context->result[i];
+		if (value < 0 || value >= length || order[value] != -1)
+			return false;
+		order[value] = i;
+	}
+
+	const int *const permutation = ranks ? order : context->result;
+
+	for (int i = 1; i < length; i++) {
+		const double previous_key = context->keys[permutation[i - 1]];
+		const double key = context->keys[permutation[i]];
+		if (previous_key > key)
+			return false;
+		if (context->variant != qsort_argsort_variant &&
+		    previous_key == key && permutation[i - 1] > permutation[i])
+			return false;
+	}
+
+	return true;
+}
+
+// Constrói no _array_ `records` os `length` registos com `record_size` _bytes_
+// cada, com as chaves dadas por `keys`. A carga de cada registo começa pelo seu
+// índice, sendo o restante preenchido com um padrão arbitrário.
+static void build_records(const long length, const size_t record_size,
+			  char *const records, const double keys[length])
+{
+	for (long i = 0L; i != length; i++) {
+		char *const record = records + i * record_size;
+		memcpy(record, &keys[i], sizeof(double));
+		memcpy(record + sizeof(double), &i, sizeof(long));
+		memset(record + sizeof(double) + sizeof(long), (int)(i & 0x7F),
+		       record_size - sizeof(double) - sizeof(long));
+	}
+}
+
+// Esta rotina executa as experiências para os ficheiros do tipo `file_type`
+// com `size` chaves, lidos da pasta `path`, escrevendo uma linha de resultados
+// no canal `output`. As variantes cuja posição no _array_
+// `excessive_time_per_sort` (indexado pela dimensão da carga e pela variante)
+// tenha o valor `true` não são experimentadas, sendo esse _array_ actualizado
+// quando uma variante exceder o limiar de tempo. O _array_
+// `excessive_time_per_key_sort` tem o mesmo papel para as variantes de
+// ordenação indirecta das chaves. Devolve `true` em caso de erro.
+static bool experiment_size(FILE *const output, const char *const path,
+			    const char *const file_type, const long size,
+			    bool excessive_time_per_sort[number_of_payload_sizes]
+			    [number_of_variants],
+			    bool excessive_time_per_key_sort
+			    [number_of_key_variants])
+{
+	char file_name[FILENAME_MAX];
+	snprintf(file_name, FILENAME_MAX, "%s%s_%ld.txt", path, file_type, size);
+
+	char *records = NULL;
+	char *work_records = NULL;
+	long *index = NULL;
+	int *result = NULL;
+	int *order = NULL;
+
+	long length;
+	double *const keys = read_double_array_from(file_name, &length);
+
+	bool error = keys == NULL || length != size;
+
+	if (error) {
+		fprintf(stderr, "Error: Reading file '%s'.\n", file_name);
+		goto terminate;
+	}
+
+	// Reservamos os _arrays_ de registos com espaço para a maior das
+	// cargas, reutilizando-os para todas as cargas.
+	const size_t maximum_record_size =
+		sizeof(double) + payload_sizes[number_of_payload_sizes - 1];
+
+	records = malloc(size * maximum_record_size);
+	work_records = malloc(size * maximum_record_size);
+	index = malloc(size * sizeof(long));
+	result = malloc(size * sizeof(int));
+	order = malloc(size * sizeof(int));
+
+	error = records == NULL || work_records == NULL || index == NULL ||
+		result == NULL || order == NULL;
+
+	if (error) {
+		fprintf(stderr, "Error: Allocating records.\n");
+		goto terminate;
+	}
+
+	fprintf(output, "%ld", size);
+
+	for (int p = 0; p != number_of_payload_sizes; p++) {
+		const size_t record_size = sizeof(double) + payload_sizes[p];
+
+		build_records(size, record_size, records, keys);
+
+		for (int v = 0; v != number_of_variants; v++) {
+			struct record_context context = {
+				.variant = v,
+				.length = size,
+				.record_size = record_size,
+				.records = records,
+				.work_records = work_records,
+				.index = index
+			};
+			struct benchmark_statistics times = {
+				.median = NAN
+			};
+
+			printf("\t%s with %zu-byte payload:", variant_names[v],
+			       payload_sizes[p]);
+
+			if (!excessive_time_per_sort[p][v]) {
+				error = prepare_records(&context) ||
+					run_variant(&context);
+				if (!error && !variant_correct(&context)) {
+					fprintf(stderr, "Error: %s did not "
+						"sort.\n", variant_names[v]);
+					error = true;
+				}
+				if (!error)
+					error = bench(run_variant,
+						      is_argsort(v) ? NULL :
+						      prepare_records, NULL,
+						      &context,
+						      &benchmark_settings,
+						      &times);
+				if (error)
+					goto terminate;
+			}
+
+			printf(" median time = %g s.\n", times.median);
+
+			fprintf(output, ";%g", times.median);
+
+			if (times.median > threshold_time_per_sort)
+				excessive_time_per_sort[p][v] = true;
+		}
+	}
+
+	for (int v = 0; v != number_of_key_variants; v++) {
+		struct key_context context = {
+			.variant = v,
+			.length = (int)size,
+			.keys = keys,
+			.result = result
+		};
+		struct benchmark_statistics times = {
+			.median = NAN
+		};
+
+		printf("\t%s:", key_variant_names[v]);
+
+		if (!excessive_time_per_key_sort[v]) {
+			error = run_key_variant(&context);
+			if (!error && !key_variant_correct(&context, order)) {
+				fprintf(stderr, "Error: %s did not sort.\n",
+					key_variant_names[v]);
+				error = true;
+			}
+			if (!error)
+				error = bench(run_key_variant, NULL, NULL,
+					      &context, &benchmark_settings,
+					      &times);
+			if (error)
+				goto terminate;
+		}
+
+		printf(" median time = %g s.\n", times.median);
+
+		fprintf(output, ";%g", times.median);
+
+		if (times.median > threshold_time_per_sort)
+			excessive_time_per_key_sort[v] = true;
+	}
+
+	fputc('\n', output);
+
+terminate:
+	free(order);
+	free(result);
+	free(index);
+	free(work_records);
+	free(records);
+	free(keys);
+
+	return error;
+}
+
+// Rotina inicial do programa.
+int main(const int argument_count,
+	 const char *const argument_values[argument_count])
+{
+	if (argument_count != 4) {
+		fprintf(stderr, "Usage: %s PATH FILE_TYPE RESULTS_FILE\n",
+			argument_values[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char *const path = argument_values[1];
+	const char *const file_type = argument_values[2];
+	const char *const results_file_name = argument_values[3];
+
+	FILE *const output = fopen(results_file_name, "w");
+	if (output == NULL) {
+		fprintf(stderr, "Error: Could not open '%s' for writing!\n",
+			results_file_name);
+		return EXIT_FAILURE;
+	}
+
+	fprintf(output, "Size");
+	for (int p = 0; p != number_of_payload_sizes; p++)
+		for (int v = 0; v != number_of_variants; v++)
+			fprintf(output, ";Time Median [seconds] (%s, %zu-byte "
+				"payload)", variant_names[v], payload_sizes[p]);
+	for (int v = 0; v != number_of_key_variants; v++)
+		fprintf(output, ";Time Median [seconds] (%s)",
+			key_variant_names[v]);
+	fputc('\n', output);
+
+	bool excessive_time_per_sort[number_of_payload_sizes]
+		[number_of_variants];
+	for (int p = 0; p != number_of_payload_sizes; p++)
+		for (int v = 0; v != number_of_variants; v++)
+			excessive_time_per_sort[p][v] = false;
+
+	bool excessive_time_per_key_sort[number_of_key_variants];
+	for (int v = 0; v != number_of_key_variants; v++)
+		excessive_time_per_key_sort[v] = false;
+
+	bool error = false;
+
+	for (long size = 1L << 1; !error && size != maximum_file_size << 1;
+	     size <<= 1) {
+		printf("Starting experiments for size %ld:\n", size);
+		error = experiment_size(output, path, file_type, size,
+					excessive_time_per_sort,
+					excessive_time_per_key_sort);
+		fflush(output);
+	}
+
+	if (fclose(output) != 0)
+		error = true;
+
+	return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,484 @@
+// `perform_search_experiments.c` &ndash; Experiências com pesquisa em _arrays_ ordenados
+// ==================================================================================
+//
+// Este é o módulo principal do programa para realização de experiências com as
+// rotinas de pesquisa e de operações de conjuntos sobre _arrays_ ordenados (ver
+// [`sorted_arrays.h`](sorted_arrays.h.html)). O objectivo é comparar a
+// pesquisa binária clássica, com ramificações, com as suas alternativas: a
+// pesquisa binária sem ramificações, a pesquisa binária em lote e a pesquisa
+// sobre a organização de Eytzinger. As diferenças entre elas só se revelam
+// quando o _array_ deixa de caber nas _caches_, pelo que as experiências
+// percorrem as mesmas dimensões que as experiências com algoritmos de
+// ordenação.
+//
+// O programa recebe a pasta onde os ficheiros se encontram, o tipo de ficheiros
+// e o nome do ficheiro CSV onde os resultados serão escritos, tal como o
+// programa de experiências com algoritmos de ordenação (ver
+// [`perform_experiments.c`](perform_experiments.c.html)). Os itens de cada
+// ficheiro são ordenados e depois pesquisados um a um, pela ordem do ficheiro,
+// seguidos de uma chave menor e de outra maior do que todos os itens, de modo a
+// exercitar também os casos extremos das pesquisas. Para as operações de
+// conjuntos, cada metade do ficheiro é ordenada em separado, operando-se
+// depois sobre as duas metades. O ficheiro CSV tem uma
+// linha por dimensão e uma coluna por variante, com a mediana do tempo por
+// pesquisa, no caso das pesquisas, ou do tempo por operação, no caso das
+// operações de conjuntos.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// Inclusão de ficheiros de interface
+// -----------------------------------
+//
+// - `stdlib.h` &ndash; Para podermos usar as rotinas `malloc()`, `free()` e
+//   `qsort()`, o valor especial `NULL` e as constantes `EXIT_SUCCESS` e
+//   `EXIT_FAILURE`.
+//
+// - `stdio.h` &ndash; Para podermos usar as rotinas `printf()`, `fprintf()`,
+//   `snprintf()`, `fopen()`, `fclose()`, `fflush()` e `fputc()`.
+//
+// - `math.h` &ndash; Para podermos usar as macros `NAN` e `INFINITY` e a
+//   função `nextafter()`.
+//
+// - `array_of_doubles.h` &ndash; Para podermos ler os ficheiros e copiar os
+//   _arrays_.
+//
+// - `sorted_arrays.h` &ndash; Para podermos usar as rotinas experimentadas.
+//
+// - `benchmark.h` &ndash; Para podermos medir os tempos de execução.
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "array_of_doubles.h"
+#include "sorted_arrays.h"
+#include "benchmark.h"
+
+// Definição de constantes
+// -----------------------
+
+// Os parâmetros das medições dos tempos de execução, iguais aos usados no
+// programa de experiências com algoritmos de ordenação.
+static const struct benchmark_settings benchmark_settings = {
+	.precision = 1.0, // seconds
+	.warm_up_runs = 1L,
+	.maximum_repetition_time = 300.0, // seconds
+	.maximum_repetitions = 1001L,
+	.flush_cache = false
+};
+
+// A dimensão máxima dos ficheiros a usar nas experiências (ver
+// `perform_experiments.c`).
+static const long maximum_file_size = 1L << 24;
+
+// As variantes experimentadas.
+enum variant {
+	branchy_search_variant,
+	branchless_search_variant,
+	batched_search_variant,
+	eytzinger_search_variant,
+	union_variant,
+	intersection_variant,
+	difference_variant,
+	number_of_variants
+};
+
+// Os nomes das variantes, usados nos cabeçalhos do ficheiro CSV.
+static const char *const variant_names[number_of_variants] = {
+	"branchy binary search",
+	"branchless binary search",
+	"batched binary search",
+	"Eytzinger search",
+	"union",
+	"intersection",
+	"difference"
+};
+
+// Estrutura do contexto das medições
+// ----------------------------------
+
+// Esta estrutura guarda o contexto passado às rotinas medidas: a variante, os
+// itens ordenados, a sua organização de Eytzinger, as chaves a pesquisar, as
+// posições encontradas, as duas metades ordenadas do ficheiro, usadas nas
+// operações de conjuntos, e o _array_ onde é colocado o seu resultado.
+struct search_context {
+	enum variant variant;
+	long length;
+	const double *sorted;
+	const double *layout;
+	long number_of_keys;
+	const double *keys;
+	long *positions;
+	long first_length;
+	const double *first;
+	long second_length;
+	const double *second;
+	double *result;
+	long result_length;
+};
+
+// Definição de rotinas
+// --------------------
+
+// Função de comparação usada por `qsort()` na ordenação dos itens.
+static int compare_doubles(const void *const first_generic,
+			   const void *const second_generic)
+{
+	const double first = *(const double *)first_generic;
+	const double second = *(const double *)second_generic;
+
+	return (first > second) - (first < second);
+}
+
+// Rotina que devolve o limite inferior de `key` no _array_ ordenado `items`,
+// com `length` itens, usando a pesquisa binária clássica, com ramificações.
+// Serve de referência às restantes variantes.
+static long branchy_lower_bound_of(const long length,
+				   const double items[length],
+				   const double key)
+{
+	long first = 0L;
+	long last = length;
+
+	while (first < last) {
+		const long middle = first + (last - first) / 2;
+		if (items[middle] < key)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	return first;
+}
+
+// Realiza a operação correspondente à variante do contexto. Devolve sempre
+// `false`, pois nenhuma das operações pode falhar.
+static bool run_variant(void *const generic_context)
+{
+	struct search_context *const context = generic_context;
+	const long length = context->length;
+	const long number_of_keys = context->number_of_keys;
+
+	switch (context->variant) {
+	case branchy_search_variant:
+		for (long i = 0L; i != number_of_keys; i++)
+			context->positions[i] =
+				branchy_lower_bound_of(length, context->sorted,
+						       context->keys[i]);
+		break;
+	case branchless_search_variant:
+		for (long i = 0L; i != number_of_keys; i++)
+			context->positions[i] =
+				lower_bound_of(length, context->sorted,
+					       context->keys[i]);
+		break;
+	case batched_search_variant:
+		lower_bounds_of(length, context->sorted, number_of_keys,
+				context->keys, context->positions);
+		break;
+	case eytzinger_search_variant:
+		for (long i = 0L; i != number_of_keys; i++)
+			context->positions[i] =
+				eytzinger_lower_bound_of(length,
+							 context->layout,
+							 context->keys[i]);
+		break;
+	case union_variant:
+		context->result_length =
+			sorted_union(context->first_length, context->first,
+				     context->second_length, context->second,
+				     context->result);
+		break;
+	case intersection_variant:
+		context->result_length =
+			sorted_intersection(context->first_length,
+					    context->first,
+					    context->second_length,
+					    context->second, context->result);
+		break;
+	default:
+		context->result_length =
+			sorted_difference(context->first_length, context->first,
+					  context->second_length,
+					  context->second, context->result);
+		break;
+	}
+
+	return false;
+}
+
+// Coloca em `result` o resultado esperado da operação de conjuntos
+// correspondente à variante do contexto, devolvendo o seu comprimento. Serve de
+// referência às rotinas de `sorted_arrays.h`, pelo que é calculado de forma
+// ingénua e independente destas: as duas metades são percorridas por blocos de
+// itens iguais e cada valor surge no resultado tantas vezes quantas as do maior
+// (na união) ou do menor (na intersecção) dos seus dois blocos, ou tantas vezes
+// quantas as que o seu bloco na primeira metade excede o da segunda (na
+// diferença).
+static long expected_set_operation(const struct search_context *const context,
+				   double result[])
+{
+	const double *const first = context->first;
+	const double *const second = context->second;
+	long i = 0L;
+	long j = 0L;
+	long k = 0L;
+
+	while (i != context->first_length || j != context->second_length) {
+		const double value = j == context->second_length ||
+			(i != context->first_length && first[i] < second[j]) ?
+			first[i] : second[j];
+
+		long first_count = 0L;
+		while (i != context->first_length && !(value < first[i])) {
+			first_count++;
+			i++;
+		}
+
+		long second_count = 0L;
+		while (j != context->second_length && !(value < second[j])) {
+			second_count++;
+			j++;
+		}
+
+		long count;
+		if (context->variant == union_variant)
+			count = first_count > second_count ? first_count :
+				second_count;
+		else if (context->variant == intersection_variant)
+			count = first_count < second_count ? first_count :
+				second_count;
+		else
+			count = first_count > second_count ?
+				first_count - second_count : 0L;
+
+		while (count-- != 0L)
+			result[k++] = value;
+	}
+
+	return k;
+}
+
+// Predicado que verifica o resultado da operação realizada através de
+// `run_variant()`. As posições encontradas pelas pesquisas são comparadas com
+// as da pesquisa binária clássica, guardadas em `expected_positions`. No caso
+// da organização de Eytzinger, compara-se o item encontrado. Os resultados das
+// operações de conjuntos têm de estar ordenados e ser iguais, item a item, aos
+// calculados por `expected_set_operation()` no _array_ auxiliar
+// `expected_result`.
+static bool variant_correct(const struct search_context *const context,
+			    const long expected_positions[],
+			    double expected_result[])
+{
+	const long length = context->length;
+	const long number_of_keys = context->number_of_keys;
+
+	switch (context->variant) {
+	case branchy_search_variant:
+	case branchless_search_variant:
+	case batched_search_variant:
+		for (long i = 0L; i != number_of_keys; i++)
+			if (context->positions[i] != expected_positions[i])
+				return false;
+		return true;
+	case eytzinger_search_variant:
+		for (long i = 0L; i != number_of_keys; i++) {
+			const long k = context->positions[i];
+			const long expected = expected_positions[i];
+			if (expected == length ? k != 0L :
+			    k == 0L || context->layout[k] !=
+			    context->sorted[expected])
+				return false;
+		}
+		return true;
+	default:
+		return double_array_is_non_decreasing(context->result_length,
+						       context->result) &&
+			expected_set_operation(context, expected_result) ==
+			context->result_length &&
+			double_arrays_equal(context->result_length,
+					    context->result, expected_result);
+	}
+}
+
+// Esta rotina executa as experiências para os ficheiros do tipo `file_type`
+// com `size` itens, lidos da pasta `path`, escrevendo uma linha de resultados
+// no canal `output`. Devolve `true` em caso de erro.
+static bool experiment_size(FILE *const output, const char *const path,
+			    const char *const file_type, const long size)
+{
+	char file_name[FILENAME_MAX];
+	snprintf(file_name, FILENAME_MAX, "%s%s_%ld.txt", path, file_type, size);
+
+	double *sorted = NULL;
+	double *layout = NULL;
+	double *halves = NULL;
+	double *result = NULL;
+	double *expected_result = NULL;
+	double *search_keys = NULL;
+	long *positions = NULL;
+	long *expected_positions = NULL;
+
+	long length;
+	double *const keys = read_double_array_from(file_name, &length);
+
+	bool error = keys == NULL || length != size;
+
+	if (error) {
+		fprintf(stderr, "Error: Reading file '%s'.\n", file_name);
+		goto terminate;
+	}
+
+	sorted = new_double_array_of(size);
+	halves = new_double_array_of(size);
+	result = new_double_array_of(size);
+	expected_result = new_double_array_of(size);
+	search_keys = new_double_array_of(size + 2);
+	positions = malloc((size + 2) * sizeof(long));
+	expected_positions = malloc((size + 2) * sizeof(long));
+
+	error = sorted == NULL || halves == NULL || result == NULL ||
+		expected_result == NULL || search_keys == NULL ||
+		positions == NULL || expected_positions == NULL;
+
+	if (!error) {
+		copy_double_array(size, sorted, keys);
+		qsort(sorted, size, sizeof(double), compare_doubles);
+
+		layout = new_eytzinger_layout_of(size, sorted);
+
+		error = layout == NULL;
+	}
+
+	if (error) {
+		fprintf(stderr, "Error: Allocating arrays.\n");
+		goto terminate;
+	}
+
+	// As duas metades do ficheiro, ordenadas em separado.
+	const long first_length = size / 2;
+	copy_double_array(size, halves, keys);
+	qsort(halves, first_length, sizeof(double), compare_doubles);
+	qsort(halves + first_length, size - first_length, sizeof(double),
+	      compare_doubles);
+
+	// As chaves a pesquisar: os itens do ficheiro, pela ordem do
+	// ficheiro, seguidos de uma chave menor do que todos os itens, cujo
+	// limite inferior é o início do _array_, e de uma chave maior do que
+	// todos os itens, cujo limite inferior é o fim do _array_.
+	const long number_of_keys = size + 2;
+	copy_double_array(size, search_keys, keys);
+	search_keys[size] = nextafter(sorted[0], -INFINITY);
+	search_keys[size + 1] = nextafter(sorted[size - 1], INFINITY);
+
+	// Os resultados de referência das pesquisas: as posições obtidas pela
+	// pesquisa binária clássica.
+	for (long i = 0L; i != number_of_keys; i++)
+		expected_positions[i] =
+			branchy_lower_bound_of(size, sorted, search_keys[i]);
+
+	fprintf(output, "%ld", size);
+
+	for (int v = 0; v != number_of_variants; v++) {
+		struct search_context context = {
+			.variant = v,
+			.length = size,
+			.sorted = sorted,
+			.layout = layout,
+			.number_of_keys = number_of_keys,
+			.keys = search_keys,
+			.positions = positions,
+			.first_length = first_length,
+			.first = halves,
+			.second_length = size - first_length,
+			.second = halves + first_length,
+			.result = result,
+			.result_length = 0L
+		};
+		struct benchmark_statistics times = {
+			.median = NAN
+		};
+
+		printf("\t%s:", variant_names[v]);
+
+		run_variant(&context);
+		if (!variant_correct(&context, expected_positions,
+				     expected_result)) {
+			fprintf(stderr, "Error: %s is not correct.\n",
+				variant_names[v]);
+			error = true;
+		}
+		if (!error)
+			error = bench(run_variant, NULL, NULL, &context,
+				      &benchmark_settings, &times);
+		if (error)
+			goto terminate;
+
+		// Os tempos das pesquisas são divididos pelo número de
+		// pesquisas.
+		const double time = v < union_variant ?
+			times.median / number_of_keys : times.median;
+
+		printf(" median time = %g s.\n", time);
+
+		fprintf(output, ";%g", time);
+	}
+
+	fputc('\n', output);
+
+terminate:
+	free(expected_positions);
+	free(positions);
+	free(search_keys);
+	free(expected_result);
+	free(result);
+	free(halves);
+	free(layout);
+	free(sorted);
+	free(keys);
+
+	return error;
+}
+
+// Rotina inicial do programa.
+int main(const int argument_count,
+	 const char *const argument_values[argument_count])
+{
+	if (argument_count != 4) {
+		fprintf(stderr, "Usage: %s PATH FILE_TYPE RESULTS_FILE\n",
+			argument_values[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char *const path = argument_values[1];
+	const char *const file_type = argument_values[2];
+	const char *const results_file_name = argument_values[3];
+
+	FILE *const output = fopen(results_file_name, "w");
+	if (output == NULL) {
+		fprintf(stderr, "Error: Could not open '%s' for writing!\n",
+			results_file_name);
+		return EXIT_FAILURE;
+	}
+
+	fprintf(output, "Size");
+	for (int v = 0; v != number_of_variants; v++)
+		fprintf(output, v < union_variant ?
+			";Time per Search Median [seconds] (%s)" :
+			";Time Median [seconds] (%s)", variant_names[v]);
+	fputc('\n', output);
+
+	bool error = false;
+
+	for (long size = 1L << 1; !error && size != maximum_file_size << 1;
+	     size <<= 1) {
+		printf("Starting experiments for size %ld:\n", size);
+		error = experiment_size(output, path, file_type, size);
+		fflush(output);
+	}
+
+	if (fclose(output) != 0)
+		error = true;
+
+	return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,328 @@
+// `perform_selection_experiments.c` &ndash; Experiências com selecção
+// ================================================================
+//
+// Este é o módulo principal do programa para realização de experiências com as
+// rotinas de selecção dos _k_ menores itens (ver
+// [`sorting_algorithms.h`](sorting_algorithms.h.html)): a ordenação parcial
+// (`partial_sort()`), a selecção do _k_-ésimo menor item (`nth_element()`) e a
+// selecção dos _k_ menores itens à medida que são lidos de um ficheiro
+// (`read_smallest_from()`). O objectivo é medir o ganho destas rotinas face a
+// uma ordenação completa quando apenas interessam os primeiros _k_ itens, para
+// vários valores de _k_.
+//
+// O programa recebe a pasta onde os ficheiros se encontram, o tipo de ficheiros
+// e o nome do ficheiro CSV onde os resultados serão escritos, tal como o
+// programa de experiências com algoritmos de ordenação (ver
+// [`perform_experiments.c`](perform_experiments.c.html)). O ficheiro CSV tem
+// uma linha por dimensão e, por cada par de variante e valor de _k_, uma
+// coluna com a mediana dos tempos de execução e outra com o número de
+// comparações. Os valores de _k_ maiores do que a dimensão não são
+// experimentados, surgindo no ficheiro CSV como NaN.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// Inclusão de ficheiros de interface
+// -----------------------------------
+//
+// - `stdlib.h` &ndash; Para podermos usar as rotinas `malloc()` e `free()`, o
+//   valor especial `NULL` e as constantes `EXIT_SUCCESS` e `EXIT_FAILURE`.
+//
+// - `stdio.h` &ndash; Para podermos usar as rotinas `printf()`, `fprintf()`,
+//   `snprintf()`, `fopen()`, `fclose()`, `fflush()` e `fputc()`.
+//
+// - `math.h` &ndash; Para podermos usar a macro `NAN`.
+//
+// - `array_of_doubles.h` &ndash; Para podermos ler os ficheiros e copiar os
+//   _arrays_.
+//
+// - `sorting_algorithms.h` &ndash; Para podermos usar as rotinas de selecção e
+//   a ordenação por monte, usada na verificação dos resultados.
+//
+// - `benchmark.h` &ndash; Para podermos medir os tempos de execução.
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "array_of_doubles.h"
+#include "sorting_algorithms.h"
+#include "benchmark.h"
+
+// Definição de constantes
+// -----------------------
+
+// Os parâmetros das medições dos tempos de execução, iguais aos usados no
+// programa de experiências com algoritmos de ordenação.
+static const struct benchmark_settings benchmark_settings = {
+	.precision = 1.0, // seconds
+	.warm_up_runs = 1L,
+	.maximum_repetition_time = 300.0, // seconds
+	.maximum_repetitions = 1001L,
+	.flush_cache = false
+};
+
+// A dimensão máxima dos ficheiros a usar nas experiências (ver
+// `perform_experiments.c`).
+static const long maximum_file_size = 1L << 24;
+
+// Os valores de _k_ experimentados.
+static const int ks[] = { 1, 16, 256, 4096, 65536 };
+#define number_of_ks ((int)(sizeof(ks) / sizeof(ks[0])))
+
+// As variantes de selecção experimentadas.
+enum variant {
+	partial_sort_variant,
+	nth_element_variant,
+	streaming_variant,
+	number_of_variants
+};
+
+// Os nomes das variantes, usados nos cabeçalhos do ficheiro CSV.
+static const char *const variant_names[number_of_variants] = {
+	"partial sort",
+	"nth element",
+	"streaming top-k"
+};
+
+// Estrutura do contexto das medições
+// ----------------------------------
+
+// Esta estrutura guarda o contexto passado às rotinas medidas: a variante, o
+// valor de _k_, o nome do ficheiro (lido pela variante de leitura), os itens
+// originais e os itens de trabalho (alterados pelas restantes variantes).
+struct selection_context {
+	enum variant variant;
+	int k;
+	const char *file_name;
+	int length;
+	const double *items;
+	double *work_items;
+};
+
+// Definição de rotinas
+// --------------------
+
+// Prepara uma selecção, copiando os itens originais para os itens de
+// trabalho. O tempo desta cópia é descontado pela biblioteca `benchmark`.
+static bool prepare_items(void *const generic_context)
+{
+	const struct selection_context *const context = generic_context;
+
+	copy_double_array(context->length, context->work_items,
+			  context->items);
+
+	return false;
+}
+
+// Realiza a selecção correspondente à variante do contexto. Devolve `true` em
+// caso de erro.
+static bool run_variant(void *const generic_context)
+{
+	const struct selection_context *const context = generic_context;
+
+	switch (context->variant) {
+	case partial_sort_variant:
+		return partial_sort(context->length, context->work_items,
+				    context->k);
+	case nth_element_variant:
+		return nth_element(context->length, context->work_items,
+				   context->k - 1);
+	default:
+		return read_smallest_from(context->file_name, context->k,
+					  context->work_items) != context->k;
+	}
+}
+
+// Realiza a selecção correspondente à variante do contexto, contando as
+// operações realizadas em `counts`. Devolve `true` em caso de erro.
+static bool run_variant_and_count(const struct selection_context *const
+				  context, struct algorithm_counts *const counts)
+{
+	switch (context->variant) {
+	case partial_sort_variant:
+		return partial_sort_and_count(context->length,
+					      context->work_items, context->k,
+					      counts);
+	case nth_element_variant:
+		return nth_element_and_count(context->length,
+					     context->work_items,
+					     context->k - 1, counts);
+	default:
+		return read_smallest_from_and_count(context->file_name,
+						    context->k,
+						    context->work_items,
+						    counts) != context->k;
+	}
+}
+
+// Predicado que verifica o resultado da selecção realizada através de
+// `run_variant()`, comparando-o com os itens ordenados `sorted`. Para as
+// variantes de ordenação parcial e de leitura, os primeiros _k_ itens têm de
+// ser os primeiros _k_ itens ordenados. Para a variante de selecção do
+// _k_-ésimo item, esse item tem de estar na sua posição definitiva, sem itens
+// maiores antes dele nem itens menores depois dele.
+static bool variant_correct(const struct selection_context *const context,
+			    const double sorted[])
+{
+	const int k = context->k;
+	const double *const items = context->work_items;
+
+	if (context->variant != nth_element_variant) {
+		for (int i = 0; i != k; i++)
+			if (items[i] != sorted[i])
+				return false;
+		return true;
+	}
+
+	if (items[k - 1] != sorted[k - 1])
+		return false;
+	for (int i = 0; i != context->length; i++)
+		if ((i < k - 1 && items[i] > items[k - 1]) ||
+		    (i > k - 1 && items[i] < items[k - 1]))
+			return false;
+
+	return true;
+}
+
+// Esta rotina executa as experiências para os ficheiros do tipo `file_type`
+// com `size` itens, lidos da pasta `path`, escrevendo uma linha de resultados
+// no canal `output`. Devolve `true` em caso de erro.
+static bool experiment_size(FILE *const output, const char *const path,
+			    const char *const file_type, const long size)
+{
+	char file_name[FILENAME_MAX];
+	snprintf(file_name, FILENAME_MAX, "%s%s_%ld.txt", path, file_type, size);
+
+	double *work_items = NULL;
+	double *sorted = NULL;
+
+	long length;
+	double *const items = read_double_array_from(file_name, &length);
+
+	bool error = items == NULL || length != size;
+
+	if (error) {
+		fprintf(stderr, "Error: Reading file '%s'.\n", file_name);
+		goto terminate;
+	}
+
+	work_items = new_double_array_of(size);
+	sorted = new_double_array_of(size);
+
+	error = work_items == NULL || sorted == NULL;
+
+	if (error) {
+		fprintf(stderr, "Error: Allocating arrays.\n");
+		goto terminate;
+	}
+
+	copy_double_array(size, sorted, items);
+	error = heap_sort(size, sorted);
+	if (error)
+		goto terminate;
+
+	fprintf(output, "%ld", size);
+
+	for (int p = 0; p != number_of_ks; p++)
+		for (int v = 0; v != number_of_variants; v++) {
+			struct selection_context context = {
+				.variant = v,
+				.k = ks[p],
+				.file_name = file_name,
+				.length = size,
+				.items = items,
+				.work_items = work_items
+			};
+			struct algorithm_counts counts = {
+				.comparisons = 0L,
+				.swaps = 0L,
+				.copies = 0L
+			};
+			struct benchmark_statistics times = {
+				.median = NAN
+			};
+			double comparisons = NAN;
+
+			printf("\t%s with k = %d:", variant_names[v], ks[p]);
+
+			if (ks[p] <= size) {
+				error = prepare_items(&context) ||
+					run_variant_and_count(&context,
+							      &counts);
+				if (!error && !variant_correct(&context,
+							       sorted)) {
+					fprintf(stderr, "Error: %s did not "
+						"select.\n", variant_names[v]);
+					error = true;
+				}
+				if (!error)
+					error = bench(run_variant,
+						      v == streaming_variant ?
+						      NULL : prepare_items,
+						      NULL, &context,
+						      &benchmark_settings,
+						      &times);
+				if (error)
+					goto terminate;
+				comparisons = counts.comparisons;
+			}
+
+			printf(" median time = %g s, comparisons = %g.\n",
+			       times.median, comparisons);
+
+			fprintf(output, ";%g;%g", times.median, comparisons);
+		}
+
+	fputc('\n', output);
+
+terminate:
+	free(sorted);
+	free(work_items);
+	free(items);
+
+	return error;
+}
+
+// Rotina inicial do programa.
+int main(const int argument_count,
+	 const char *const argument_values[argument_count])
+{
+	if (argument_count != 4) {
+		fprintf(stderr, "Usage: %s PATH FILE_TYPE RESULTS_FILE\n",
+			argument_values[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char *const path = argument_values[1];
+	const char *const file_type = argument_values[2];
+	const char *const results_file_name = argument_values[3];
+
+	FILE *const output = fopen(results_file_name, "w");
+	if (output == NULL) {
+		fprintf(stderr, "Error: Could not open '%s' for writing!\n",
+			results_file_name);
+		return EXIT_FAILURE;
+	}
+
+	fprintf(output, "Size");
+	for (int p = 0; p != number_of_ks; p++)
+		for (int v = 0; v != number_of_variants; v++)
+			fprintf(output, ";Time Median [seconds] (%s, k = %d)"
+				";Comparisons (%s, k = %d)", variant_names[v],
+				ks[p], variant_names[v], ks[p]);
+	fputc('\n', output);
+
+	bool error = false;
+
+	for (long size = 1L << 1; !error && size != maximum_file_size << 1;
+	     size <<= 1) {
+		printf("Starting experiments for size %ld:\n", size);
+		error = experiment_size(output, path, file_type, size);
+		fflush(output);
+	}
+
+	if (fclose(output) != 0)
+		error = true;
+
+	return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
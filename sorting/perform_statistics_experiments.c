@@ -0,0 +1,265 @@
+// `perform_statistics_experiments.c` &ndash; Experiências com o cálculo de estatísticas
+// ==================================================================================
+//
+// Este é o módulo principal do programa de regressão do cálculo das
+// estatísticas de _arrays_ de `double` (ver
+// [`array_of_doubles.h`](array_of_doubles.h.html)). A mediana era calculada
+// ordenando uma cópia dos itens através de `qsort()`, com uma função de
+// comparação que, por engano, comparava os ponteiros para os itens, e não os
+// próprios itens. O resultado dependia apenas das posições em memória dos
+// itens comparados, e não dos seus valores, pelo que, em geral, os itens
+// ficavam por ordenar e a «mediana» não o era. A mediana é agora calculada por
+// selecção rápida, sem ordenar o _array_ e sem comparações indirectas.
+//
+// Para cada dimensão, o programa calcula a mediana dos itens do ficheiro das
+// três formas (a antiga, errada, através de `qsort()` com uma função de
+// comparação correcta e através de `double_array_statistics()`), verifica que
+// as duas últimas coincidem e mede o tempo das duas últimas. O programa
+// recebe a pasta onde os ficheiros se encontram, o tipo de ficheiros e o nome
+// do ficheiro CSV onde os resultados serão escritos, tal como o programa de
+// experiências com algoritmos de ordenação (ver
+// [`perform_experiments.c`](perform_experiments.c.html)).
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// Inclusão de ficheiros de interface
+// -----------------------------------
+//
+// - `stdlib.h` &ndash; Para podermos usar as rotinas `malloc()`, `free()` e
+//   `qsort()`, o valor especial `NULL` e as constantes `EXIT_SUCCESS` e
+//   `EXIT_FAILURE`.
+//
+// - `stdio.h` &ndash; Para podermos usar as rotinas `printf()`, `fprintf()`,
+//   `snprintf()`, `fopen()`, `fclose()`, `fflush()` e `fputc()`.
+//
+// - `math.h` &ndash; Para podermos usar a função `sqrt()`.
+//
+// - `array_of_doubles.h` &ndash; Para podermos ler os ficheiros e calcular as
+//   estatísticas.
+//
+// - `benchmark.h` &ndash; Para podermos medir os tempos de execução.
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "array_of_doubles.h"
+#include "benchmark.h"
+
+// Definição de constantes
+// -----------------------
+
+// Os parâmetros das medições dos tempos de execução, iguais aos usados no
+// programa de experiências com algoritmos de ordenação.
+static const struct benchmark_settings benchmark_settings = {
+	.precision = 1.0, // seconds
+	.warm_up_runs = 1L,
+	.maximum_repetition_time = 300.0, // seconds
+	.maximum_repetitions = 1001L,
+	.flush_cache = false
+};
+
+// A dimensão máxima dos ficheiros a usar nas experiências (ver
+// `perform_experiments.c`).
+static const long maximum_file_size = 1L << 24;
+
+// Estrutura do contexto das medições
+// ----------------------------------
+
+// Esta estrutura guarda o contexto passado às rotinas medidas: os itens e as
+// estatísticas calculadas.
+struct statistics_context {
+	long length;
+	const double *items;
+	struct double_statistics statistics;
+};
+
+// Definição de rotinas
+// --------------------
+
+// A função de comparação usada antes pelo módulo `array_of_doubles`, que
+// compara os ponteiros, e não os itens apontados.
+static int compare_pointers(const void *const first_generic,
+			    const void *const second_generic)
+{
+	const double *first = first_generic;
+	const double *second = second_generic;
+
+	return (first > second) - (first < second);
+}
+
+// Uma função de comparação correcta, que compara os itens apontados.
+static int compare_items(const void *const first_generic,
+			 const void *const second_generic)
+{
+	const double first = *(const double *)first_generic;
+	const double second = *(const double *)second_generic;
+
+	return (first > second) - (first < second);
+}
+
+// Calcula as estatísticas dos itens do contexto da forma antiga, ordenando uma
+// cópia dos itens através de `qsort()` com a função de comparação
+// `comparison`, e guarda-as no contexto. Devolve `true` em caso de erro.
+static bool qsort_statistics(struct statistics_context *const context,
+			     int comparison(const void *, const void *))
+{
+	const long length = context->length;
+	double *const work_items = new_double_array_of(length);
+	if (work_items == NULL)
+		return true;
+
+	double sum = 0.0;
+	double sum_of_squares = 0.0;
+
+	for (long i = 0L; i != length; i++) {
+		work_items[i] = context->items[i];
+		sum += context->items[i];
+		sum_of_squares += context->items[i] * context->items[i];
+	}
+
+	context->statistics.average = sum / length;
+	context->statistics.stddev =
+		sqrt(sum_of_squares / length - context->statistics.average *
+		     context->statistics.average);
+
+	qsort(work_items, length, sizeof(double), comparison);
+
+	context->statistics.minimum = work_items[0];
+	context->statistics.median = length % 2 == 0L ?
+		(work_items[length / 2 - 1] + work_items[length / 2]) / 2 :
+		work_items[length / 2];
+	context->statistics.maximum = work_items[length - 1];
+
+	free(work_items);
+
+	return false;
+}
+
+// Calcula as estatísticas através de `qsort()` com uma função de comparação
+// correcta. Devolve `true` em caso de erro.
+static bool run_qsort_statistics(void *const generic_context)
+{
+	return qsort_statistics(generic_context, compare_items);
+}
+
+// Calcula as estatísticas através de `double_array_statistics()`. Devolve
+// sempre `false`.
+static bool run_selection_statistics(void *const generic_context)
+{
+	struct statistics_context *const context = generic_context;
+
+	context->statistics = double_array_statistics(context->length,
+						      context->items);
+
+	return false;
+}
+
+// Esta rotina executa as experiências para o ficheiro do tipo `file_type` com
+// `size` itens, lido da pasta `path`, escrevendo uma linha de resultados no
+// canal `output`. Devolve `true` em caso de erro.
+static bool experiment_size(FILE *const output, const char *const path,
+			    const char *const file_type, const long size)
+{
+	char file_name[FILENAME_MAX];
+	snprintf(file_name, FILENAME_MAX, "%s%s_%ld.txt", path, file_type, size);
+
+	long length;
+	double *const items = read_double_array_from(file_name, &length);
+
+	bool error = items == NULL || length != size;
+
+	if (error) {
+		fprintf(stderr, "Error: Reading file '%s'.\n", file_name);
+		goto terminate;
+	}
+
+	struct statistics_context context = {
+		.length = size,
+		.items = items
+	};
+
+	error = qsort_statistics(&context, compare_pointers);
+	const double old_median = context.statistics.median;
+
+	error = error || run_qsort_statistics(&context);
+	const struct double_statistics expected = context.statistics;
+
+	if (error) {
+		fprintf(stderr, "Error: Allocating the working copy.\n");
+		goto terminate;
+	}
+
+	run_selection_statistics(&context);
+	const struct double_statistics obtained = context.statistics;
+
+	if (obtained.median != expected.median ||
+	    obtained.minimum != expected.minimum ||
+	    obtained.maximum != expected.maximum) {
+		fprintf(stderr, "Error: Statistics differ for '%s'.\n",
+			file_name);
+		error = true;
+		goto terminate;
+	}
+
+	struct benchmark_statistics qsort_times;
+	struct benchmark_statistics selection_times;
+
+	error = bench(run_qsort_statistics, NULL, NULL, &context,
+		      &benchmark_settings, &qsort_times) ||
+		bench(run_selection_statistics, NULL, NULL, &context,
+		      &benchmark_settings, &selection_times);
+	if (error)
+		goto terminate;
+
+	printf("\tmedian = %g (was %g), median time = %g s with qsort, %g s "
+	       "with selection.\n", obtained.median, old_median,
+	       qsort_times.median, selection_times.median);
+
+	fprintf(output, "%ld;%g;%g;%g;%g\n", size, old_median, obtained.median,
+		qsort_times.median, selection_times.median);
+
+terminate:
+	free(items);
+
+	return error;
+}
+
+// Rotina inicial do programa.
+int main(const int argument_count,
+	 const char *const argument_values[argument_count])
+{
+	if (argument_count != 4) {
+		fprintf(stderr, "Usage: %s PATH FILE_TYPE RESULTS_FILE\n",
+			argument_values[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char *const path = argument_values[1];
+	const char *const file_type = argument_values[2];
+	const char *const results_file_name = argument_values[3];
+
+	FILE *const output = fopen(results_file_name, "w");
+	if (output == NULL) {
+		fprintf(stderr, "Error: Could not open '%s' for writing!\n",
+			results_file_name);
+		return EXIT_FAILURE;
+	}
+
+	fprintf(output, "Size;Median (old);Median;Time Median [seconds] (qsort)"
+		";Time Median [seconds] (selection)\n");
+
+	bool error = false;
+
+	for (long size = 1L << 1; !error && size != maximum_file_size << 1;
+	     size <<= 1) {
+		printf("Starting experiments for size %ld:\n", size);
+		error = experiment_size(output, path, file_type, size);
+		fflush(output);
+	}
+
+	if (fclose(output) != 0)
+		error = true;
+
+	return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -15,9 +15,9 @@ function print_sort_results(types_to_plot, algs_to_plot, stats_to_plot, file)
   types_colors = {'1', '2', '3'};
   n_types = columns(types);
 
-  algs = {'bubble', 'selection', 'insertion', 'shell', 'quick', 'merge'};
-  algs_long = {'bubble sort', 'selection sort', 'insertion sort', 'Shell sort', 'quicksort', 'merge sort'};
-  algs_marks = {'.', 'o', 'x', '*', '+', '^'};
+  algs = {'bubble', 'selection', 'insertion', 'shell', 'shell_ciura', 'shell_tokuda', 'shell_sedgewick', 'shell_pratt', 'quick', 'merge', 'heap', 'heap4', 'heap8'};
+  algs_long = {'bubble sort', 'selection sort', 'insertion sort', 'Shell sort', 'Shell sort (Ciura)', 'Shell sort (Tokuda)', 'Shell sort (Sedgewick)', 'Shell sort (Pratt)', 'quicksort', 'merge sort', 'heapsort', '4-ary heapsort', '8-ary heapsort'};
+  algs_marks = {'.', 'o', 'x', '*', '<', '>', 'p', 'h', '+', '^', 's', 'd', 'v'};
   n_algs = columns(algs);
 
   stats = {'comparisons', 'swaps', 'copies', 'runs', 'repetitions', 'average', 'stddev', 'median', 'minimum', 'maximum'};
@@ -0,0 +1,297 @@
+// `record_sorting.c` &ndash; Ordenação de registos com chave `double`
+// ================================================================
+//
+// Este é o ficheiro de implementação correspondente ao ficheiro de cabeçalho ou
+// de interface [`record_sorting.h`](record_sorting.h.html). Ambos correspondem
+// ao módulo físico `record_sorting`, cujo objectivo é ordenar _arrays_ de
+// registos, ou seja, de instâncias de estruturas, por uma chave `double`.
+//
+// Como a dimensão dos registos só é conhecida durante a execução, os registos
+// são manipulados como sequências de _bytes_, através de ponteiros para `char`,
+// e movidos através de `memcpy()` e `memmove()`.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// Começamos por incluir o próprio ficheiro de interface. Isso ajuda-nos a
+// garantir a coerência entre os dois ficheiros, pois desta forma o compilador
+// poderá gerar erros quando detectar incoerências.
+#include "record_sorting.h"
+
+// Inclusão de ficheiros de interface
+// -----------------------------------
+//
+// - `stdlib.h` &ndash; Para podermos usar as rotinas `malloc()` e `free()` e o
+//   valor especial `NULL`.
+//
+// - `string.h` &ndash; Para podermos usar os procedimentos `memcpy()` e
+//   `memmove()`.
+//
+// - `assert.h` &ndash; Para podermos usar a macro `assert()`.
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+// Definição de constantes
+// -----------------------
+
+// Os segmentos com até este número de registos são ordenados por inserção,
+// quer na ordenação estável, quer na instável. Para segmentos tão pequenos, a
+// ordenação por inserção é mais rápida do que os algoritmos de divisão e
+// conquista.
+static const long insertion_threshold = 16L;
+
+// Definição de tipos
+// ------------------
+
+// Os registos ordenados durante um _argsort_, compostos pela chave de um
+// registo e pelo seu índice no _array_ original.
+struct keyed_index {
+	double key;
+	long index;
+};
+
+// Definição de rotinas auxiliares
+// -------------------------------
+
+// Devolve a chave do registo `record`, ou seja, o `double` com que começa.
+static inline double key_of(const char *const record)
+{
+	double key;
+	memcpy(&key, record, sizeof(key));
+	return key;
+}
+
+// Troca os conteúdos dos registos `first` e `second`, com `size` _bytes_ cada,
+// em pedaços de até 64 _bytes_.
+static void swap_records(char *first, char *second, size_t size)
+{
+	char buffer[64];
+
+	while (size != 0) {
+		const size_t chunk = size < sizeof(buffer) ? size : sizeof(buffer);
+		memcpy(buffer, first, chunk);
+		memcpy(first, second, chunk);
+		memcpy(second, buffer, chunk);
+		first += chunk;
+		second += chunk;
+		size -= chunk;
+	}
+}
+
+// Ordena por inserção os `length` registos com `size` _bytes_ cada do _array_
+// `records`, usando `held` para guardar o registo em inserção. A ordenação é
+// estável. Os registos maiores do que o registo em inserção são deslocados de
+// uma só vez, através de `memmove()`.
+static void insertion_sort_records(const long length, const size_t size,
+				   char *const records, char *const held)
+{
+	for (long i = 1L; i < length; i++) {
+		const double key = key_of(records + i * size);
+
+		if (key_of(records + (i - 1) * size) <= key)
+			continue;
+
+		long j = i - 1;
+		while (j > 0L && key_of(records + (j - 1) * size) > key)
+			j--;
+
+		memcpy(held, records + i * size, size);
+		memmove(records + (j + 1) * size, records + j * size,
+			(i - j) * size);
+		memcpy(records + j * size, held, size);
+	}
+}
+
+// ### Ordenação estável
+
+// Ordena de forma estável os `length` registos com `size` _bytes_ cada do
+// _array_ `records`, usando o _array_ auxiliar `temporary`, com espaço para
+// metade dos registos, e `held`, com espaço para um registo. Trata-se de uma
+// ordenação por fusão recursiva com duas optimizações: os segmentos pequenos
+// são ordenados por inserção e dois sub-segmentos que, ordenados, já estão pela
+// ordem certa não são fundidos. Esta última optimização torna a ordenação
+// linear para _arrays_ já ordenados.
+static void merge_sort_records(const long length, const size_t size,
+			       char *const records, char *const temporary,
+			       char *const held)
+{
+	if (length <= insertion_threshold) {
+		insertion_sort_records(length, size, records, held);
+		return;
+	}
+
+	const long middle = length / 2;
+	char *const right = records + middle * size;
+
+	merge_sort_records(middle, size, records, temporary, held);
+	merge_sort_records(length - middle, size, right, temporary, held);
+
+	if (key_of(right - size) <= key_of(right))
+		return;
+
+	// Copiamos o primeiro sub-segmento para o _array_ auxiliar e fundimos
+	// os registos aí guardados com os do segundo sub-segmento, escrevendo
+	// o resultado a partir do início do segmento. A escrita nunca ultrapassa
+	// a leitura do segundo sub-segmento. Em caso de empate, escolhe-se o
+	// registo do primeiro sub-segmento, o que garante a estabilidade.
+	memcpy(temporary, records, middle * size);
+
+	const char *left = temporary;
+	const char *const left_end = temporary + middle * size;
+	const char *next = right;
+	const char *const right_end = records + length * size;
+	char *output = records;
+
+	while (left != left_end && next != right_end) {
+		if (key_of(left) <= key_of(next)) {
+			memcpy(output, left, size);
+			left += size;
+		} else {
+			memcpy(output, next, size);
+			next += size;
+		}
+		output += size;
+	}
+
+	// Os registos que restem do segundo sub-segmento já estão na sua
+	// posição final. Os que restem do primeiro têm de ser copiados.
+	memcpy(output, left, left_end - left);
+}
+
+// ### Ordenação instável
+
+// Ordena os `length` registos com `size` _bytes_ cada do _array_ `records`,
+// usando `held` para guardar um registo durante a ordenação por inserção
+// final. Trata-se de uma ordenação rápida com mediana de três e partição de
+// Hoare, que pára em chaves iguais ao pivô e, por isso, lida bem com muitas
+// chaves repetidas. Para limitar a profundidade da pilha a O(log _n_), a
+// recursão é feita apenas sobre o menor dos dois segmentos, sendo o maior
+// ordenado na iteração seguinte do ciclo.
+static void quicksort_records(long length, const size_t size,
+			      char *records, char *const held)
+{
+	while (length > insertion_threshold) {
+		// Colocamos por ordem o primeiro registo, o registo do meio e o
+		// último registo. O do meio fornece o pivô e os outros dois
+		// servem de sentinelas aos ciclos de partição.
+		char *const first = records;
+		char *const middle = records + (length / 2) * size;
+		char *const last = records + (length - 1) * size;
+
+		if (key_of(middle) < key_of(first))
+			swap_records(first, middle, size);
+		if (key_of(last) < key_of(middle)) {
+			swap_records(middle, last, size);
+			if (key_of(middle) < key_of(first))
+				swap_records(first, middle, size);
+		}
+
+		const double pivot = key_of(middle);
+
+		long i = 0L;
+		long j = length - 1;
+		for (;;) {
+			do
+				i++;
+			while (key_of(records + i * size) < pivot);
+			do
+				j--;
+			while (key_of(records + j * size) > pivot);
+			if (i >= j)
+				break;
+			swap_records(records + i * size, records + j * size,
+				     size);
+		}
+
+		// Os registos antes de `i` têm chaves não superiores ao pivô e
+		// os restantes têm chaves não inferiores.
+		if (i < length - i) {
+			quicksort_records(i, size, records, held);
+			records += i * size;
+			length -= i;
+		} else {
+			quicksort_records(length - i, size, records + i * size,
+					  held);
+			length = i;
+		}
+	}
+
+	insertion_sort_records(length, size, records, held);
+}
+
+// Definição de rotinas
+// --------------------
+
+bool sort_records(const long length, const size_t record_size,
+		  void *const records, const bool stable)
+{
+	assert(length >= 0L);
+	assert(record_size >= sizeof(double));
+	assert(record_size % sizeof(double) == 0);
+	assert(length == 0L || records != NULL);
+
+	if (length <= 1L)
+		return false;
+
+	// O registo guardado durante a ordenação por inserção.
+	char held[record_size];
+
+	if (!stable) {
+		quicksort_records(length, record_size, records, held);
+		return false;
+	}
+
+	char *const temporary = malloc((length / 2) * record_size);
+	if (temporary == NULL)
+		return true;
+
+	merge_sort_records(length, record_size, records, temporary, held);
+
+	free(temporary);
+
+	return false;
+}
+
+// O _argsort_ ordena pares compostos pela chave e pelo índice de cada registo,
+// com 16 _bytes_, usando as mesmas rotinas de ordenação. Ao contrário de uma
+// ordenação de índices que compare as chaves indirectamente, através dos
+// registos, esta abordagem lê cada registo uma única vez e percorre
+// sequencialmente a memória durante a ordenação, independentemente da dimensão
+// da carga. Como os pares são construídos por ordem crescente de índice, a
+// ordenação estável dos pares deixa os índices de chaves iguais por ordem
+// crescente.
+bool argsort_records(const long length, const size_t record_size,
+		     const void *const records, long index[length],
+		     const bool stable)
+{
+	assert(length >= 0L);
+	assert(record_size >= sizeof(double));
+	assert(record_size % sizeof(double) == 0);
+	assert(length == 0L || records != NULL);
+	assert(length == 0L || index != NULL);
+
+	if (length == 0L)
+		return false;
+
+	struct keyed_index *const pairs =
+		malloc(length * sizeof(struct keyed_index));
+	if (pairs == NULL)
+		return true;
+
+	for (long i = 0L; i != length; i++) {
+		pairs[i].key = key_of((const char *)records + i * record_size);
+		pairs[i].index = i;
+	}
+
+	const bool error = sort_records(length, sizeof(struct keyed_index),
+					pairs, stable);
+
+	if (!error)
+		for (long i = 0L; i != length; i++)
+			index[i] = pairs[i].index;
+
+	free(pairs);
+
+	return error;
+}
@@ -0,0 +1,77 @@
+// `record_sorting.h` &ndash; Ordenação de registos com chave `double`
+// ================================================================
+//
+// Este é o ficheiro de cabeçalho ou de interface correspondente ao ficheiro de
+// implementação [`record_sorting.c`](record_sorting.c.html). Ambos correspondem
+// ao módulo físico `record_sorting`, cujo objectivo é ordenar _arrays_ de
+// registos, ou seja, de instâncias de estruturas, por uma chave `double`.
+//
+// As rotinas do módulo [`sorting_algorithms`](sorting_algorithms.h.html)
+// ordenam apenas _arrays_ de `double`. Na prática, porém, o que se ordena são
+// geralmente registos compostos por uma chave e por uma carga (_payload_)
+// arbitrária, que acompanha a chave. Tal como a rotina `qsort()` da biblioteca
+// padrão, as rotinas deste módulo lidam com registos de qualquer dimensão,
+// impondo apenas que cada registo comece pela sua chave, ou seja, que o
+// primeiro campo da estrutura seja um `double`. Por exemplo:
+//
+// ```C
+// struct row {
+//         double key;
+//         char payload[56];
+// };
+// ```
+//
+// São fornecidos dois modos de ordenação:
+//
+// - Estável &ndash; Os registos com chaves iguais mantêm a sua ordem relativa.
+//   Usa-se uma ordenação por fusão que não funde duas metades quando estas já
+//   estão pela ordem certa, e que requer memória auxiliar para metade dos
+//   registos.
+//
+// - Instável &ndash; Os registos com chaves iguais podem ficar por qualquer
+//   ordem. Usa-se uma ordenação rápida (_quicksort_) com mediana de três, que
+//   não requer memória auxiliar e é geralmente mais rápida.
+//
+// Quando a carga é grande, mover os registos durante a ordenação é caro. Nesse
+// caso, pode ordenar-se apenas um _array_ de índices, ou seja, obter a
+// permutação que ordena os registos (_argsort_), sem mover os registos.
+//
+// As chaves são comparadas com o operador `<=`, pelo que os registos não podem
+// ter chaves NaN.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// A usual protecção contra os efeitos nefastos da inclusão múltipla.
+#ifndef ISLA_EDA_RECORD_SORTING_H_INCLUDED
+#define ISLA_EDA_RECORD_SORTING_H_INCLUDED
+
+// Incluímos os ficheiros de interface `stdbool.h`, para podermos usar o tipo
+// `bool` e os seus dois valores `true` e `false`, e `stddef.h`, para podermos
+// usar o tipo `size_t`.
+#include <stdbool.h>
+#include <stddef.h>
+
+// Rotina que ordena por ordem não decrescente da sua chave os `length` registos
+// com `record_size` _bytes_ cada do _array_ `records`. A chave é o `double`
+// com que começa cada registo. Se `stable` for `true`, a ordenação é estável.
+// Devolve `true` em caso de erro (i.e., se não houver memória para a ordenação
+// estável). O valor de `length` não pode ser negativo. O valor de `record_size`
+// tem de ser um múltiplo de `sizeof(double)` e o _array_ `records` tem de
+// estar alinhado como um `double`. O valor de `records` pode ser `NULL`, mas
+// apenas se `length` for zero.
+bool sort_records(long length, size_t record_size, void *records, bool stable);
+
+// Rotina que coloca em `index` os índices dos `length` registos com
+// `record_size` _bytes_ cada do _array_ `records` pela ordem não decrescente das
+// suas chaves, sem alterar o _array_ `records`. Ou seja, `records[index[0]]`
+// passa a ser o registo com menor chave. Se `stable` for `true`, os índices de
+// registos com chaves iguais ficam por ordem crescente. Devolve `true` em caso
+// de erro. As restrições sobre os argumentos são as mesmas de
+// `sort_records()`. O valor de `index` pode ser `NULL`, mas apenas se `length`
+// for zero.
+bool argsort_records(long length, size_t record_size, const void *records,
+		     long index[length], bool stable);
+
+// Fecho da protecção contra os efeitos perversos da inclusão múltipla.
+#endif // ISLA_EDA_RECORD_SORTING_H_INCLUDED
@@ -0,0 +1,753 @@
+// `results_file.c` &ndash; Ficheiros de resultados em formato longo
+// ================================================================
+//
+// Este é o ficheiro de implementação correspondente ao ficheiro de cabeçalho
+// ou de interface [`results_file.h`](results_file.h.html). Ambos correspondem
+// ao módulo físico `results_file`, cujo objectivo é escrever e ler os
+// resultados das experiências em formato longo.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// Começamos por incluir o próprio ficheiro de interface. Isso ajuda-nos a
+// garantir a coerência entre os dois ficheiros, pois desta forma o compilador
+// poderá gerar erros quando detectar incoerências.
+#include "results_file.h"
+
+// Inclusão de ficheiros de interface
+// -----------------------------------
+//
+// Incluímos os vários ficheiro de interface necessários:
+//
+// - `stdlib.h` &ndash; Para podermos usar o valor especial `NULL` dos ponteiros
+//   e as rotinas `malloc()`, `realloc()`, `free()` e `strtod()`.
+//
+// - `stdio.h` &ndash; Para podermos usar as rotinas `fopen()`, `fclose()`,
+//   `fread()`, `fwrite()`, `snprintf()` e `getline()`.
+//
+// - `string.h` &ndash; Para podermos usar as rotinas `strcmp()`, `strlen()`,
+//   `memcmp()` e `memcpy()`.
+//
+// - `stdint.h` &ndash; Para podermos usar os tipos inteiros de dimensão fixa
+//   usados no formato colunar binário.
+//
+// - `math.h` &ndash; Para podermos usar a macro `isfinite()`.
+//
+// - `assert.h` &ndash; Para podermos usar a macro `assert()`.
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <assert.h>
+
+// Métricas
+// --------
+
+const char *const result_metric_names[number_of_result_metrics] = {
+	"comparisons",
+	"swaps",
+	"copies",
+	"accumulated_runs",
+	"repetitions",
+	"time_average",
+	"time_stddev",
+	"time_median",
+	"time_minimum",
+	"time_maximum",
+	"cold_time_average",
+	"cold_time_stddev",
+	"cold_time_median",
+	"cold_time_minimum",
+	"cold_time_maximum"
+};
+
+const char *const result_metric_headers[number_of_result_metrics] = {
+	"Comparisons",
+	"Swaps",
+	"Copies",
+	"Accumulated runs",
+	"Repetitions",
+	"Time Average [seconds]",
+	"Time Stddev [seconds]",
+	"Time Median [seconds]",
+	"Time Minimum [seconds]",
+	"Time Maximum [seconds]",
+	"Cold Time Average [seconds]",
+	"Cold Time Stddev [seconds]",
+	"Cold Time Median [seconds]",
+	"Cold Time Minimum [seconds]",
+	"Cold Time Maximum [seconds]"
+};
+
+const bool result_metric_is_count[number_of_result_metrics] = {
+	true, true, true, true, true, false, false, false, false, false,
+	false, false, false, false, false
+};
+
+enum result_metric result_metric_named(const char *const name)
+{
+	assert(name != NULL);
+
+	int m = 0;
+	while (m != number_of_result_metrics &&
+	       strcmp(name, result_metric_names[m]) != 0)
+		m++;
+
+	return m;
+}
+
+// Definição de constantes
+// -----------------------
+
+// A assinatura com que começam os ficheiros no formato colunar binário. Os
+// ficheiros que não começam com esta assinatura são lidos como JSON Lines.
+static const char columnar_signature[8] = { 'E', 'D', 'A', 'R', 'S', 'L', 'T',
+					    '1' };
+
+// Valor escrito logo após a assinatura, permitindo verificar, durante a
+// leitura, se a ordem dos _bytes_ é a da máquina que escreveu o ficheiro.
+static const uint32_t byte_order_mark = 0x01020304U;
+
+// Dimensão, em _bytes_, do _buffer_ usado na escrita no formato JSON Lines.
+#define json_buffer_size (64 * 1024)
+
+// Número máximo de cadeias de caracteres distintas num ficheiro no formato
+// colunar binário. Os identificadores das cadeias são guardados em 16 _bits_.
+static const int maximum_number_of_strings = UINT16_MAX;
+
+// Definição das estruturas
+// ------------------------
+
+// Um dicionário de cadeias de caracteres, usado no formato colunar binário.
+// Cada cadeia é identificada pela sua posição no dicionário.
+struct string_dictionary {
+	char **strings;
+	int length;
+	int capacity;
+};
+
+// As colunas de um bloco de registos do formato colunar binário. Os campos de
+// texto são guardados como identificadores do dicionário.
+struct result_columns {
+	int length;
+	uint16_t file_types[results_block_length];
+	int64_t sizes[results_block_length];
+	uint16_t algorithms[results_block_length];
+	uint16_t metrics[results_block_length];
+	double values[results_block_length];
+};
+
+struct results_writer {
+	// O canal de escrita, o formato e a indicação de erro.
+	FILE *file;
+	enum results_format format;
+	bool failed;
+	// O _buffer_ usado no formato JSON Lines e o número de _bytes_ que
+	// contém.
+	char buffer[json_buffer_size];
+	size_t buffered;
+	// O dicionário e o bloco corrente do formato colunar binário. As
+	// cadeias do dicionário com posição igual ou superior a
+	// `written_strings` ainda não foram escritas no ficheiro.
+	struct string_dictionary dictionary;
+	int written_strings;
+	struct result_columns block;
+};
+
+struct results_reader {
+	// O canal de leitura, o formato e a indicação de erro.
+	FILE *file;
+	enum results_format format;
+	bool failed;
+	// A linha corrente do formato JSON Lines. As cadeias do registo lido
+	// são descodificadas na própria linha.
+	char *line;
+	size_t line_capacity;
+	// O dicionário, o bloco corrente e a posição do próximo registo no
+	// bloco, no formato colunar binário.
+	struct string_dictionary dictionary;
+	struct result_columns block;
+	int next;
+};
+
+// Rotinas auxiliares do dicionário
+// --------------------------------
+
+// Acrescenta ao dicionário `dictionary` uma cópia da cadeia `string`, com
+// `length` caracteres, devolvendo a sua posição. Devolve -1 em caso de erro.
+static int add_to_dictionary(struct string_dictionary *const dictionary,
+			     const char *const string, const size_t length)
+{
+	if (dictionary->length == maximum_number_of_strings)
+		return -1;
+
+	if (dictionary->length == dictionary->capacity) {
+		const int capacity =
+			dictionary->capacity == 0 ? 16 : 2 * dictionary->capacity;
+		char **const strings = realloc(dictionary->strings,
+					       capacity * sizeof(char *));
+		if (strings == NULL)
+			return -1;
+		dictionary->strings = strings;
+		dictionary->capacity = capacity;
+	}
+
+	char *const copy = malloc(length + 1);
+	if (copy == NULL)
+		return -1;
+	memcpy(copy, string, length);
+	copy[length] = '\0';
+
+	dictionary->strings[dictionary->length] = copy;
+
+	return dictionary->length++;
+}
+
+// Devolve a posição da cadeia `string` no dicionário `dictionary`,
+// acrescentando-a se necessário. Devolve -1 em caso de erro. Os dicionários
+// têm poucas cadeias (tipos de ficheiro, algoritmos e métricas), pelo que uma
+// pesquisa linear é suficiente.
+static int string_id(struct string_dictionary *const dictionary,
+		     const char *const string)
+{
+	for (int i = 0; i != dictionary->length; i++)
+		if (strcmp(dictionary->strings[i], string) == 0)
+			return i;
+
+	return add_to_dictionary(dictionary, string, strlen(string));
+}
+
+// Liberta toda a memória do dicionário `dictionary`.
+static void free_dictionary(struct string_dictionary *const dictionary)
+{
+	for (int i = 0; i != dictionary->length; i++)
+		free(dictionary->strings[i]);
+	free(dictionary->strings);
+}
+
+// Rotinas auxiliares de escrita
+// -----------------------------
+
+// Escreve no ficheiro os `length` _bytes_ com início em `bytes`, registando
+// qualquer erro no escritor `writer`.
+static void write_bytes(struct results_writer *const writer,
+			const void *const bytes, const size_t length)
+{
+	if (!writer->failed && fwrite(bytes, 1, length, writer->file) != length)
+		writer->failed = true;
+}
+
+// Escreve no ficheiro o conteúdo do _buffer_ do escritor `writer`.
+static void flush_buffer(struct results_writer *const writer)
+{
+	write_bytes(writer, writer->buffer, writer->buffered);
+	writer->buffered = 0;
+}
+
+// Acrescenta ao _buffer_ do escritor `writer` os `length` caracteres com
+// início em `text`, escrevendo o _buffer_ no ficheiro sempre que fica cheio.
+static void put_text(struct results_writer *const writer,
+		     const char *const text, const size_t length)
+{
+	for (size_t i = 0; i != length; i++) {
+		if (writer->buffered == json_buffer_size)
+			flush_buffer(writer);
+		writer->buffer[writer->buffered++] = text[i];
+	}
+}
+
+// Acrescenta ao _buffer_ do escritor `writer` a cadeia de caracteres `text`.
+static void put_string(struct results_writer *const writer,
+		       const char *const text)
+{
+	put_text(writer, text, strlen(text));
+}
+
+// Acrescenta ao _buffer_ do escritor `writer` a cadeia `string`, como cadeia
+// de caracteres JSON, ou seja, entre aspas e com os caracteres especiais
+// devidamente escapados.
+static void put_json_string(struct results_writer *const writer,
+			    const char *const string)
+{
+	put_string(writer, "\"");
+	for (const char *c = string; *c != '\0'; c++)
+		if (*c == '"' || *c == '\\') {
+			const char escaped[2] = { '\\', *c };
+			put_text(writer, escaped, 2);
+		} else if ((unsigned char)*c < 0x20) {
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x",
+				 (unsigned char)*c);
+			put_string(writer, escaped);
+		} else
+			put_text(writer, c, 1);
+	put_string(writer, "\"");
+}
+
+// Acrescenta o registo `record` ao _buffer_ do escritor `writer`, no formato
+// JSON Lines.
+static void put_json_record(struct results_writer *const writer,
+			    const struct result_record record)
+{
+	char number[32];
+
+	put_string(writer, "{\"file_type\":");
+	put_json_string(writer, record.file_type);
+
+	snprintf(number, sizeof(number), "%ld", record.size);
+	put_string(writer, ",\"size\":");
+	put_string(writer, number);
+
+	put_string(writer, ",\"algorithm\":");
+	put_json_string(writer, record.algorithm);
+
+	put_string(writer, ",\"metric\":");
+	put_json_string(writer, record.metric);
+
+	// O formato `%.17g` garante que o valor lido é exactamente igual ao
+	// escrito, e escreve as contagens como inteiros. Os valores não finitos,
+	// que o JSON não suporta como números, são escritos como cadeias de
+	// caracteres (`"inf"`, `"-inf"`, `"nan"` ou `"-nan"`), que
+	// `read_json_record()` converte de volta nos valores originais.
+	put_string(writer, ",\"value\":");
+	if (isfinite(record.value))
+		snprintf(number, sizeof(number), "%.17g", record.value);
+	else
+		snprintf(number, sizeof(number), "\"%g\"", record.value);
+	put_string(writer, number);
+	put_string(writer, "}\n");
+}
+
+// Escreve no ficheiro o bloco corrente do escritor `writer`, precedido pelas
+// cadeias do dicionário ainda não escritas.
+static void write_block(struct results_writer *const writer)
+{
+	struct result_columns *const block = &writer->block;
+
+	const uint32_t new_strings =
+		writer->dictionary.length - writer->written_strings;
+	write_bytes(writer, &new_strings, sizeof(new_strings));
+	for (int i = writer->written_strings;
+	     i != writer->dictionary.length; i++) {
+		const char *const string = writer->dictionary.strings[i];
+		const uint16_t length = strlen(string);
+		write_bytes(writer, &length, sizeof(length));
+		write_bytes(writer, string, length);
+	}
+	writer->written_strings = writer->dictionary.length;
+
+	const uint32_t length = block->length;
+	write_bytes(writer, &length, sizeof(length));
+	write_bytes(writer, block->file_types, length * sizeof(uint16_t));
+	write_bytes(writer, block->sizes, length * sizeof(int64_t));
+	write_bytes(writer, block->algorithms, length * sizeof(uint16_t));
+	write_bytes(writer, block->metrics, length * sizeof(uint16_t));
+	write_bytes(writer, block->values, length * sizeof(double));
+
+	block->length = 0;
+}
+
+// Acrescenta o registo `record` ao bloco corrente do escritor `writer`,
+// escrevendo o bloco no ficheiro quando fica cheio.
+static void put_columnar_record(struct results_writer *const writer,
+				const struct result_record record)
+{
+	struct result_columns *const block = &writer->block;
+
+	const int file_type = string_id(&writer->dictionary, record.file_type);
+	const int algorithm = string_id(&writer->dictionary, record.algorithm);
+	const int metric = string_id(&writer->dictionary, record.metric);
+
+	if (file_type < 0 || algorithm < 0 || metric < 0) {
+		writer->failed = true;
+		return;
+	}
+
+	block->file_types[block->length] = file_type;
+	block->sizes[block->length] = record.size;
+	block->algorithms[block->length] = algorithm;
+	block->metrics[block->length] = metric;
+	block->values[block->length] = record.value;
+	block->length++;
+
+	if (block->length == results_block_length)
+		write_block(writer);
+}
+
+// Rotinas de escrita
+// ------------------
+
+struct results_writer *new_results_writer(const char *const file_name,
+					  const enum results_format format)
+{
+	assert(file_name != NULL);
+
+	struct results_writer *const writer =
+		malloc(sizeof(struct results_writer));
+	if (writer == NULL)
+		return NULL;
+
+	writer->file = fopen(file_name, "wb");
+	if (writer->file == NULL) {
+		free(writer);
+		return NULL;
+	}
+
+	writer->format = format;
+	writer->failed = false;
+	writer->buffered = 0;
+	writer->dictionary.strings = NULL;
+	writer->dictionary.length = 0;
+	writer->dictionary.capacity = 0;
+	writer->written_strings = 0;
+	writer->block.length = 0;
+
+	if (format == columnar_format) {
+		write_bytes(writer, columnar_signature,
+			    sizeof(columnar_signature));
+		write_bytes(writer, &byte_order_mark, sizeof(byte_order_mark));
+	}
+
+	return writer;
+}
+
+bool write_result(struct results_writer *const writer,
+		  const struct result_record record)
+{
+	assert(writer != NULL);
+	assert(record.file_type != NULL);
+	assert(record.algorithm != NULL);
+	assert(record.metric != NULL);
+
+	if (writer->format == json_lines_format)
+		put_json_record(writer, record);
+	else
+		put_columnar_record(writer, record);
+
+	return writer->failed;
+}
+
+bool free_results_writer(struct results_writer *const writer)
+{
+	if (writer == NULL)
+		return false;
+
+	if (writer->format == json_lines_format)
+		flush_buffer(writer);
+	else if (writer->block.length != 0)
+		write_block(writer);
+
+	bool error = writer->failed;
+
+	if (fclose(writer->file) != 0)
+		error = true;
+
+	free_dictionary(&writer->dictionary);
+	free(writer);
+
+	return error;
+}
+
+// Rotinas auxiliares de leitura
+// -----------------------------
+
+// Lê do ficheiro `length` _bytes_ para `bytes`, registando qualquer erro no
+// leitor `reader`. Devolve `true` em caso de erro.
+static bool read_bytes(struct results_reader *const reader, void *const bytes,
+		       const size_t length)
+{
+	if (!reader->failed && fread(bytes, 1, length, reader->file) != length)
+		reader->failed = true;
+
+	return reader->failed;
+}
+
+// Avança o cursor `cursor` para lá dos espaços em branco e, em seguida, para lá
+// do texto `text`. Devolve `true` se o texto não estiver presente.
+static bool skip(char **const cursor, const char *const text)
+{
+	while (**cursor == ' ' || **cursor == '\t')
+		(*cursor)++;
+
+	const size_t length = strlen(text);
+	if (strncmp(*cursor, text, length) != 0)
+		return true;
+
+	*cursor += length;
+	return false;
+}
+
+// Descodifica, no próprio local, a cadeia de caracteres JSON com início no
+// cursor `cursor`, avançando o cursor para lá dela. Devolve o início da cadeia
+// descodificada, ou `NULL` em caso de erro. Só são suportados os escapes
+// `\uXXXX` correspondentes a caracteres ASCII, que são os únicos escritos por
+// `put_json_string()`.
+static char *parse_json_string(char **const cursor)
+{
+	if (skip(cursor, "\""))
+		return NULL;
+
+	char *const string = *cursor;
+	char *source = *cursor;
+	char *target = *cursor;
+
+	while (*source != '"') {
+		if (*source == '\0')
+			return NULL;
+		if (*source != '\\') {
+			*target++ = *source++;
+			continue;
+		}
+		source++;
+		switch (*source) {
+		case '"':
+		case '\\':
+		case '/':
+			*target++ = *source++;
+			break;
+		case 'n':
+			*target++ = '\n', source++;
+			break;
+		case 't':
+			*target++ = '\t', source++;
+			break;
+		case 'r':
+			*target++ = '\r', source++;
+			break;
+		case 'u': {
+			unsigned code;
+			if (sscanf(source + 1, "%4x", &code) != 1 || code > 0x7F)
+				return NULL;
+			*target++ = code;
+			source += 5;
+			break;
+		}
+		default:
+			return NULL;
+		}
+	}
+
+	*target = '\0';
+	*cursor = source + 1;
+
+	return string;
+}
+
+// Lê o próximo registo no formato JSON Lines. Os campos têm de surgir pela
+// ordem pela qual `put_json_record()` os escreve. As linhas em branco são
+// ignoradas. Os valores escritos como cadeias de caracteres são convertidos
+// através de `strtod()`, que reconhece `inf`, `-inf`, `nan` e `-nan`.
+static bool read_json_record(struct results_reader *const reader,
+			     struct result_record *const record)
+{
+	ssize_t length;
+	do
+		length = getline(&reader->line, &reader->line_capacity,
+				 reader->file);
+	while (length == 1 && reader->line[0] == '\n');
+
+	if (length < 0) {
+		if (ferror(reader->file))
+			reader->failed = true;
+		return false;
+	}
+
+	char *cursor = reader->line;
+	char *end;
+
+	if (skip(&cursor, "{\"file_type\":") ||
+	    (record->file_type = parse_json_string(&cursor)) == NULL ||
+	    skip(&cursor, ",\"size\":"))
+		goto malformed;
+
+	record->size = strtol(cursor, &end, 10);
+	if (end == cursor)
+		goto malformed;
+	cursor = end;
+
+	if (skip(&cursor, ",\"algorithm\":") ||
+	    (record->algorithm = parse_json_string(&cursor)) == NULL ||
+	    skip(&cursor, ",\"metric\":") ||
+	    (record->metric = parse_json_string(&cursor)) == NULL ||
+	    skip(&cursor, ",\"value\":"))
+		goto malformed;
+
+	char *text;
+
+	if (*cursor == '"') {
+		if ((text = parse_json_string(&cursor)) == NULL)
+			goto malformed;
+		record->value = strtod(text, &end);
+		if (end == text || *end != '\0' || isfinite(record->value))
+			goto malformed;
+	} else {
+		record->value = strtod(cursor, &end);
+		if (end == cursor)
+			goto malformed;
+		cursor = end;
+	}
+
+	if (skip(&cursor, "}"))
+		goto malformed;
+
+	return true;
+
+malformed:
+	reader->failed = true;
+	return false;
+}
+
+// Lê o próximo bloco no formato colunar binário. Devolve `false` se tiver
+// chegado ao fim do ficheiro ou se tiver ocorrido um erro.
+static bool read_block(struct results_reader *const reader)
+{
+	struct result_columns *const block = &reader->block;
+
+	uint32_t new_strings;
+	if (fread(&new_strings, sizeof(new_strings), 1, reader->file) != 1) {
+		if (ferror(reader->file))
+			reader->failed = true;
+		return false;
+	}
+
+	char string[UINT16_MAX];
+	for (uint32_t i = 0; i != new_strings; i++) {
+		uint16_t length;
+		if (read_bytes(reader, &length, sizeof(length)) ||
+		    read_bytes(reader, string, length))
+			return false;
+		if (add_to_dictionary(&reader->dictionary, string, length) < 0) {
+			reader->failed = true;
+			return false;
+		}
+	}
+
+	uint32_t length;
+	if (read_bytes(reader, &length, sizeof(length)))
+		return false;
+	if (length > results_block_length) {
+		reader->failed = true;
+		return false;
+	}
+
+	if (read_bytes(reader, block->file_types, length * sizeof(uint16_t)) ||
+	    read_bytes(reader, block->sizes, length * sizeof(int64_t)) ||
+	    read_bytes(reader, block->algorithms, length * sizeof(uint16_t)) ||
+	    read_bytes(reader, block->metrics, length * sizeof(uint16_t)) ||
+	    read_bytes(reader, block->values, length * sizeof(double)))
+		return false;
+
+	block->length = length;
+	reader->next = 0;
+
+	return true;
+}
+
+// Lê o próximo registo no formato colunar binário.
+static bool read_columnar_record(struct results_reader *const reader,
+				 struct result_record *const record)
+{
+	struct result_columns *const block = &reader->block;
+
+	while (reader->next == block->length)
+		if (!read_block(reader))
+			return false;
+
+	const int i = reader->next++;
+	const int strings = reader->dictionary.length;
+
+	if (block->file_types[i] >= strings ||
+	    block->algorithms[i] >= strings || block->metrics[i] >= strings) {
+		reader->failed = true;
+		return false;
+	}
+
+	record->file_type = reader->dictionary.strings[block->file_types[i]];
+	record->size = block->sizes[i];
+	record->algorithm = reader->dictionary.strings[block->algorithms[i]];
+	record->metric = reader->dictionary.strings[block->metrics[i]];
+	record->value = block->values[i];
+
+	return true;
+}
+
+// Rotinas de leitura
+// ------------------
+
+struct results_reader *new_results_reader(const char *const file_name)
+{
+	assert(file_name != NULL);
+
+	struct results_reader *const reader =
+		malloc(sizeof(struct results_reader));
+	if (reader == NULL)
+		return NULL;
+
+	reader->file = fopen(file_name, "rb");
+	if (reader->file == NULL) {
+		free(reader);
+		return NULL;
+	}
+
+	reader->failed = false;
+	reader->line = NULL;
+	reader->line_capacity = 0;
+	reader->dictionary.strings = NULL;
+	reader->dictionary.length = 0;
+	reader->dictionary.capacity = 0;
+	reader->block.length = 0;
+	reader->next = 0;
+
+	// Detectamos o formato através da assinatura. Se não estiver presente,
+	// voltamos ao início do ficheiro e lemo-lo como JSON Lines.
+	char signature[sizeof(columnar_signature)];
+	uint32_t mark;
+	if (fread(signature, sizeof(signature), 1, reader->file) == 1 &&
+	    memcmp(signature, columnar_signature, sizeof(signature)) == 0) {
+		reader->format = columnar_format;
+		if (fread(&mark, sizeof(mark), 1, reader->file) != 1 ||
+		    mark != byte_order_mark) {
+			free_results_reader(reader);
+			return NULL;
+		}
+	} else {
+		reader->format = json_lines_format;
+		rewind(reader->file);
+	}
+
+	return reader;
+}
+
+bool read_result(struct results_reader *const reader,
+		 struct result_record *const record)
+{
+	assert(reader != NULL);
+	assert(record != NULL);
+
+	if (reader->failed)
+		return false;
+
+	if (reader->format == json_lines_format)
+		return read_json_record(reader, record);
+	else
+		return read_columnar_record(reader, record);
+}
+
+bool results_reader_failed(const struct results_reader *const reader)
+{
+	assert(reader != NULL);
+
+	return reader->failed;
+}
+
+void free_results_reader(struct results_reader *const reader)
+{
+	if (reader == NULL)
+		return;
+
+	fclose(reader->file);
+	free(reader->line);
+	free_dictionary(&reader->dictionary);
+	free(reader);
+}
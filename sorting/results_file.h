@@ -0,0 +1,163 @@
+// `results_file.h` &ndash; Ficheiros de resultados em formato longo
+// ================================================================
+//
+// Este é o ficheiro de cabeçalho ou de interface correspondente ao ficheiro de
+// implementação [`results_file.c`](results_file.c.html). Ambos correspondem ao
+// módulo físico `results_file`, cujo objectivo é escrever e ler os resultados
+// das experiências em formato longo, ou seja, com um registo por cada
+// combinação de tipo de ficheiro, dimensão, algoritmo e métrica.
+//
+// O ficheiro CSV escrito pelo programa de experiências tem uma única linha
+// (muito larga) por dimensão, com uma coluna por cada par de algoritmo e
+// métrica. Acrescentar um algoritmo altera a posição de todas as colunas
+// seguintes, e ler esses ficheiros em grandes quantidades é lento. Os formatos
+// longos não têm esse problema. São suportados dois formatos:
+//
+// - JSON Lines &ndash; Um objecto JSON por linha, com os campos `file_type`,
+//   `size`, `algorithm`, `metric` e `value`, por esta ordem. Os valores não
+//   finitos (NaN e infinitos), que o JSON não suporta como números, são
+//   escritos como cadeias de caracteres (`"inf"`, `"-inf"`, `"nan"` ou
+//   `"-nan"`), pelo que são recuperados sem perdas.
+//
+// - Colunar binário &ndash; Os registos são agrupados em blocos de até
+//   `results_block_length` registos, guardando-se cada campo de todos os
+//   registos de um bloco de forma contígua (i.e., em colunas). As cadeias de
+//   caracteres são guardadas uma única vez num dicionário, sendo os registos
+//   compostos apenas por números. O formato usa a ordem dos _bytes_ da máquina
+//   que o escreve, o que é verificado durante a leitura.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// A usual protecção contra os efeitos nefastos da inclusão múltipla.
+#ifndef ISLA_EDA_RESULTS_FILE_H_INCLUDED
+#define ISLA_EDA_RESULTS_FILE_H_INCLUDED
+
+// Incluímos o ficheiro de interface `stdbool.h` para podermos usar o tipo
+// `bool` e os seus dois valores `true` e `false`.
+#include <stdbool.h>
+
+// Métricas
+// --------
+
+// As métricas registadas para cada algoritmo, pela ordem pela qual surgem nas
+// colunas do ficheiro CSV. As métricas de tempo com _caches_ frias (começadas
+// por `cold_`) só são registadas quando o programa de experiências é executado
+// nesse modo. O último valor, `number_of_result_metrics`, não é uma métrica,
+// indicando apenas quantas métricas existem.
+enum result_metric {
+	comparisons_metric,
+	swaps_metric,
+	copies_metric,
+	accumulated_runs_metric,
+	repetitions_metric,
+	time_average_metric,
+	time_stddev_metric,
+	time_median_metric,
+	time_minimum_metric,
+	time_maximum_metric,
+	cold_time_average_metric,
+	cold_time_stddev_metric,
+	cold_time_median_metric,
+	cold_time_minimum_metric,
+	cold_time_maximum_metric,
+	number_of_result_metrics
+};
+
+// Os nomes das métricas usados nos ficheiros em formato longo (e.g.,
+// `"time_median"`).
+extern const char *const result_metric_names[number_of_result_metrics];
+
+// Os cabeçalhos das métricas usados no ficheiro CSV (e.g., `"Time Median
+// [seconds]"`), aos quais se acrescenta o nome do algoritmo entre parênteses.
+extern const char *const result_metric_headers[number_of_result_metrics];
+
+// Indica, para cada métrica, se se trata de uma contagem (escrita no ficheiro
+// CSV como um inteiro) ou não (escrita como um valor de vírgula flutuante).
+extern const bool result_metric_is_count[number_of_result_metrics];
+
+// Função que devolve a métrica com o nome `name` ou `number_of_result_metrics`
+// se não existir nenhuma métrica com esse nome. O valor de `name` não pode ser
+// `NULL`.
+enum result_metric result_metric_named(const char *name);
+
+// Registos
+// --------
+
+// Os formatos de ficheiro suportados. O último valor,
+// `number_of_results_formats`, não é um formato, indicando apenas quantos
+// formatos existem.
+enum results_format {
+	json_lines_format,
+	columnar_format,
+	number_of_results_formats
+};
+
+// O número máximo de registos em cada bloco do formato colunar binário.
+#define results_block_length 4096
+
+// Um registo de resultados. As cadeias de caracteres de um registo lido
+// através de `read_result()` pertencem ao leitor e só são válidas até à
+// próxima leitura.
+struct result_record {
+	const char *file_type;
+	long size;
+	const char *algorithm;
+	const char *metric;
+	double value;
+};
+
+// Escrita
+// -------
+
+// Declaração da estrutura que representa um escritor de resultados, cuja
+// definição se encontra no ficheiro de implementação.
+struct results_writer;
+
+// Rotina que cria um novo escritor de resultados no formato `format`, criando
+// (ou truncando) o ficheiro com o nome `file_name`. Devolve `NULL` em caso de
+// erro. O valor de `file_name` não pode ser `NULL`.
+struct results_writer *new_results_writer(const char *file_name,
+					  enum results_format format);
+
+// Rotina que acrescenta o registo `record` aos resultados escritos por
+// `writer`. A escrita é feita através de um _buffer_ próprio, pelo que o
+// registo pode só chegar ao ficheiro mais tarde. Devolve `true` em caso de
+// erro. Os valores de `writer` e das cadeias de caracteres do registo não podem
+// ser `NULL`.
+bool write_result(struct results_writer *writer, struct result_record record);
+
+// Rotina que escreve no ficheiro todos os registos pendentes de `writer`,
+// fecha o ficheiro e liberta o escritor. Devolve `true` em caso de erro. O
+// valor de `writer` pode ser `NULL`, não tendo nesse caso qualquer efeito.
+bool free_results_writer(struct results_writer *writer);
+
+// Leitura
+// -------
+
+// Declaração da estrutura que representa um leitor de resultados, cuja
+// definição se encontra no ficheiro de implementação.
+struct results_reader;
+
+// Rotina que cria um novo leitor para o ficheiro de resultados com o nome
+// `file_name`, cujo formato é detectado automaticamente. Devolve `NULL` em caso
+// de erro. O valor de `file_name` não pode ser `NULL`.
+struct results_reader *new_results_reader(const char *file_name);
+
+// Rotina que lê o próximo registo de `reader` para o registo apontado por
+// `record`. Devolve `true` se tiver lido um registo e `false` se tiver chegado
+// ao fim do ficheiro ou se tiver ocorrido um erro, situações que se distinguem
+// através de `results_reader_failed()`. Os valores de `reader` e de `record`
+// não podem ser `NULL`.
+bool read_result(struct results_reader *reader, struct result_record *record);
+
+// Predicado que devolve `true` se tiver ocorrido algum erro durante a leitura
+// de `reader`. O valor de `reader` não pode ser `NULL`.
+bool results_reader_failed(const struct results_reader *reader);
+
+// Procedimento que fecha o ficheiro e liberta o leitor `reader`. O valor de
+// `reader` pode ser `NULL`, não tendo nesse caso qualquer efeito.
+void free_results_reader(struct results_reader *reader);
+
+// Fecho da protecção contra os efeitos perversos da inclusão múltipla.
+#endif // ISLA_EDA_RESULTS_FILE_H_INCLUDED
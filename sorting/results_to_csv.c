@@ -0,0 +1,243 @@
+// `results_to_csv.c` &ndash; Conversão de resultados em formato longo para CSV
+// ===========================================================================
+//
+// Este é o módulo principal de um pequeno programa que lê um ficheiro de
+// resultados em formato longo (JSON Lines ou colunar binário, ver
+// [`results_file.h`](results_file.h.html)) e reconstrói o ficheiro CSV largo
+// escrito pelo programa de experiências, com uma linha por dimensão e uma
+// coluna por cada par de algoritmo e métrica. Isso permite continuar a usar
+// ferramentas como `print_sort_results.m` com resultados guardados apenas em
+// formato longo.
+//
+// O programa recebe o nome do ficheiro de resultados, o tipo de ficheiro cujos
+// resultados se pretendem (`sorted`, `partially_sorted`, `shuffled` ou
+// `with_nans`) e o nome do ficheiro CSV a escrever, por esta ordem. Os registos têm de estar
+// agrupados por dimensão, tal como são escritos pelo programa de experiências.
+// Os algoritmos surgem pela ordem pela qual aparecem na primeira dimensão e
+// apenas são escritas as métricas que nela surgem (as métricas de tempo com as
+// _caches_ frias, por exemplo, só existem se tiverem sido medidas).
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// Inclusão de ficheiros de interface
+// -----------------------------------
+//
+// - `stdlib.h` &ndash; Para podermos usar as rotinas `malloc()`, `realloc()` e
+//   `free()` e as constantes `EXIT_SUCCESS` e `EXIT_FAILURE`.
+//
+// - `stdio.h` &ndash; Para podermos usar as rotinas `fopen()`, `fclose()`,
+//   `fprintf()` e `fputc()`.
+//
+// - `string.h` &ndash; Para podermos usar as funções `strcmp()` e `strdup()`.
+//
+// - `math.h` &ndash; Para podermos usar a macro `NAN`.
+//
+// - `results_file.h` &ndash; Para podermos ler os ficheiros de resultados em
+//   formato longo.
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "results_file.h"
+
+// Estrutura com a linha do ficheiro CSV em construção
+// ---------------------------------------------------
+
+// Esta estrutura guarda os nomes dos algoritmos conhecidos e os valores de
+// cada métrica de cada algoritmo para a dimensão corrente.
+struct csv_row {
+	// A dimensão a que a linha diz respeito, ou -1 antes do primeiro
+	// registo.
+	long size;
+	// Os nomes dos algoritmos, pela ordem das colunas.
+	char **algorithms;
+	int number_of_algorithms;
+	// Os valores, com `number_of_result_metrics` métricas por algoritmo.
+	double *values;
+	// Indica, para cada métrica, se esta surgiu nos registos da primeira
+	// dimensão, caso em que tem colunas no ficheiro CSV.
+	bool seen[number_of_result_metrics];
+	// Indica se a linha de cabeçalhos já foi escrita. A partir desse
+	// momento, não podem surgir novos algoritmos.
+	bool headers_written;
+};
+
+// Definição de rotinas
+// --------------------
+
+// Devolve a posição do algoritmo `algorithm` na linha `row`, acrescentando-o
+// caso ainda não exista e os cabeçalhos não tenham sido escritos. Devolve -1
+// em caso de erro.
+static int algorithm_column(struct csv_row *const row,
+			    const char *const algorithm)
+{
+	for (int a = 0; a != row->number_of_algorithms; a++)
+		if (strcmp(row->algorithms[a], algorithm) == 0)
+			return a;
+
+	if (row->headers_written)
+		return -1;
+
+	const int count = row->number_of_algorithms + 1;
+
+	char **const algorithms =
+		realloc(row->algorithms, count * sizeof(char *));
+	if (algorithms == NULL)
+		return -1;
+	row->algorithms = algorithms;
+
+	double *const values = realloc(row->values, count *
+				       number_of_result_metrics * sizeof(double));
+	if (values == NULL)
+		return -1;
+	row->values = values;
+
+	row->algorithms[count - 1] = strdup(algorithm);
+	if (row->algorithms[count - 1] == NULL)
+		return -1;
+
+	for (int m = 0; m != number_of_result_metrics; m++)
+		row->values[(count - 1) * number_of_result_metrics + m] = NAN;
+
+	row->number_of_algorithms = count;
+
+	return count - 1;
+}
+
+// Escreve a linha `row` no canal `output`, precedida pelos cabeçalhos, se
+// estes ainda não tiverem sido escritos. Em seguida, prepara a linha para a
+// próxima dimensão.
+static void write_row(FILE *const output, struct csv_row *const row)
+{
+	if (!row->headers_written) {
+		fprintf(output, "Size");
+		for (int a = 0; a != row->number_of_algorithms; a++)
+			for (int m = 0; m != number_of_result_metrics; m++)
+				if (row->seen[m])
+					fprintf(output, ";%s (%s)",
+						result_metric_headers[m],
+						row->algorithms[a]);
+		fputc('\n', output);
+		row->headers_written = true;
+	}
+
+	fprintf(output, "%ld", row->size);
+	for (int i = 0;
+	     i != row->number_of_algorithms * number_of_result_metrics; i++) {
+		const int m = i % number_of_result_metrics;
+		if (row->seen[m] && result_metric_is_count[m])
+			fprintf(output, ";%ld", (long)row->values[i]);
+		else if (row->seen[m])
+			fprintf(output, ";%g", row->values[i]);
+		row->values[i] = NAN;
+	}
+	fputc('\n', output);
+}
+
+// Converte os registos de `reader` com o tipo de ficheiro `file_type` para o
+// formato CSV, escrevendo-os no canal `output`. Devolve `true` em caso de erro.
+static bool convert(struct results_reader *const reader,
+		    const char *const file_type, FILE *const output)
+{
+	struct csv_row row = {
+		.size = -1L,
+		.algorithms = NULL,
+		.number_of_algorithms = 0,
+		.values = NULL,
+		.seen = { false },
+		.headers_written = false
+	};
+
+	bool error = false;
+	struct result_record record;
+
+	while (read_result(reader, &record)) {
+		if (strcmp(record.file_type, file_type) != 0)
+			continue;
+
+		const enum result_metric m = result_metric_named(record.metric);
+		if (m == number_of_result_metrics) {
+			fprintf(stderr, "Error: Unknown metric '%s'!\n",
+				record.metric);
+			error = true;
+			goto terminate;
+		}
+
+		if (record.size != row.size) {
+			if (row.size >= 0L)
+				write_row(output, &row);
+			row.size = record.size;
+		}
+
+		const int a = algorithm_column(&row, record.algorithm);
+		if (a < 0) {
+			fprintf(stderr, "Error: Unexpected algorithm '%s'!\n",
+				record.algorithm);
+			error = true;
+			goto terminate;
+		}
+
+		if (!row.headers_written)
+			row.seen[m] = true;
+
+		row.values[a * number_of_result_metrics + m] = record.value;
+	}
+
+	error = results_reader_failed(reader);
+	if (error) {
+		fprintf(stderr, "Error: Reading results!\n");
+		goto terminate;
+	}
+
+	if (row.size >= 0L)
+		write_row(output, &row);
+
+terminate:
+	for (int a = 0; a != row.number_of_algorithms; a++)
+		free(row.algorithms[a]);
+	free(row.algorithms);
+	free(row.values);
+
+	return error;
+}
+
+// Rotina inicial do programa.
+int main(const int argument_count,
+	 const char *const argument_values[argument_count])
+{
+	if (argument_count != 4) {
+		fprintf(stderr, "Usage: %s RESULTS_FILE FILE_TYPE CSV_FILE\n",
+			argument_values[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char *const results_file_name = argument_values[1];
+	const char *const file_type = argument_values[2];
+	const char *const csv_file_name = argument_values[3];
+
+	struct results_reader *const reader =
+		new_results_reader(results_file_name);
+	if (reader == NULL) {
+		fprintf(stderr, "Error: Could not open '%s' for reading!\n",
+			results_file_name);
+		return EXIT_FAILURE;
+	}
+
+	FILE *const output = fopen(csv_file_name, "w");
+	if (output == NULL) {
+		fprintf(stderr, "Error: Could not open '%s' for writing!\n",
+			csv_file_name);
+		free_results_reader(reader);
+		return EXIT_FAILURE;
+	}
+
+	bool error = convert(reader, file_type, output);
+
+	if (fclose(output) != 0)
+		error = true;
+	free_results_reader(reader);
+
+	return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
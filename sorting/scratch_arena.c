@@ -0,0 +1,171 @@
+// `scratch_arena.c` &ndash; Arenas de memória de rascunho
+// ======================================================
+//
+// Este é o ficheiro de implementação correspondente ao ficheiro de cabeçalho
+// ou de interface [`scratch_arena.h`](scratch_arena.h.html). Ambos
+// correspondem ao módulo físico `scratch_arena`, cujo objectivo é fornecer uma
+// arena de memória de rascunho para as rotinas que precisam de _arrays_
+// auxiliares.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// Começamos por incluir o próprio ficheiro de interface. Isso ajuda-nos a
+// garantir a coerência entre os dois ficheiros, pois desta forma o compilador
+// poderá gerar erros quando detectar incoerências.
+#include "scratch_arena.h"
+
+// Inclusão de ficheiros de interface
+// -----------------------------------
+//
+// Incluímos os vários ficheiro de interface necessários:
+//
+// - `stdlib.h` &ndash; Para podermos usar o valor especial `NULL` dos ponteiros
+//   e as rotinas `malloc()` e `free()`.
+//
+// - `assert.h` &ndash; Para podermos usar a macro `assert()`.
+//
+// - `array_of_doubles.h` &ndash; Para podermos reservar os blocos de memória
+//   usando páginas enormes (_huge pages_), que reduzem as falhas na TLB
+//   (_translation lookaside buffer_).
+#include <stdlib.h>
+#include <assert.h>
+
+#include "array_of_doubles.h"
+
+// Definição da estrutura
+// ----------------------
+
+// A arena é representada por um único bloco de memória, do qual se vão
+// reservando _arrays_ consecutivos, como numa pilha.
+struct scratch_arena {
+	// Ponteiro para o primeiro item do bloco de memória. É `NULL` se o
+	// bloco ainda não tiver sido reservado.
+	double *block;
+	// A capacidade do bloco, em itens `double`.
+	long capacity;
+	// O número de itens do bloco já reservados.
+	long used;
+	// Indica se a arena funciona em modo «frio».
+	bool cold;
+};
+
+// Definição de rotinas auxiliares
+// -------------------------------
+
+// Reserva para a arena `arena` um novo bloco com capacidade para `capacity`
+// itens, sugerindo-se ao sistema operativo a utilização de páginas enormes. Se
+// a arena não estiver em modo «frio», tocamos em todas as páginas do bloco, de
+// modo a que as faltas de página ocorram agora, e não durante a primeira
+// ordenação. Devolve `true` em caso de erro.
+static bool reserve_block(struct scratch_arena *const arena,
+			  const long capacity)
+{
+	assert(arena != NULL);
+	assert(arena->block == NULL);
+	assert(capacity >= 0L);
+
+	const struct allocation_hints hints = {
+		.huge_pages = true,
+		.interleaved = false,
+		.touch_threads = arena->cold ? 0 : 1
+	};
+
+	arena->block = new_placed_double_array_of(capacity, hints);
+	arena->capacity = capacity;
+
+	return arena->block == NULL;
+}
+
+// Liberta o bloco da arena `arena`, caso exista.
+static void release_block(struct scratch_arena *const arena)
+{
+	assert(arena != NULL);
+	assert(arena->used == 0L);
+
+	free_placed_double_array(arena->block);
+
+	arena->block = NULL;
+	arena->capacity = 0L;
+}
+
+// Definição de rotinas
+// --------------------
+
+struct scratch_arena *new_scratch_arena(const long capacity, const bool cold)
+{
+	assert(capacity >= 0L);
+
+	struct scratch_arena *const arena = malloc(sizeof(struct scratch_arena));
+
+	if (arena == NULL)
+		return NULL;
+
+	arena->block = NULL;
+	arena->capacity = capacity;
+	arena->used = 0L;
+	arena->cold = cold;
+
+	// Em modo «frio», o bloco só é reservado quando for necessário.
+	if (cold)
+		return arena;
+
+	if (reserve_block(arena, capacity)) {
+		free(arena);
+		return NULL;
+	}
+
+	return arena;
+}
+
+void free_scratch_arena(struct scratch_arena *const arena)
+{
+	if (arena == NULL)
+		return;
+
+	arena->used = 0L;
+	release_block(arena);
+	free(arena);
+}
+
+double *scratch_arena_reserve(struct scratch_arena *const arena,
+			      const long length)
+{
+	assert(arena != NULL);
+	assert(length >= 0L);
+
+	// Se a arena estiver vazia e o bloco não existir (modo «frio») ou não
+	// tiver capacidade suficiente, obtemos um novo bloco.
+	if (arena->used == 0L &&
+	    (arena->block == NULL || arena->capacity < length)) {
+		const long capacity =
+			arena->capacity > length ? arena->capacity : length;
+		release_block(arena);
+		if (reserve_block(arena, capacity))
+			return NULL;
+	}
+
+	// Com a arena em uso, a capacidade não pode ser aumentada.
+	if (arena->used + length > arena->capacity)
+		return NULL;
+
+	double *const items = arena->block + arena->used;
+	arena->used += length;
+
+	return items;
+}
+
+void scratch_arena_release(struct scratch_arena *const arena,
+			   double items[])
+{
+	assert(arena != NULL);
+	assert(items != NULL);
+	assert(arena->block <= items && items <= arena->block + arena->used);
+
+	arena->used = items - arena->block;
+
+	// Em modo «frio», a memória é devolvida ao sistema operativo logo que
+	// a arena fica vazia.
+	if (arena->cold && arena->used == 0L)
+		release_block(arena);
+}
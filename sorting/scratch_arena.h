@@ -0,0 +1,64 @@
+// `scratch_arena.h` &ndash; Arenas de memória de rascunho
+// ======================================================
+//
+// Este é o ficheiro de cabeçalho ou de interface correspondente ao ficheiro de
+// implementação [`scratch_arena.c`](scratch_arena.c.html). Ambos correspondem
+// ao módulo físico `scratch_arena`, cujo objectivo é fornecer uma arena de
+// memória de rascunho, ou seja, um bloco de memória reservado uma única vez e
+// reutilizado pelas rotinas que precisam de _arrays_ auxiliares (e.g., a
+// ordenação por fusão). Quando uma rotina de ordenação é executada milhares de
+// vezes seguidas, como acontece durante as experiências, reservar e libertar
+// o _array_ auxiliar em cada execução faz com que se meça sobretudo o custo de
+// `malloc()`, `free()` e das faltas de página que se seguem, e não o custo da
+// ordenação propriamente dita.
+//
+// A memória de uma arena é reservada e libertada por ordem inversa, como numa
+// pilha. Uma arena pode ainda funcionar em modo «frio», em que a memória é
+// devolvida ao sistema operativo sempre que a arena fica vazia. Nesse modo o
+// custo de reservar memória nova volta a ser medido, o que permite comparar
+// honestamente as duas situações.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// A usual protecção contra os efeitos nefastos da inclusão múltipla.
+#ifndef ISLA_EDA_SCRATCH_ARENA_H_INCLUDED
+#define ISLA_EDA_SCRATCH_ARENA_H_INCLUDED
+
+// Incluímos o ficheiro de interface `stdbool.h` para podermos usar o tipo
+// `bool` e os seus dois valores `true` e `false`.
+#include <stdbool.h>
+
+// Declaração da estrutura que representa uma arena. A sua definição encontra-se
+// no ficheiro de implementação, pelo que o código cliente só a pode manipular
+// através de ponteiros e das rotinas declaradas abaixo.
+struct scratch_arena;
+
+// Rotina que cria uma nova arena com capacidade inicial para `capacity` itens
+// `double`. Se `cold` for `false`, a memória é reservada de imediato (usando
+// páginas enormes, quando o sistema operativo o permite) e é tocada, de modo a
+// que as faltas de página ocorram já e não durante as ordenações. Se `cold` for
+// `true`, a memória só é reservada quando necessária e é devolvida ao sistema
+// operativo sempre que a arena fica vazia. Devolve `NULL` em caso de erro. O
+// valor de `capacity` não pode ser negativo.
+struct scratch_arena *new_scratch_arena(long capacity, bool cold);
+
+// Procedimento que liberta a arena `arena` e toda a sua memória. O valor de
+// `arena` pode ser `NULL`, não tendo nesse caso qualquer efeito.
+void free_scratch_arena(struct scratch_arena *arena);
+
+// Rotina que reserva na arena `arena` um _array_ com `length` itens `double`,
+// todos por inicializar. Devolve um ponteiro para o novo _array_. Devolve `NULL`
+// em caso de erro. Se a arena estiver vazia e não tiver capacidade suficiente,
+// a sua capacidade é aumentada. Se não estiver vazia, a sua capacidade não pode
+// ser aumentada, pois isso invalidaria os _arrays_ já reservados. O valor de
+// `arena` não pode ser `NULL` e o valor de `length` não pode ser negativo.
+double *scratch_arena_reserve(struct scratch_arena *arena, long length);
+
+// Procedimento que devolve à arena `arena` o _array_ `items`, que tem de ter
+// sido reservado nessa arena, bem como todos os _arrays_ reservados depois dele.
+// Os valores de `arena` e `items` não podem ser `NULL`.
+void scratch_arena_release(struct scratch_arena *arena, double items[]);
+
+// Fecho da protecção contra os efeitos perversos da inclusão múltipla.
+#endif // ISLA_EDA_SCRATCH_ARENA_H_INCLUDED
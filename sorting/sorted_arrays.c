@@ -0,0 +1,340 @@
+// `sorted_arrays.c` &ndash; Pesquisa e fusão de _arrays_ ordenados de `double`
+// =========================================================================
+//
+// Este é o ficheiro de implementação correspondente ao ficheiro de cabeçalho ou
+// de interface [`sorted_arrays.h`](sorted_arrays.h.html). Ambos correspondem ao
+// módulo físico `sorted_arrays`, cujo objectivo é fornecer as operações
+// habitualmente realizadas sobre _arrays_ de `double` depois de ordenados.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// Começamos por incluir o próprio ficheiro de interface. Isso ajuda-nos a
+// garantir a coerência entre os dois ficheiros, pois desta forma o compilador
+// poderá gerar erros quando detectar incoerências.
+#include "sorted_arrays.h"
+
+// Inclusão de ficheiros de interface
+// -----------------------------------
+//
+// - `stdlib.h` &ndash; Para podermos usar a rotina `aligned_alloc()` e o valor
+//   especial `NULL`.
+//
+// - `assert.h` &ndash; Para podermos usar a macro `assert()`.
+#include <stdlib.h>
+#include <assert.h>
+
+// Definição de constantes
+// -----------------------
+
+// Dimensão, em _bytes_, de uma linha de _cache_. Os _arrays_ com a organização
+// de Eytzinger ficam alinhados com este valor.
+static const size_t cache_line_size = 64;
+
+// O número de pesquisas intercaladas em cada lote por `lower_bounds_of()`.
+// Deve ser suficiente para manter ocupados os vários acessos à memória que um
+// processador consegue ter pendentes em simultâneo (tipicamente entre 10 e 20).
+#define batch_size 16
+
+// Definição de rotinas auxiliares
+// -------------------------------
+
+// Procedimento que sugere ao processador que leia para a _cache_ a linha que
+// contém o endereço `address`, sem esperar pelo resultado. É apenas uma
+// sugestão, pelo que o endereço pode estar fora dos _arrays_ do programa. Com
+// compiladores que não suportem `__builtin_prefetch()`, nada faz.
+static inline void prefetch(const void *const address)
+{
+#if defined(__GNUC__)
+	__builtin_prefetch(address);
+#else
+	(void)address;
+#endif
+}
+
+// Rotina recursiva que coloca na sub-árvore com raiz no índice `k` do _array_
+// `layout`, pela organização de Eytzinger, os itens de `sorted` a partir do
+// índice `i`. A travessia da sub-árvore é feita em ordem (_in-order_), pelo que
+// os itens são consumidos por ordem crescente. Devolve o índice do primeiro
+// item de `sorted` ainda não colocado. A profundidade da recursão é
+// logarítmica.
+static long fill_eytzinger_layout(const long length,
+				  const double sorted[length],
+				  double layout[length + 1], long i,
+				  const long k)
+{
+	if (k > length)
+		return i;
+
+	i = fill_eytzinger_layout(length, sorted, layout, i, 2 * k);
+	layout[k] = sorted[i++];
+	return fill_eytzinger_layout(length, sorted, layout, i, 2 * k + 1);
+}
+
+// Definição de rotinas
+// --------------------
+
+// ### Pesquisa binária sem ramificações
+//
+// Em cada passo, o segmento em pesquisa, com início em `base` e com `n` itens,
+// perde metade dos itens. Se o item do meio for menor do que a chave, o limite
+// inferior não está na primeira metade, pelo que o início avança para o meio.
+// O item do meio continua a fazer parte do segmento, o que permite que o
+// comprimento seja actualizado sempre da mesma forma, independentemente do
+// resultado da comparação. O número de passos depende assim apenas de
+// `length`, e a atribuição condicional a `base` é compilada como uma
+// instrução de movimento condicional (`cmov`, em x86-64), sem saltos.
+long lower_bound_of(const long length, const double items[length],
+		    const double key)
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+
+	if (length == 0L)
+		return 0L;
+
+	const double *base = items;
+	long n = length;
+
+	while (n > 1L) {
+		const long half = n / 2;
+		base = base[half] < key ? base + half : base;
+		n -= half;
+	}
+
+	return (base - items) + (*base < key);
+}
+
+// ### Pesquisa binária em lote
+//
+// Como todas as pesquisas são feitas no mesmo _array_, o comprimento do
+// segmento em pesquisa evolui da mesma forma para todas as chaves, pelo que as
+// pesquisas de um lote podem avançar em simultâneo, um passo de cada vez. Os
+// acessos à memória de um passo são independentes entre si, pelo que o
+// processador os pode realizar em paralelo. Além disso, em cada passo
+// antecipa-se a leitura dos dois itens que poderão ser consultados no passo
+// seguinte.
+void lower_bounds_of(const long length, const double items[length],
+		     const long number_of_keys,
+		     const double keys[number_of_keys],
+		     long positions[number_of_keys])
+{
+	assert(length >= 0L);
+	assert(length == 0L || items != NULL);
+	assert(number_of_keys >= 0L);
+	assert(number_of_keys == 0L || (keys != NULL && positions != NULL));
+
+	if (length == 0L) {
+		for (long i = 0L; i != number_of_keys; i++)
+			positions[i] = 0L;
+		return;
+	}
+
+	for (long first = 0L; first < number_of_keys; first += batch_size) {
+		const int batch = number_of_keys - first < batch_size ?
+			(int)(number_of_keys - first) : batch_size;
+		const double *const batch_keys = keys + first;
+		const double *bases[batch_size];
+
+		for (int j = 0; j != batch; j++)
+			bases[j] = items;
+
+		long n = length;
+
+		while (n > 1L) {
+			const long half = n / 2;
+			const long next_half = (n - half) / 2;
+			for (int j = 0; j != batch; j++) {
+				const double *const base = bases[j];
+				bases[j] = base[half] < batch_keys[j] ?
+					base + half : base;
+				prefetch(bases[j] + next_half);
+			}
+			n -= half;
+		}
+
+		for (int j = 0; j != batch; j++)
+			positions[first + j] = (bases[j] - items) +
+				(*bases[j] < batch_keys[j]);
+	}
+}
+
+// ### Organização de Eytzinger
+
+void build_eytzinger_layout(const long length, const double sorted[length],
+			    double layout[length + 1])
+{
+	assert(length >= 0L);
+	assert(length == 0L || sorted != NULL);
+	assert(layout != NULL);
+
+	fill_eytzinger_layout(length, sorted, layout, 0L, 1L);
+}
+
+double *new_eytzinger_layout_of(const long length, const double sorted[length])
+{
+	assert(length >= 0L);
+	assert(length == 0L || sorted != NULL);
+
+	// A função `aligned_alloc()` exige que a dimensão seja um múltiplo do
+	// alinhamento.
+	const size_t size = ((length + 1) * sizeof(double) + cache_line_size -
+			     1) / cache_line_size * cache_line_size;
+
+	double *const layout = aligned_alloc(cache_line_size, size);
+	if (layout == NULL)
+		return NULL;
+
+	build_eytzinger_layout(length, sorted, layout);
+
+	return layout;
+}
+
+// A pesquisa desce a árvore desde a raiz, passando para o filho direito
+// sempre que o item corrente é menor do que a chave, de novo sem saltos
+// condicionais. Os 16 descendentes do item corrente quatro níveis abaixo
+// ocupam posições consecutivas a partir do índice 16_k_, ou seja, duas
+// linhas de _cache_ (se o _array_ estiver alinhado), pelo que se antecipa a
+// sua leitura. Depois de se sair da árvore, o índice `k` codifica o caminho
+// percorrido: cada _bit_ a 1 corresponde a uma descida para a direita. O
+// limite inferior é o último item a partir do qual se desceu para a esquerda,
+// que se obtém eliminando os _bits_ a 1 finais e o _bit_ a 0 que os precede.
+long eytzinger_lower_bound_of(const long length,
+			      const double layout[length + 1],
+			      const double key)
+{
+	assert(length >= 0L);
+	assert(layout != NULL);
+
+	long k = 1L;
+
+	while (k <= length) {
+		prefetch(layout + 16 * k);
+		k = 2 * k + (layout[k] < key);
+	}
+
+	while (k % 2 == 1L)
+		k /= 2;
+
+	return k / 2;
+}
+
+// ### Fusão e operações de conjuntos
+
+long merge_sorted(const long first_length, const double first[first_length],
+		  const long second_length, const double second[second_length],
+		  double result[first_length + second_length])
+{
+	assert(first_length >= 0L);
+	assert(second_length >= 0L);
+	assert(first_length == 0L || first != NULL);
+	assert(second_length == 0L || second != NULL);
+	assert(first_length + second_length == 0L || result != NULL);
+
+	long i = 0L;
+	long j = 0L;
+	long k = 0L;
+
+	while (i != first_length && j != second_length)
+		result[k++] = second[j] < first[i] ? second[j++] : first[i++];
+
+	while (i != first_length)
+		result[k++] = first[i++];
+
+	while (j != second_length)
+		result[k++] = second[j++];
+
+	return k;
+}
+
+long sorted_union(const long first_length, const double first[first_length],
+		  const long second_length, const double second[second_length],
+		  double result[first_length + second_length])
+{
+	assert(first_length >= 0L);
+	assert(second_length >= 0L);
+	assert(first_length == 0L || first != NULL);
+	assert(second_length == 0L || second != NULL);
+	assert(first_length + second_length == 0L || result != NULL);
+
+	long i = 0L;
+	long j = 0L;
+	long k = 0L;
+
+	while (i != first_length && j != second_length)
+		if (first[i] < second[j])
+			result[k++] = first[i++];
+		else if (second[j] < first[i])
+			result[k++] = second[j++];
+		else {
+			result[k++] = first[i++];
+			j++;
+		}
+
+	while (i != first_length)
+		result[k++] = first[i++];
+
+	while (j != second_length)
+		result[k++] = second[j++];
+
+	return k;
+}
+
+long sorted_intersection(const long first_length,
+			 const double first[first_length],
+			 const long second_length,
+			 const double second[second_length], double result[])
+{
+	assert(first_length >= 0L);
+	assert(second_length >= 0L);
+	assert(first_length == 0L || first != NULL);
+	assert(second_length == 0L || second != NULL);
+
+	long i = 0L;
+	long j = 0L;
+	long k = 0L;
+
+	while (i != first_length && j != second_length)
+		if (first[i] < second[j])
+			i++;
+		else if (second[j] < first[i])
+			j++;
+		else {
+			result[k++] = first[i++];
+			j++;
+		}
+
+	return k;
+}
+
+long sorted_difference(const long first_length,
+		       const double first[first_length],
+		       const long second_length,
+		       const double second[second_length],
+		       double result[first_length])
+{
+	assert(first_length >= 0L);
+	assert(second_length >= 0L);
+	assert(first_length == 0L || first != NULL);
+	assert(second_length == 0L || second != NULL);
+	assert(first_length == 0L || result != NULL);
+
+	long i = 0L;
+	long j = 0L;
+	long k = 0L;
+
+	while (i != first_length && j != second_length)
+		if (first[i] < second[j])
+			result[k++] = first[i++];
+		else if (second[j] < first[i])
+			j++;
+		else {
+			i++;
+			j++;
+		}
+
+	while (i != first_length)
+		result[k++] = first[i++];
+
+	return k;
+}
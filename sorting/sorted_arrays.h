@@ -0,0 +1,122 @@
+// `sorted_arrays.h` &ndash; Pesquisa e fusão de _arrays_ ordenados de `double`
+// =========================================================================
+//
+// Este é o ficheiro de cabeçalho ou de interface correspondente ao ficheiro de
+// implementação [`sorted_arrays.c`](sorted_arrays.c.html). Ambos correspondem
+// ao módulo físico `sorted_arrays`, cujo objectivo é fornecer as operações
+// habitualmente realizadas sobre _arrays_ de `double` depois de ordenados
+// (e.g., pelas rotinas do módulo
+// [`sorting_algorithms`](sorting_algorithms.h.html)):
+//
+// - Pesquisa binária sem ramificações (_branchless_), em que a escolha da
+//   metade onde prosseguir a pesquisa é feita através de uma atribuição
+//   condicional, e não de uma instrução `if`, evitando assim os custos das
+//   previsões de salto falhadas, que numa pesquisa binária ocorrem em cerca de
+//   metade dos passos.
+//
+// - Pesquisa binária em lote, em que as pesquisas de várias chaves são
+//   intercaladas passo a passo, de modo a que os acessos à memória de umas se
+//   sobreponham aos das outras, escondendo assim a sua latência.
+//
+// - Pesquisa sobre a organização de Eytzinger, em que os itens ordenados são
+//   guardados pela ordem de uma travessia por níveis de uma árvore de pesquisa
+//   binária completa, como nos montes binários. Os itens visitados nos
+//   primeiros passos de todas as pesquisas ficam assim juntos no início do
+//   _array_, e os descendentes de um item nos níveis seguintes ficam juntos
+//   entre si, o que permite antecipar a sua leitura (_prefetching_).
+//
+// - Fusão e operações de conjuntos (união, intersecção e diferença) sobre
+//   _arrays_ ordenados, em tempo linear.
+//
+// Os itens são comparados com o operador `<`, pelo que os _arrays_ não podem
+// conter NaN. As operações de conjuntos seguem a semântica dos multiconjuntos:
+// um valor que ocorra _m_ vezes no primeiro _array_ e _n_ vezes no segundo
+// ocorre max(_m_, _n_) vezes na união, min(_m_, _n_) vezes na intersecção e
+// max(_m_ - _n_, 0) vezes na diferença. Para _arrays_ sem repetições, estas
+// são as operações usuais sobre conjuntos.
+//
+// Note que optámos por _não_ incluir comentários de documentação
+// [Doxygen](http://doxygen.org/) em nenhum dos módulos deste programa.
+
+// A usual protecção contra os efeitos nefastos da inclusão múltipla.
+#ifndef ISLA_EDA_SORTED_ARRAYS_H_INCLUDED
+#define ISLA_EDA_SORTED_ARRAYS_H_INCLUDED
+
+// Pesquisa
+// --------
+
+// Rotina que devolve o índice do primeiro item do _array_ ordenado `items`,
+// com `length` itens, que não é menor do que `key` (i.e., o seu limite
+// inferior ou _lower bound_), ou `length`, se todos os itens forem menores do
+// que `key`. A pesquisa é binária e sem ramificações. O valor de `length` não
+// pode ser negativo. O valor de `items` pode ser `NULL`, mas apenas se `length`
+// for zero.
+long lower_bound_of(long length, const double items[length], double key);
+
+// Procedimento que coloca em `positions[i]` o resultado de
+// `lower_bound_of(length, items, keys[i])`, para cada uma das
+// `number_of_keys` chaves em `keys`. As pesquisas são feitas em lotes de
+// várias chaves, intercaladas passo a passo. Os valores de `length` e de
+// `number_of_keys` não podem ser negativos.
+void lower_bounds_of(long length, const double items[length],
+		     long number_of_keys, const double keys[number_of_keys],
+		     long positions[number_of_keys]);
+
+// Procedimento que coloca em `layout` os `length` itens do _array_ ordenado
+// `sorted` pela organização de Eytzinger. O _array_ `layout` tem de ter
+// `length` + 1 itens: por conveniência, a raiz da árvore fica no índice 1 e os
+// filhos do item no índice _k_ ficam nos índices 2_k_ e 2_k_ + 1. O item no
+// índice 0 não é usado. O valor de `length` não pode ser negativo.
+void build_eytzinger_layout(long length, const double sorted[length],
+			    double layout[length + 1]);
+
+// Rotina que cria um novo _array_ com os `length` itens do _array_ ordenado
+// `sorted` pela organização de Eytzinger (ver `build_eytzinger_layout()`),
+// alinhado com as linhas de _cache_. O _array_ deve ser libertado através de
+// `free()`. Devolve `NULL` em caso de erro.
+double *new_eytzinger_layout_of(long length, const double sorted[length]);
+
+// Rotina que devolve o índice no _array_ `layout`, com `length` itens pela
+// organização de Eytzinger, do primeiro item, por ordem crescente, que não é
+// menor do que `key`, ou 0, se todos os itens forem menores do que `key`. Se o
+// índice devolvido não for 0, `layout[índice]` é esse item. O valor de
+// `length` não pode ser negativo.
+long eytzinger_lower_bound_of(long length, const double layout[length + 1],
+			      double key);
+
+// Fusão e operações de conjuntos
+// ------------------------------
+//
+// Todas as rotinas recebem dois _arrays_ ordenados, `first` e `second`, com
+// `first_length` e `second_length` itens, respectivamente, e colocam o
+// resultado, também ordenado, no _array_ `result`, que não se pode sobrepor a
+// nenhum deles. Devolvem o número de itens do resultado. O _array_ `result`
+// tem de ter espaço para o maior número de itens que o resultado pode ter.
+
+// Coloca em `result` todos os itens de `first` e de `second`. O resultado tem
+// exactamente `first_length` + `second_length` itens. A fusão é estável, ou
+// seja, os itens de `first` precedem os itens iguais de `second`.
+long merge_sorted(long first_length, const double first[first_length],
+		  long second_length, const double second[second_length],
+		  double result[first_length + second_length]);
+
+// Coloca em `result` a união de `first` e `second`, com até `first_length` +
+// `second_length` itens.
+long sorted_union(long first_length, const double first[first_length],
+		  long second_length, const double second[second_length],
+		  double result[first_length + second_length]);
+
+// Coloca em `result` a intersecção de `first` e `second`, com até o menor de
+// `first_length` e `second_length` itens.
+long sorted_intersection(long first_length, const double first[first_length],
+			 long second_length,
+			 const double second[second_length], double result[]);
+
+// Coloca em `result` a diferença entre `first` e `second`, com até
+// `first_length` itens.
+long sorted_difference(long first_length, const double first[first_length],
+		       long second_length, const double second[second_length],
+		       double result[first_length]);
+
+// Fecho da protecção contra os efeitos perversos da inclusão múltipla.
+#endif // ISLA_EDA_SORTED_ARRAYS_H_INCLUDED
@@ -29,12 +29,32 @@
 //
 // - `assert.h` &ndash; Para podermos usar a macro `assert()`.
 //
+// - `stdint.h` &ndash; Para podermos usar os tipos `uint32_t` e `uint64_t`.
+//
+// - `string.h` &ndash; Para podermos usar o procedimento `memcpy()`.
+//
+// - `limits.h` &ndash; Para podermos usar a macro `INT_MAX`.
+//
+// - `stdio.h` &ndash; Para podermos usar as rotinas `fopen()`, `fclose()`,
+//   `fscanf()` e `ferror()` na selecção dos menores itens de um ficheiro.
+//
+// - `math.h` &ndash; Para podermos usar a macro `signbit()`.
+//
 // - `array_of_doubles.h` &ndash; Para podermos usar as rotinas que
 //   desenvolvemos para lidar com _arrays_ de `double`.
+//
+// - `scratch_arena.h` &ndash; Para podermos reservar os _arrays_ auxiliares
+//   numa arena de memória de rascunho.
 #include <stdlib.h>
 #include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <stdio.h>
+#include <math.h>
 
 #include "array_of_doubles.h"
+#include "scratch_arena.h"
 
 // Definição de constantes globais
 // -------------------------------
@@ -63,6 +83,26 @@ const struct sorting_algorithm sorting_algorithms[] = {
 		.sort = shell_sort,
 		.sort_and_count = shell_sort_and_count
 	},
+	{
+		.name = "Shell sort (Ciura)",
+		.sort = shell_sort_ciura,
+		.sort_and_count = shell_sort_ciura_and_count
+	},
+	{
+		.name = "Shell sort (Tokuda)",
+		.sort = shell_sort_tokuda,
+		.sort_and_count = shell_sort_tokuda_and_count
+	},
+	{
+		.name = "Shell sort (Sedgewick)",
+		.sort = shell_sort_sedgewick,
+		.sort_and_count = shell_sort_sedgewick_and_count
+	},
+	{
+		.name = "Shell sort (Pratt)",
+		.sort = shell_sort_pratt,
+		.sort_and_count = shell_sort_pratt_and_count
+	},
 	{
 		.name = "quicksort",
 		.sort = quicksort,
@@ -73,6 +113,21 @@ const struct sorting_algorithm sorting_algorithms[] = {
 		.sort = merge_sort,
 		.sort_and_count = merge_sort_and_count
 	},
+	{
+		.name = "heapsort",
+		.sort = heap_sort,
+		.sort_and_count = heap_sort_and_count
+	},
+	{
+		.name = "4-ary heapsort",
+		.sort = quaternary_heap_sort,
+		.sort_and_count = quaternary_heap_sort_and_count
+	},
+	{
+		.name = "8-ary heapsort",
+		.sort = octonary_heap_sort,
+		.sort_and_count = octonary_heap_sort_and_count
+	},
 };
 
 // Definimos a constante contendo o número de algoritmos considerado, i.e.,
@@ -80,6 +135,21 @@ const struct sorting_algorithm sorting_algorithms[] = {
 const int number_of_sorting_algorithms =
 	sizeof(sorting_algorithms) / sizeof(sorting_algorithms[0]);
 
+// Definição de variáveis globais
+// ------------------------------
+
+// A arena de memória de rascunho usada pelas rotinas de ordenação que precisam
+// de _arrays_ auxiliares e que não a recebem explicitamente como argumento. Se
+// for `NULL`, essas rotinas reservam e libertam os _arrays_ auxiliares em cada
+// invocação. Tem ligação interna, sendo alterada através do procedimento
+// `set_sorting_scratch_arena()`.
+static struct scratch_arena *sorting_scratch_arena = NULL;
+
+void set_sorting_scratch_arena(struct scratch_arena *const arena)
+{
+	sorting_scratch_arena = arena;
+}
+
 // Definição de rotinas auxiliares genéricas
 // -----------------------------------------
 //
@@ -120,6 +190,33 @@ static void swap_and_count(const int length, double items[length],
 	counts->copies += 3;
 }
 
+// Devolve um novo _array_ auxiliar com `length` itens, reservado na arena
+// `arena` ou, se esta for `NULL`, reservado dinamicamente. Devolve `NULL` em
+// caso de erro.
+static double *new_temporary_array(struct scratch_arena *const arena,
+				   const int length)
+{
+	assert(length >= 0);
+
+	if (arena == NULL)
+		return new_double_array_of(length);
+	else
+		return scratch_arena_reserve(arena, length);
+}
+
+// Liberta o _array_ auxiliar `temporary`, obtido através de
+// `new_temporary_array()` com a mesma arena `arena`.
+static void free_temporary_array(struct scratch_arena *const arena,
+				 double temporary[])
+{
+	assert(temporary != NULL);
+
+	if (arena == NULL)
+		free(temporary);
+	else
+		scratch_arena_release(arena, temporary);
+}
+
 // Definição das rotinas de ordenação
 // ----------------------------------
   
@@ -338,26 +435,151 @@ bool insertion_sort_and_count(const int length, double items[length],
 	return false;
 }
 
+// ### Sucessões de incrementos para a ordenação de Shell
+//
+// A eficiência da ordenação de Shell depende fortemente da sucessão de
+// incrementos usada. Cada sucessão é guardada numa tabela constante, por ordem
+// crescente, começando sempre em 1 e terminando no maior termo que cabe num
+// `int`. Os termos maiores do que o comprimento do _array_ a ordenar são
+// simplesmente ignorados.
+
+// Sucessão de Knuth, 1, 4, 13, 40, 121, etc., em que cada termo é o triplo do
+// anterior mais um. Ver Algorithms, de Robert Sedgewick e Kevin Wayne (4.ª
+// edição), pág. 259.
+static const int knuth_gaps[] = {
+	1, 4, 13, 40, 121, 364, 1093, 3280, 9841, 29524, 88573, 265720, 797161,
+	2391484, 7174453, 21523360, 64570081, 193710244, 581130733, 1743392200
+};
+
+// Sucessão de Ciura, obtida experimentalmente até 1750 (Marcin Ciura, «Best
+// Increments for the Average Case of Shellsort», 2001). Os termos seguintes
+// obtêm-se, como é usual, multiplicando o termo anterior por 2,25 e
+// truncando.
+static const int ciura_gaps[] = {
+	1, 4, 10, 23, 57, 132, 301, 701, 1750, 3937, 8858, 19930, 44842, 100894,
+	227011, 510774, 1149241, 2585792, 5818032, 13090572, 29453787, 66271020,
+	149109795, 335497038, 754868335, 1698453753
+};
+
+// Sucessão de Tokuda, cujo termo _k_ é ⌈(9<sup>_k_</sup> -
+// 4<sup>_k_</sup>) / (5 × 4<sup>_k_ - 1</sup>)⌉.
+static const int tokuda_gaps[] = {
+	1, 4, 9, 20, 46, 103, 233, 525, 1182, 2660, 5985, 13467, 30301, 68178,
+	153401, 345152, 776591, 1747331, 3931496, 8845866, 19903198, 44782196,
+	100759940, 226709866, 510097200, 1147718700
+};
+
+// Sucessão de Sedgewick (1986), que intercala os termos 9(4<sup>_k_</sup> -
+// 2<sup>_k_</sup>) + 1 e 4<sup>_k_</sup> - 3 × 2<sup>_k_</sup> + 1.
+static const int sedgewick_gaps[] = {
+	1, 5, 19, 41, 109, 209, 505, 929, 2161, 3905, 8929, 16001, 36289, 64769,
+	146305, 260609, 587521, 1045505, 2354689, 4188161, 9427969, 16764929,
+	37730305, 67084289, 150958081, 268386305, 603906049, 1073643521
+};
+
+// Sucessão de Pratt, formada por todos os números da forma 2<sup>_p_</sup> ×
+// 3<sup>_q_</sup>. Garante um tempo de execução proporcional a _n_
+// log<sup>2</sup> _n_ no pior caso, mas à custa de um número muito elevado de
+// incrementos.
+static const int pratt_gaps[] = {
+	1, 2, 3, 4, 6, 8, 9, 12, 16, 18, 24, 27, 32, 36, 48, 54, 64, 72, 81, 96,
+	108, 128, 144, 162, 192, 216, 243, 256, 288, 324, 384, 432, 486, 512,
+	576, 648, 729, 768, 864, 972, 1024, 1152, 1296, 1458, 1536, 1728, 1944,
+	2048, 2187, 2304, 2592, 2916, 3072, 3456, 3888, 4096, 4374, 4608, 5184,
+	5832, 6144, 6561, 6912, 7776, 8192, 8748, 9216, 10368, 11664, 12288,
+	13122, 13824, 15552, 16384, 17496, 18432, 19683, 20736, 23328, 24576,
+	26244, 27648, 31104, 32768, 34992, 36864, 39366, 41472, 46656, 49152,
+	52488, 55296, 59049, 62208, 65536, 69984, 73728, 78732, 82944, 93312,
+	98304, 104976, 110592, 118098, 124416, 131072, 139968, 147456, 157464,
+	165888, 177147, 186624, 196608, 209952, 221184, 236196, 248832, 262144,
+	279936, 294912, 314928, 331776, 354294, 373248, 393216, 419904, 442368,
+	472392, 497664, 524288, 531441, 559872, 589824, 629856, 663552, 708588,
+	746496, 786432, 839808, 884736, 944784, 995328, 1048576, 1062882,
+	1119744, 1179648, 1259712, 1327104, 1417176, 1492992, 1572864, 1594323,
+	1679616, 1769472, 1889568, 1990656, 2097152, 2125764, 2239488, 2359296,
+	2519424, 2654208, 2834352, 2985984, 3145728, 3188646, 3359232, 3538944,
+	3779136, 3981312, 4194304, 4251528, 4478976, 4718592, 4782969, 5038848,
+	5308416, 5668704, 5971968, 6291456, 6377292, 6718464, 7077888, 7558272,
+	7962624, 8388608, 8503056, 8957952, 9437184, 9565938, 10077696,
+	10616832, 11337408, 11943936, 12582912, 12754584, 13436928, 14155776,
+	14348907, 15116544, 15925248, 16777216, 17006112, 17915904, 18874368,
+	19131876, 20155392, 21233664, 22674816, 23887872, 25165824, 25509168,
+	26873856, 28311552, 28697814, 30233088, 31850496, 33554432, 34012224,
+	35831808, 37748736, 38263752, 40310784, 42467328, 43046721, 45349632,
+	47775744, 50331648, 51018336, 53747712, 56623104, 57395628, 60466176,
+	63700992, 67108864, 68024448, 71663616, 75497472, 76527504, 80621568,
+	84934656, 86093442, 90699264, 95551488, 100663296, 102036672, 107495424,
+	113246208, 114791256, 120932352, 127401984, 129140163, 134217728,
+	136048896, 143327232, 150994944, 153055008, 161243136, 169869312,
+	172186884, 181398528, 191102976, 201326592, 204073344, 214990848,
+	226492416, 229582512, 241864704, 254803968, 258280326, 268435456,
+	272097792, 286654464, 301989888, 306110016, 322486272, 339738624,
+	344373768, 362797056, 382205952, 387420489, 402653184, 408146688,
+	429981696, 452984832, 459165024, 483729408, 509607936, 516560652,
+	536870912, 544195584, 573308928, 603979776, 612220032, 644972544,
+	679477248, 688747536, 725594112, 764411904, 774840978, 805306368,
+	816293376, 859963392, 905969664, 918330048, 967458816, 1019215872,
+	1033121304, 1073741824, 1088391168, 1146617856, 1162261467, 1207959552,
+	1224440064, 1289945088, 1358954496, 1377495072, 1451188224, 1528823808,
+	1549681956, 1610612736, 1632586752, 1719926784, 1811939328, 1836660096,
+	1934917632, 2038431744, 2066242608
+};
+
+// Esta macro devolve o número de termos de uma tabela de incrementos.
+#define NUMBER_OF_GAPS(gaps) ((int) (sizeof(gaps) / sizeof(gaps[0])))
+
+// Esta função devolve o número de termos iniciais da sucessão de Knuth a usar
+// na ordenação de um _array_ com `length` itens. Tal como na implementação
+// original de `shell_sort()`, o primeiro incremento usado é o menor termo da
+// sucessão que não é inferior a `length` / 3 (ver Algorithms, de Robert
+// Sedgewick e Kevin Wayne, 4.ª edição, pág. 259), e não o maior termo inferior
+// a `length`, que seria o usado com a tabela completa. Esse termo é sempre
+// inferior a `length`, pelo que é, de facto, o primeiro a ser usado.
+static int knuth_number_of_gaps(const int length)
+{
+	int number_of_gaps = 1;
+
+	while (number_of_gaps != NUMBER_OF_GAPS(knuth_gaps) &&
+	       knuth_gaps[number_of_gaps - 1] < length / 3)
+		number_of_gaps++;
+
+	return number_of_gaps;
+}
+
 // ### Ordenação de Shell ou _Shell sort_
-bool shell_sort(const int length, double items[length])
+//
+// A ordenação de Shell é implementada recorrendo a uma rotina genérica,
+// `shell_sort_with_gaps()`, que recebe como argumento a tabela de incrementos a
+// usar, e a um conjunto de rotinas, uma por sucessão de incrementos, que se
+// limitam a invocá-la com a tabela apropriada.
+
+// #### Rotina genérica de ordenação de Shell
+bool shell_sort_with_gaps(const int length, double items[length],
+			  const int number_of_gaps,
+			  const int gaps[number_of_gaps])
 {
 	assert(length >= 0);
 	assert(length == 0 || items != NULL);
+	assert(number_of_gaps > 0);
+	assert(gaps != NULL);
+	assert(gaps[0] == 1);
 
 	// _Arrays_ vazios ou com apenas um item estão sempre ordenados, pelo
 	// que podemos terminar a execução da rotina.
 	if (length <= 1)
 		return false;
 
-	// Os incrementos decrescentes a usar pertencem à sucessão 1, 4, 13, 40,
-	// 121, etc. Este ciclo procura o valor inicial desses incrementos. Ver
-	// Algorithms, de Robert Sedgewick e Kevin Wayne (4.ª edição), pág. 259.
-	int step = 1;
-	while (step < length / 3)
-		step = 3 * step + 1;
-
-	// Percorremos cada incremento da sucessão até ao incremento 1.
-	while (step >= 1) {
+	// Procuramos o índice do maior incremento da tabela que é inferior ao
+	// comprimento do _array_. Os incrementos maiores não teriam qualquer
+	// efeito.
+	int g = 0;
+	while (g != number_of_gaps - 1 && gaps[g + 1] < length)
+		g++;
+
+	// Percorremos cada incremento da sucessão, por ordem decrescente, até
+	// ao incremento 1.
+	for (; g >= 0; g--) {
+		const int step = gaps[g];
 		// Executa-se o algoritmo de ordenação por inserção a sub-
 		// _arrays_ entremeados obtidos percorrendo o _array_ em saltos
 		// dados pelo incremento.
@@ -371,7 +593,6 @@ bool shell_sort(const int length, double items[length])
 			if (j != i)
 				items[j] = item_to_insert;
 		}
-		step /= 3;
 	}
 
 	// Retornamos devolvendo `false`, i.e., assinalando o sucesso da
@@ -379,22 +600,64 @@ bool shell_sort(const int length, double items[length])
 	return false;
 }
 
+// #### Rotinas de ordenação de Shell para cada sucessão de incrementos
+//
+// A rotina `shell_sort()` usa a sucessão de Knuth, que foi a usada
+// originalmente neste módulo, começando pelo mesmo incremento que a
+// implementação original (ver `knuth_number_of_gaps()`).
+bool shell_sort(const int length, double items[length])
+{
+	return shell_sort_with_gaps(length, items,
+				    knuth_number_of_gaps(length), knuth_gaps);
+}
+
+bool shell_sort_ciura(const int length, double items[length])
+{
+	return shell_sort_with_gaps(length, items,
+				    NUMBER_OF_GAPS(ciura_gaps), ciura_gaps);
+}
+
+bool shell_sort_tokuda(const int length, double items[length])
+{
+	return shell_sort_with_gaps(length, items,
+				    NUMBER_OF_GAPS(tokuda_gaps), tokuda_gaps);
+}
+
+bool shell_sort_sedgewick(const int length, double items[length])
+{
+	return shell_sort_with_gaps(length, items,
+				    NUMBER_OF_GAPS(sedgewick_gaps),
+				    sedgewick_gaps);
+}
+
+bool shell_sort_pratt(const int length, double items[length])
+{
+	return shell_sort_with_gaps(length, items,
+				    NUMBER_OF_GAPS(pratt_gaps), pratt_gaps);
+}
+
 // ### Ordenação de Shell ou _Shell sort_ (com contagem de operações)
-bool shell_sort_and_count(const int length, double items[length],
-			struct algorithm_counts* counts)
+bool shell_sort_with_gaps_and_count(const int length, double items[length],
+				    const int number_of_gaps,
+				    const int gaps[number_of_gaps],
+				    struct algorithm_counts* counts)
 {
 	assert(length >= 0);
 	assert(length == 0 || items != NULL);
 	assert(length == 0 || counts != NULL);
+	assert(number_of_gaps > 0);
+	assert(gaps != NULL);
+	assert(gaps[0] == 1);
 
 	if (length <= 1)
 		return false;
 
-	int step = 1;
-	while (step < length / 3)
-		step = 3 * step + 1;
+	int g = 0;
+	while (g != number_of_gaps - 1 && gaps[g + 1] < length)
+		g++;
 
-	while (step >= 1) {
+	for (; g >= 0; g--) {
+		const int step = gaps[g];
 		for (int i = step; i != length; i++) {
 			counts->copies++;
 			const double item_to_insert = items[i];
@@ -412,51 +675,72 @@ bool shell_sort_and_count(const int length, double items[length],
 				items[j] = item_to_insert;
 			}
 		}
-		step /= 3;
 	}
 
 	return false;
 }
 
+bool shell_sort_and_count(const int length, double items[length],
+			  struct algorithm_counts* counts)
+{
+	return shell_sort_with_gaps_and_count(length, items,
+					      knuth_number_of_gaps(length),
+					      knuth_gaps, counts);
+}
+
+bool shell_sort_ciura_and_count(const int length, double items[length],
+				struct algorithm_counts* counts)
+{
+	return shell_sort_with_gaps_and_count(length, items,
+					      NUMBER_OF_GAPS(ciura_gaps),
+					      ciura_gaps, counts);
+}
+
+bool shell_sort_tokuda_and_count(const int length, double items[length],
+				 struct algorithm_counts* counts)
+{
+	return shell_sort_with_gaps_and_count(length, items,
+					      NUMBER_OF_GAPS(tokuda_gaps),
+					      tokuda_gaps, counts);
+}
+
+bool shell_sort_sedgewick_and_count(const int length, double items[length],
+				    struct algorithm_counts* counts)
+{
+	return shell_sort_with_gaps_and_count(length, items,
+					      NUMBER_OF_GAPS(sedgewick_gaps),
+					      sedgewick_gaps, counts);
+}
+
+bool shell_sort_pratt_and_count(const int length, double items[length],
+				struct algorithm_counts* counts)
+{
+	return shell_sort_with_gaps_and_count(length, items,
+					      NUMBER_OF_GAPS(pratt_gaps),
+					      pratt_gaps, counts);
+}
+
 // ### Ordenação rápida ou _quicksort_
 //
 // A ordenação rápida é implementada recorrendo a um procedimento recursivo de
 // ordenação de um segmento de um _array_ e a uma rotina que invoca o
 // procedimento especificando o _array_ completo como segmento a ordenar.
   
-// #### Procedimento recursivo auxiliar de ordenação rápida
+// #### Procedimento auxiliar de particionamento
 //
-// Procedimento auxiliar que implementa o algoritmo de ordenação rápida sobre o
-// segmento do _array_ `items` (cujo comprimento é `length`) com início no
-// índice `first` e fim no índice `last`. Este procedimento é recursivo.
-static void quicksort_segment(const int length, double items[length],
-			const int first, const int last)
+// Procedimento auxiliar que particiona o segmento do _array_ `items` (cujo
+// comprimento é `length`) com início no índice `first` e fim no índice `last`,
+// que tem de ter pelo menos dois itens. Devolve a posição definitiva do
+// _pivot_. Este procedimento é usado tanto pela ordenação rápida como pela
+// selecção do _n_-ésimo item (ver `nth_element()`).
+static int partition(const int length, double items[length],
+		     const int first, const int last)
 {
-	// ##### Verificação das pré-condições
 	assert(length >= 0);
 	assert(length == 0 || items != NULL);
-	assert(0 <= first);
+	assert(0 <= first && first < last);
 	assert(last < length);
 
-	// ##### Verificação dos casos especiais
-	//
-	// Se o segmento tem um número de itens inferior a dois, não é
-	// necessário fazer nada: está ordenado por natureza.
-	if (first >= last)
-		return;
-
-	// ##### Particionamento do segmento
-	//
-	// Seleccionamos um _pivot_ e particionamos o segmento de modo a colocar
-	// o _pivot_ no seu lugar definitivo, com todos os itens do segmento à
-	// sua esquerda com valor inferior ou igual ao do _pivot_ e todos os
-	// itens do segmento à sua direita com valor superior ou igual. O
-	// segmento fica, assim, particionado em três partes: (a) sub-segmento
-	// esquerdo, por ordenar, (b) _pivot_ e (c) sub-segmento direito. Depois
-	// deste particionamento, a ordenação total consegue-se ordenando de
-	// forma independente os sub-segmentos esquerdo e direito, usando
-	// exactamente o mesmo algoritmo.
-  
 	// O _pivot_ será o primeiro item do segmento. Para simplificar o ciclo
 	// em `i` do particionamento, em que se procura um item maior ou igual
 	// ao _pivot_ a partir da esquerda, convém garantir que o último item do
@@ -507,24 +791,61 @@ static void quicksort_segment(const int length, double items[length],
 	// partir da direita que tem um valor menor ou igual ao _pivot_, podendo
 	// por isso ser usado como posição definitiva do _pivot_. Se o valor de
 	// `j` for igual a `first`, então o primeiro sub-segmento está vazio e o
-	// _pivot_ está na sua posição correcta, pelo não é necessário trocar a
-	// sua posição nem proceder a qualquer ordenação do sub-segmento
-	// esquerdo.
-	if(j != first) {
+	// _pivot_ está na sua posição correcta, pelo que não é necessário
+	// trocar a sua posição.
+	if(j != first)
 		// Trocamos os valores dos itens `first` e `j`, para que o
 		// _pivot_ fique na posição definitiva, ou seja, na posição `j`.
 		swap(length, items, first, j);
 
-		// ##### Invocação recursiva do algoritmo
-		//
-		// Feito o particionamento, aplica-se recursivamente o mesmo
-		// algoritmo a cada um dos sub-segmentos.
+	return j;
+}
+
+// #### Procedimento recursivo auxiliar de ordenação rápida
+//
+// Procedimento auxiliar que implementa o algoritmo de ordenação rápida sobre o
+// segmento do _array_ `items` (cujo comprimento é `length`) com início no
+// índice `first` e fim no índice `last`. Este procedimento é recursivo.
+static void quicksort_segment(const int length, double items[length],
+			const int first, const int last)
+{
+	// ##### Verificação das pré-condições
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(0 <= first);
+	assert(last < length);
+
+	// ##### Verificação dos casos especiais
+	//
+	// Se o segmento tem um número de itens inferior a dois, não é
+	// necessário fazer nada: está ordenado por natureza.
+	if (first >= last)
+		return;
+
+	// ##### Particionamento do segmento
+	//
+	// Seleccionamos um _pivot_ e particionamos o segmento de modo a colocar
+	// o _pivot_ no seu lugar definitivo, com todos os itens do segmento à
+	// sua esquerda com valor inferior ou igual ao do _pivot_ e todos os
+	// itens do segmento à sua direita com valor superior ou igual (ver
+	// `partition()`). O segmento fica, assim, particionado em três partes:
+	// (a) sub-segmento esquerdo, por ordenar, (b) _pivot_ e (c) sub-segmento
+	// direito. Depois deste particionamento, a ordenação total consegue-se
+	// ordenando de forma independente os sub-segmentos esquerdo e direito,
+	// usando exactamente o mesmo algoritmo.
+	const int j = partition(length, items, first, last);
+
+	// ##### Invocação recursiva do algoritmo
+	//
+	// Feito o particionamento, aplica-se recursivamente o mesmo algoritmo a
+	// cada um dos sub-segmentos. Se o valor de `j` for igual a `first`, o
+	// sub-segmento esquerdo está vazio, e a invocação correspondente
+	// termina imediatamente.
   
-		// Invocação do mesmo algoritmo para ordenação do sub-segmento
-		// esquerdo, entre `first` e `j` - 1. (O _pivot_ está na posição
-		// `j`.)
-		quicksort_segment(length, items, first, j - 1);
-	}
+	// Invocação do mesmo algoritmo para ordenação do sub-segmento esquerdo,
+	// entre `first` e `j` - 1. (O _pivot_ está na posição `j`.)
+	quicksort_segment(length, items, first, j - 1);
+
 	// Invocação do mesmo algoritmo para ordenação do sub-segmento direito,
 	// entre `j` + 1 e `last`. (O _pivot_ está na posição `j`.)
 	quicksort_segment(length, items, j + 1, last);
@@ -552,19 +873,16 @@ bool quicksort(const int length, double items[length])
 
 // ### Ordenação rápida ou _quicksort_ (com contagem de operações)
 
-static void quicksort_segment_and_count(const int length, double items[length],
-					const int first, const int last,
-					struct algorithm_counts* counts)
+static int partition_and_count(const int length, double items[length],
+			       const int first, const int last,
+			       struct algorithm_counts* counts)
 {
 	assert(length >= 0);
 	assert(length == 0 || items != NULL);
 	assert(length == 0 || counts != NULL);
-	assert(0 <= first);
+	assert(0 <= first && first < last);
 	assert(last < length);
 
-	if (first >= last)
-		return;
-
 	int i = first;
 	int j = last + 1;
 	counts->comparisons++;
@@ -583,10 +901,27 @@ static void quicksort_segment_and_count(const int length, double items[length],
 		if (i < j)
 			swap_and_count(length, items, i, j, counts);
 	} while(i < j);
-	if(j != first) {
+	if(j != first)
 		swap_and_count(length, items, first, j, counts);
-		quicksort_segment_and_count(length, items, first, j - 1, counts);
-	}
+
+	return j;
+}
+
+static void quicksort_segment_and_count(const int length, double items[length],
+					const int first, const int last,
+					struct algorithm_counts* counts)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(length == 0 || counts != NULL);
+	assert(0 <= first);
+	assert(last < length);
+
+	if (first >= last)
+		return;
+
+	const int j = partition_and_count(length, items, first, last, counts);
+	quicksort_segment_and_count(length, items, first, j - 1, counts);
 	quicksort_segment_and_count(length, items, j + 1, last, counts);
 }
 
@@ -685,9 +1020,13 @@ static void merge(const int length, double items[length],
 	// qualquer efeito. Para evitar a realização de duas cópias dos valores
 	// destes itens, primeiro para o _array_ auxiliar, depois para o _array_
 	// a ordenar, copiamos estes itens para a sua posição no _array_ a
-	// ordenar, a partir da posição dada por `k`.
-	for (int m = k; i <= middle; i++, m++)
-		items[m] = items[i];
+	// ordenar, a partir da posição dada por `k`. Como o segundo sub-segmento
+	// se esgotou, estes itens ocupam as posições entre `k` e `right`. A
+	// origem e o destino da cópia podem sobrepor-se, estando o destino à
+	// direita da origem, pelo que a cópia tem de ser feita da direita para
+	// a esquerda.
+	for (int m = right, n = middle; n >= i; n--, m--)
+		items[m] = items[n];
 
 	// Da mesma forma, o segundo sub-segmento do _array_ pode não ter sido
 	// esgotado no ciclo original. Se isso aconteceu, então os itens desse
@@ -750,8 +1089,10 @@ static void merge_sort_segment(const int length,
 // #### Rotina de ordenação por fusão
   
 // Esta rotina não é recursiva, recorrendo ao procedimento recursivo definido
-// acima para efectuar a ordenação por fusão.
-bool merge_sort(const int length, double items[length])
+// acima para efectuar a ordenação por fusão. O _array_ auxiliar é reservado na
+// arena `arena` ou, se esta for `NULL`, reservado dinamicamente.
+bool merge_sort_with_arena(const int length, double items[length],
+			   struct scratch_arena *const arena)
 {
 	assert(length >= 0);
 	assert(length == 0 || items != NULL);
@@ -762,7 +1103,7 @@ bool merge_sort(const int length, double items[length])
 		return false;
 
 	// Construímos um _array_ auxiliar que será usado durante a fusão.
-	double *const temporary = new_double_array_of(length);
+	double *const temporary = new_temporary_array(arena, length);
 
 	// Verificamos a construção do novo _array_ teve sucesso.
 	if (temporary == NULL)
@@ -775,13 +1116,19 @@ bool merge_sort(const int length, double items[length])
 	merge_sort_segment(length, items, temporary, 0, length - 1);
 
 	// Libertamos o _array_ auxiliar.
-	free(temporary);
+	free_temporary_array(arena, temporary);
 
 	// Retornamos devolvendo `false`, i.e., assinalando o sucesso da
 	// ordenação.
 	return false;
 }
 
+// Esta rotina usa a arena definida através de `set_sorting_scratch_arena()`.
+bool merge_sort(const int length, double items[length])
+{
+	return merge_sort_with_arena(length, items, sorting_scratch_arena);
+}
+
 // ### Ordenação por fusão ou _merge sort_ (com contagem de operações)
 
 static void merge_and_count(const int length, double items[length],
@@ -847,8 +1194,9 @@ static void merge_sort_segment_and_count(const int length,
 	merge_and_count(length, items, temporary, left, middle, right, counts);
 }
 
-bool merge_sort_and_count(const int length, double items[length],
-			struct algorithm_counts* counts)
+bool merge_sort_with_arena_and_count(const int length, double items[length],
+				     struct scratch_arena *const arena,
+				     struct algorithm_counts* counts)
 {
 	assert(length >= 0);
 	assert(length == 0 || items != NULL);
@@ -857,7 +1205,7 @@ bool merge_sort_and_count(const int length, double items[length],
 	if (length <= 1)
 		return false;
 
-	double *const temporary = new_double_array_of(length);
+	double *const temporary = new_temporary_array(arena, length);
 
 	if (temporary == NULL)
 		return true;
@@ -865,7 +1213,1134 @@ bool merge_sort_and_count(const int length, double items[length],
 	merge_sort_segment_and_count(length, items, temporary, 0, length - 1,
 				counts);
 
-	free(temporary);
+	free_temporary_array(arena, temporary);
+
+	return false;
+}
+
+bool merge_sort_and_count(const int length, double items[length],
+			struct algorithm_counts* counts)
+{
+	return merge_sort_with_arena_and_count(length, items,
+					       sorting_scratch_arena, counts);
+}
+
+// ### Ordenação por monte ou _heapsort_
+//
+// A ordenação por monte é implementada recorrendo a:
+//
+// - um procedimento auxiliar `sift_down()`, não recursivo, que coloca um valor
+//   na sua posição correcta num monte (_heap_) cuja raiz está «vazia», e
+// - uma rotina `heap_sort()`, não recursiva, que começa por transformar o
+//   _array_ a ordenar num monte e que depois retira repetidamente o maior dos
+//   itens do monte, colocando-o na sua posição definitiva no final do _array_.
+//
+// Um monte (máximo) é uma árvore em que o valor de cada nó é maior ou igual ao
+// valor de cada um dos seus filhos. Na ordenação por monte clássica a árvore é
+// binária e está guardada no próprio _array_: os filhos do item com índice `i`
+// são os itens com índices 2`i` + 1 e 2`i` + 2. Ao contrário da ordenação
+// rápida, esta ordenação garante um tempo de execução proporcional a _n_ log
+// _n_ no pior caso e, ao contrário da ordenação por fusão, não precisa de
+// qualquer _array_ auxiliar.
+
+// #### Procedimento auxiliar de afundamento
+//
+// Procedimento auxiliar que coloca o valor `item` na sua posição correcta no
+// monte formado pelos primeiros `heap_length` itens do _array_ `items` (cujo
+// comprimento é `length`), admitindo que a sub-árvore com raiz no índice
+// `hole` é um monte com excepção da própria raiz, cujo valor original já não
+// interessa (é um «buraco»).
+//
+// Usa-se a variante de Floyd (_bottom-up heapsort_): em vez de comparar o
+// valor a colocar com o maior dos filhos em cada nível, desce-se primeiro até
+// uma folha seguindo sempre o maior dos filhos, o que exige apenas uma
+// comparação por nível, e só depois se sobe a partir dessa folha à procura da
+// posição do valor. Como o valor a colocar vem quase sempre do fundo do monte,
+// a subida é normalmente muito curta, pelo que se poupa quase metade das
+// comparações.
+static void sift_down(const int length, double items[length],
+		      const int heap_length, const int hole, const double item)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(0 <= heap_length && heap_length <= length);
+	assert(0 <= hole && hole < heap_length);
+
+	// ##### Descida até uma folha
+	//
+	// Percorremos o caminho que vai do buraco até uma folha escolhendo
+	// sempre o maior dos filhos. No final, `i` é o índice dessa folha.
+	int i = hole;
+	int child;
+	while ((child = 2 * i + 1) < heap_length) {
+		if (child + 1 < heap_length && items[child] < items[child + 1])
+			child++;
+		i = child;
+	}
+
+	// ##### Subida até à posição do valor a colocar
+	//
+	// Subimos pelo mesmo caminho enquanto o valor a colocar for maior do
+	// que o valor do item em que nos encontramos. No final, `i` é o índice
+	// onde o valor a colocar deve ficar.
+	while (i > hole && items[i] < item)
+		i = (i - 1) / 2;
+
+	// ##### Deslocação dos itens do caminho
+	//
+	// Colocamos o valor em `i` e fazemos subir um nível cada um dos itens
+	// do caminho entre `i` e o buraco, que fica assim preenchido.
+	double displaced_item = item;
+	while (i > hole) {
+		const double original_item_i = items[i];
+		items[i] = displaced_item;
+		displaced_item = original_item_i;
+		i = (i - 1) / 2;
+	}
+	items[hole] = displaced_item;
+}
+
+// #### Rotina de ordenação por monte
+bool heap_sort(const int length, double items[length])
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+
+	// _Arrays_ vazios ou com apenas um item estão sempre ordenados, pelo
+	// que podemos terminar a execução da rotina.
+	if (length <= 1)
+		return false;
+
+	// Construímos o monte de baixo para cima: as folhas são montes por
+	// natureza, pelo que basta afundar o valor de cada um dos nós
+	// interiores, do último (o pai do último item) até à raiz.
+	for (int i = length / 2 - 1; i >= 0; i--)
+		sift_down(length, items, length, i, items[i]);
+
+	// A variável `heap_length` guarda o número de itens que ainda fazem
+	// parte do monte. Conceptualmente, o _array_ está dividido em dois
+	// segmentos. O monte ocupa o segmento inicial, com `heap_length` itens.
+	// O segmento final contém os itens já na sua posição definitiva. Em
+	// cada iteração, a raiz do monte, que é o seu maior item, troca de
+	// lugar com o último item do monte, que passa para o segmento final.
+	for (int heap_length = length - 1; heap_length != 0; heap_length--) {
+		const double item = items[heap_length];
+		items[heap_length] = items[0];
+		sift_down(length, items, heap_length, 0, item);
+	}
+
+	// Retornamos devolvendo `false`, i.e., assinalando o sucesso da
+	// ordenação.
+	return false;
+}
+
+// ### Ordenação por monte ou _heapsort_ (com contagem de operações)
+
+static void sift_down_and_count(const int length, double items[length],
+				const int heap_length, const int hole,
+				const double item,
+				struct algorithm_counts* counts)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(length == 0 || counts != NULL);
+	assert(0 <= heap_length && heap_length <= length);
+	assert(0 <= hole && hole < heap_length);
+
+	int i = hole;
+	int child;
+	while ((child = 2 * i + 1) < heap_length) {
+		if (child + 1 < heap_length) {
+			counts->comparisons++;
+			if (items[child] < items[child + 1])
+				child++;
+		}
+		i = child;
+	}
+
+	while (i > hole) {
+		counts->comparisons++;
+		if (!(items[i] < item))
+			break;
+		i = (i - 1) / 2;
+	}
+
+	double displaced_item = item;
+	while (i > hole) {
+		counts->copies += 3;
+		const double original_item_i = items[i];
+		items[i] = displaced_item;
+		displaced_item = original_item_i;
+		i = (i - 1) / 2;
+	}
+	counts->copies++;
+	items[hole] = displaced_item;
+}
+
+bool heap_sort_and_count(const int length, double items[length],
+			 struct algorithm_counts* counts)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(length == 0 || counts != NULL);
+
+	if (length <= 1)
+		return false;
+
+	for (int i = length / 2 - 1; i >= 0; i--) {
+		counts->copies++;
+		sift_down_and_count(length, items, length, i, items[i], counts);
+	}
+
+	for (int heap_length = length - 1; heap_length != 0; heap_length--) {
+		counts->copies += 2;
+		const double item = items[heap_length];
+		items[heap_length] = items[0];
+		sift_down_and_count(length, items, heap_length, 0, item, counts);
+	}
 
 	return false;
 }
+
+// ### Ordenação por monte _d_-ário
+//
+// Num monte _d_-ário cada nó tem até `arity` filhos, em vez de apenas dois. O
+// monte fica menos profundo (log<sub>_d_</sub> _n_ níveis em vez de log<sub>2
+// </sub> _n_), pelo que a descida até às folhas visita menos níveis e, por
+// isso, menos linhas de _cache_. Em contrapartida, em cada nível é necessário
+// comparar os `arity` filhos entre si.
+//
+// Para que os irmãos partilhem a mesma linha de _cache_, usamos uma disposição
+// ligeiramente diferente da clássica: os filhos do nó com índice `i` &gt; 0 são
+// os itens com índices entre `arity` × `i` e `arity` × `i` + `arity` - 1, e os
+// filhos da raiz são os itens com índices entre 1 e `arity` - 1. Desta forma,
+// cada grupo de irmãos (excepto o da raiz) começa num índice múltiplo de
+// `arity`. Com `arity` igual a 8 e um _array_ alinhado em 64 _bytes_, os oito
+// irmãos ocupam exactamente uma linha de _cache_ de 64 _bytes_. Com esta
+// disposição, o pai do item com índice `i` é simplesmente o item com índice
+// `i` / `arity`.
+
+// #### Procedimento auxiliar de afundamento num monte _d_-ário
+//
+// Procedimento em tudo semelhante a `sift_down()`, mas que lida com montes
+// _d_-ários. O índice do primeiro filho de `i` só é calculado depois de se
+// saber que o nó tem filhos, de modo a evitar transbordamentos na
+// multiplicação.
+static void d_ary_sift_down(const int length, double items[length],
+			    const int arity, const int heap_length,
+			    const int hole, const double item)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(arity >= 2);
+	assert(0 <= heap_length && heap_length <= length);
+	assert(0 <= hole && hole < heap_length);
+
+	// Descida até uma folha seguindo sempre o maior dos filhos.
+	int i = hole;
+	while (i == 0 ? heap_length > 1 : i <= (heap_length - 1) / arity) {
+		const int first_child = i == 0 ? 1 : arity * i;
+		int last_child = arity * i + arity - 1;
+		if (last_child >= heap_length)
+			last_child = heap_length - 1;
+		int largest_child = first_child;
+		for (int child = first_child + 1; child <= last_child; child++)
+			if (items[largest_child] < items[child])
+				largest_child = child;
+		i = largest_child;
+	}
+
+	// Subida até à posição do valor a colocar.
+	while (i > hole && items[i] < item)
+		i /= arity;
+
+	// Deslocação dos itens do caminho.
+	double displaced_item = item;
+	while (i > hole) {
+		const double original_item_i = items[i];
+		items[i] = displaced_item;
+		displaced_item = original_item_i;
+		i /= arity;
+	}
+	items[hole] = displaced_item;
+}
+
+// #### Procedimento auxiliar de ordenação por monte _d_-ário
+//
+// Procedimento auxiliar que ordena o _array_ `items` usando um monte com
+// aridade `arity`. As rotinas públicas limitam-se a invocá-lo com uma aridade
+// constante, o que permite ao compilador especializá-lo para cada caso.
+static void d_ary_heap_sort(const int length, double items[length],
+			    const int arity)
+{
+	assert(length >= 2);
+	assert(items != NULL);
+	assert(arity >= 2);
+
+	// O último nó interior é o pai do último item do _array_.
+	for (int i = (length - 1) / arity; i >= 0; i--)
+		d_ary_sift_down(length, items, arity, length, i, items[i]);
+
+	for (int heap_length = length - 1; heap_length != 0; heap_length--) {
+		const double item = items[heap_length];
+		items[heap_length] = items[0];
+		d_ary_sift_down(length, items, arity, heap_length, 0, item);
+	}
+}
+
+// #### Rotinas de ordenação por monte 4-ário e 8-ário
+//
+// Com _arrays_ de `double`, quatro irmãos ocupam 32 _bytes_ e oito irmãos
+// ocupam 64 _bytes_, ou seja, meia linha e uma linha de _cache_ completa,
+// respectivamente, na generalidade dos processadores actuais.
+bool quaternary_heap_sort(const int length, double items[length])
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+
+	if (length <= 1)
+		return false;
+
+	d_ary_heap_sort(length, items, 4);
+
+	return false;
+}
+
+bool octonary_heap_sort(const int length, double items[length])
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+
+	if (length <= 1)
+		return false;
+
+	d_ary_heap_sort(length, items, 8);
+
+	return false;
+}
+
+// ### Ordenação por monte _d_-ário (com contagem de operações)
+
+static void d_ary_sift_down_and_count(const int length, double items[length],
+				      const int arity, const int heap_length,
+				      const int hole, const double item,
+				      struct algorithm_counts* counts)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(length == 0 || counts != NULL);
+	assert(arity >= 2);
+	assert(0 <= heap_length && heap_length <= length);
+	assert(0 <= hole && hole < heap_length);
+
+	int i = hole;
+	while (i == 0 ? heap_length > 1 : i <= (heap_length - 1) / arity) {
+		const int first_child = i == 0 ? 1 : arity * i;
+		int last_child = arity * i + arity - 1;
+		if (last_child >= heap_length)
+			last_child = heap_length - 1;
+		int largest_child = first_child;
+		for (int child = first_child + 1; child <= last_child; child++) {
+			counts->comparisons++;
+			if (items[largest_child] < items[child])
+				largest_child = child;
+		}
+		i = largest_child;
+	}
+
+	while (i > hole) {
+		counts->comparisons++;
+		if (!(items[i] < item))
+			break;
+		i /= arity;
+	}
+
+	double displaced_item = item;
+	while (i > hole) {
+		counts->copies += 3;
+		const double original_item_i = items[i];
+		items[i] = displaced_item;
+		displaced_item = original_item_i;
+		i /= arity;
+	}
+	counts->copies++;
+	items[hole] = displaced_item;
+}
+
+static void d_ary_heap_sort_and_count(const int length, double items[length],
+				      const int arity,
+				      struct algorithm_counts* counts)
+{
+	assert(length >= 2);
+	assert(items != NULL);
+	assert(counts != NULL);
+	assert(arity >= 2);
+
+	for (int i = (length - 1) / arity; i >= 0; i--) {
+		counts->copies++;
+		d_ary_sift_down_and_count(length, items, arity, length, i,
+					  items[i], counts);
+	}
+
+	for (int heap_length = length - 1; heap_length != 0; heap_length--) {
+		counts->copies += 2;
+		const double item = items[heap_length];
+		items[heap_length] = items[0];
+		d_ary_sift_down_and_count(length, items, arity, heap_length, 0,
+					  item, counts);
+	}
+}
+
+bool quaternary_heap_sort_and_count(const int length, double items[length],
+				    struct algorithm_counts* counts)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(length == 0 || counts != NULL);
+
+	if (length <= 1)
+		return false;
+
+	d_ary_heap_sort_and_count(length, items, 4, counts);
+
+	return false;
+}
+
+bool octonary_heap_sort_and_count(const int length, double items[length],
+				  struct algorithm_counts* counts)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(length == 0 || counts != NULL);
+
+	if (length <= 1)
+		return false;
+
+	d_ary_heap_sort_and_count(length, items, 8, counts);
+
+	return false;
+}
+
+// ### Ordenação na presença de NaN
+//
+// Todas as comparações envolvendo um NaN são falsas (ver
+// [`nans_and_other_oddities.c`](../nans_and_other_oddities/nans_and_other_oddities.c.html)).
+// Os algoritmos de ordenação acima admitem que os itens a ordenar não incluem
+// NaN. Se os incluírem, o resultado não faz sentido e, no caso da ordenação
+// rápida, cujos ciclos de particionamento usam o _pivot_ e o último item como
+// sentinelas, pode mesmo haver acessos fora dos limites do _array_.
+//
+// Em vez de complicar cada algoritmo, e de tornar mais lentas as suas
+// comparações, agrupam-se primeiro os NaN nos extremos do _array_ e ordenam-se
+// depois os restantes itens com o algoritmo pretendido, sem alterações. Uma
+// primeira passagem, vectorial, conta os NaN. Se não houver nenhum, o que é o
+// caso habitual, o custo adicional limita-se a essa passagem. No caso
+// contrário, uma segunda passagem agrupa-os, trocando-os com os restantes
+// itens, como no problema da bandeira holandesa.
+//
+// A ordem total da norma IEEE 754 (`totalOrder`) exige ainda que os NaN com
+// sinal negativo fiquem antes de todos os outros itens e que o zero negativo
+// fique antes do zero positivo. Depois de ordenados os restantes itens, os
+// zeros estão todos juntos, pelo que basta reescrevê-los pela ordem certa.
+
+// Procedimento auxiliar que agrupa os NaN do _array_ `items`. Se `by_sign` for
+// `true`, os NaN com sinal negativo ficam no início do _array_. Os restantes
+// ficam no fim. Coloca em `*first` e `*last` os limites do segmento de itens
+// que não são NaN, sendo `*first` o índice do seu primeiro item e `*last` o
+// índice do item seguinte ao seu último item.
+static void group_nans(const int length, double items[length],
+		       const bool by_sign, int *const first, int *const last)
+{
+	*first = 0;
+	*last = length;
+
+	if (double_array_nan_count(length, items) == 0L)
+		return;
+
+	// Os itens nos índices em [0, `*first`[ são NaN negativos, em
+	// [`*first`, `i`[ não são NaN, em [`i`, `*last`[ estão por classificar
+	// e em [`*last`, `length`[ são NaN positivos (ou todos os NaN
+	// restantes, se `by_sign` for `false`).
+	int i = 0;
+	while (i != *last)
+		if (items[i] == items[i])
+			i++;
+		else if (by_sign && signbit(items[i]))
+			swap(length, items, (*first)++, i++);
+		else
+			swap(length, items, i, --*last);
+}
+
+static void group_nans_and_count(const int length, double items[length],
+				 const bool by_sign, int *const first,
+				 int *const last,
+				 struct algorithm_counts* counts)
+{
+	*first = 0;
+	*last = length;
+
+	counts->comparisons += length;
+	if (double_array_nan_count(length, items) == 0L)
+		return;
+
+	int i = 0;
+	while (i != *last) {
+		counts->comparisons++;
+		if (items[i] == items[i])
+			i++;
+		else if (by_sign && signbit(items[i]))
+			swap_and_count(length, items, (*first)++, i++, counts);
+		else
+			swap_and_count(length, items, i, --*last, counts);
+	}
+}
+
+// Procedimento auxiliar que coloca os zeros negativos antes dos zeros positivos
+// no segmento ordenado do _array_ `items` com início no índice `first` e fim
+// antes do índice `last`. O início dos zeros é encontrado por pesquisa
+// binária. Devolve o número de comparações realizadas.
+static long order_zeros(const int length, double items[length],
+			const int first, const int last)
+{
+	long comparisons = 0L;
+
+	int low = first;
+	int high = last;
+	while (low < high) {
+		const int middle = low + (high - low) / 2;
+		comparisons++;
+		if (items[middle] < 0.0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	int negative_zeros = 0;
+	int end = low;
+	while (end != last && items[end] == 0.0) {
+		comparisons++;
+		negative_zeros += signbit(items[end]) != 0;
+		end++;
+	}
+
+	for (int i = low; i != end; i++)
+		items[i] = i < low + negative_zeros ? -0.0 : 0.0;
+
+	return comparisons;
+}
+
+bool sort_handling_nans(bool (*const sort)(int, double[]),
+			const enum nan_handling handling, const int length,
+			double items[length])
+{
+	assert(sort != NULL);
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+
+	if (handling == no_nan_handling)
+		return sort(length, items);
+
+	const bool total_order = handling == total_order_nan_handling;
+
+	int first;
+	int last;
+	group_nans(length, items, total_order, &first, &last);
+
+	if (sort(last - first, items + first))
+		return true;
+
+	if (total_order)
+		order_zeros(length, items, first, last);
+
+	return false;
+}
+
+bool sort_handling_nans_and_count(bool (*const sort_and_count)(int, double[],
+						struct algorithm_counts*),
+				  const enum nan_handling handling,
+				  const int length, double items[length],
+				  struct algorithm_counts* counts)
+{
+	assert(sort_and_count != NULL);
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(counts != NULL);
+
+	if (handling == no_nan_handling)
+		return sort_and_count(length, items, counts);
+
+	const bool total_order = handling == total_order_nan_handling;
+
+	int first;
+	int last;
+	group_nans_and_count(length, items, total_order, &first, &last,
+			     counts);
+
+	if (sort_and_count(last - first, items + first, counts))
+		return true;
+
+	if (total_order)
+		counts->comparisons += order_zeros(length, items, first, last);
+
+	return false;
+}
+
+// ### Selecção
+//
+// As rotinas de selecção obtêm os menores itens de um _array_ sem o ordenar por
+// completo, reutilizando o particionamento da ordenação rápida e os montes
+// binários da ordenação por monte:
+//
+// - `nth_element()` coloca na posição _n_ o item que lá estaria se o _array_
+//   estivesse ordenado, com os itens anteriores não superiores e os seguintes
+//   não inferiores. Usa a selecção introspectiva (_introselect_): particiona
+//   sucessivamente apenas o segmento que contém a posição _n_, escolhendo para
+//   _pivot_ a mediana de três, e, se o número de particionamentos exceder o
+//   dobro do logaritmo do comprimento (o que só acontece em casos
+//   patológicos), ordena o segmento restante por monte. O tempo é O(_n_) em
+//   média e O(_n_ log _n_) no pior caso.
+//
+// - `partial_sort()` coloca por ordem os _k_ menores itens no início do
+//   _array_. Mantém um monte máximo com os _k_ menores itens encontrados até
+//   ao momento, substituindo a sua raiz sempre que surge um item menor, e
+//   ordena o monte no fim. O tempo é O(_n_ log _k_).
+//
+// - `read_smallest_from()` faz o mesmo que `partial_sort()`, mas sobre os
+//   itens lidos de um ficheiro, à medida que são lidos, pelo que requer apenas
+//   memória para _k_ itens, qualquer que seja a dimensão do ficheiro.
+
+// Procedimento auxiliar que ordena o monte máximo formado pelos primeiros
+// `heap_length` itens do _array_ `items`, retirando sucessivamente a sua raiz
+// para o fim do monte, tal como na segunda fase da ordenação por monte.
+static void sort_heap(const int length, double items[length],
+		      const int heap_length)
+{
+	for (int i = heap_length - 1; i > 0; i--) {
+		const double item = items[i];
+		items[i] = items[0];
+		sift_down(length, items, i, 0, item);
+	}
+}
+
+// Procedimento auxiliar que transforma os primeiros `heap_length` itens do
+// _array_ `items` num monte máximo.
+static void make_heap(const int length, double items[length],
+		      const int heap_length)
+{
+	for (int i = heap_length / 2 - 1; i >= 0; i--)
+		sift_down(length, items, heap_length, i, items[i]);
+}
+
+// Procedimento auxiliar que coloca na posição `first` a mediana dos itens nas
+// posições `first`, `middle` e `last`, garantindo ainda que o item na posição
+// `last` não é inferior a essa mediana, como requer `partition()`.
+static void move_median_to_first(const int length, double items[length],
+				 const int first, const int middle,
+				 const int last)
+{
+	if (items[middle] < items[first])
+		swap(length, items, first, middle);
+	if (items[last] < items[middle]) {
+		swap(length, items, middle, last);
+		if (items[middle] < items[first])
+			swap(length, items, first, middle);
+	}
+	swap(length, items, first, middle);
+}
+
+// Devolve o maior inteiro _l_ tal que 2<sup>_l_</sup> ≤ `value`, sendo `value`
+// positivo.
+static int floor_log2(int value)
+{
+	int logarithm = 0;
+	while (value > 1) {
+		value /= 2;
+		logarithm++;
+	}
+	return logarithm;
+}
+
+bool nth_element(const int length, double items[length], const int n)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(length == 0 || (0 <= n && n < length));
+
+	int first = 0;
+	int last = length - 1;
+	int remaining_partitions = 2 * floor_log2(length + 1);
+
+	while (first < last) {
+		if (remaining_partitions-- == 0) {
+			heap_sort(last - first + 1, items + first);
+			break;
+		}
+
+		move_median_to_first(length, items, first,
+				     first + (last - first) / 2, last);
+
+		const int j = partition(length, items, first, last);
+
+		if (j == n)
+			break;
+		else if (n < j)
+			last = j - 1;
+		else
+			first = j + 1;
+	}
+
+	return false;
+}
+
+bool partial_sort(const int length, double items[length], const int k)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(0 <= k && k <= length);
+
+	if (k == 0)
+		return false;
+
+	make_heap(length, items, k);
+
+	for (int i = k; i != length; i++)
+		if (items[i] < items[0]) {
+			const double item = items[i];
+			items[i] = items[0];
+			sift_down(length, items, k, 0, item);
+		}
+
+	sort_heap(length, items, k);
+
+	return false;
+}
+
+int read_smallest_from(const char *const file_name, const int k,
+		       double smallest[k])
+{
+	assert(file_name != NULL);
+	assert(k >= 0);
+	assert(k == 0 || smallest != NULL);
+
+	FILE *const file = fopen(file_name, "r");
+	if (file == NULL)
+		return -1;
+
+	// Os primeiros `k` itens lidos são simplesmente guardados. Quando se
+	// completam `k` itens, transformamo-los num monte máximo. A partir daí,
+	// cada item lido que seja menor do que a raiz do monte substitui-a.
+	int count = 0;
+	double item;
+	while (fscanf(file, "%lg", &item) == 1)
+		if (count < k) {
+			smallest[count++] = item;
+			if (count == k)
+				make_heap(k, smallest, k);
+		} else if (k != 0 && item < smallest[0])
+			sift_down(k, smallest, k, 0, item);
+
+	const bool error = ferror(file);
+
+	fclose(file);
+
+	if (error)
+		return -1;
+
+	// Se o ficheiro tiver menos de `k` itens, o monte nunca chegou a ser
+	// construído.
+	if (count < k)
+		make_heap(k, smallest, count);
+
+	sort_heap(k, smallest, count);
+
+	return count;
+}
+
+// ### Selecção (com contagem de operações)
+
+static void sort_heap_and_count(const int length, double items[length],
+				const int heap_length,
+				struct algorithm_counts* counts)
+{
+	for (int i = heap_length - 1; i > 0; i--) {
+		counts->copies += 2;
+		const double item = items[i];
+		items[i] = items[0];
+		sift_down_and_count(length, items, i, 0, item, counts);
+	}
+}
+
+static void make_heap_and_count(const int length, double items[length],
+				const int heap_length,
+				struct algorithm_counts* counts)
+{
+	for (int i = heap_length / 2 - 1; i >= 0; i--) {
+		counts->copies++;
+		sift_down_and_count(length, items, heap_length, i, items[i],
+				    counts);
+	}
+}
+
+static void move_median_to_first_and_count(const int length,
+					   double items[length],
+					   const int first, const int middle,
+					   const int last,
+					   struct algorithm_counts* counts)
+{
+	counts->comparisons++;
+	if (items[middle] < items[first])
+		swap_and_count(length, items, first, middle, counts);
+	counts->comparisons++;
+	if (items[last] < items[middle]) {
+		swap_and_count(length, items, middle, last, counts);
+		counts->comparisons++;
+		if (items[middle] < items[first])
+			swap_and_count(length, items, first, middle, counts);
+	}
+	swap_and_count(length, items, first, middle, counts);
+}
+
+bool nth_element_and_count(const int length, double items[length],
+			   const int n, struct algorithm_counts* counts)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(length == 0 || (0 <= n && n < length));
+	assert(counts != NULL);
+
+	int first = 0;
+	int last = length - 1;
+	int remaining_partitions = 2 * floor_log2(length + 1);
+
+	while (first < last) {
+		if (remaining_partitions-- == 0) {
+			heap_sort_and_count(last - first + 1, items + first,
+					    counts);
+			break;
+		}
+
+		move_median_to_first_and_count(length, items, first,
+					       first + (last - first) / 2,
+					       last, counts);
+
+		const int j = partition_and_count(length, items, first, last,
+						  counts);
+
+		if (j == n)
+			break;
+		else if (n < j)
+			last = j - 1;
+		else
+			first = j + 1;
+	}
+
+	return false;
+}
+
+bool partial_sort_and_count(const int length, double items[length],
+			    const int k, struct algorithm_counts* counts)
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(0 <= k && k <= length);
+	assert(counts != NULL);
+
+	if (k == 0)
+		return false;
+
+	make_heap_and_count(length, items, k, counts);
+
+	for (int i = k; i != length; i++) {
+		counts->comparisons++;
+		if (items[i] < items[0]) {
+			counts->copies += 2;
+			const double item = items[i];
+			items[i] = items[0];
+			sift_down_and_count(length, items, k, 0, item, counts);
+		}
+	}
+
+	sort_heap_and_count(length, items, k, counts);
+
+	return false;
+}
+
+int read_smallest_from_and_count(const char *const file_name, const int k,
+				 double smallest[k],
+				 struct algorithm_counts* counts)
+{
+	assert(file_name != NULL);
+	assert(k >= 0);
+	assert(k == 0 || smallest != NULL);
+	assert(counts != NULL);
+
+	FILE *const file = fopen(file_name, "r");
+	if (file == NULL)
+		return -1;
+
+	int count = 0;
+	double item;
+	while (fscanf(file, "%lg", &item) == 1)
+		if (count < k) {
+			counts->copies++;
+			smallest[count++] = item;
+			if (count == k)
+				make_heap_and_count(k, smallest, k, counts);
+		} else if (k != 0) {
+			counts->comparisons++;
+			if (item < smallest[0])
+				sift_down_and_count(k, smallest, k, 0, item,
+						    counts);
+		}
+
+	const bool error = ferror(file);
+
+	fclose(file);
+
+	if (error)
+		return -1;
+
+	if (count < k)
+		make_heap_and_count(k, smallest, count, counts);
+
+	sort_heap_and_count(k, smallest, count, counts);
+
+	return count;
+}
+
+// ### Ordenação indirecta (_argsort_ e _rank_)
+//
+// A ordenação indirecta é feita sobre palavras que empacotam a chave de cada
+// item e o seu índice, de modo a que a ordenação não precise de aceder aos
+// itens através dos índices (o que, para _arrays_ grandes, resultaria num
+// acesso aleatório à memória por cada comparação). As chaves são os padrões
+// de _bits_ dos itens, transformados de modo a que a sua ordem enquanto
+// inteiros sem sinal coincida com a ordem dos `double`: nos valores positivos
+// liga-se o _bit_ de sinal e nos negativos invertem-se todos os _bits_. As
+// palavras são ordenadas por dispersão (_radix sort_ LSD), _byte_ a _byte_,
+// começando pelo menos significativo.
+
+// Palavra de 128 _bits_ usada quando a chave precisa dos 64 _bits_ do `double`.
+struct keyed_position {
+	uint64_t key;
+	uint32_t index;
+	uint32_t padding;
+};
+
+// Devolve a chave de 64 _bits_ do item `item`.
+static inline uint64_t ordered_bits_of(const double item)
+{
+	uint64_t bits;
+	memcpy(&bits, &item, sizeof(bits));
+	return bits >> 63 ? ~bits : bits | (UINT64_C(1) << 63);
+}
+
+// Devolve a chave de 32 _bits_ do item `item`, que tem de ser representável
+// exactamente como `float`.
+static inline uint32_t ordered_float_bits_of(const double item)
+{
+	const float narrow = (float)item;
+	uint32_t bits;
+	memcpy(&bits, &narrow, sizeof(bits));
+	return bits >> 31 ? ~bits : bits | (UINT32_C(1) << 31);
+}
+
+// Predicado que devolve `true` se todos os itens de `items` forem
+// representáveis exactamente como `float`. Os NaN falham a comparação, pelo
+// que levam ao uso de palavras de 128 _bits_.
+static bool all_fit_float(const int length, const double items[length])
+{
+	int i = 0;
+	while (i != length && (double)(float)items[i] == items[i])
+		i++;
+	return i == length;
+}
+
+// Acumula nos histogramas `counts` os _bytes_ `first_byte` a `last_byte`
+// (inclusive) da chave `key`. É invocado durante a construção das palavras, de
+// modo a que os histogramas de todas as passagens sejam calculados sem
+// percorrer de novo as palavras.
+static inline void count_key_bytes(const uint64_t key, const int first_byte,
+				   const int last_byte, int counts[8][256])
+{
+	for (int b = first_byte; b <= last_byte; b++)
+		counts[b][(key >> (8 * b)) & 0xFF]++;
+}
+
+// Transforma os histogramas dos _bytes_ `first_byte` a `last_byte` de `counts`
+// nas posições iniciais de cada valor do _byte_ no resultado de cada passagem.
+// Assinala em `skip` as passagens que podem ser omitidas, por todas as
+// `length` chaves terem o mesmo valor no _byte_ correspondente.
+static void prepare_radix_passes(const int length, const int first_byte,
+				 const int last_byte, int counts[8][256],
+				 bool skip[8])
+{
+	for (int b = first_byte; b <= last_byte; b++) {
+		int total = 0;
+		skip[b] = false;
+		for (int v = 0; v != 256; v++) {
+			const int count = counts[b][v];
+			skip[b] = skip[b] || count == length;
+			counts[b][v] = total;
+			total += count;
+		}
+	}
+}
+
+// Ordena por dispersão as `length` palavras de 64 _bits_ de `words` pelos seus
+// _bytes_ `first_byte` a `last_byte`, usando o _array_ auxiliar `temporary`,
+// com o mesmo comprimento, e os histogramas `counts` desses _bytes_, calculados
+// através de `count_key_bytes()`. O resultado fica sempre em `words`.
+static void radix_sort_words(const int length, uint64_t words[length],
+			     uint64_t temporary[length], const int first_byte,
+			     const int last_byte, int counts[8][256])
+{
+	bool skip[8];
+	prepare_radix_passes(length, first_byte, last_byte, counts, skip);
+
+	uint64_t *source = words;
+	uint64_t *destination = temporary;
+
+	for (int b = first_byte; b <= last_byte; b++) {
+		if (skip[b])
+			continue;
+		for (int i = 0; i != length; i++) {
+			const uint64_t word = source[i];
+			destination[counts[b][(word >> (8 * b)) & 0xFF]++] = word;
+		}
+		uint64_t *const swapped = source;
+		source = destination;
+		destination = swapped;
+	}
+
+	if (source != words)
+		memcpy(words, source, length * sizeof(uint64_t));
+}
+
+// Ordena por dispersão as `length` palavras de 128 _bits_ de `pairs` pelas suas
+// chaves, usando o _array_ auxiliar `temporary`, com o mesmo comprimento, e os
+// histogramas `counts` dos oito _bytes_ das chaves. O resultado fica sempre em
+// `pairs`.
+static void radix_sort_pairs(const int length,
+			     struct keyed_position pairs[length],
+			     struct keyed_position temporary[length],
+			     int counts[8][256])
+{
+	bool skip[8];
+	prepare_radix_passes(length, 0, 7, counts, skip);
+
+	struct keyed_position *source = pairs;
+	struct keyed_position *destination = temporary;
+
+	for (int b = 0; b != 8; b++) {
+		if (skip[b])
+			continue;
+		for (int i = 0; i != length; i++) {
+			const struct keyed_position pair = source[i];
+			destination[counts[b][(pair.key >> (8 * b)) & 0xFF]++] =
+				pair;
+		}
+		struct keyed_position *const swapped = source;
+		source = destination;
+		destination = swapped;
+	}
+
+	if (source != pairs)
+		memcpy(pairs, source, length * sizeof(struct keyed_position));
+}
+
+bool argsort_double(const int length, const double items[length],
+		    int permutation[length])
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(length == 0 || permutation != NULL);
+
+	if (length > INT_MAX / 4)
+		return true;
+
+	if (length <= 1) {
+		if (length == 1)
+			permutation[0] = 0;
+		return false;
+	}
+
+	int counts[8][256] = { { 0 } };
+
+	// Se todos os itens couberem num `float`, empacotamos a chave de 32
+	// _bits_ na metade mais significativa de uma palavra de 64 _bits_ e o
+	// índice na menos significativa. Como as palavras são construídas por
+	// ordem crescente de índice e a ordenação é estável, basta ordenar pelos
+	// quatro _bytes_ da chave.
+	if (all_fit_float(length, items)) {
+		uint64_t *const words = (uint64_t *)
+			new_temporary_array(sorting_scratch_arena, 2 * length);
+		if (words == NULL)
+			return true;
+
+		for (int i = 0; i != length; i++) {
+			words[i] = (uint64_t)ordered_float_bits_of(items[i]) << 32 |
+				(uint32_t)i;
+			count_key_bytes(words[i], 4, 7, counts);
+		}
+
+		radix_sort_words(length, words, words + length, 4, 7, counts);
+
+		for (int i = 0; i != length; i++)
+			permutation[i] = (int)(uint32_t)words[i];
+
+		free_temporary_array(sorting_scratch_arena, (double *)words);
+
+		return false;
+	}
+
+	// Caso contrário, usamos palavras de 128 _bits_, com a chave de 64
+	// _bits_ e o índice.
+	struct keyed_position *const pairs = (struct keyed_position *)
+		new_temporary_array(sorting_scratch_arena, 4 * length);
+	if (pairs == NULL)
+		return true;
+
+	for (int i = 0; i != length; i++) {
+		pairs[i].key = ordered_bits_of(items[i]);
+		pairs[i].index = (uint32_t)i;
+		count_key_bytes(pairs[i].key, 0, 7, counts);
+	}
+
+	radix_sort_pairs(length, pairs, pairs + length, counts);
+
+	for (int i = 0; i != length; i++)
+		permutation[i] = (int)pairs[i].index;
+
+	free_temporary_array(sorting_scratch_arena, (double *)pairs);
+
+	return false;
+}
+
+// A ordem de cada item é a posição do seu índice na permutação que ordena o
+// _array_. Calculamos a permutação num _array_ auxiliar e invertemo-la para
+// `ranks`.
+bool rank_double(const int length, const double items[length],
+		 int ranks[length])
+{
+	assert(length >= 0);
+	assert(length == 0 || items != NULL);
+	assert(length == 0 || ranks != NULL);
+
+	if (length == 0)
+		return false;
+
+	int *const permutation = malloc(length * sizeof(int));
+	if (permutation == NULL)
+		return true;
+
+	const bool error = argsort_double(length, items, permutation);
+
+	if (!error)
+		for (int i = 0; i != length; i++)
+			ranks[permutation[i]] = i;
+
+	free(permutation);
+
+	return error;
+}
@@ -11,9 +11,18 @@
 // - Ordenação por bolha ou _bubble sort_.
 // - Ordenação por selecção ou _selection sort_.
 // - Ordenação por inserção ou _insertion sort_.
-// - Ordenação de Shell ou _Shell sort_.
+// - Ordenação de Shell ou _Shell sort_, com as sucessões de incrementos de
+//   Knuth, Ciura, Tokuda, Sedgewick e Pratt.
 // - Ordenação rápida ou _quicksort_.
 // - Ordenação por fusão ou _merge sort_.
+// - Ordenação por monte ou _heapsort_, quer com montes binários, quer com
+//   montes 4-ários e 8-ários.
+//
+// O módulo fornece também rotinas de selecção dos menores itens (_partial
+// sort_, _nth element_ e _top-k_ sobre um ficheiro) e rotinas de ordenação
+// indirecta, que calculam a
+// permutação que ordena um _array_ (_argsort_) ou a ordem de cada um dos seus
+// itens (_rank_), sem o alterar.
 //
 // Este módulo foi concebido para o estudo da algoritmia. Por isso, para além de
 // uma implementação «normal» de cada um dos algoritmos, existe uma outra que é
@@ -30,8 +39,13 @@
 // `bool` e os seus dois valores `true` e `false`.
 #include <stdbool.h>
 
-// Definições de tipos
-// ===================
+// Declarações e definições de tipos
+// =================================
+
+// Declaração da estrutura que representa uma arena de memória de rascunho (ver
+// [`scratch_arena.h`](scratch_arena.h.html)). As rotinas que precisam de
+// _arrays_ auxiliares podem reservá-los numa destas arenas.
+struct scratch_arena;
 
 // As rotinas de ordenação que registam o número de operações elementares
 // realizadas durante a ordenação de uma _array_ recorrem a esta estrutura para
@@ -72,6 +86,16 @@ extern const struct sorting_algorithm sorting_algorithms[];
 // Esta constante guarda o número de algoritmos considerados.
 extern const int number_of_sorting_algorithms;
 
+// Declaração de rotinas de configuração
+// =====================================
+
+// Procedimento que define a arena de memória de rascunho `arena` como aquela
+// onde as rotinas de ordenação que precisam de _arrays_ auxiliares, e que não
+// recebem uma arena como argumento, os devem reservar. A arena tem de existir
+// enquanto estiver definida. Se `arena` for `NULL` (o valor inicial), os
+// _arrays_ auxiliares são reservados e libertados em cada invocação.
+void set_sorting_scratch_arena(struct scratch_arena *arena);
+
 // Declaração das rotinas de ordenação
 // ===================================
 
@@ -86,16 +110,49 @@ bool selection_sort(int length, double items[length]);
 // Ordenação por inserção ou _insertion sort_.
 bool insertion_sort(int length, double items[length]);
 
-// Ordenação de Shell ou _Shell sort_.
+// Ordenação de Shell ou _Shell sort_ usando os `number_of_gaps` incrementos
+// da tabela `gaps`, que têm de estar por ordem crescente, começando em 1.
+bool shell_sort_with_gaps(int length, double items[length],
+			int number_of_gaps, const int gaps[number_of_gaps]);
+
+// Ordenação de Shell ou _Shell sort_ com a sucessão de incrementos de Knuth
+// (1, 4, 13, 40, ...).
 bool shell_sort(int length, double items[length]);
 
+// Ordenação de Shell ou _Shell sort_ com a sucessão de incrementos de Ciura.
+bool shell_sort_ciura(int length, double items[length]);
+
+// Ordenação de Shell ou _Shell sort_ com a sucessão de incrementos de Tokuda.
+bool shell_sort_tokuda(int length, double items[length]);
+
+// Ordenação de Shell ou _Shell sort_ com a sucessão de incrementos de
+// Sedgewick (1986).
+bool shell_sort_sedgewick(int length, double items[length]);
+
+// Ordenação de Shell ou _Shell sort_ com a sucessão de incrementos de Pratt.
+bool shell_sort_pratt(int length, double items[length]);
+
 // Ordenação rápida ou _quicksort_.
 bool quicksort(int length, double items[length]);
 
 // Ordenação por fusão ou _merge sort_.
 bool merge_sort(int length, double items[length]);
 
-// ### Rotinas sem contagem de operações elementares
+// Ordenação por fusão ou _merge sort_ reservando o _array_ auxiliar na arena
+// `arena` (ou dinamicamente, se `arena` for `NULL`).
+bool merge_sort_with_arena(int length, double items[length],
+			struct scratch_arena *arena);
+
+// Ordenação por monte (binário) ou _heapsort_.
+bool heap_sort(int length, double items[length]);
+
+// Ordenação por monte 4-ário.
+bool quaternary_heap_sort(int length, double items[length]);
+
+// Ordenação por monte 8-ário.
+bool octonary_heap_sort(int length, double items[length]);
+
+// ### Rotinas com contagem de operações elementares
 
 // Ordenação por bolha ou _bubble sort_.
 bool bubble_sort_and_count(int length, double items[length],
@@ -109,10 +166,34 @@ bool selection_sort_and_count(int length, double items[length],
 bool insertion_sort_and_count(int length, double items[length],
 			struct algorithm_counts* counts);
 
-// Ordenação de Shell ou _Shell sort_.
+// Ordenação de Shell ou _Shell sort_ usando os `number_of_gaps` incrementos
+// da tabela `gaps`.
+bool shell_sort_with_gaps_and_count(int length, double items[length],
+				int number_of_gaps,
+				const int gaps[number_of_gaps],
+				struct algorithm_counts* counts);
+
+// Ordenação de Shell ou _Shell sort_ com a sucessão de incrementos de Knuth.
 bool shell_sort_and_count(int length, double items[length],
 			struct algorithm_counts* counts);
 
+// Ordenação de Shell ou _Shell sort_ com a sucessão de incrementos de Ciura.
+bool shell_sort_ciura_and_count(int length, double items[length],
+				struct algorithm_counts* counts);
+
+// Ordenação de Shell ou _Shell sort_ com a sucessão de incrementos de Tokuda.
+bool shell_sort_tokuda_and_count(int length, double items[length],
+				struct algorithm_counts* counts);
+
+// Ordenação de Shell ou _Shell sort_ com a sucessão de incrementos de
+// Sedgewick (1986).
+bool shell_sort_sedgewick_and_count(int length, double items[length],
+				struct algorithm_counts* counts);
+
+// Ordenação de Shell ou _Shell sort_ com a sucessão de incrementos de Pratt.
+bool shell_sort_pratt_and_count(int length, double items[length],
+				struct algorithm_counts* counts);
+
 // Ordenação rápida ou _quicksort_.
 bool quicksort_and_count(int length, double items[length],
 			struct algorithm_counts* counts);
@@ -121,4 +202,121 @@ bool quicksort_and_count(int length, double items[length],
 bool merge_sort_and_count(int length, double items[length],
 			struct algorithm_counts* counts);
 
+// Ordenação por fusão ou _merge sort_ reservando o _array_ auxiliar na arena
+// `arena` (ou dinamicamente, se `arena` for `NULL`).
+bool merge_sort_with_arena_and_count(int length, double items[length],
+				struct scratch_arena *arena,
+				struct algorithm_counts* counts);
+
+// Ordenação por monte (binário) ou _heapsort_.
+bool heap_sort_and_count(int length, double items[length],
+			struct algorithm_counts* counts);
+
+// Ordenação por monte 4-ário.
+bool quaternary_heap_sort_and_count(int length, double items[length],
+				struct algorithm_counts* counts);
+
+// Ordenação por monte 8-ário.
+bool octonary_heap_sort_and_count(int length, double items[length],
+				struct algorithm_counts* counts);
+
+// Declaração das rotinas de ordenação na presença de NaN
+// ======================================================
+//
+// As rotinas de ordenação acima admitem que os itens não incluem NaN. As
+// rotinas seguintes permitem ordenar com qualquer delas itens que incluam NaN
+// (ver [`sorting_algorithms.c`](sorting_algorithms.c.html)), de acordo com a
+// forma de lidar com os NaN escolhida.
+
+// As formas de lidar com os NaN.
+enum nan_handling {
+	// Os itens são ordenados directamente, pelo que não podem incluir
+	// NaN.
+	no_nan_handling,
+	// Os NaN ficam no fim do _array_, por qualquer ordem, seguindo-se aos
+	// restantes itens, ordenados. Os zeros negativos e positivos ficam
+	// por qualquer ordem.
+	nans_last_nan_handling,
+	// Os itens ficam ordenados de acordo com a ordem total da norma IEEE
+	// 754 (`totalOrder`): os NaN com sinal negativo no início, seguidos
+	// dos restantes itens, ordenados, com os zeros negativos antes dos
+	// zeros positivos, e dos NaN com sinal positivo no fim. Os NaN com o
+	// mesmo sinal ficam por qualquer ordem.
+	total_order_nan_handling
+};
+
+// Ordena os itens do _array_ `items` usando a rotina de ordenação `sort` (que
+// pode ser qualquer uma das rotinas acima) e lidando com os NaN da forma
+// indicada por `handling`. Devolve `true` em caso de erro.
+bool sort_handling_nans(bool (*sort)(int, double[]),
+			enum nan_handling handling, int length,
+			double items[length]);
+
+bool sort_handling_nans_and_count(bool (*sort_and_count)(int, double[],
+						struct algorithm_counts*),
+				  enum nan_handling handling, int length,
+				  double items[length],
+				  struct algorithm_counts* counts);
+
+// Declaração das rotinas de selecção
+// ==================================
+//
+// Estas rotinas obtêm os menores itens sem ordenar por completo os itens
+// (ver [`sorting_algorithms.c`](sorting_algorithms.c.html)). Cada uma tem uma
+// versão que regista o número de operações elementares realizadas.
+
+// Coloca na posição `n` do _array_ `items` o item que lá estaria se o _array_
+// estivesse ordenado, ficando antes dele apenas itens menores ou iguais e
+// depois dele apenas itens maiores ou iguais (selecção introspectiva). O valor
+// de `n` tem de estar entre 0 e `length` - 1, excepto se `length` for zero.
+bool nth_element(int length, double items[length], int n);
+
+// Coloca por ordem nas primeiras `k` posições do _array_ `items` os seus `k`
+// menores itens. A ordem dos restantes itens fica indefinida. O valor de `k`
+// tem de estar entre 0 e `length`.
+bool partial_sort(int length, double items[length], int k);
+
+// Lê os itens do ficheiro com o nome `file_name`, um a um, guardando por ordem
+// no _array_ `smallest` os `k` menores (ou todos, se o ficheiro tiver menos de
+// `k` itens). Apenas os `k` itens guardados são mantidos em memória. Devolve o
+// número de itens guardados ou -1 em caso de erro. O valor de `k` não pode ser
+// negativo.
+int read_smallest_from(const char *file_name, int k, double smallest[k]);
+
+bool nth_element_and_count(int length, double items[length], int n,
+			struct algorithm_counts* counts);
+
+bool partial_sort_and_count(int length, double items[length], int k,
+			struct algorithm_counts* counts);
+
+int read_smallest_from_and_count(const char *file_name, int k,
+				double smallest[k],
+				struct algorithm_counts* counts);
+
+// Declaração das rotinas de ordenação indirecta
+// =============================================
+//
+// Estas rotinas não alteram o _array_ recebido, calculando apenas a permutação
+// que o ordena ou a ordem de cada item. Usam uma ordenação por dispersão
+// (_radix sort_) sobre palavras que empacotam os _bits_ da chave (transformados
+// de modo a que a sua ordem enquanto inteiros sem sinal seja a ordem dos
+// `double`) e o índice do item. Quando todos os itens são representáveis
+// exactamente como `float`, a chave e o índice cabem numa única palavra de 64
+// _bits_. Caso contrário, usam-se pares de 128 _bits_. Como a ordenação por
+// dispersão é estável, os índices de itens iguais ficam por ordem crescente.
+// Note-se que, nesta ordem, -0,0 surge antes de 0,0 e os NaN positivos surgem
+// depois de +∞ (e os negativos antes de -∞). Os _arrays_ auxiliares são
+// reservados na arena definida através de `set_sorting_scratch_arena()`.
+// Ambas as rotinas devolvem `true` em caso de erro.
+
+// Coloca em `permutation` os índices dos itens de `items` pela ordem que os
+// ordena, ou seja, `items[permutation[0]]` é o menor item.
+bool argsort_double(int length, const double items[length],
+		    int permutation[length]);
+
+// Coloca em `ranks` a ordem de cada item de `items`, ou seja, a posição, a
+// começar em zero, que ocuparia no _array_ ordenado. Os itens iguais têm
+// ordens diferentes, atribuídas pela ordem dos seus índices.
+bool rank_double(int length, const double items[length], int ranks[length]);
+
 #endif // ISLA_EDA_SORTING_ALGORITHMS_H_INCLUDED